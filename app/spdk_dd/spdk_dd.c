@@ -10,6 +10,7 @@
 #include "spdk/event.h"
 #include "spdk/fd.h"
 #include "spdk/string.h"
+#include "spdk/thread.h"
 #include "spdk/util.h"
 #include "spdk/vmd.h"
 
@@ -1067,6 +1068,80 @@ dd_register_buffers(void)
 }
 #endif
 
+static bool
+dd_bdev_copy_progress(void *cb_arg, uint64_t num_blocks)
+{
+	g_job.incremental_bytes += num_blocks * g_job.input.block_size;
+
+	/* Stop submitting new chunks once interrupted */
+	return !g_interrupt;
+}
+
+static void
+dd_bdev_copy_done(void *cb_arg, int status)
+{
+	if (status != 0 && !(status == -ECANCELED && g_interrupt)) {
+		SPDK_ERRLOG("%s\n", strerror(-status));
+		g_error = status;
+	}
+
+	dd_finalize_output();
+}
+
+/* Both input and output are bdevs: hand the whole range over to the bdev layer copy engine,
+ * which pipelines the chunks and offloads the copy when possible. */
+static bool
+dd_try_bdev_copy(void)
+{
+	struct spdk_bdev_copy_opts opts;
+	struct spdk_iobuf_opts iobuf_opts;
+	int rc;
+
+	if (g_job.input.type != DD_TARGET_TYPE_BDEV || g_job.output.type != DD_TARGET_TYPE_BDEV ||
+	    g_opts.sparse) {
+		return false;
+	}
+
+	if (g_opts.io_unit_size % g_job.output.block_size != 0 ||
+	    g_job.input.pos % g_job.input.block_size != 0 ||
+	    g_job.output.pos % g_job.output.block_size != 0 ||
+	    g_job.copy_size % g_job.output.block_size != 0 ||
+	    g_job.copy_size % g_job.input.block_size != 0) {
+		return false;
+	}
+
+	spdk_bdev_copy_opts_init(&opts, sizeof(opts));
+	opts.queue_depth = g_opts.queue_depth;
+	/* Chunks may be read into iobuf large buffers, which can be smaller than --bs. The copy
+	 * engine further reduces the chunk size if the alignment or metadata don't fit. */
+	spdk_iobuf_get_opts(&iobuf_opts, sizeof(iobuf_opts));
+	opts.chunk_size = spdk_min(g_opts.io_unit_size, iobuf_opts.large_bufsize);
+	opts.chunk_size -= opts.chunk_size % g_job.input.block_size;
+	while (opts.chunk_size % g_job.output.block_size != 0) {
+		opts.chunk_size -= g_job.input.block_size;
+	}
+	if (opts.chunk_size == 0) {
+		return false;
+	}
+	opts.progress_cb = dd_bdev_copy_progress;
+
+	g_job.status_poller = SPDK_POLLER_REGISTER(dd_status_poller, NULL,
+			      STATUS_POLLER_PERIOD_SEC * SPDK_SEC_TO_USEC);
+
+	rc = spdk_bdev_copy_between(g_job.input.u.bdev.desc, g_job.input.u.bdev.ch,
+				    g_job.input.pos / g_job.input.block_size,
+				    g_job.output.u.bdev.desc, g_job.output.u.bdev.ch,
+				    g_job.output.pos / g_job.output.block_size,
+				    g_job.copy_size / g_job.input.block_size,
+				    &opts, dd_bdev_copy_done, NULL);
+	if (rc != 0) {
+		SPDK_ERRLOG("%s\n", strerror(-rc));
+		dd_exit(rc);
+	}
+
+	return true;
+}
+
 static void
 dd_run(void *arg1)
 {
@@ -1171,6 +1246,12 @@ dd_run(void *arg1)
 		return;
 	}
 
+	clock_gettime(CLOCK_REALTIME, &g_job.start_time);
+
+	if (dd_try_bdev_copy()) {
+		return;
+	}
+
 	g_job.ios = calloc(g_opts.queue_depth, sizeof(struct dd_io));
 	if (g_job.ios == NULL) {
 		SPDK_ERRLOG("%s\n", strerror(ENOMEM));
@@ -1236,8 +1317,6 @@ dd_run(void *arg1)
 		}
 	}
 
-	clock_gettime(CLOCK_REALTIME, &g_job.start_time);
-
 	g_job.status_poller = SPDK_POLLER_REGISTER(dd_status_poller, NULL,
 			      STATUS_POLLER_PERIOD_SEC * SPDK_SEC_TO_USEC);
 
@@ -15,10 +15,14 @@
 #include "spdk/util.h"
 #include "spdk/xor.h"
 #include "spdk/dif.h"
+#include "spdk/dma.h"
+#include "spdk/histogram_data.h"
 
 #define DATA_PATTERN 0x5a
 #define ALIGN_4K 0x1000
 #define COMP_BUF_PAD_PERCENTAGE 1.1L
+#define ACCEL_PERF_MAX_SEQ_STEPS 8
+#define ACCEL_PERF_CRYPTO_KEY_NAME "accel_perf_key"
 
 static uint64_t	g_tsc_rate;
 static uint64_t g_tsc_end;
@@ -47,6 +51,58 @@ static int g_num_workers = 0;
 static char *g_cd_file_in_name = NULL;
 static pthread_mutex_t g_workers_lock = PTHREAD_MUTEX_INITIALIZER;
 static struct spdk_app_opts g_opts = {};
+static int g_latency_tracking_level = 0;
+static bool g_use_memory_domain = false;
+static struct spdk_memory_domain *g_memory_domain = NULL;
+static struct spdk_accel_crypto_key *g_crypto_key = NULL;
+
+/* Describes how the data buffers are split into the io vectors */
+enum accel_perf_frag_profile {
+	/* Equally sized elements */
+	ACCEL_PERF_FRAG_EVEN,
+	/* Randomly sized elements */
+	ACCEL_PERF_FRAG_RANDOM,
+	/* Equally sized elements, but with all boundaries shifted off the natural alignment */
+	ACCEL_PERF_FRAG_UNALIGNED,
+};
+
+static const char *g_frag_profile_names[] = {
+	[ACCEL_PERF_FRAG_EVEN] = "even",
+	[ACCEL_PERF_FRAG_RANDOM] = "random",
+	[ACCEL_PERF_FRAG_UNALIGNED] = "unaligned",
+};
+
+static enum accel_perf_frag_profile g_frag_profile = ACCEL_PERF_FRAG_EVEN;
+
+/* Operations which can be used in the sequence workload */
+static const struct {
+	const char		*name;
+	enum spdk_accel_opcode	opcode;
+} g_seq_ops[] = {
+	{ "copy", SPDK_ACCEL_OPC_COPY },
+	{ "fill", SPDK_ACCEL_OPC_FILL },
+	{ "crc32c", SPDK_ACCEL_OPC_CRC32C },
+	{ "encrypt", SPDK_ACCEL_OPC_ENCRYPT },
+	{ "decrypt", SPDK_ACCEL_OPC_DECRYPT },
+};
+
+static bool g_workload_sequence = false;
+static char *g_seq_desc = NULL;
+static enum spdk_accel_opcode g_seq_steps[ACCEL_PERF_MAX_SEQ_STEPS];
+static uint32_t g_seq_num_steps = 0;
+
+static const double g_latency_cutoffs[] = {
+	0.01,
+	0.10,
+	0.25,
+	0.50,
+	0.75,
+	0.90,
+	0.99,
+	0.999,
+	0.9999,
+	-1,
+};
 
 struct ap_compress_seg {
 	void		*uncompressed_data;
@@ -73,6 +129,13 @@ struct display_info {
 	int thread;
 };
 
+struct ap_task;
+
+struct ap_seq_step_ctx {
+	struct ap_task		*task;
+	uint32_t		step;
+};
+
 struct ap_task {
 	void			*src;
 	struct iovec		*src_iovs;
@@ -88,9 +151,13 @@ struct ap_task {
 	struct ap_compress_seg *cur_seg;
 	struct worker_thread	*worker;
 	int			expected_status; /* used for the compare operation */
+	bool			is_zero; /* used for the check_zero operation */
 	uint32_t		num_blocks; /* used for the DIF related operations */
 	struct spdk_dif_ctx	dif_ctx;
 	struct spdk_dif_error	dif_err;
+	uint64_t		submit_tsc;
+	uint64_t		step_tsc; /* completion time of the last step of a sequence */
+	struct ap_seq_step_ctx	step_ctx[ACCEL_PERF_MAX_SEQ_STEPS];
 	TAILQ_ENTRY(ap_task)	link;
 };
 
@@ -110,23 +177,39 @@ struct worker_thread {
 	void				*task_base;
 	struct display_info		display;
 	enum spdk_accel_opcode		workload;
+	unsigned int			seed;
+	uint64_t			seq_completed;
+	struct spdk_histogram_data	*latency;
+	struct spdk_histogram_data	*step_latency[ACCEL_PERF_MAX_SEQ_STEPS];
 };
 
 static void
 dump_user_config(void)
 {
 	const char *module_name = NULL;
+	uint32_t i;
 	int rc;
 
-	rc = spdk_accel_get_opc_module_name(g_workload_selection, &module_name);
-	if (rc) {
-		printf("error getting module name (%d)\n", rc);
+	if (!g_workload_sequence) {
+		rc = spdk_accel_get_opc_module_name(g_workload_selection, &module_name);
+		if (rc) {
+			printf("error getting module name (%d)\n", rc);
+		}
 	}
 
 	printf("\nSPDK Configuration:\n");
 	printf("Core mask:      %s\n\n", g_opts.reactor_mask);
 	printf("Accel Perf Configuration:\n");
 	printf("Workload Type:  %s\n", g_workload_type);
+	if (g_workload_sequence) {
+		printf("Sequence:       %s\n", g_seq_desc);
+		for (i = 0; i < g_seq_num_steps; i++) {
+			rc = spdk_accel_get_opc_module_name(g_seq_steps[i], &module_name);
+			printf("Step %u:         %s (module: %s)\n", i, spdk_accel_get_opcode_name(g_seq_steps[i]),
+			       rc == 0 ? module_name : "unknown");
+		}
+		printf("Memory domain:  %s\n", g_use_memory_domain ? "Yes" : "No");
+	}
 	if (g_workload_selection == SPDK_ACCEL_OPC_CRC32C ||
 	    g_workload_selection == SPDK_ACCEL_OPC_COPY_CRC32C) {
 		printf("CRC-32C seed:   %u\n", g_crc32c_seed);
@@ -142,7 +225,8 @@ dump_user_config(void)
 	    g_workload_selection == SPDK_ACCEL_OPC_DIF_GENERATE ||
 	    g_workload_selection == SPDK_ACCEL_OPC_DIX_VERIFY ||
 	    g_workload_selection == SPDK_ACCEL_OPC_DIX_GENERATE ||
-	    g_workload_selection == SPDK_ACCEL_OPC_DIF_GENERATE_COPY) {
+	    g_workload_selection == SPDK_ACCEL_OPC_DIF_GENERATE_COPY ||
+	    g_workload_selection == SPDK_ACCEL_OPC_CHECK_ZERO) {
 		printf("Vector size:    %u bytes\n", g_xfer_size_bytes);
 		printf("Transfer size:  %u bytes\n", g_xfer_size_bytes * g_chained_count);
 	} else {
@@ -156,7 +240,10 @@ dump_user_config(void)
 		printf("Metadata size:  %u bytes\n", g_md_size_bytes);
 	}
 	printf("Vector count    %u\n", g_chained_count);
-	printf("Module:         %s\n", module_name);
+	printf("Fragmentation:  %s\n", g_frag_profile_names[g_frag_profile]);
+	if (!g_workload_sequence) {
+		printf("Module:         %s\n", module_name);
+	}
 	if (g_workload_selection == SPDK_ACCEL_OPC_COMPRESS ||
 	    g_workload_selection == SPDK_ACCEL_OPC_DECOMPRESS) {
 		printf("File Name:      %s\n", g_cd_file_in_name);
@@ -165,7 +252,8 @@ dump_user_config(void)
 	printf("Allocate depth: %u\n", g_allocate_depth);
 	printf("# threads/core: %u\n", g_threads_per_core);
 	printf("Run time:       %u seconds\n", g_time_in_sec);
-	printf("Verify:         %s\n\n", g_verify ? "Yes" : "No");
+	printf("Verify:         %s\n", g_verify ? "Yes" : "No");
+	printf("Latency:        %s\n\n", g_latency_tracking_level > 0 ? "Yes" : "No");
 }
 
 static void
@@ -179,7 +267,14 @@ usage(void)
 	printf("\t[-o transfer size in bytes (default: 4KiB. For compress/decompress, 0 means the input file size)]\n");
 	printf("\t[-t time in seconds]\n");
 	printf("\t[-w workload type must be one of these: copy, fill, crc32c, copy_crc32c, compare, compress, decompress, dualcast, xor,\n");
-	printf("\t[                                       dif_verify, dif_verify_copy, dif_generate, dif_generate_copy, dix_generate, dix_verify\n");
+	printf("\t[                                       dif_verify, dif_verify_copy, dif_generate, dif_generate_copy, dix_generate, dix_verify,\n");
+	printf("\t[                                       check_zero, sequence\n");
+	printf("\t[-O for sequence workload, comma separated list of operations appended to each sequence, e.g. decrypt,crc32c\n");
+	printf("\t[                          supported operations: copy, fill, crc32c, encrypt, decrypt\n");
+	printf("\t[                          operations producing data (copy, encrypt, decrypt) alternate between two buffers\n");
+	printf("\t[-D for sequence workload, describe the buffers using a memory domain requiring data pull/push\n");
+	printf("\t[-F io vector fragmentation profile, one of: even, random, unaligned (default: even)]\n");
+	printf("\t[-H track latency, -HH also prints the detailed histograms (per step for sequences)]\n");
 	printf("\t[-M assign module to the operation, not compatible with accel_assign_opc RPC\n");
 	printf("\t[-l for compress/decompress workloads, name of uncompressed input file\n");
 	printf("\t[-S for crc32c workload, use this seed value (default 0)\n");
@@ -195,6 +290,7 @@ static int
 parse_args(int ch, char *arg)
 {
 	int argval = 0;
+	uint32_t i;
 
 	switch (ch) {
 	case 'a':
@@ -287,6 +383,10 @@ parse_args(int ch, char *arg)
 			g_workload_selection = SPDK_ACCEL_OPC_DIX_VERIFY;
 		} else if (!strcmp(g_workload_type, "dix_generate")) {
 			g_workload_selection = SPDK_ACCEL_OPC_DIX_GENERATE;
+		} else if (!strcmp(g_workload_type, "check_zero")) {
+			g_workload_selection = SPDK_ACCEL_OPC_CHECK_ZERO;
+		} else if (!strcmp(g_workload_type, "sequence")) {
+			g_workload_sequence = true;
 		} else {
 			fprintf(stderr, "Unsupported workload type: %s\n", optarg);
 			usage();
@@ -296,6 +396,28 @@ parse_args(int ch, char *arg)
 	case 'M':
 		g_module_name = optarg;
 		break;
+	case 'O':
+		g_seq_desc = optarg;
+		break;
+	case 'D':
+		g_use_memory_domain = true;
+		break;
+	case 'F':
+		for (i = 0; i < SPDK_COUNTOF(g_frag_profile_names); i++) {
+			if (!strcmp(optarg, g_frag_profile_names[i])) {
+				g_frag_profile = i;
+				break;
+			}
+		}
+		if (i == SPDK_COUNTOF(g_frag_profile_names)) {
+			fprintf(stderr, "Unsupported fragmentation profile: %s\n", optarg);
+			usage();
+			return 1;
+		}
+		break;
+	case 'H':
+		g_latency_tracking_level++;
+		break;
 
 	default:
 		usage();
@@ -312,8 +434,13 @@ unregister_worker(void *arg1)
 	struct worker_thread *worker = arg1;
 
 	if (worker->ch) {
-		spdk_accel_get_opcode_stats(worker->ch, worker->workload,
-					    &worker->stats, sizeof(worker->stats));
+		if (g_workload_sequence) {
+			worker->stats.executed = worker->seq_completed;
+			worker->stats.num_bytes = worker->seq_completed * g_xfer_size_bytes;
+		} else {
+			spdk_accel_get_opcode_stats(worker->ch, worker->workload,
+						    &worker->stats, sizeof(worker->stats));
+		}
 		spdk_put_io_channel(worker->ch);
 		worker->ch = NULL;
 	}
@@ -333,10 +460,36 @@ unregister_worker(void *arg1)
 	}
 }
 
+static uint64_t
+accel_perf_get_iov_size(uint64_t ele_size, uint64_t sz, uint32_t i, uint32_t iovcnt, unsigned int *seed)
+{
+	uint32_t remaining = iovcnt - i - 1;
+
+	switch (g_frag_profile) {
+	case ACCEL_PERF_FRAG_RANDOM:
+		/* Leave at least a byte for each of the remaining elements */
+		if (remaining == 0) {
+			return sz;
+		}
+		return 1 + rand_r(seed) % spdk_min(sz - remaining, 2 * sz / (remaining + 1));
+	case ACCEL_PERF_FRAG_UNALIGNED:
+		/* Shorten the first element by a byte, so that none of the following ones start at an
+		 * aligned address, and let the last one pick up the remainder */
+		if (remaining == 0) {
+			return sz;
+		}
+		return i == 0 && ele_size > 1 ? ele_size - 1 : spdk_min(ele_size, sz - remaining);
+	case ACCEL_PERF_FRAG_EVEN:
+	default:
+		return spdk_min(ele_size, sz);
+	}
+}
+
 static void
-accel_perf_construct_iovs(void *buf, uint64_t sz, struct iovec *iovs, uint32_t iovcnt)
+accel_perf_construct_iovs(void *buf, uint64_t sz, struct iovec *iovs, uint32_t iovcnt,
+			  unsigned int *seed)
 {
-	uint64_t ele_size;
+	uint64_t ele_size, len;
 	uint8_t *data;
 	uint32_t i;
 
@@ -344,18 +497,60 @@ accel_perf_construct_iovs(void *buf, uint64_t sz, struct iovec *iovs, uint32_t i
 
 	data = buf;
 	for (i = 0; i < iovcnt; i++) {
-		ele_size = spdk_min(ele_size, sz);
-		assert(ele_size > 0);
+		if (sz >= iovcnt - i) {
+			len = accel_perf_get_iov_size(ele_size, sz, i, iovcnt, seed);
+		} else {
+			len = spdk_min(ele_size, sz);
+		}
+		assert(len > 0);
 
 		iovs[i].iov_base = data;
-		iovs[i].iov_len = ele_size;
+		iovs[i].iov_len = len;
 
-		data += ele_size;
-		sz -= ele_size;
+		data += len;
+		sz -= len;
 	}
 	assert(sz == 0);
 }
 
+static int
+_get_sequence_task_data_bufs(struct ap_task *task)
+{
+	uint32_t i;
+
+	for (i = 0; i < g_seq_num_steps; i++) {
+		task->step_ctx[i].task = task;
+		task->step_ctx[i].step = i;
+	}
+
+	task->crc_dst = spdk_dma_zmalloc(sizeof(*task->crc_dst), 0, NULL);
+	task->src = spdk_dma_zmalloc(g_xfer_size_bytes, 0, NULL);
+	task->dst = spdk_dma_zmalloc(g_xfer_size_bytes, 0, NULL);
+	if (task->crc_dst == NULL || task->src == NULL || task->dst == NULL) {
+		fprintf(stderr, "Unable to alloc sequence buffers\n");
+		return -ENOMEM;
+	}
+
+	memset(task->src, DATA_PATTERN, g_xfer_size_bytes);
+	memset(task->dst, ~DATA_PATTERN, g_xfer_size_bytes);
+
+	task->src_iovs = calloc(g_chained_count, sizeof(struct iovec));
+	task->dst_iovs = calloc(g_chained_count, sizeof(struct iovec));
+	if (task->src_iovs == NULL || task->dst_iovs == NULL) {
+		fprintf(stderr, "cannot allocate iovecs for task=%p\n", task);
+		return -ENOMEM;
+	}
+
+	task->src_iovcnt = g_chained_count;
+	task->dst_iovcnt = g_chained_count;
+	accel_perf_construct_iovs(task->src, g_xfer_size_bytes, task->src_iovs, task->src_iovcnt,
+				  &task->worker->seed);
+	accel_perf_construct_iovs(task->dst, g_xfer_size_bytes, task->dst_iovs, task->dst_iovcnt,
+				  &task->worker->seed);
+
+	return 0;
+}
+
 static int
 _get_task_data_bufs(struct ap_task *task)
 {
@@ -368,6 +563,10 @@ _get_task_data_bufs(struct ap_task *task)
 	uint32_t num_blocks, transfer_size_with_md;
 	int rc;
 
+	if (g_workload_sequence) {
+		return _get_sequence_task_data_bufs(task);
+	}
+
 	/* For dualcast, the DSA HW requires 4K alignment on destination addresses but
 	 * we do this for all modules to keep it simple.
 	 */
@@ -395,7 +594,8 @@ _get_task_data_bufs(struct ap_task *task)
 			return -ENOMEM;
 		}
 		task->dst_iovcnt = g_chained_count;
-		accel_perf_construct_iovs(task->dst, dst_buff_len, task->dst_iovs, task->dst_iovcnt);
+		accel_perf_construct_iovs(task->dst, dst_buff_len, task->dst_iovs, task->dst_iovcnt,
+					  &task->worker->seed);
 
 		return 0;
 	}
@@ -508,7 +708,8 @@ _get_task_data_bufs(struct ap_task *task)
 	    g_workload_selection == SPDK_ACCEL_OPC_DIF_GENERATE ||
 	    g_workload_selection == SPDK_ACCEL_OPC_DIF_GENERATE_COPY ||
 	    g_workload_selection == SPDK_ACCEL_OPC_DIX_VERIFY ||
-	    g_workload_selection == SPDK_ACCEL_OPC_DIX_GENERATE) {
+	    g_workload_selection == SPDK_ACCEL_OPC_DIX_GENERATE ||
+	    g_workload_selection == SPDK_ACCEL_OPC_CHECK_ZERO) {
 		assert(g_chained_count > 0);
 		task->src_iovcnt = g_chained_count;
 		task->src_iovs = calloc(task->src_iovcnt, sizeof(struct iovec));
@@ -531,7 +732,10 @@ _get_task_data_bufs(struct ap_task *task)
 			if (task->src_iovs[i].iov_base == NULL) {
 				return -ENOMEM;
 			}
-			memset(task->src_iovs[i].iov_base, DATA_PATTERN, src_buff_len);
+			/* Keep check_zero buffers zeroed, so that they're scanned entirely */
+			if (g_workload_selection != SPDK_ACCEL_OPC_CHECK_ZERO) {
+				memset(task->src_iovs[i].iov_base, DATA_PATTERN, src_buff_len);
+			}
 			task->src_iovs[i].iov_len = src_buff_len;
 		}
 		if (g_workload_selection == SPDK_ACCEL_OPC_DIX_GENERATE ||
@@ -579,7 +783,8 @@ _get_task_data_bufs(struct ap_task *task)
 	    g_workload_selection != SPDK_ACCEL_OPC_DIF_GENERATE_COPY &&
 	    g_workload_selection != SPDK_ACCEL_OPC_DIF_VERIFY_COPY &&
 	    g_workload_selection != SPDK_ACCEL_OPC_DIX_VERIFY &&
-	    g_workload_selection != SPDK_ACCEL_OPC_DIX_GENERATE) {
+	    g_workload_selection != SPDK_ACCEL_OPC_DIX_GENERATE &&
+	    g_workload_selection != SPDK_ACCEL_OPC_CHECK_ZERO) {
 		task->dst = spdk_dma_zmalloc(dst_buff_len, align, NULL);
 		if (task->dst == NULL) {
 			fprintf(stderr, "Unable to alloc dst buffer\n");
@@ -681,6 +886,97 @@ _get_task(struct worker_thread *worker)
 	return task;
 }
 
+static void
+accel_perf_seq_step_done(void *arg)
+{
+	struct ap_seq_step_ctx *ctx = arg;
+	struct ap_task *task = ctx->task;
+	uint64_t now = spdk_get_ticks();
+
+	/* Steps which were elided or merged with other steps by the accel framework are completed
+	 * together with them, so they'll show up as close to zero latency. */
+	spdk_histogram_data_tally(task->worker->step_latency[ctx->step], now - task->step_tsc);
+	task->step_tsc = now;
+}
+
+/* Build a sequence out of the operations described by the user and execute it. */
+static void
+_submit_sequence(struct worker_thread *worker, struct ap_task *task)
+{
+	struct spdk_accel_sequence *seq = NULL;
+	struct iovec *src_iovs = task->src_iovs, *dst_iovs = task->dst_iovs, *tmp_iovs;
+	void *src = task->src, *dst = task->dst, *tmp;
+	spdk_accel_step_cb step_cb = NULL;
+	bool swap;
+	uint32_t i;
+	int rc = 0;
+
+	if (g_latency_tracking_level > 0) {
+		step_cb = accel_perf_seq_step_done;
+	}
+
+	for (i = 0; i < g_seq_num_steps && rc == 0; i++) {
+		swap = false;
+		switch (g_seq_steps[i]) {
+		case SPDK_ACCEL_OPC_FILL:
+			rc = spdk_accel_append_fill(&seq, worker->ch, src, g_xfer_size_bytes,
+						    g_memory_domain, NULL, g_fill_pattern,
+						    step_cb, &task->step_ctx[i]);
+			break;
+		case SPDK_ACCEL_OPC_CRC32C:
+			rc = spdk_accel_append_crc32c(&seq, worker->ch, task->crc_dst, src_iovs,
+						      task->src_iovcnt, g_memory_domain, NULL, g_crc32c_seed,
+						      step_cb, &task->step_ctx[i]);
+			break;
+		case SPDK_ACCEL_OPC_COPY:
+			rc = spdk_accel_append_copy(&seq, worker->ch, dst_iovs, task->dst_iovcnt,
+						    g_memory_domain, NULL, src_iovs, task->src_iovcnt,
+						    g_memory_domain, NULL, step_cb, &task->step_ctx[i]);
+			swap = true;
+			break;
+		case SPDK_ACCEL_OPC_ENCRYPT:
+			rc = spdk_accel_append_encrypt(&seq, worker->ch, g_crypto_key,
+						       dst_iovs, task->dst_iovcnt, g_memory_domain, NULL,
+						       src_iovs, task->src_iovcnt, g_memory_domain, NULL,
+						       0, g_block_size_bytes, step_cb, &task->step_ctx[i]);
+			swap = true;
+			break;
+		case SPDK_ACCEL_OPC_DECRYPT:
+			rc = spdk_accel_append_decrypt(&seq, worker->ch, g_crypto_key,
+						       dst_iovs, task->dst_iovcnt, g_memory_domain, NULL,
+						       src_iovs, task->src_iovcnt, g_memory_domain, NULL,
+						       0, g_block_size_bytes, step_cb, &task->step_ctx[i]);
+			swap = true;
+			break;
+		default:
+			assert(false);
+			rc = -EINVAL;
+			break;
+		}
+
+		/* The output of an operation is the input of the next one */
+		if (swap) {
+			tmp = src;
+			src = dst;
+			dst = tmp;
+			tmp_iovs = src_iovs;
+			src_iovs = dst_iovs;
+			dst_iovs = tmp_iovs;
+		}
+	}
+
+	worker->current_queue_depth++;
+	if (spdk_unlikely(rc != 0)) {
+		if (seq != NULL) {
+			spdk_accel_sequence_abort(seq);
+		}
+		accel_done(task, rc);
+		return;
+	}
+
+	spdk_accel_sequence_finish(seq, accel_done, task);
+}
+
 /* Submit one operation using the same ap task that just completed. */
 static void
 _submit_single(struct worker_thread *worker, struct ap_task *task)
@@ -690,6 +986,16 @@ _submit_single(struct worker_thread *worker, struct ap_task *task)
 
 	assert(worker);
 
+	if (g_latency_tracking_level > 0) {
+		task->submit_tsc = spdk_get_ticks();
+		task->step_tsc = task->submit_tsc;
+	}
+
+	if (g_workload_sequence) {
+		_submit_sequence(worker, task);
+		return;
+	}
+
 	switch (worker->workload) {
 	case SPDK_ACCEL_OPC_COPY:
 		rc = spdk_accel_submit_copy(worker->ch, task->dst, task->src,
@@ -770,6 +1076,10 @@ _submit_single(struct worker_thread *worker, struct ap_task *task)
 						  &task->md_iov, task->num_blocks,
 						  &task->dif_ctx, &task->dif_err, accel_done, task);
 		break;
+	case SPDK_ACCEL_OPC_CHECK_ZERO:
+		rc = spdk_accel_submit_check_zero(worker->ch, task->src_iovs, task->src_iovcnt,
+						  &task->is_zero, accel_done, task);
+		break;
 	default:
 		assert(false);
 		break;
@@ -787,6 +1097,15 @@ _free_task_buffers(struct ap_task *task)
 {
 	uint32_t i;
 
+	if (g_workload_sequence) {
+		spdk_dma_free(task->crc_dst);
+		free(task->src_iovs);
+		free(task->dst_iovs);
+		spdk_dma_free(task->src);
+		spdk_dma_free(task->dst);
+		return;
+	}
+
 	if (g_workload_selection == SPDK_ACCEL_OPC_DECOMPRESS ||
 	    g_workload_selection == SPDK_ACCEL_OPC_COMPRESS) {
 		free(task->dst_iovs);
@@ -797,7 +1116,8 @@ _free_task_buffers(struct ap_task *task)
 		   g_workload_selection == SPDK_ACCEL_OPC_DIF_GENERATE_COPY ||
 		   g_workload_selection == SPDK_ACCEL_OPC_DIF_VERIFY_COPY ||
 		   g_workload_selection == SPDK_ACCEL_OPC_DIX_VERIFY ||
-		   g_workload_selection == SPDK_ACCEL_OPC_DIX_GENERATE) {
+		   g_workload_selection == SPDK_ACCEL_OPC_DIX_GENERATE ||
+		   g_workload_selection == SPDK_ACCEL_OPC_CHECK_ZERO) {
 		if (task->crc_dst) {
 			spdk_dma_free(task->crc_dst);
 		}
@@ -872,6 +1192,14 @@ accel_done(void *arg1, int status)
 	assert(worker);
 	assert(worker->current_queue_depth > 0);
 
+	if (worker->latency != NULL) {
+		spdk_histogram_data_tally(worker->latency, spdk_get_ticks() - task->submit_tsc);
+	}
+
+	if (g_workload_sequence && status == 0) {
+		worker->seq_completed++;
+	}
+
 	if (g_verify && status == 0) {
 		switch (worker->workload) {
 		case SPDK_ACCEL_OPC_COPY_CRC32C:
@@ -969,6 +1297,12 @@ accel_done(void *arg1, int status)
 			break;
 		case SPDK_ACCEL_OPC_DIX_VERIFY:
 			break;
+		case SPDK_ACCEL_OPC_CHECK_ZERO:
+			if (!task->is_zero) {
+				SPDK_NOTICELOG("Buffer unexpectedly reported as non-zero\n");
+				worker->xfer_failed++;
+			}
+			break;
 		default:
 			assert(false);
 			break;
@@ -1004,6 +1338,91 @@ accel_done(void *arg1, int status)
 	}
 }
 
+static void
+check_cutoff(void *ctx, uint64_t start, uint64_t end, uint64_t count,
+	     uint64_t total, uint64_t so_far)
+{
+	double so_far_pct;
+	const double **cutoff = ctx;
+
+	if (count == 0) {
+		return;
+	}
+
+	so_far_pct = (double)so_far / total;
+	while (so_far_pct >= **cutoff && **cutoff > 0) {
+		printf("%9.5f%% : %9.3fus\n", **cutoff * 100, (double)end * 1000 * 1000 / g_tsc_rate);
+		(*cutoff)++;
+	}
+}
+
+static void
+print_bucket(void *ctx, uint64_t start, uint64_t end, uint64_t count,
+	     uint64_t total, uint64_t so_far)
+{
+	double so_far_pct;
+
+	if (count == 0) {
+		return;
+	}
+
+	so_far_pct = (double)so_far * 100 / total;
+	printf("%9.3f - %9.3f: %9.4f%%  (%9ju)\n",
+	       (double)start * 1000 * 1000 / g_tsc_rate,
+	       (double)end * 1000 * 1000 / g_tsc_rate,
+	       so_far_pct, count);
+}
+
+static void
+dump_histogram(const char *name, struct spdk_histogram_data *histogram)
+{
+	const double *cutoff = g_latency_cutoffs;
+
+	printf("\nSummary latency data for %s:\n", name);
+	printf("====================================================================================\n");
+	spdk_histogram_data_iterate(histogram, check_cutoff, &cutoff);
+
+	if (g_latency_tracking_level > 1) {
+		printf("\nLatency histogram for %s:\n", name);
+		printf("====================================================================================\n");
+		printf("       Range in us     Cumulative    IO count\n");
+		spdk_histogram_data_iterate(histogram, print_bucket, NULL);
+	}
+}
+
+/* Print the latency of the operations (or of the whole sequences) and, for sequences, the
+ * latency of each of their steps, aggregated across all workers. */
+static void
+dump_latency(void)
+{
+	struct spdk_histogram_data *histogram;
+	struct worker_thread *worker;
+	char name[64];
+	uint32_t i;
+
+	histogram = spdk_histogram_data_alloc();
+	if (histogram == NULL) {
+		fprintf(stderr, "Could not allocate latency histogram.\n");
+		return;
+	}
+
+	for (worker = g_workers; worker != NULL; worker = worker->next) {
+		spdk_histogram_data_merge(histogram, worker->latency);
+	}
+	dump_histogram(g_workload_sequence ? "sequence" : g_workload_type, histogram);
+
+	for (i = 0; i < g_seq_num_steps; i++) {
+		spdk_histogram_data_reset(histogram);
+		for (worker = g_workers; worker != NULL; worker = worker->next) {
+			spdk_histogram_data_merge(histogram, worker->step_latency[i]);
+		}
+		snprintf(name, sizeof(name), "step %u (%s)", i, spdk_accel_get_opcode_name(g_seq_steps[i]));
+		dump_histogram(name, histogram);
+	}
+
+	spdk_histogram_data_free(histogram);
+}
+
 static int
 dump_result(void)
 {
@@ -1044,6 +1463,10 @@ dump_result(void)
 	printf("%-12s %18" PRIu64 "/s %10" PRIu64 " MiB/s %16"PRIu64 " %16" PRIu64 "\n",
 	       "Total", total_xfer_per_sec, total_bw_in_MiBps, total_failed, total_miscompared);
 
+	if (g_latency_tracking_level > 0 && total_completed > 0) {
+		dump_latency();
+	}
+
 	return total_failed ? 1 : 0;
 }
 
@@ -1112,6 +1535,7 @@ _init_thread(void *arg1)
 	worker->workload = g_workload_selection;
 	worker->display.core = display->core;
 	worker->display.thread = display->thread;
+	worker->seed = display->core << 16 | display->thread;
 	free(display);
 	worker->core = spdk_env_get_current_core();
 	worker->thread = spdk_get_thread();
@@ -1128,6 +1552,21 @@ _init_thread(void *arg1)
 
 	TAILQ_INIT(&worker->tasks_pool);
 
+	if (g_latency_tracking_level > 0) {
+		worker->latency = spdk_histogram_data_alloc();
+		if (worker->latency == NULL) {
+			fprintf(stderr, "Could not allocate latency histogram.\n");
+			goto error;
+		}
+		for (i = 0; i < (int)g_seq_num_steps; i++) {
+			worker->step_latency[i] = spdk_histogram_data_alloc();
+			if (worker->step_latency[i] == NULL) {
+				fprintf(stderr, "Could not allocate latency histogram.\n");
+				goto error;
+			}
+		}
+	}
+
 	worker->task_base = calloc(num_tasks, sizeof(struct ap_task));
 	if (worker->task_base == NULL) {
 		fprintf(stderr, "Could not allocate task base.\n");
@@ -1227,6 +1666,7 @@ struct accel_perf_prep_ctx {
 	long			remaining;
 	struct spdk_io_channel	*ch;
 	struct ap_compress_seg	*cur_seg;
+	unsigned int		seed;
 };
 
 static void accel_perf_prep_process_seg(struct accel_perf_prep_ctx *ctx);
@@ -1267,7 +1707,7 @@ accel_perf_prep_process_seg_cpl(void *ref, int status)
 		seg->compressed_iovcnt = g_chained_count;
 
 		accel_perf_construct_iovs(seg->compressed_data, seg->compressed_len, seg->compressed_iovs,
-					  seg->compressed_iovcnt);
+					  seg->compressed_iovcnt, &ctx->seed);
 	}
 
 	STAILQ_INSERT_TAIL(&g_compress_segs, seg, link);
@@ -1348,7 +1788,8 @@ accel_perf_prep_process_seg(struct accel_perf_prep_ctx *ctx)
 			goto error;
 		}
 		seg->uncompressed_iovcnt = g_chained_count;
-		accel_perf_construct_iovs(ubuf, sz, seg->uncompressed_iovs, seg->uncompressed_iovcnt);
+		accel_perf_construct_iovs(ubuf, sz, seg->uncompressed_iovs, seg->uncompressed_iovcnt,
+					  &ctx->seed);
 	}
 
 	seg->uncompressed_data = ubuf;
@@ -1381,22 +1822,124 @@ error:
 	spdk_app_stop(rc);
 }
 
+static int
+accel_perf_pull_data(struct spdk_memory_domain *src_domain, void *src_domain_ctx,
+		     struct iovec *src_iov, uint32_t src_iovcnt, struct iovec *dst_iov, uint32_t dst_iovcnt,
+		     spdk_memory_domain_data_cpl_cb cpl_cb, void *cpl_cb_arg)
+{
+	/* The buffers are actually in local memory, so simply copy the data */
+	spdk_iovcpy(src_iov, src_iovcnt, dst_iov, dst_iovcnt);
+	cpl_cb(cpl_cb_arg, 0);
+
+	return 0;
+}
+
+static int
+accel_perf_push_data(struct spdk_memory_domain *dst_domain, void *dst_domain_ctx,
+		     struct iovec *dst_iov, uint32_t dst_iovcnt, struct iovec *src_iov, uint32_t src_iovcnt,
+		     spdk_memory_domain_data_cpl_cb cpl_cb, void *cpl_cb_arg)
+{
+	spdk_iovcpy(src_iov, src_iovcnt, dst_iov, dst_iovcnt);
+	cpl_cb(cpl_cb_arg, 0);
+
+	return 0;
+}
+
+static bool
+accel_perf_sequence_has_crypto(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < g_seq_num_steps; i++) {
+		if (g_seq_steps[i] == SPDK_ACCEL_OPC_ENCRYPT ||
+		    g_seq_steps[i] == SPDK_ACCEL_OPC_DECRYPT) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static int
+accel_perf_prep_sequence(void)
+{
+	struct spdk_accel_crypto_key_create_param param = {
+		.cipher = "AES_XTS",
+		.hex_key = "00112233445566778899aabbccddeeff",
+		.hex_key2 = "ffeeddccbbaa99887766554433221100",
+		.key_name = ACCEL_PERF_CRYPTO_KEY_NAME,
+	};
+	int rc;
+
+	if (accel_perf_sequence_has_crypto()) {
+		/* The key is destroyed by the accel framework when it's finished */
+		rc = spdk_accel_crypto_key_create(&param);
+		if (rc != 0) {
+			fprintf(stderr, "Unable to create crypto key (%d)\n", rc);
+			return rc;
+		}
+		g_crypto_key = spdk_accel_crypto_key_get(ACCEL_PERF_CRYPTO_KEY_NAME);
+		assert(g_crypto_key != NULL);
+	}
+
+	if (g_use_memory_domain) {
+		rc = spdk_memory_domain_create(&g_memory_domain, SPDK_DMA_DEVICE_TYPE_DMA, NULL,
+					       "accel_perf");
+		if (rc != 0) {
+			fprintf(stderr, "Unable to create memory domain (%d)\n", rc);
+			return rc;
+		}
+		spdk_memory_domain_set_pull(g_memory_domain, accel_perf_pull_data);
+		spdk_memory_domain_set_push(g_memory_domain, accel_perf_push_data);
+	}
+
+	return 0;
+}
+
+static int
+accel_perf_check_module(enum spdk_accel_opcode opcode)
+{
+	const char *module_name = NULL;
+	int rc;
+
+	rc = spdk_accel_get_opc_module_name(opcode, &module_name);
+	if (rc != 0 || strcmp(g_module_name, module_name) != 0) {
+		fprintf(stderr, "Module '%s' was assigned via JSON config or RPC, instead of '%s'\n",
+			module_name, g_module_name);
+		fprintf(stderr, "-M option is not compatible with accel_assign_opc RPC\n");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 static void
 accel_perf_prep(void *arg1)
 {
 	struct accel_perf_prep_ctx *ctx;
-	const char *module_name = NULL;
+	uint32_t i;
 	int rc = 0;
 
 	if (g_module_name) {
-		rc = spdk_accel_get_opc_module_name(g_workload_selection, &module_name);
-		if (rc != 0 || strcmp(g_module_name, module_name) != 0) {
-			fprintf(stderr, "Module '%s' was assigned via JSON config or RPC, instead of '%s'\n",
-				module_name, g_module_name);
-			fprintf(stderr, "-M option is not compatible with accel_assign_opc RPC\n");
-			rc = -EINVAL;
+		if (g_workload_sequence) {
+			for (i = 0; i < g_seq_num_steps && rc == 0; i++) {
+				rc = accel_perf_check_module(g_seq_steps[i]);
+			}
+		} else {
+			rc = accel_perf_check_module(g_workload_selection);
+		}
+		if (rc != 0) {
+			goto error_end;
+		}
+	}
+
+	if (g_workload_sequence) {
+		rc = accel_perf_prep_sequence();
+		if (rc != 0) {
 			goto error_end;
 		}
+		accel_perf_start(arg1);
+		return;
 	}
 
 	if (g_workload_selection != SPDK_ACCEL_OPC_COMPRESS &&
@@ -1484,10 +2027,54 @@ unlock:
 	pthread_mutex_unlock(&g_workers_lock);
 }
 
+static int
+accel_perf_parse_sequence(const char *desc)
+{
+	char *str, *tok, *sp = NULL;
+	uint32_t i;
+	int rc = 0;
+
+	str = strdup(desc);
+	if (str == NULL) {
+		return -ENOMEM;
+	}
+
+	for (tok = strtok_r(str, ",", &sp); tok != NULL; tok = strtok_r(NULL, ",", &sp)) {
+		if (g_seq_num_steps == ACCEL_PERF_MAX_SEQ_STEPS) {
+			fprintf(stderr, "Sequence can consist of at most %d operations\n",
+				ACCEL_PERF_MAX_SEQ_STEPS);
+			rc = -EINVAL;
+			break;
+		}
+
+		for (i = 0; i < SPDK_COUNTOF(g_seq_ops); i++) {
+			if (!strcmp(tok, g_seq_ops[i].name)) {
+				break;
+			}
+		}
+		if (i == SPDK_COUNTOF(g_seq_ops)) {
+			fprintf(stderr, "Unsupported sequence operation: %s\n", tok);
+			rc = -EINVAL;
+			break;
+		}
+
+		g_seq_steps[g_seq_num_steps++] = g_seq_ops[i].opcode;
+	}
+
+	free(str);
+	if (rc == 0 && g_seq_num_steps == 0) {
+		fprintf(stderr, "Sequence must consist of at least one operation\n");
+		rc = -EINVAL;
+	}
+
+	return rc;
+}
+
 int
 main(int argc, char **argv)
 {
 	struct worker_thread *worker, *tmp;
+	uint32_t i;
 	int rc;
 
 	pthread_mutex_init(&g_workers_lock, NULL);
@@ -1497,18 +2084,47 @@ main(int argc, char **argv)
 	g_opts.shutdown_cb = shutdown_cb;
 	g_opts.rpc_addr = NULL;
 
-	rc = spdk_app_parse_args(argc, argv, &g_opts, "a:C:o:q:t:yw:M:P:f:T:l:S:x:", NULL,
+	rc = spdk_app_parse_args(argc, argv, &g_opts, "a:C:o:q:t:yw:M:P:f:T:l:S:x:O:DF:H", NULL,
 				 parse_args, usage);
 	if (rc != SPDK_APP_PARSE_ARGS_SUCCESS) {
 		return rc == SPDK_APP_PARSE_ARGS_HELP ? 0 : 1;
 	}
 
-	if (g_workload_selection == SPDK_ACCEL_OPC_LAST) {
+	if (g_workload_selection == SPDK_ACCEL_OPC_LAST && !g_workload_sequence) {
 		fprintf(stderr, "Must provide a workload type\n");
 		usage();
 		return -1;
 	}
 
+	if (g_workload_sequence) {
+		if (g_seq_desc == NULL) {
+			fprintf(stderr, "Must provide the operations of the sequence\n");
+			usage();
+			return -1;
+		}
+		if (accel_perf_parse_sequence(g_seq_desc) != 0) {
+			usage();
+			return -1;
+		}
+		if (g_verify) {
+			fprintf(stderr, "Sequence workload does not support the verify option\n");
+			return -1;
+		}
+		if (g_chained_count == 0 || (uint32_t)g_xfer_size_bytes < g_chained_count) {
+			usage();
+			return -1;
+		}
+		if (accel_perf_sequence_has_crypto() && g_xfer_size_bytes % g_block_size_bytes != 0) {
+			fprintf(stderr, "Transfer size must be a multiple of %d for crypto operations\n",
+				g_block_size_bytes);
+			return -1;
+		}
+	} else if (g_seq_desc != NULL || g_use_memory_domain) {
+		fprintf(stderr, "-O and -D options are only supported by the sequence workload\n");
+		usage();
+		return -1;
+	}
+
 	if (g_allocate_depth > 0 && g_queue_depth > g_allocate_depth) {
 		fprintf(stdout, "allocate depth must be at least as big as queue depth\n");
 		usage();
@@ -1524,7 +2140,8 @@ main(int argc, char **argv)
 	     g_workload_selection == SPDK_ACCEL_OPC_DIF_VERIFY ||
 	     g_workload_selection == SPDK_ACCEL_OPC_DIF_GENERATE ||
 	     g_workload_selection == SPDK_ACCEL_OPC_DIX_VERIFY ||
-	     g_workload_selection == SPDK_ACCEL_OPC_DIX_GENERATE) &&
+	     g_workload_selection == SPDK_ACCEL_OPC_DIX_GENERATE ||
+	     g_workload_selection == SPDK_ACCEL_OPC_CHECK_ZERO) &&
 	    g_chained_count == 0) {
 		usage();
 		return -1;
@@ -1535,10 +2152,19 @@ main(int argc, char **argv)
 		return -1;
 	}
 
-	if (g_module_name && spdk_accel_assign_opc(g_workload_selection, g_module_name)) {
-		fprintf(stderr, "Was not able to assign '%s' module to the workload\n", g_module_name);
-		usage();
-		return -1;
+	if (g_module_name) {
+		if (g_workload_sequence) {
+			for (i = 0, rc = 0; i < g_seq_num_steps && rc == 0; i++) {
+				rc = spdk_accel_assign_opc(g_seq_steps[i], g_module_name);
+			}
+		} else {
+			rc = spdk_accel_assign_opc(g_workload_selection, g_module_name);
+		}
+		if (rc != 0) {
+			fprintf(stderr, "Was not able to assign '%s' module to the workload\n", g_module_name);
+			usage();
+			return -1;
+		}
 	}
 
 	g_rc = spdk_app_start(&g_opts, accel_perf_prep, NULL);
@@ -1551,10 +2177,21 @@ main(int argc, char **argv)
 	worker = g_workers;
 	while (worker) {
 		tmp = worker->next;
+		if (worker->latency != NULL) {
+			spdk_histogram_data_free(worker->latency);
+		}
+		for (i = 0; i < g_seq_num_steps; i++) {
+			if (worker->step_latency[i] != NULL) {
+				spdk_histogram_data_free(worker->step_latency[i]);
+			}
+		}
 		free(worker);
 		worker = tmp;
 	}
 	accel_perf_free_compress_segs();
+	if (g_memory_domain != NULL) {
+		spdk_memory_domain_destroy(g_memory_domain);
+	}
 	spdk_app_fini();
 	return g_rc;
 }
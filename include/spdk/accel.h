@@ -56,7 +56,8 @@ enum spdk_accel_opcode {
 	SPDK_ACCEL_OPC_DIF_GENERATE_COPY	= 14,
 	SPDK_ACCEL_OPC_DIX_GENERATE		= 15,
 	SPDK_ACCEL_OPC_DIX_VERIFY		= 16,
-	SPDK_ACCEL_OPC_LAST			= 17,
+	SPDK_ACCEL_OPC_CHECK_ZERO		= 17,
+	SPDK_ACCEL_OPC_LAST			= 18,
 };
 
 enum spdk_accel_cipher {
@@ -172,6 +173,22 @@ int spdk_accel_submit_dualcast(struct spdk_io_channel *ch, void *dst1, void *dst
 int spdk_accel_submit_compare(struct spdk_io_channel *ch, void *src1, void *src2, uint64_t nbytes,
 			      spdk_accel_completion_cb cb_fn, void *cb_arg);
 
+/**
+ * Submit a request to check whether a buffer consists entirely of zeroes.
+ *
+ * \param ch I/O channel associated with this call.
+ * \param iovs The io vector array describing the buffer to check.
+ * \param iovcnt The size of the io vector array.
+ * \param is_zero Set to true if the whole buffer is zero and to false otherwise. It's only
+ * valid once the operation completes successfully.
+ * \param cb_fn Called when this operation completes.
+ * \param cb_arg Callback argument.
+ *
+ * \return 0 on success, negative errno on failure.
+ */
+int spdk_accel_submit_check_zero(struct spdk_io_channel *ch, struct iovec *iovs, uint32_t iovcnt,
+				 bool *is_zero, spdk_accel_completion_cb cb_fn, void *cb_arg);
+
 /**
  * Submit a fill request.
  *
@@ -1090,6 +1107,30 @@ int spdk_accel_get_opc_module_name(enum spdk_accel_opcode opcode, const char **m
  */
 int spdk_accel_assign_opc(enum spdk_accel_opcode opcode, const char *name);
 
+/** Maximum number of modules an opcode can be spread across. */
+#define SPDK_ACCEL_OPC_MAX_MODULES 4
+
+/**
+ * Spread the execution of an opcode across several modules.  Each task is dispatched to the
+ * module expected to complete it first, based on the module's queue depth and measured
+ * throughput on the submitting channel.  If a module fails to accept a task with -ENOMEM, the
+ * task spills over to the remaining modules, in order of preference.
+ *
+ * Encrypt, decrypt, compress and decompress operations cannot be spread, as their keys and
+ * parameters are bound to a single module.
+ *
+ * \param opcode Accel Framework Opcode enum value. Valid codes can be retrieved using
+ * `accel_get_opc_assignments` or `spdk_accel_get_opcode_name`.
+ * \param names Names of the modules, in order of preference.  The first one is assigned to the
+ * opcode the same way as with `spdk_accel_assign_opc`.
+ * \param num_names Number of modules, up to SPDK_ACCEL_OPC_MAX_MODULES.
+ *
+ * \return 0 on success. -EINVAL for invalid opcode or number of modules or if the framework has
+ * started (cannot change modules after startup), -ENOMEM if memory couldn't be allocated.
+ */
+int spdk_accel_assign_opc_modules(enum spdk_accel_opcode opcode, const char **names,
+				  size_t num_names);
+
 struct spdk_json_write_ctx;
 
 /**
@@ -95,7 +95,9 @@ struct spdk_accel_task {
 	uint8_t				op_code;
 	bool				has_aux;
 	int16_t				status;
-	uint8_t				reserved[4];
+	/* Index of the module the task was dispatched to, if its opcode is spread across modules */
+	uint8_t				module_idx;
+	uint8_t				reserved[3];
 	struct accel_io_channel		*accel_ch;
 	struct spdk_accel_sequence	*seq;
 	union {
@@ -152,9 +154,16 @@ struct spdk_accel_task {
 		uint32_t		*crc_dst;
 		uint32_t		*output_size;
 		uint32_t		block_size; /* for crypto op */
+		bool			*is_zero; /* for check zero op */
 	};
 	uint64_t			iv; /* Initialization vector (tweak) for crypto op */
 	struct spdk_accel_task_aux_data	*aux;
+	/*
+	 * CRC-32C operation of a sequence fused into this task.  If set, the module needs to
+	 * compute the CRC-32C of the destination buffer while executing the task and store it
+	 * according to the fused task's `crc_dst` and `seed`.
+	 */
+	struct spdk_accel_task		*fused_crc32c;
 };
 
 struct spdk_accel_opcode_info {
@@ -266,6 +275,14 @@ struct spdk_accel_module_if {
 				  const struct spdk_accel_operation_exec_ctx *ctx,
 				  struct spdk_accel_opcode_info *info);
 
+	/**
+	 * Returns true if the module can compute the CRC-32C of the destination buffer of a given
+	 * operation in the same pass as the operation itself.  A CRC-32C operation following such
+	 * an operation in a sequence is then fused into it (see `spdk_accel_task.fused_crc32c`),
+	 * as long as the same module executes both of them.  Optional.
+	 */
+	bool (*supports_fused_crc32c)(enum spdk_accel_opcode opcode);
+
 	TAILQ_ENTRY(spdk_accel_module_if)	tailq;
 };
 
@@ -1957,6 +1957,102 @@ int spdk_bdev_copy_blocks(struct spdk_bdev_desc *desc, struct spdk_io_channel *c
 			  uint64_t dst_offset_blocks, uint64_t src_offset_blocks,
 			  uint64_t num_blocks, spdk_bdev_io_completion_cb cb, void *cb_arg);
 
+/**
+ * Copy between bdevs progress callback.
+ *
+ * \param cb_arg Callback argument specified in struct spdk_bdev_copy_opts.
+ * \param num_blocks Number of source blocks copied by the chunk that just completed.
+ *
+ * \return true to continue the copy. false to stop it: no more chunks are submitted and
+ * the copy completes with -ECANCELED once the chunks in flight are done. If all of the chunks
+ * had already been submitted, the copy completes normally.
+ */
+typedef bool (*spdk_bdev_copy_progress_cb)(void *cb_arg, uint64_t num_blocks);
+
+/**
+ * Options for spdk_bdev_copy_between().
+ */
+struct spdk_bdev_copy_opts {
+	/** Size of this structure in bytes */
+	size_t size;
+
+	/** Maximum number of chunks in flight. */
+	uint32_t queue_depth;
+
+	/**
+	 * Size of a single chunk in bytes. Must be a multiple of the block size of both
+	 * the source and the destination bdev. When the chunks are read into buffers
+	 * allocated by the bdev layer, it is reduced to fit in an iobuf large buffer.
+	 */
+	uint32_t chunk_size;
+
+	/** Maximum copy bandwidth in MiB/s. 0 means unlimited. */
+	uint32_t max_bandwidth_mb_sec;
+
+	/** Optional callback called after each successfully copied chunk. */
+	spdk_bdev_copy_progress_cb progress_cb;
+
+	/** Argument passed to progress_cb. */
+	void *progress_cb_arg;
+} __attribute__((packed));
+SPDK_STATIC_ASSERT(sizeof(struct spdk_bdev_copy_opts) == 36, "Incorrect size");
+
+/**
+ * Initialize copy options structure with default values.
+ *
+ * \param opts The structure to initialize.
+ * \param size The size of *opts.
+ */
+void spdk_bdev_copy_opts_init(struct spdk_bdev_copy_opts *opts, size_t size);
+
+/**
+ * Copy between bdevs completion callback.
+ *
+ * \param cb_arg Callback argument specified in spdk_bdev_copy_between().
+ * \param status 0 if the copy succeeded, negated errno otherwise.
+ */
+typedef void (*spdk_bdev_copy_between_cb)(void *cb_arg, int status);
+
+/**
+ * Copy a range of data from one block device to another (or to another range of
+ * the same block device).
+ *
+ * The data is copied in chunks, keeping up to opts->queue_depth chunks in flight.
+ * If both descriptors refer to the same bdev and it supports SPDK_BDEV_IO_TYPE_COPY,
+ * each chunk is offloaded as a copy request. Otherwise, each chunk is read into a
+ * buffer owned by the source bdev (a zero-copy buffer if the source supports
+ * SPDK_BDEV_IO_TYPE_ZCOPY and src_desc is writable, or a buffer from the iobuf pool)
+ * and written from that buffer directly to the destination, so no additional bounce
+ * buffers are used. Separate metadata is not copied.
+ *
+ * All I/O is submitted on the calling thread, so both channels must belong to it.
+ *
+ * \param src_desc Source block device descriptor.
+ * \param src_ch I/O channel of the source bdev.
+ * \param src_offset_blocks The offset, in source blocks, to copy from.
+ * \param dst_desc Destination block device descriptor. Must be open for writing.
+ * \param dst_ch I/O channel of the destination bdev.
+ * \param dst_offset_blocks The offset, in destination blocks, to copy to.
+ * \param num_blocks The number of source blocks to copy.
+ * \param opts Copy options. NULL selects the defaults.
+ * \param cb Called when the copy is complete.
+ * \param cb_arg Argument passed to cb.
+ *
+ * \return 0 on success. On success, the callback will always be called (even if
+ * the copy ultimately failed). Return negated errno on failure, in which case the
+ * callback will not be called.
+ *   * -EINVAL - offsets and/or num_blocks are out of range, the ranges overlap,
+ *               or the chunk size is not aligned to both block sizes
+ *   * -ENOMEM - the copy context cannot be allocated
+ *   * -EBADF - dst_desc not open for writing
+ */
+int spdk_bdev_copy_between(struct spdk_bdev_desc *src_desc, struct spdk_io_channel *src_ch,
+			   uint64_t src_offset_blocks,
+			   struct spdk_bdev_desc *dst_desc, struct spdk_io_channel *dst_ch,
+			   uint64_t dst_offset_blocks, uint64_t num_blocks,
+			   const struct spdk_bdev_copy_opts *opts,
+			   spdk_bdev_copy_between_cb cb, void *cb_arg);
+
 /**
  * Free an I/O request. This should only be called after the completion callback
  * for the I/O has been called and notifies the bdev layer that memory may now
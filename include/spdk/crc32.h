@@ -50,6 +50,19 @@ uint32_t spdk_crc32c_update(const void *buf, size_t len, uint32_t crc);
  */
 uint32_t spdk_crc32c_iov_update(struct iovec *iov, int iovcnt, uint32_t crc32c);
 
+/**
+ * Calculate partial CRC-32C checksums of multiple independent buffers.
+ *
+ * The result is the same as calling spdk_crc32c_update() on each of the buffers, but the
+ * checksums are calculated concurrently, which is faster when there are many small buffers.
+ *
+ * \param iovs Array of \c count data buffers to checksum.
+ * \param crcs Array of \c count CRC-32C values.  On input, the previous CRC-32C value of each
+ * buffer; on output, its updated CRC-32C value.
+ * \param count Number of buffers.
+ */
+void spdk_crc32c_update_batch(const struct iovec *iovs, uint32_t *crcs, uint32_t count);
+
 /**
  * Calculate a CRC-32C checksum, for NVMe Protection Information
  *
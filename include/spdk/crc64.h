@@ -28,6 +28,19 @@ extern "C" {
  */
 uint64_t spdk_crc64_nvme(const void *buf, size_t len, uint64_t crc);
 
+/**
+ * Calculate CRC-64 checksums (Rocksoft) of multiple independent buffers.
+ *
+ * The result is the same as calling spdk_crc64_nvme() on each of the buffers, but the checksums
+ * may be calculated concurrently, which is faster when there are many small buffers.
+ *
+ * \param iovs Array of \c count data buffers to checksum.
+ * \param crcs Array of \c count CRC-64 values.  On input, the previous CRC-64 value of each
+ * buffer; on output, its updated CRC-64 value.
+ * \param count Number of buffers.
+ */
+void spdk_crc64_nvme_batch(const struct iovec *iovs, uint64_t *crcs, uint32_t count);
+
 #ifdef __cplusplus
 }
 #endif
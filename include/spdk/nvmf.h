@@ -63,6 +63,20 @@ struct spdk_nvmf_target_opts {
 	uint32_t	discovery_filter;
 	uint32_t	dhchap_digests;
 	uint32_t	dhchap_dhgroups;
+	/* Place new qpairs on the least loaded poll group, based on the poll groups'
+	 * busy ratio, instead of round-robin */
+	bool		load_aware_placement;
+	/* Hole at bytes 289-291. */
+	uint8_t		reserved289[3];
+	/* Move I/O qpairs away from a poll group whose busy percentage stays higher than
+	 * the least busy poll group's by at least this many points. 0 disables migration. */
+	uint32_t	qpair_migration_threshold;
+	/* Number of threads computing DH-HMAC-CHAP challenges and responses, so that they don't
+	 * run on the poll group threads. 0 computes them on the poll group threads. */
+	uint32_t	auth_threads;
+	/* Maximum number of computations queued to those threads. Further ones are retried
+	 * once there is room in the queue. */
+	uint32_t	auth_queue_depth;
 };
 
 struct spdk_nvmf_transport_opts {
@@ -172,6 +186,17 @@ struct spdk_nvmf_poll_group_stat {
 	uint64_t pending_bdev_io;
 	/* NVMe IO commands completed (excludes admin commands) */
 	uint64_t completed_nvme_io;
+	/* DH-HMAC-CHAP challenges generated and cumulative ticks spent generating them */
+	uint64_t auth_challenges;
+	uint64_t auth_challenge_ticks;
+	/* DH-HMAC-CHAP replies verified and cumulative ticks spent verifying them */
+	uint64_t auth_replies;
+	uint64_t auth_reply_ticks;
+	/* DH-HMAC-CHAP transactions completed successfully and their cumulative duration in ticks */
+	uint64_t auth_completed;
+	uint64_t auth_ticks;
+	/* Number of times a computation had to wait for room in the authentication queue */
+	uint64_t auth_deferred;
 };
 
 /**
@@ -604,6 +629,31 @@ int spdk_nvmf_ns_remove_host(struct spdk_nvmf_subsystem *subsystem,
 			     const char *hostnqn,
 			     uint32_t flags);
 
+/**
+ * Limit the rate of the read and write commands the specified host sends to the specified
+ * namespace.
+ *
+ * The limits apply to all controllers of the host together, regardless of the poll groups
+ * their queue pairs are on. Commands exceeding the limits are queued until the rate allows
+ * them to be executed.
+ *
+ * May only be performed on subsystems in the PAUSED or INACTIVE states.
+ *
+ * \param subsystem Subsystem the namespace belong to.
+ * \param nsid Namespace ID.
+ * \param hostnqn The NQN for the host.
+ * \param rw_ios_per_sec Limit of read and write I/O per second, 0 for unlimited.
+ * \param rw_mbytes_per_sec Limit of read and write bandwidth in MiB per second, 0 for
+ * unlimited. The host's limits are removed if both are 0.
+ *
+ * \return 0 on success, or negated errno value on failure.
+ */
+int spdk_nvmf_ns_set_qos_limits(struct spdk_nvmf_subsystem *subsystem,
+				uint32_t nsid,
+				const char *hostnqn,
+				uint64_t rw_ios_per_sec,
+				uint64_t rw_mbytes_per_sec);
+
 /**
  * Allow the given host NQN to connect to the given subsystem.  Adding a host that's already allowed
  * results in an error.
@@ -1542,6 +1592,14 @@ struct spdk_nvmf_reservation_info {
 	struct spdk_nvmf_registrant_info	registrants[SPDK_NVMF_MAX_NUM_REGISTRANTS];
 };
 
+/**
+ * Function to be called once the namespace reservation information is persisted.
+ *
+ * \param cb_arg Callback argument.
+ * \param status 0 on success, negated errno on failure.
+ */
+typedef void (*spdk_nvmf_ns_reservation_update_cb)(void *cb_arg, int status);
+
 struct spdk_nvmf_ns_reservation_ops {
 	/* Checks if the namespace supports the Persist Through Power Loss capability. */
 	bool (*is_ptpl_capable)(const struct spdk_nvmf_ns *ns);
@@ -1555,6 +1613,14 @@ struct spdk_nvmf_ns_reservation_ops {
 	 * The new reservation information is returned via the info parameter.
 	 * Returns 0 on success, negated errno on failure. */
 	int (*load)(const struct spdk_nvmf_ns *ns, struct spdk_nvmf_reservation_info *info);
+
+	/* Optional asynchronous variant of update, called instead of it if set, so that the
+	 * subsystem thread isn't stalled while the information is persisted. The info
+	 * parameter is only valid during the call. cb_fn is called once the information is
+	 * persisted. Returns 0 on success, negated errno on failure, in which case cb_fn
+	 * isn't called. */
+	int (*update_async)(const struct spdk_nvmf_ns *ns, const struct spdk_nvmf_reservation_info *info,
+			    spdk_nvmf_ns_reservation_update_cb cb_fn, void *cb_arg);
 };
 
 /**
@@ -167,6 +167,11 @@ struct spdk_nvmf_qpair {
 
 	bool					connect_received;
 	bool					disconnect_started;
+	/* Set while the qpair is being moved to another poll group */
+	bool					migrating;
+	/* Set while the qpair is drained before moving it to another poll group. Transports
+	 * should stop taking new commands on it, except for data of commands in progress. */
+	bool					draining;
 
 	uint16_t				trace_id;
 
@@ -180,6 +185,13 @@ struct spdk_nvmf_qpair {
 		uint32_t			id_valid : 1;
 		int32_t				id : 31;
 	} numa;
+
+	/* Load of the qpair, sampled with the load of its poll group */
+	struct {
+		uint64_t			completed_nvme_io;
+		uint64_t			last_completed_nvme_io;
+		uint64_t			iops;
+	} load;
 };
 
 static inline int32_t
@@ -219,6 +231,24 @@ struct spdk_nvmf_poll_group {
 	/* Statistics */
 	struct spdk_nvmf_poll_group_stat		stat;
 
+	/* Load of the poll group, sampled periodically by load_poller on the
+	 * poll group's thread and read without locking by other threads. */
+	struct {
+		struct spdk_poller			*poller;
+		uint64_t				last_busy_tsc;
+		uint64_t				last_idle_tsc;
+		uint64_t				last_completed_nvme_io;
+		uint32_t				busy_pct;
+		uint64_t				iops;
+		/* Consecutive periods this poll group was overloaded */
+		uint32_t				imbalance_periods;
+		/* I/O qpair being drained to move it to migrate_to */
+		struct spdk_nvmf_qpair			*draining_qpair;
+		struct spdk_nvmf_poll_group		*migrate_to;
+		struct spdk_poller			*drain_poller;
+		uint64_t				drain_deadline_tsc;
+	} load;
+
 	spdk_nvmf_poll_group_destroy_done_fn		destroy_cb_fn;
 	void						*destroy_cb_arg;
 
@@ -399,6 +429,32 @@ struct spdk_nvmf_transport_ops {
 	int (*poll_group_remove)(struct spdk_nvmf_transport_poll_group *group,
 				 struct spdk_nvmf_qpair *qpair);
 
+	/**
+	 * Detach an established qpair from a poll group without tearing down its connection,
+	 * so that it can be attached to another poll group of the same transport with
+	 * poll_group_attach. Optional.
+	 *
+	 * Must return -EBUSY and leave the qpair untouched if it has any work in progress. While
+	 * spdk_nvmf_qpair::draining is set, the transport should stop taking new commands on the
+	 * qpair, so that its work in progress completes and it can be detached.
+	 */
+	int (*poll_group_detach)(struct spdk_nvmf_transport_poll_group *group,
+				 struct spdk_nvmf_qpair *qpair);
+
+	/**
+	 * Check whether a qpair can be detached from a poll group once it's idle, i.e. whether
+	 * it's worth draining it. Optional, all qpairs can be detached if not implemented.
+	 */
+	bool (*poll_group_can_detach)(struct spdk_nvmf_transport_poll_group *group,
+				      struct spdk_nvmf_qpair *qpair);
+
+	/**
+	 * Attach a qpair detached by poll_group_detach to a poll group. Called on the thread
+	 * of the new poll group.
+	 */
+	int (*poll_group_attach)(struct spdk_nvmf_transport_poll_group *group,
+				 struct spdk_nvmf_qpair *qpair);
+
 	/**
 	 * Poll the group to process I/O
 	 */
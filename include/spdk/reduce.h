@@ -70,9 +70,24 @@ struct spdk_reduce_vol_params {
 	 * specified by the user
 	 */
 	uint8_t                 comp_algo;
-	uint8_t                 reserved[3];
+
+	/**
+	 * Volume flags, a bitmask of SPDK_REDUCE_VOL_FLAG_* values.
+	 */
+	uint8_t                 flags;
+	uint8_t                 reserved[2];
 };
 
+/**
+ * Adaptive compression.  The compression ratio of written chunks is sampled and
+ *  once a number of consecutive chunks didn't compress, following chunks are
+ *  stored uncompressed without issuing the compress operation, except for
+ *  periodic samples.  The backing device may also compress each chunk with a
+ *  different algorithm, which is recorded in the chunk map (see
+ *  spdk_reduce_vol_cb_args::comp_algo).
+ */
+#define SPDK_REDUCE_VOL_FLAG_ADAPTIVE	(1u << 0)
+
 struct spdk_reduce_vol;
 
 typedef void (*spdk_reduce_vol_op_complete)(void *ctx, int reduce_errno);
@@ -98,6 +113,14 @@ struct spdk_reduce_vol_cb_args {
 	uint32_t		output_size;
 	spdk_reduce_dev_cpl	cb_fn;
 	void			*cb_arg;
+
+	/**
+	 * Compression algorithm.  For decompress operations, this is the algorithm
+	 *  the chunk was compressed with.  For compress operations, it's set to the
+	 *  algorithm of the volume and the backing device may change it to the
+	 *  algorithm it actually used, which is then recorded for the chunk.
+	 */
+	uint8_t			comp_algo;
 };
 
 enum spdk_reduce_backing_io_type {
@@ -99,6 +99,8 @@ struct nvme_tcp_pdu {
 
 	bool						has_hdgst;
 	bool						ddgst_enable;
+	/* Data digest is accumulated in data_digest_crc32 as the payload is received */
+	bool						ddgst_inline;
 	uint32_t					data_digest_crc32;
 	uint8_t						data_digest[SPDK_NVME_TCP_DIGEST_LEN];
 
@@ -202,20 +204,10 @@ nvme_tcp_pdu_calc_header_digest(struct nvme_tcp_pdu *pdu)
 }
 
 static uint32_t
-nvme_tcp_pdu_calc_data_digest(struct nvme_tcp_pdu *pdu)
+nvme_tcp_pdu_pad_data_digest(struct nvme_tcp_pdu *pdu, uint32_t crc32c)
 {
-	uint32_t crc32c = SPDK_CRC32C_XOR;
 	uint32_t mod;
 
-	assert(pdu->data_len != 0);
-
-	if (spdk_likely(!pdu->dif_ctx)) {
-		crc32c = spdk_crc32c_iov_update(pdu->data_iov, pdu->data_iovcnt, crc32c);
-	} else {
-		spdk_dif_update_crc32c_stream(pdu->data_iov, pdu->data_iovcnt,
-					      0, pdu->data_len, &crc32c, pdu->dif_ctx);
-	}
-
 	mod = pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT;
 	if (mod != 0) {
 		uint32_t pad_length = SPDK_NVME_TCP_DIGEST_ALIGNMENT - mod;
@@ -228,6 +220,23 @@ nvme_tcp_pdu_calc_data_digest(struct nvme_tcp_pdu *pdu)
 	return crc32c;
 }
 
+static uint32_t
+nvme_tcp_pdu_calc_data_digest(struct nvme_tcp_pdu *pdu)
+{
+	uint32_t crc32c = SPDK_CRC32C_XOR;
+
+	assert(pdu->data_len != 0);
+
+	if (spdk_likely(!pdu->dif_ctx)) {
+		crc32c = spdk_crc32c_iov_update(pdu->data_iov, pdu->data_iovcnt, crc32c);
+	} else {
+		spdk_dif_update_crc32c_stream(pdu->data_iov, pdu->data_iovcnt,
+					      0, pdu->data_len, &crc32c, pdu->dif_ctx);
+	}
+
+	return nvme_tcp_pdu_pad_data_digest(pdu, crc32c);
+}
+
 static inline void
 _nvme_tcp_sgl_get_buf(struct spdk_iov_sgl *s, void **_buf, uint32_t *_buf_len)
 {
@@ -239,6 +248,40 @@ _nvme_tcp_sgl_get_buf(struct spdk_iov_sgl *s, void **_buf, uint32_t *_buf_len)
 	}
 }
 
+/*
+ * Accumulate the data digest of a PDU that is being received, while the data that has just
+ * been read from the socket is still hot in the cache. offset and len describe the bytes
+ * returned by the last payload read, which may also cover the data digest itself.
+ */
+static inline void
+nvme_tcp_pdu_update_data_digest(struct nvme_tcp_pdu *pdu, uint32_t offset, uint32_t len)
+{
+	struct spdk_iov_sgl sgl;
+	uint32_t buf_len;
+	void *buf;
+
+	assert(pdu->ddgst_inline);
+
+	if (offset >= pdu->data_len) {
+		return;
+	}
+
+	len = spdk_min(len, pdu->data_len - offset);
+
+	spdk_iov_sgl_init(&sgl, pdu->data_iov, pdu->data_iovcnt, 0);
+	spdk_iov_sgl_advance(&sgl, offset);
+
+	while (len > 0) {
+		_nvme_tcp_sgl_get_buf(&sgl, &buf, &buf_len);
+		buf_len = spdk_min(buf_len, len);
+
+		pdu->data_digest_crc32 = spdk_crc32c_update(buf, buf_len, pdu->data_digest_crc32);
+
+		spdk_iov_sgl_advance(&sgl, buf_len);
+		len -= buf_len;
+	}
+}
+
 static inline bool
 _nvme_tcp_sgl_append_multi(struct spdk_iov_sgl *s, struct iovec *iov, int iovcnt)
 {
@@ -38,10 +38,17 @@
 
 #define ACCEL_CRYPTO_TWEAK_MODE_DEFAULT	SPDK_ACCEL_CRYPTO_TWEAK_MODE_SIMPLE_LBA
 #define ACCEL_TASKS_IN_SEQUENCE_LIMIT	8
+#define ACCEL_TASK_MODULE_IDX_NONE	UINT8_MAX
 
 struct accel_module {
 	struct spdk_accel_module_if	*module;
 	bool				supports_memory_domains;
+	/*
+	 * Modules the opcode is spread across, in order of preference, with `module` being the
+	 * first one.  Empty if the opcode is only assigned to `module`.
+	 */
+	uint32_t			num_modules;
+	struct spdk_accel_module_if	*modules[SPDK_ACCEL_OPC_MAX_MODULES];
 };
 
 /* Largest context size for all accel modules */
@@ -64,6 +71,8 @@ static struct spdk_spinlock g_keyring_spin;
 /* Global array mapping capabilities to modules */
 static struct accel_module g_modules_opc[SPDK_ACCEL_OPC_LAST] = {};
 static char *g_modules_opc_override[SPDK_ACCEL_OPC_LAST] = {};
+/* Names of the modules an opcode is spread across, following g_modules_opc_override */
+static char *g_modules_opc_spread[SPDK_ACCEL_OPC_LAST][SPDK_ACCEL_OPC_MAX_MODULES - 1] = {};
 TAILQ_HEAD(, spdk_accel_driver) g_accel_drivers = TAILQ_HEAD_INITIALIZER(g_accel_drivers);
 static struct spdk_accel_driver *g_accel_driver;
 static struct spdk_accel_opts g_opts = {
@@ -80,7 +89,7 @@ static const char *g_opcode_strings[SPDK_ACCEL_OPC_LAST] = {
 	"copy", "fill", "dualcast", "compare", "crc32c", "copy_crc32c",
 	"compress", "decompress", "encrypt", "decrypt", "xor",
 	"dif_verify", "dif_verify_copy", "dif_generate", "dif_generate_copy",
-	"dix_generate", "dix_verify"
+	"dix_generate", "dix_verify", "check_zero"
 };
 
 enum accel_sequence_state {
@@ -141,8 +150,25 @@ struct accel_buffer {
 	struct accel_io_channel		*ch;
 };
 
+struct accel_dispatch_module {
+	struct spdk_io_channel			*ch;
+	uint32_t				outstanding;
+	/*
+	 * Moving average of the ticks between two completions while the module is busy, i.e.
+	 * the inverse of its throughput.
+	 */
+	uint64_t				task_ticks;
+	uint64_t				last_tsc;
+};
+
+/* Per-channel state of an opcode spread across modules */
+struct accel_dispatch {
+	struct accel_dispatch_module		modules[SPDK_ACCEL_OPC_MAX_MODULES];
+};
+
 struct accel_io_channel {
 	struct spdk_io_channel			*module_ch[SPDK_ACCEL_OPC_LAST];
+	struct accel_dispatch			*dispatch[SPDK_ACCEL_OPC_LAST];
 	struct spdk_io_channel			*driver_channel;
 	void					*task_pool_base;
 	struct spdk_accel_sequence		*seq_pool_base;
@@ -249,9 +275,11 @@ spdk_accel_get_opcode_name(enum spdk_accel_opcode opcode)
 }
 
 int
-spdk_accel_assign_opc(enum spdk_accel_opcode opcode, const char *name)
+spdk_accel_assign_opc_modules(enum spdk_accel_opcode opcode, const char **names,
+			      size_t num_names)
 {
-	char *copy;
+	char *copy[SPDK_ACCEL_OPC_MAX_MODULES] = {};
+	size_t i;
 
 	if (g_modules_started == true) {
 		/* we don't allow re-assignment once things have started */
@@ -263,18 +291,37 @@ spdk_accel_assign_opc(enum spdk_accel_opcode opcode, const char *name)
 		return -EINVAL;
 	}
 
-	copy = strdup(name);
-	if (copy == NULL) {
-		return -ENOMEM;
+	if (num_names == 0 || num_names > SPDK_ACCEL_OPC_MAX_MODULES) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < num_names; i++) {
+		copy[i] = strdup(names[i]);
+		if (copy[i] == NULL) {
+			while (i > 0) {
+				free(copy[--i]);
+			}
+			return -ENOMEM;
+		}
 	}
 
 	/* module selection will be validated after the framework starts. */
 	free(g_modules_opc_override[opcode]);
-	g_modules_opc_override[opcode] = copy;
+	g_modules_opc_override[opcode] = copy[0];
+	for (i = 0; i < SPDK_ACCEL_OPC_MAX_MODULES - 1; i++) {
+		free(g_modules_opc_spread[opcode][i]);
+		g_modules_opc_spread[opcode][i] = copy[i + 1];
+	}
 
 	return 0;
 }
 
+int
+spdk_accel_assign_opc(enum spdk_accel_opcode opcode, const char *name)
+{
+	return spdk_accel_assign_opc_modules(opcode, &name, 1);
+}
+
 inline static struct spdk_accel_task *
 _get_task(struct accel_io_channel *accel_ch, spdk_accel_completion_cb cb_fn, void *cb_arg)
 {
@@ -293,8 +340,10 @@ _get_task(struct accel_io_channel *accel_ch, spdk_accel_completion_cb cb_fn, voi
 	accel_task->cb_fn = cb_fn;
 	accel_task->cb_arg = cb_arg;
 	accel_task->accel_ch = accel_ch;
+	accel_task->module_idx = ACCEL_TASK_MODULE_IDX_NONE;
 	accel_task->s.iovs = NULL;
 	accel_task->d.iovs = NULL;
+	accel_task->fused_crc32c = NULL;
 
 	return accel_task;
 }
@@ -306,6 +355,84 @@ _put_task(struct accel_io_channel *ch, struct spdk_accel_task *task)
 	accel_update_stats(ch, task_outstanding, -1);
 }
 
+/* Estimated number of ticks until a task submitted now would be completed by the module */
+static inline uint64_t
+accel_dispatch_cost(struct accel_dispatch_module *module)
+{
+	return (module->outstanding + 1) * module->task_ticks;
+}
+
+static int
+accel_dispatch_task(struct accel_io_channel *accel_ch, struct spdk_accel_task *task)
+{
+	enum spdk_accel_opcode opcode = task->op_code;
+	struct accel_module *opc_module = &g_modules_opc[opcode];
+	struct accel_dispatch *dispatch = accel_ch->dispatch[opcode];
+	struct accel_dispatch_module *module;
+	uint64_t cost, min_cost = UINT64_MAX;
+	uint32_t i, idx, best = 0;
+	int rc = -ENOMEM;
+
+	for (i = 0; i < opc_module->num_modules; i++) {
+		cost = accel_dispatch_cost(&dispatch->modules[i]);
+		if (cost < min_cost) {
+			min_cost = cost;
+			best = i;
+		}
+	}
+
+	/* Try the best module first and then the remaining ones in order of preference */
+	for (i = 0; i <= opc_module->num_modules; i++) {
+		idx = i == 0 ? best : i - 1;
+		if (i > 0 && idx == best) {
+			continue;
+		}
+
+		module = &dispatch->modules[idx];
+		if (module->outstanding++ == 0) {
+			module->last_tsc = spdk_get_ticks();
+		}
+
+		task->module_idx = idx;
+		rc = opc_module->modules[idx]->submit_tasks(module->ch, task);
+		if (spdk_likely(rc == 0)) {
+			/* The task might have already been completed, so it mustn't be touched here */
+			if (spdk_unlikely(i > 0)) {
+				accel_update_stats(accel_ch, operations[opcode].modules[idx].spilled, 1);
+			}
+			return 0;
+		}
+
+		module->outstanding--;
+		if (rc != -ENOMEM) {
+			break;
+		}
+	}
+
+	task->module_idx = ACCEL_TASK_MODULE_IDX_NONE;
+
+	return rc;
+}
+
+static void
+accel_dispatch_complete(struct accel_io_channel *accel_ch, struct spdk_accel_task *task)
+{
+	struct accel_dispatch_module *module;
+	uint64_t now, ticks;
+
+	module = &accel_ch->dispatch[task->op_code]->modules[task->module_idx];
+	assert(module->outstanding > 0);
+
+	now = spdk_get_ticks();
+	ticks = now - module->last_tsc;
+	module->task_ticks = module->task_ticks == 0 ? ticks : (module->task_ticks * 7 + ticks) / 8;
+	module->last_tsc = now;
+	module->outstanding--;
+
+	accel_update_task_stats(accel_ch, task, modules[task->module_idx].executed, 1);
+	task->module_idx = ACCEL_TASK_MODULE_IDX_NONE;
+}
+
 void
 spdk_accel_task_complete(struct spdk_accel_task *accel_task, int status)
 {
@@ -318,8 +445,17 @@ spdk_accel_task_complete(struct spdk_accel_task *accel_task, int status)
 	if (spdk_unlikely(status != 0)) {
 		accel_update_task_stats(accel_ch, accel_task, failed, 1);
 	}
+	if (spdk_unlikely(accel_ch->dispatch[accel_task->op_code] != NULL &&
+			  accel_task->module_idx != ACCEL_TASK_MODULE_IDX_NONE)) {
+		accel_dispatch_complete(accel_ch, accel_task);
+	}
 
 	if (accel_task->seq) {
+		if (spdk_unlikely(accel_task->fused_crc32c != NULL)) {
+			accel_update_task_stats(accel_ch, accel_task->fused_crc32c, executed, 1);
+			accel_update_task_stats(accel_ch, accel_task->fused_crc32c, num_bytes,
+						accel_task->fused_crc32c->nbytes);
+		}
 		accel_sequence_task_cb(accel_task->seq, accel_task, status);
 		return;
 	}
@@ -349,7 +485,11 @@ accel_submit_task(struct accel_io_channel *accel_ch, struct spdk_accel_task *tas
 	struct spdk_accel_module_if *module = g_modules_opc[task->op_code].module;
 	int rc;
 
-	rc = module->submit_tasks(module_ch, task);
+	if (spdk_unlikely(accel_ch->dispatch[task->op_code] != NULL)) {
+		rc = accel_dispatch_task(accel_ch, task);
+	} else {
+		rc = module->submit_tasks(module_ch, task);
+	}
 	if (spdk_unlikely(rc != 0)) {
 		accel_update_task_stats(accel_ch, task, failed, 1);
 	}
@@ -488,6 +628,34 @@ spdk_accel_submit_compare(struct spdk_io_channel *ch, void *src1,
 	return accel_submit_task(accel_ch, accel_task);
 }
 
+/* Accel framework public API for check zero function */
+int
+spdk_accel_submit_check_zero(struct spdk_io_channel *ch, struct iovec *iovs, uint32_t iovcnt,
+			     bool *is_zero, spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *accel_task;
+
+	if (spdk_unlikely(iovs == NULL || iovcnt == 0)) {
+		return -EINVAL;
+	}
+
+	accel_task = _get_task(accel_ch, cb_fn, cb_arg);
+	if (spdk_unlikely(accel_task == NULL)) {
+		return -ENOMEM;
+	}
+
+	accel_task->s.iovs = iovs;
+	accel_task->s.iovcnt = iovcnt;
+	accel_task->nbytes = accel_get_iovlen(iovs, iovcnt);
+	accel_task->is_zero = is_zero;
+	accel_task->op_code = SPDK_ACCEL_OPC_CHECK_ZERO;
+	accel_task->src_domain = NULL;
+	accel_task->dst_domain = NULL;
+
+	return accel_submit_task(accel_ch, accel_task);
+}
+
 /* Accel framework public API for fill function */
 int
 spdk_accel_submit_fill(struct spdk_io_channel *ch, void *dst,
@@ -1801,6 +1969,7 @@ static void
 accel_sequence_complete_task(struct spdk_accel_sequence *seq, struct spdk_accel_task *task)
 {
 	struct accel_io_channel *ch = seq->ch;
+	struct spdk_accel_task *fused = task->fused_crc32c;
 	spdk_accel_step_cb cb_fn;
 	void *cb_arg;
 
@@ -1808,6 +1977,7 @@ accel_sequence_complete_task(struct spdk_accel_sequence *seq, struct spdk_accel_
 	cb_fn = task->step_cb_fn;
 	cb_arg = task->cb_arg;
 	task->seq = NULL;
+	task->fused_crc32c = NULL;
 	if (task->has_aux) {
 		SLIST_INSERT_HEAD(&ch->task_aux_data_pool, task->aux, link);
 		task->aux = NULL;
@@ -1819,6 +1989,12 @@ accel_sequence_complete_task(struct spdk_accel_sequence *seq, struct spdk_accel_
 	if (cb_fn != NULL) {
 		cb_fn(cb_arg);
 	}
+
+	if (spdk_unlikely(fused != NULL)) {
+		/* The fused task was taken off the task list, put it back to complete it */
+		TAILQ_INSERT_HEAD(&seq->tasks, fused, seq_link);
+		accel_sequence_complete_task(seq, fused);
+	}
 }
 
 static void
@@ -2549,6 +2725,72 @@ accel_sequence_merge_tasks(struct spdk_accel_sequence *seq, struct spdk_accel_ta
 	}
 }
 
+static void
+accel_sequence_fuse_tasks(struct spdk_accel_sequence *seq, struct spdk_accel_task *task,
+			  struct spdk_accel_task **next_task)
+{
+	struct spdk_accel_task *next = *next_task;
+	struct accel_module *module = &g_modules_opc[task->op_code];
+	struct spdk_accel_module_if *module_if = module->module;
+
+	switch (task->op_code) {
+	case SPDK_ACCEL_OPC_COPY:
+	case SPDK_ACCEL_OPC_ENCRYPT:
+	case SPDK_ACCEL_OPC_DECRYPT:
+	case SPDK_ACCEL_OPC_DECOMPRESS:
+		break;
+	default:
+		return;
+	}
+	if (next->op_code != SPDK_ACCEL_OPC_CRC32C) {
+		return;
+	}
+	/* Both operations need to be executed by the same module */
+	if (module_if != g_modules_opc[SPDK_ACCEL_OPC_CRC32C].module ||
+	    module->num_modules > 0 || g_modules_opc[SPDK_ACCEL_OPC_CRC32C].num_modules > 0) {
+		return;
+	}
+	if (task->dst_domain != next->src_domain) {
+		return;
+	}
+	if (!accel_compare_iovs(task->d.iovs, task->d.iovcnt, next->s.iovs, next->s.iovcnt)) {
+		return;
+	}
+
+	switch (task->op_code) {
+	case SPDK_ACCEL_OPC_COPY:
+		if (g_modules_opc[SPDK_ACCEL_OPC_COPY_CRC32C].module != module_if ||
+		    g_modules_opc[SPDK_ACCEL_OPC_COPY_CRC32C].num_modules > 0) {
+			return;
+		}
+		/* The data is the same on both sides of a copy, so calculate the crc on the fly */
+		task->op_code = SPDK_ACCEL_OPC_COPY_CRC32C;
+		task->crc_dst = next->crc_dst;
+		task->seed = next->seed;
+		*next_task = TAILQ_NEXT(next, seq_link);
+		accel_sequence_complete_task(seq, next);
+		break;
+	case SPDK_ACCEL_OPC_ENCRYPT:
+	case SPDK_ACCEL_OPC_DECRYPT:
+	case SPDK_ACCEL_OPC_DECOMPRESS:
+		if (module_if->supports_fused_crc32c == NULL ||
+		    !module_if->supports_fused_crc32c(task->op_code)) {
+			return;
+		}
+		/* The module can only calculate the crc of a local buffer */
+		if (task->dst_domain != NULL && module->supports_memory_domains) {
+			return;
+		}
+		TAILQ_REMOVE(&seq->tasks, next, seq_link);
+		task->fused_crc32c = next;
+		*next_task = TAILQ_NEXT(task, seq_link);
+		break;
+	default:
+		assert(0 && "bad opcode");
+		break;
+	}
+}
+
 void
 spdk_accel_sequence_finish(struct spdk_accel_sequence *seq,
 			   spdk_accel_completion_cb cb_fn, void *cb_arg)
@@ -2563,6 +2805,17 @@ spdk_accel_sequence_finish(struct spdk_accel_sequence *seq,
 		accel_sequence_merge_tasks(seq, task, &next);
 	}
 
+	/* Fuse crc32c operations into the operations producing their data, unless a driver is
+	 * used, as it executes the sequence on its own */
+	if (g_accel_driver == NULL) {
+		TAILQ_FOREACH_SAFE(task, &seq->tasks, seq_link, next) {
+			if (next == NULL) {
+				break;
+			}
+			accel_sequence_fuse_tasks(seq, task, &next);
+		}
+	}
+
 	seq->cb_fn = cb_fn;
 	seq->cb_arg = cb_arg;
 
@@ -2971,6 +3224,62 @@ spdk_accel_module_list_add(struct spdk_accel_module_if *accel_module)
 	}
 }
 
+static void
+accel_put_dispatch_channels(struct accel_io_channel *accel_ch)
+{
+	struct accel_dispatch *dispatch;
+	enum spdk_accel_opcode op;
+	uint32_t i;
+
+	for (op = 0; op < SPDK_ACCEL_OPC_LAST; op++) {
+		dispatch = accel_ch->dispatch[op];
+		if (dispatch == NULL) {
+			continue;
+		}
+		/* The first module's channel is module_ch[op] */
+		for (i = 1; i < g_modules_opc[op].num_modules; i++) {
+			if (dispatch->modules[i].ch != NULL) {
+				spdk_put_io_channel(dispatch->modules[i].ch);
+			}
+		}
+		free(dispatch);
+		accel_ch->dispatch[op] = NULL;
+	}
+}
+
+static int
+accel_get_dispatch_channels(struct accel_io_channel *accel_ch)
+{
+	struct accel_dispatch *dispatch;
+	struct accel_module *module;
+	enum spdk_accel_opcode op;
+	uint32_t i;
+
+	for (op = 0; op < SPDK_ACCEL_OPC_LAST; op++) {
+		module = &g_modules_opc[op];
+		if (module->num_modules == 0) {
+			continue;
+		}
+
+		dispatch = calloc(1, sizeof(*dispatch));
+		if (dispatch == NULL) {
+			return -ENOMEM;
+		}
+
+		accel_ch->dispatch[op] = dispatch;
+		dispatch->modules[0].ch = accel_ch->module_ch[op];
+		for (i = 1; i < module->num_modules; i++) {
+			dispatch->modules[i].ch = module->modules[i]->get_io_channel();
+			if (dispatch->modules[i].ch == NULL) {
+				SPDK_ERRLOG("Module %s failed to get io channel\n", module->modules[i]->name);
+				return -ENOMEM;
+			}
+		}
+	}
+
+	return 0;
+}
+
 /* Framework level channel create callback. */
 static int
 accel_create_channel(void *io_device, void *ctx_buf)
@@ -3043,6 +3352,10 @@ accel_create_channel(void *io_device, void *ctx_buf)
 		}
 	}
 
+	if (accel_get_dispatch_channels(accel_ch) != 0) {
+		goto err;
+	}
+
 	if (g_accel_driver != NULL) {
 		accel_ch->driver_channel = g_accel_driver->get_io_channel();
 		if (accel_ch->driver_channel == NULL) {
@@ -3063,6 +3376,7 @@ err:
 	if (accel_ch->driver_channel != NULL) {
 		spdk_put_io_channel(accel_ch->driver_channel);
 	}
+	accel_put_dispatch_channels(accel_ch);
 	for (j = 0; j < i; j++) {
 		spdk_put_io_channel(accel_ch->module_ch[j]);
 	}
@@ -3077,7 +3391,7 @@ err:
 static void
 accel_add_stats(struct accel_stats *total, struct accel_stats *stats)
 {
-	int i;
+	int i, j;
 
 	total->sequence_executed += stats->sequence_executed;
 	total->sequence_failed += stats->sequence_failed;
@@ -3091,6 +3405,10 @@ accel_add_stats(struct accel_stats *total, struct accel_stats *stats)
 		total->operations[i].executed += stats->operations[i].executed;
 		total->operations[i].failed += stats->operations[i].failed;
 		total->operations[i].num_bytes += stats->operations[i].num_bytes;
+		for (j = 0; j < SPDK_ACCEL_OPC_MAX_MODULES; ++j) {
+			total->operations[i].modules[j].executed += stats->operations[i].modules[j].executed;
+			total->operations[i].modules[j].spilled += stats->operations[i].modules[j].spilled;
+		}
 	}
 }
 
@@ -3107,6 +3425,7 @@ accel_destroy_channel(void *io_device, void *ctx_buf)
 		spdk_put_io_channel(accel_ch->driver_channel);
 	}
 
+	accel_put_dispatch_channels(accel_ch);
 	for (i = 0; i < SPDK_ACCEL_OPC_LAST; i++) {
 		assert(accel_ch->module_ch[i] != NULL);
 		spdk_put_io_channel(accel_ch->module_ch[i]);
@@ -3161,11 +3480,52 @@ accel_module_init_opcode(enum spdk_accel_opcode opcode)
 	struct accel_module *module = &g_modules_opc[opcode];
 	struct spdk_accel_module_if *module_if = module->module;
 
-	if (module_if->get_memory_domains != NULL) {
+	/* Opcodes spread across modules always use buffers local to the system domain, as tasks
+	 * can be dispatched to any of the modules */
+	if (module_if->get_memory_domains != NULL && module->num_modules == 0) {
 		module->supports_memory_domains = module_if->get_memory_domains(NULL, 0) > 0;
 	}
 }
 
+static int
+accel_module_init_spread(enum spdk_accel_opcode opcode)
+{
+	struct accel_module *module = &g_modules_opc[opcode];
+	struct spdk_accel_module_if *module_if;
+	uint32_t i;
+
+	switch (opcode) {
+	case SPDK_ACCEL_OPC_ENCRYPT:
+	case SPDK_ACCEL_OPC_DECRYPT:
+	case SPDK_ACCEL_OPC_COMPRESS:
+	case SPDK_ACCEL_OPC_DECOMPRESS:
+		SPDK_ERRLOG("Operation %s cannot be spread across modules\n", g_opcode_strings[opcode]);
+		return -EINVAL;
+	default:
+		break;
+	}
+
+	module->modules[0] = module->module;
+	module->num_modules = 1;
+	for (i = 0; i < SPDK_COUNTOF(g_modules_opc_spread[opcode]); i++) {
+		if (g_modules_opc_spread[opcode][i] == NULL) {
+			break;
+		}
+		module_if = _module_find_by_name(g_modules_opc_spread[opcode][i]);
+		if (module_if == NULL) {
+			SPDK_ERRLOG("Invalid module name of %s\n", g_modules_opc_spread[opcode][i]);
+			return -EINVAL;
+		}
+		if (module_if->supports_opcode(opcode) == false) {
+			SPDK_ERRLOG("Module %s does not support op code %d\n", module_if->name, opcode);
+			return -EINVAL;
+		}
+		module->modules[module->num_modules++] = module_if;
+	}
+
+	return 0;
+}
+
 static int
 accel_memory_domain_translate(struct spdk_memory_domain *src_domain, void *src_domain_ctx,
 			      struct spdk_memory_domain *dst_domain, struct spdk_memory_domain_translation_ctx *dst_domain_ctx,
@@ -3287,6 +3647,12 @@ spdk_accel_initialize(void)
 			}
 			g_modules_opc[op].module = accel_module;
 		}
+		if (g_modules_opc_spread[op][0] != NULL) {
+			rc = accel_module_init_spread(op);
+			if (rc != 0) {
+				return rc;
+			}
+		}
 	}
 
 	if (g_modules_opc[SPDK_ACCEL_OPC_ENCRYPT].module != g_modules_opc[SPDK_ACCEL_OPC_DECRYPT].module) {
@@ -3324,14 +3690,25 @@ accel_module_finish_cb(void)
 }
 
 static void
-accel_write_overridden_opc(struct spdk_json_write_ctx *w, const char *opc_str,
-			   const char *module_str)
+accel_write_overridden_opc(struct spdk_json_write_ctx *w, enum spdk_accel_opcode opcode)
 {
+	uint32_t i;
+
 	spdk_json_write_object_begin(w);
 	spdk_json_write_named_string(w, "method", "accel_assign_opc");
 	spdk_json_write_named_object_begin(w, "params");
-	spdk_json_write_named_string(w, "opname", opc_str);
-	spdk_json_write_named_string(w, "module", module_str);
+	spdk_json_write_named_string(w, "opname", g_opcode_strings[opcode]);
+	spdk_json_write_named_string(w, "module", g_modules_opc_override[opcode]);
+	if (g_modules_opc_spread[opcode][0] != NULL) {
+		spdk_json_write_named_array_begin(w, "spread_modules");
+		for (i = 0; i < SPDK_COUNTOF(g_modules_opc_spread[opcode]); i++) {
+			if (g_modules_opc_spread[opcode][i] == NULL) {
+				break;
+			}
+			spdk_json_write_string(w, g_modules_opc_spread[opcode][i]);
+		}
+		spdk_json_write_array_end(w);
+	}
 	spdk_json_write_object_end(w);
 	spdk_json_write_object_end(w);
 }
@@ -3433,7 +3810,7 @@ spdk_accel_write_config_json(struct spdk_json_write_ctx *w)
 	}
 	for (i = 0; i < SPDK_ACCEL_OPC_LAST; i++) {
 		if (g_modules_opc_override[i]) {
-			accel_write_overridden_opc(w, g_opcode_strings[i], g_modules_opc_override[i]);
+			accel_write_overridden_opc(w, i);
 		}
 	}
 
@@ -3478,6 +3855,7 @@ accel_io_device_unregister_cb(void *io_device)
 {
 	struct spdk_accel_crypto_key *key, *key_tmp;
 	enum spdk_accel_opcode op;
+	uint32_t i;
 
 	spdk_spin_lock(&g_keyring_spin);
 	TAILQ_FOREACH_SAFE(key, &g_keyring, link, key_tmp) {
@@ -3490,7 +3868,12 @@ accel_io_device_unregister_cb(void *io_device)
 			free(g_modules_opc_override[op]);
 			g_modules_opc_override[op] = NULL;
 		}
+		for (i = 0; i < SPDK_COUNTOF(g_modules_opc_spread[op]); i++) {
+			free(g_modules_opc_spread[op][i]);
+			g_modules_opc_spread[op][i] = NULL;
+		}
 		g_modules_opc[op].module = NULL;
+		g_modules_opc[op].num_modules = 0;
 	}
 
 	spdk_accel_module_finish();
@@ -3706,7 +4089,8 @@ spdk_accel_get_buf_align(enum spdk_accel_opcode opcode,
 			 const struct spdk_accel_operation_exec_ctx *ctx)
 {
 	struct spdk_accel_module_if *module = g_modules_opc[opcode].module;
-	struct spdk_accel_opcode_info modinfo = {}, drvinfo = {};
+	struct spdk_accel_opcode_info modinfo = {}, drvinfo = {}, spreadinfo;
+	uint32_t i;
 
 	if (g_accel_driver != NULL && g_accel_driver->get_operation_info != NULL) {
 		g_accel_driver->get_operation_info(opcode, ctx, &drvinfo);
@@ -3716,6 +4100,17 @@ spdk_accel_get_buf_align(enum spdk_accel_opcode opcode,
 		module->get_operation_info(opcode, ctx, &modinfo);
 	}
 
+	/* Tasks can be dispatched to any module the opcode is spread across */
+	for (i = 1; i < g_modules_opc[opcode].num_modules; i++) {
+		module = g_modules_opc[opcode].modules[i];
+		if (module->get_operation_info != NULL) {
+			spreadinfo = (struct spdk_accel_opcode_info) {};
+			module->get_operation_info(opcode, ctx, &spreadinfo);
+			modinfo.required_alignment = spdk_max(modinfo.required_alignment,
+							      spreadinfo.required_alignment);
+		}
+	}
+
 	/* If a driver is set, it'll execute most of the operations, while the rest will usually
 	 * fall back to accel_sw, which doesn't have any alignment requirements.  However, to be
 	 * extra safe, return the max(driver, module) if a driver delegates some operations to a
@@ -3723,6 +4118,19 @@ spdk_accel_get_buf_align(enum spdk_accel_opcode opcode,
 	return spdk_max(modinfo.required_alignment, drvinfo.required_alignment);
 }
 
+uint32_t
+accel_get_opc_modules(enum spdk_accel_opcode opcode, const char **names)
+{
+	struct accel_module *module = &g_modules_opc[opcode];
+	uint32_t i;
+
+	for (i = 0; i < module->num_modules; i++) {
+		names[i] = module->modules[i]->name;
+	}
+
+	return module->num_modules;
+}
+
 struct spdk_accel_module_if *
 spdk_accel_get_module(const char *name)
 {
@@ -3744,6 +4152,10 @@ spdk_accel_get_opc_memory_domains(enum spdk_accel_opcode opcode,
 {
 	assert(opcode < SPDK_ACCEL_OPC_LAST);
 
+	if (g_modules_opc[opcode].num_modules > 0) {
+		return 0;
+	}
+
 	if (g_modules_opc[opcode].module->get_memory_domains) {
 		return g_modules_opc[opcode].module->get_memory_domains(domains, array_size);
 	}
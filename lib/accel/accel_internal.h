@@ -26,6 +26,12 @@ struct accel_operation_stats {
 	uint64_t executed;
 	uint64_t failed;
 	uint64_t num_bytes;
+	/* Split of the executed operations, if the opcode is spread across modules */
+	struct {
+		uint64_t executed;
+		/* Operations that spilled over from a module that ran out of resources */
+		uint64_t spilled;
+	} modules[SPDK_ACCEL_OPC_MAX_MODULES];
 };
 
 struct accel_stats {
@@ -49,5 +55,31 @@ void _accel_crypto_key_dump_param(struct spdk_json_write_ctx *w, struct spdk_acc
 void _accel_crypto_keys_dump_param(struct spdk_json_write_ctx *w);
 typedef void (*accel_get_stats_cb)(struct accel_stats *stats, void *cb_arg);
 int accel_get_stats(accel_get_stats_cb cb_fn, void *cb_arg);
+uint32_t accel_get_opc_modules(enum spdk_accel_opcode opcode, const char **names);
+
+/* Execution context of the software module, allowing its operations to be executed outside of
+ * an SPDK thread */
+struct spdk_accel_task;
+struct sw_accel_io_channel;
+struct sw_accel_io_channel *accel_sw_exec_ctx_create(void);
+void accel_sw_exec_ctx_destroy(struct sw_accel_io_channel *sw_ch);
+int accel_sw_exec_task(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *task);
+
+#define ACCEL_SW_ASYNC_DEFAULT_NUM_WORKERS	2
+#define ACCEL_SW_ASYNC_MAX_WORKERS		64
+
+int accel_sw_async_enable(uint32_t num_workers);
+
+struct accel_sw_key_cache_stats {
+	/* Number of crypto keys using the software module */
+	uint64_t num_keys;
+	/*
+	 * Hugepage memory reserved for the key schedules, in bytes. It grows by whole slabs, so it
+	 * doesn't reveal which keys share their key material.
+	 */
+	uint64_t arena_size;
+};
+
+void accel_sw_get_key_cache_stats(struct accel_sw_key_cache_stats *stats);
 
 #endif
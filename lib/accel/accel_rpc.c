@@ -105,21 +105,45 @@ rpc_accel_get_module_info(struct spdk_jsonrpc_request *request,
 SPDK_RPC_REGISTER("accel_get_module_info", rpc_accel_get_module_info, SPDK_RPC_RUNTIME)
 SPDK_RPC_REGISTER_ALIAS_DEPRECATED(accel_get_module_info, accel_get_engine_info)
 
+struct rpc_accel_spread_modules {
+	size_t num_modules;
+	char *modules[SPDK_ACCEL_OPC_MAX_MODULES - 1];
+};
+
 struct rpc_accel_assign_opc {
 	char *opname;
 	char *module;
+	struct rpc_accel_spread_modules spread;
 };
 
+static int
+decode_rpc_accel_spread_modules(const struct spdk_json_val *val, void *out)
+{
+	struct rpc_accel_spread_modules *spread = out;
+
+	return spdk_json_decode_array(val, spdk_json_decode_string, spread->modules,
+				      SPDK_COUNTOF(spread->modules), &spread->num_modules, sizeof(char *));
+}
+
 static const struct spdk_json_object_decoder rpc_accel_assign_opc_decoders[] = {
 	{"opname", offsetof(struct rpc_accel_assign_opc, opname), spdk_json_decode_string},
 	{"module", offsetof(struct rpc_accel_assign_opc, module), spdk_json_decode_string},
+	{
+		"spread_modules", offsetof(struct rpc_accel_assign_opc, spread),
+		decode_rpc_accel_spread_modules, true
+	},
 };
 
 static void
 free_accel_assign_opc(struct rpc_accel_assign_opc *r)
 {
+	size_t i;
+
 	free(r->opname);
 	free(r->module);
+	for (i = 0; i < r->spread.num_modules; i++) {
+		free(r->spread.modules[i]);
+	}
 }
 
 static void
@@ -127,9 +151,10 @@ rpc_accel_assign_opc(struct spdk_jsonrpc_request *request,
 		     const struct spdk_json_val *params)
 {
 	struct rpc_accel_assign_opc req = {};
-	const char *opcode_str;
+	const char *opcode_str, *modules[SPDK_ACCEL_OPC_MAX_MODULES];
 	enum spdk_accel_opcode opcode;
 	bool found = false;
+	size_t i;
 	int rc;
 
 	if (spdk_json_decode_object(params, rpc_accel_assign_opc_decoders,
@@ -157,7 +182,12 @@ rpc_accel_assign_opc(struct spdk_jsonrpc_request *request,
 		goto cleanup;
 	}
 
-	rc = spdk_accel_assign_opc(opcode, req.module);
+	modules[0] = req.module;
+	for (i = 0; i < req.spread.num_modules; i++) {
+		modules[i + 1] = req.spread.modules[i];
+	}
+
+	rc = spdk_accel_assign_opc_modules(opcode, modules, req.spread.num_modules + 1);
 	if (rc) {
 		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
 						 "error assigning opcode");
@@ -410,12 +440,47 @@ rpc_accel_set_options(struct spdk_jsonrpc_request *request, const struct spdk_js
 }
 SPDK_RPC_REGISTER("accel_set_options", rpc_accel_set_options, SPDK_RPC_STARTUP)
 
+struct rpc_accel_sw_async_enable {
+	uint32_t	num_workers;
+};
+
+static const struct spdk_json_object_decoder rpc_accel_sw_async_enable_decoders[] = {
+	{"num_workers", offsetof(struct rpc_accel_sw_async_enable, num_workers), spdk_json_decode_uint32, true},
+};
+
+static void
+rpc_accel_sw_async_enable(struct spdk_jsonrpc_request *request, const struct spdk_json_val *params)
+{
+	struct rpc_accel_sw_async_enable req = {
+		.num_workers = ACCEL_SW_ASYNC_DEFAULT_NUM_WORKERS,
+	};
+	int rc;
+
+	if (params != NULL &&
+	    spdk_json_decode_object(params, rpc_accel_sw_async_enable_decoders,
+				    SPDK_COUNTOF(rpc_accel_sw_async_enable_decoders), &req)) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_PARSE_ERROR,
+						 "spdk_json_decode_object failed");
+		return;
+	}
+
+	rc = accel_sw_async_enable(req.num_workers);
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response(request, rc, spdk_strerror(-rc));
+		return;
+	}
+
+	spdk_jsonrpc_send_bool_response(request, true);
+}
+SPDK_RPC_REGISTER("accel_sw_async_enable", rpc_accel_sw_async_enable, SPDK_RPC_STARTUP)
+
 static void
 rpc_accel_get_stats_done(struct accel_stats *stats, void *cb_arg)
 {
 	struct spdk_jsonrpc_request *request = cb_arg;
 	struct spdk_json_write_ctx *w;
-	const char *module_name;
+	const char *module_name, *module_names[SPDK_ACCEL_OPC_MAX_MODULES];
+	uint32_t j, num_modules;
 	int i, rc;
 
 	w = spdk_jsonrpc_begin_result(request);
@@ -440,6 +505,20 @@ rpc_accel_get_stats_done(struct accel_stats *stats, void *cb_arg)
 		spdk_json_write_named_uint64(w, "executed", stats->operations[i].executed);
 		spdk_json_write_named_uint64(w, "failed", stats->operations[i].failed);
 		spdk_json_write_named_uint64(w, "num_bytes", stats->operations[i].num_bytes);
+		num_modules = accel_get_opc_modules(i, module_names);
+		if (num_modules > 0) {
+			spdk_json_write_named_array_begin(w, "modules");
+			for (j = 0; j < num_modules; j++) {
+				spdk_json_write_object_begin(w);
+				spdk_json_write_named_string(w, "module_name", module_names[j]);
+				spdk_json_write_named_uint64(w, "executed",
+							     stats->operations[i].modules[j].executed);
+				spdk_json_write_named_uint64(w, "spilled",
+							     stats->operations[i].modules[j].spilled);
+				spdk_json_write_object_end(w);
+			}
+			spdk_json_write_array_end(w);
+		}
 		spdk_json_write_object_end(w);
 	}
 	spdk_json_write_array_end(w);
@@ -464,3 +543,28 @@ rpc_accel_get_stats(struct spdk_jsonrpc_request *request, const struct spdk_json
 	}
 }
 SPDK_RPC_REGISTER("accel_get_stats", rpc_accel_get_stats, SPDK_RPC_RUNTIME)
+
+static void
+rpc_accel_sw_get_key_cache_stats(struct spdk_jsonrpc_request *request,
+				 const struct spdk_json_val *params)
+{
+	struct accel_sw_key_cache_stats stats;
+	struct spdk_json_write_ctx *w;
+
+	if (params != NULL) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
+						 "accel_sw_get_key_cache_stats requires no parameters");
+		return;
+	}
+
+	accel_sw_get_key_cache_stats(&stats);
+
+	w = spdk_jsonrpc_begin_result(request);
+	spdk_json_write_object_begin(w);
+	spdk_json_write_named_uint64(w, "num_keys", stats.num_keys);
+	spdk_json_write_named_uint64(w, "arena_size", stats.arena_size);
+	spdk_json_write_object_end(w);
+	spdk_jsonrpc_end_result(request, w);
+}
+SPDK_RPC_REGISTER("accel_sw_get_key_cache_stats", rpc_accel_sw_get_key_cache_stats,
+		  SPDK_RPC_RUNTIME)
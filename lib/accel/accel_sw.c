@@ -15,9 +15,11 @@
 #include "spdk/thread.h"
 #include "spdk/json.h"
 #include "spdk/crc32.h"
+#include "spdk/string.h"
 #include "spdk/util.h"
 #include "spdk/xor.h"
 #include "spdk/dif.h"
+#include "spdk/tree.h"
 
 #ifdef SPDK_CONFIG_HAVE_LZ4
 #include <lz4.h>
@@ -27,6 +29,7 @@
 #include "../isa-l/include/igzip_lib.h"
 #ifdef SPDK_CONFIG_ISAL_CRYPTO
 #include "../isa-l-crypto/include/aes_xts.h"
+#include "../isa-l-crypto/include/aes_keyexp.h"
 #include "../isa-l-crypto/include/isal_crypto_api.h"
 #endif
 #endif
@@ -34,6 +37,9 @@
 /* Per the AES-XTS spec, the size of data unit cannot be bigger than 2^20 blocks, 128b each block */
 #define ACCEL_AES_XTS_MAX_BLOCK_SIZE (1 << 24)
 
+/* Size of an expanded AES-256 key schedule (15 round keys, 16B each) */
+#define ACCEL_AES_MAX_EXP_KEY_SIZE (15 * 16)
+
 #ifdef SPDK_CONFIG_ISAL
 #define COMP_DEFLATE_MIN_LEVEL ISAL_DEF_MIN_LEVEL
 #define COMP_DEFLATE_MAX_LEVEL ISAL_DEF_MAX_LEVEL
@@ -66,6 +72,8 @@ struct sw_accel_io_channel {
 #endif
 	struct spdk_poller		*completion_poller;
 	STAILQ_HEAD(, spdk_accel_task)	tasks_to_complete;
+	/* Single buffer crc32c tasks, calculated together by the completion poller */
+	STAILQ_HEAD(, spdk_accel_task)	crc32c_tasks;
 };
 
 typedef int (*sw_accel_crypto_op)(const uint8_t *k2, const uint8_t *k1,
@@ -73,13 +81,54 @@ typedef int (*sw_accel_crypto_op)(const uint8_t *k2, const uint8_t *k1,
 				  const void *in, void *out);
 
 struct sw_accel_crypto_key_data {
+	/* Key schedules are expanded once, when the key is created, instead of on each data unit */
+	uint8_t key_enc[ACCEL_AES_MAX_EXP_KEY_SIZE];
+	uint8_t key_dec[ACCEL_AES_MAX_EXP_KEY_SIZE];
+	/* Only the encryption schedule of the tweak key is used, for both directions */
+	uint8_t key2_enc[ACCEL_AES_MAX_EXP_KEY_SIZE];
 	sw_accel_crypto_op encrypt;
 	sw_accel_crypto_op decrypt;
+	size_t key_size;
+	/* Number of keys sharing this schedule */
+	uint32_t refcnt;
+	RB_ENTRY(sw_accel_crypto_key_data) node;
+	SLIST_ENTRY(sw_accel_crypto_key_data) free_link;
+} __attribute__((aligned(SPDK_CACHE_LINE_SIZE)));
+
+/* Number of key schedules in each hugepage slab of the key arena */
+#define SW_ACCEL_KEY_ARENA_SLAB_KEYS	64
+
+struct sw_accel_key_arena_slab {
+	struct sw_accel_crypto_key_data	*keys;
+	SLIST_ENTRY(sw_accel_key_arena_slab) link;
+};
+
+static int sw_accel_crypto_key_data_cmp(struct sw_accel_crypto_key_data *k1,
+					struct sw_accel_crypto_key_data *k2);
+RB_HEAD(sw_accel_key_tree, sw_accel_crypto_key_data);
+RB_GENERATE_STATIC(sw_accel_key_tree, sw_accel_crypto_key_data, node, sw_accel_crypto_key_data_cmp);
+
+/*
+ * Expanded key schedules, shared by all keys using the same key material and allocated from
+ * hugepage slabs, so that a large number of keys doesn't fragment the heap.
+ */
+static struct {
+	pthread_mutex_t				mutex;
+	struct sw_accel_key_tree		tree;
+	SLIST_HEAD(, sw_accel_crypto_key_data)	free_keys;
+	SLIST_HEAD(, sw_accel_key_arena_slab)	slabs;
+	struct accel_sw_key_cache_stats		stats;
+} g_sw_key_cache = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+	.tree = RB_INITIALIZER(&g_sw_key_cache.tree),
+	.free_keys = SLIST_HEAD_INITIALIZER(g_sw_key_cache.free_keys),
+	.slabs = SLIST_HEAD_INITIALIZER(g_sw_key_cache.slabs),
 };
 
 static struct spdk_accel_module_if g_sw_module;
 
 static void sw_accel_crypto_key_deinit(struct spdk_accel_crypto_key *_key);
+static void sw_accel_key_arena_free(void);
 static int sw_accel_crypto_key_init(struct spdk_accel_crypto_key *key);
 static bool sw_accel_crypto_supports_tweak_mode(enum spdk_accel_crypto_tweak_mode tweak_mode);
 static bool sw_accel_crypto_supports_cipher(enum spdk_accel_cipher cipher, size_t key_size);
@@ -113,6 +162,7 @@ sw_accel_supports_opcode(enum spdk_accel_opcode opc)
 	case SPDK_ACCEL_OPC_DIF_VERIFY_COPY:
 	case SPDK_ACCEL_OPC_DIX_GENERATE:
 	case SPDK_ACCEL_OPC_DIX_VERIFY:
+	case SPDK_ACCEL_OPC_CHECK_ZERO:
 		return true;
 	default:
 		return false;
@@ -170,6 +220,21 @@ _sw_accel_compare(struct iovec *src_iovs, uint32_t src_iovcnt,
 	return memcmp(src_iovs[0].iov_base, src2_iovs[0].iov_base, src_iovs[0].iov_len);
 }
 
+static void
+_sw_accel_check_zero(struct iovec *iovs, uint32_t iovcnt, bool *is_zero)
+{
+	uint32_t i;
+
+	for (i = 0; i < iovcnt; i++) {
+		if (!spdk_mem_all_zero(iovs[i].iov_base, iovs[i].iov_len)) {
+			*is_zero = false;
+			return;
+		}
+	}
+
+	*is_zero = true;
+}
+
 static int
 _sw_accel_fill(struct iovec *iovs, uint32_t iovcnt, uint8_t fill)
 {
@@ -194,6 +259,77 @@ _sw_accel_crc32cv(uint32_t *crc_dst, struct iovec *iov, uint32_t iovcnt, uint32_
 	*crc_dst = spdk_crc32c_iov_update(iov, iovcnt, ~seed);
 }
 
+/* Maximum number of crc32c tasks calculated in a single spdk_crc32c_update_batch() call */
+#define SW_ACCEL_CRC32C_BATCH_SIZE	32
+
+static void
+_sw_accel_crc32c_batch(struct sw_accel_io_channel *sw_ch)
+{
+	struct spdk_accel_task *tasks[SW_ACCEL_CRC32C_BATCH_SIZE], *accel_task;
+	struct iovec iovs[SW_ACCEL_CRC32C_BATCH_SIZE];
+	uint32_t crcs[SW_ACCEL_CRC32C_BATCH_SIZE];
+	uint32_t i, count;
+
+	while (!STAILQ_EMPTY(&sw_ch->crc32c_tasks)) {
+		count = 0;
+		while (count < SW_ACCEL_CRC32C_BATCH_SIZE &&
+		       (accel_task = STAILQ_FIRST(&sw_ch->crc32c_tasks)) != NULL) {
+			STAILQ_REMOVE_HEAD(&sw_ch->crc32c_tasks, link);
+			tasks[count] = accel_task;
+			iovs[count] = accel_task->s.iovs[0];
+			crcs[count] = ~accel_task->seed;
+			count++;
+		}
+
+		spdk_crc32c_update_batch(iovs, crcs, count);
+
+		for (i = 0; i < count; i++) {
+			*tasks[i]->crc_dst = crcs[i];
+			_add_to_comp_list(sw_ch, tasks[i], 0);
+		}
+	}
+}
+
+/* Size of the chunks in which the data is copied and checksummed, small enough to still be
+ * present in L1 cache when the crc is calculated */
+#define SW_ACCEL_COPY_CRC32C_CHUNK_SIZE	4096
+
+static void
+_sw_accel_copy_crc32cv(uint32_t *crc_dst, struct iovec *dst_iovs, uint32_t dst_iovcnt,
+		       struct iovec *src_iovs, uint32_t src_iovcnt, uint32_t seed)
+{
+	struct spdk_ioviter iter;
+	uint32_t crc = ~seed;
+	void *src, *dst;
+	size_t len, chunk;
+
+	for (len = spdk_ioviter_first(&iter, src_iovs, src_iovcnt,
+				      dst_iovs, dst_iovcnt, &src, &dst);
+	     len != 0;
+	     len = spdk_ioviter_next(&iter, &src, &dst)) {
+		while (len > 0) {
+			chunk = spdk_min(len, SW_ACCEL_COPY_CRC32C_CHUNK_SIZE);
+			memcpy(dst, src, chunk);
+			crc = spdk_crc32c_update(dst, chunk, crc);
+			src = (uint8_t *)src + chunk;
+			dst = (uint8_t *)dst + chunk;
+			len -= chunk;
+		}
+	}
+
+	*crc_dst = crc;
+}
+
+static void
+_sw_accel_fused_crc32cv(struct spdk_accel_task *accel_task)
+{
+	struct spdk_accel_task *fused = accel_task->fused_crc32c;
+
+	if (fused != NULL) {
+		_sw_accel_crc32cv(fused->crc_dst, accel_task->d.iovs, accel_task->d.iovcnt, fused->seed);
+	}
+}
+
 static int
 _sw_accel_compress_lz4(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *accel_task)
 {
@@ -468,8 +604,8 @@ _sw_accel_decompress(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *
 }
 
 static int
-_sw_accel_crypto_operation(struct spdk_accel_task *accel_task, struct spdk_accel_crypto_key *key,
-			   sw_accel_crypto_op op)
+_sw_accel_crypto_operation(struct spdk_accel_task *accel_task, const uint8_t *key2,
+			   const uint8_t *key, sw_accel_crypto_op op)
 {
 #ifdef SPDK_CONFIG_ISAL_CRYPTO
 	uint64_t iv[2];
@@ -477,7 +613,9 @@ _sw_accel_crypto_operation(struct spdk_accel_task *accel_task, struct spdk_accel
 	uint64_t src_offset = 0, dst_offset = 0;
 	uint32_t src_iovpos = 0, dst_iovpos = 0, src_iovcnt, dst_iovcnt;
 	uint32_t i, block_size, crypto_len, crypto_accum_len = 0;
+	struct spdk_accel_task *fused = accel_task->fused_crc32c;
 	struct iovec *src_iov, *dst_iov;
+	uint32_t crc = 0;
 	uint8_t *src, *dst;
 	int rc;
 
@@ -518,16 +656,24 @@ _sw_accel_crypto_operation(struct spdk_accel_task *accel_task, struct spdk_accel
 		return -EINVAL;
 	}
 
+	if (fused != NULL) {
+		crc = ~fused->seed;
+	}
+
 	while (remaining_len) {
 		crypto_len = spdk_min(block_size - crypto_accum_len, src_iov->iov_len - src_offset);
 		crypto_len = spdk_min(crypto_len, dst_iov->iov_len - dst_offset);
 		src = (uint8_t *)src_iov->iov_base + src_offset;
 		dst = (uint8_t *)dst_iov->iov_base + dst_offset;
 
-		rc = op((uint8_t *)key->key2, (uint8_t *)key->key, (uint8_t *)iv, crypto_len, src, dst);
+		rc = op(key2, key, (uint8_t *)iv, crypto_len, src, dst);
 		if (rc != ISAL_CRYPTO_ERR_NONE) {
 			break;
 		}
+		if (fused != NULL) {
+			/* Checksum the output while it's still hot in cache */
+			crc = spdk_crc32c_update(dst, crypto_len, crc);
+		}
 
 		src_offset += crypto_len;
 		dst_offset += crypto_len;
@@ -562,6 +708,10 @@ _sw_accel_crypto_operation(struct spdk_accel_task *accel_task, struct spdk_accel
 		return -EINVAL;
 	}
 
+	if (fused != NULL) {
+		*fused->crc_dst = crc;
+	}
+
 	return 0;
 #else
 	return -ENOTSUP;
@@ -584,7 +734,8 @@ _sw_accel_encrypt(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *acc
 		return -ERANGE;
 	}
 	key_data = key->priv;
-	return _sw_accel_crypto_operation(accel_task, key, key_data->encrypt);
+	return _sw_accel_crypto_operation(accel_task, key_data->key2_enc, key_data->key_enc,
+					  key_data->encrypt);
 }
 
 static int
@@ -603,7 +754,8 @@ _sw_accel_decrypt(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *acc
 		return -ERANGE;
 	}
 	key_data = key->priv;
-	return _sw_accel_crypto_operation(accel_task, key, key_data->decrypt);
+	return _sw_accel_crypto_operation(accel_task, key_data->key2_enc, key_data->key_dec,
+					  key_data->decrypt);
 }
 
 static int
@@ -685,6 +837,8 @@ accel_comp_poll(void *arg)
 	STAILQ_HEAD(, spdk_accel_task)	tasks_to_complete;
 	struct spdk_accel_task		*accel_task;
 
+	_sw_accel_crc32c_batch(sw_ch);
+
 	if (STAILQ_EMPTY(&sw_ch->tasks_to_complete)) {
 		return SPDK_POLLER_IDLE;
 	}
@@ -700,12 +854,89 @@ accel_comp_poll(void *arg)
 	return SPDK_POLLER_BUSY;
 }
 
+static int
+_sw_accel_execute_task(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *accel_task)
+{
+	int rc = 0;
+
+	switch (accel_task->op_code) {
+	case SPDK_ACCEL_OPC_COPY:
+		_sw_accel_copy_iovs(accel_task->d.iovs, accel_task->d.iovcnt,
+				    accel_task->s.iovs, accel_task->s.iovcnt);
+		break;
+	case SPDK_ACCEL_OPC_FILL:
+		rc = _sw_accel_fill(accel_task->d.iovs, accel_task->d.iovcnt,
+				    accel_task->fill_pattern);
+		break;
+	case SPDK_ACCEL_OPC_DUALCAST:
+		rc = _sw_accel_dualcast_iovs(accel_task->d.iovs, accel_task->d.iovcnt,
+					     accel_task->d2.iovs, accel_task->d2.iovcnt,
+					     accel_task->s.iovs, accel_task->s.iovcnt);
+		break;
+	case SPDK_ACCEL_OPC_COMPARE:
+		rc = _sw_accel_compare(accel_task->s.iovs, accel_task->s.iovcnt,
+				       accel_task->s2.iovs, accel_task->s2.iovcnt);
+		break;
+	case SPDK_ACCEL_OPC_CRC32C:
+		_sw_accel_crc32cv(accel_task->crc_dst, accel_task->s.iovs, accel_task->s.iovcnt, accel_task->seed);
+		break;
+	case SPDK_ACCEL_OPC_COPY_CRC32C:
+		_sw_accel_copy_crc32cv(accel_task->crc_dst, accel_task->d.iovs, accel_task->d.iovcnt,
+				       accel_task->s.iovs, accel_task->s.iovcnt, accel_task->seed);
+		break;
+	case SPDK_ACCEL_OPC_COMPRESS:
+		rc = _sw_accel_compress(sw_ch, accel_task);
+		break;
+	case SPDK_ACCEL_OPC_DECOMPRESS:
+		rc = _sw_accel_decompress(sw_ch, accel_task);
+		if (rc == 0) {
+			_sw_accel_fused_crc32cv(accel_task);
+		}
+		break;
+	case SPDK_ACCEL_OPC_XOR:
+		rc = _sw_accel_xor(sw_ch, accel_task);
+		break;
+	case SPDK_ACCEL_OPC_ENCRYPT:
+		rc = _sw_accel_encrypt(sw_ch, accel_task);
+		break;
+	case SPDK_ACCEL_OPC_DECRYPT:
+		rc = _sw_accel_decrypt(sw_ch, accel_task);
+		break;
+	case SPDK_ACCEL_OPC_DIF_VERIFY:
+		rc = _sw_accel_dif_verify(sw_ch, accel_task);
+		break;
+	case SPDK_ACCEL_OPC_DIF_VERIFY_COPY:
+		rc = _sw_accel_dif_verify_copy(sw_ch, accel_task);
+		break;
+	case SPDK_ACCEL_OPC_DIF_GENERATE:
+		rc = _sw_accel_dif_generate(sw_ch, accel_task);
+		break;
+	case SPDK_ACCEL_OPC_DIF_GENERATE_COPY:
+		rc = _sw_accel_dif_generate_copy(sw_ch, accel_task);
+		break;
+	case SPDK_ACCEL_OPC_DIX_GENERATE:
+		rc = _sw_accel_dix_generate(sw_ch, accel_task);
+		break;
+	case SPDK_ACCEL_OPC_DIX_VERIFY:
+		rc = _sw_accel_dix_verify(sw_ch, accel_task);
+		break;
+	case SPDK_ACCEL_OPC_CHECK_ZERO:
+		_sw_accel_check_zero(accel_task->s.iovs, accel_task->s.iovcnt, accel_task->is_zero);
+		break;
+	default:
+		assert(false);
+		break;
+	}
+
+	return rc;
+}
+
 static int
 sw_accel_submit_tasks(struct spdk_io_channel *ch, struct spdk_accel_task *accel_task)
 {
 	struct sw_accel_io_channel *sw_ch = spdk_io_channel_get_ctx(ch);
 	struct spdk_accel_task *tmp;
-	int rc = 0;
+	int rc;
 
 	/*
 	 * Lazily initialize our completion poller. We don't want to complete
@@ -716,74 +947,18 @@ sw_accel_submit_tasks(struct spdk_io_channel *ch, struct spdk_accel_task *accel_
 	}
 
 	do {
-		switch (accel_task->op_code) {
-		case SPDK_ACCEL_OPC_COPY:
-			_sw_accel_copy_iovs(accel_task->d.iovs, accel_task->d.iovcnt,
-					    accel_task->s.iovs, accel_task->s.iovcnt);
-			break;
-		case SPDK_ACCEL_OPC_FILL:
-			rc = _sw_accel_fill(accel_task->d.iovs, accel_task->d.iovcnt,
-					    accel_task->fill_pattern);
-			break;
-		case SPDK_ACCEL_OPC_DUALCAST:
-			rc = _sw_accel_dualcast_iovs(accel_task->d.iovs, accel_task->d.iovcnt,
-						     accel_task->d2.iovs, accel_task->d2.iovcnt,
-						     accel_task->s.iovs, accel_task->s.iovcnt);
-			break;
-		case SPDK_ACCEL_OPC_COMPARE:
-			rc = _sw_accel_compare(accel_task->s.iovs, accel_task->s.iovcnt,
-					       accel_task->s2.iovs, accel_task->s2.iovcnt);
-			break;
-		case SPDK_ACCEL_OPC_CRC32C:
-			_sw_accel_crc32cv(accel_task->crc_dst, accel_task->s.iovs, accel_task->s.iovcnt, accel_task->seed);
-			break;
-		case SPDK_ACCEL_OPC_COPY_CRC32C:
-			_sw_accel_copy_iovs(accel_task->d.iovs, accel_task->d.iovcnt,
-					    accel_task->s.iovs, accel_task->s.iovcnt);
-			_sw_accel_crc32cv(accel_task->crc_dst, accel_task->s.iovs,
-					  accel_task->s.iovcnt, accel_task->seed);
-			break;
-		case SPDK_ACCEL_OPC_COMPRESS:
-			rc = _sw_accel_compress(sw_ch, accel_task);
-			break;
-		case SPDK_ACCEL_OPC_DECOMPRESS:
-			rc = _sw_accel_decompress(sw_ch, accel_task);
-			break;
-		case SPDK_ACCEL_OPC_XOR:
-			rc = _sw_accel_xor(sw_ch, accel_task);
-			break;
-		case SPDK_ACCEL_OPC_ENCRYPT:
-			rc = _sw_accel_encrypt(sw_ch, accel_task);
-			break;
-		case SPDK_ACCEL_OPC_DECRYPT:
-			rc = _sw_accel_decrypt(sw_ch, accel_task);
-			break;
-		case SPDK_ACCEL_OPC_DIF_VERIFY:
-			rc = _sw_accel_dif_verify(sw_ch, accel_task);
-			break;
-		case SPDK_ACCEL_OPC_DIF_VERIFY_COPY:
-			rc = _sw_accel_dif_verify_copy(sw_ch, accel_task);
-			break;
-		case SPDK_ACCEL_OPC_DIF_GENERATE:
-			rc = _sw_accel_dif_generate(sw_ch, accel_task);
-			break;
-		case SPDK_ACCEL_OPC_DIF_GENERATE_COPY:
-			rc = _sw_accel_dif_generate_copy(sw_ch, accel_task);
-			break;
-		case SPDK_ACCEL_OPC_DIX_GENERATE:
-			rc = _sw_accel_dix_generate(sw_ch, accel_task);
-			break;
-		case SPDK_ACCEL_OPC_DIX_VERIFY:
-			rc = _sw_accel_dix_verify(sw_ch, accel_task);
-			break;
-		default:
-			assert(false);
-			break;
-		}
-
 		tmp = STAILQ_NEXT(accel_task, link);
 
-		_add_to_comp_list(sw_ch, accel_task, rc);
+		/*
+		 * Single buffer crc32c tasks are deferred to the completion poller, which
+		 * calculates all of the ones submitted since its last run in one batch.
+		 */
+		if (accel_task->op_code == SPDK_ACCEL_OPC_CRC32C && accel_task->s.iovcnt == 1) {
+			STAILQ_INSERT_TAIL(&sw_ch->crc32c_tasks, accel_task, link);
+		} else {
+			rc = _sw_accel_execute_task(sw_ch, accel_task);
+			_add_to_comp_list(sw_ch, accel_task, rc);
+		}
 
 		accel_task = tmp;
 	} while (accel_task);
@@ -801,6 +976,7 @@ sw_accel_create_cb(void *io_device, void *ctx_buf)
 #endif
 
 	STAILQ_INIT(&sw_ch->tasks_to_complete);
+	STAILQ_INIT(&sw_ch->crc32c_tasks);
 	sw_ch->completion_poller = NULL;
 
 #ifdef SPDK_CONFIG_HAVE_LZ4
@@ -858,6 +1034,37 @@ sw_accel_destroy_cb(void *io_device, void *ctx_buf)
 	spdk_poller_unregister(&sw_ch->completion_poller);
 }
 
+struct sw_accel_io_channel *
+accel_sw_exec_ctx_create(void)
+{
+	struct sw_accel_io_channel *sw_ch;
+
+	sw_ch = calloc(1, sizeof(*sw_ch));
+	if (sw_ch == NULL) {
+		return NULL;
+	}
+
+	if (sw_accel_create_cb(NULL, sw_ch) != 0) {
+		free(sw_ch);
+		return NULL;
+	}
+
+	return sw_ch;
+}
+
+void
+accel_sw_exec_ctx_destroy(struct sw_accel_io_channel *sw_ch)
+{
+	sw_accel_destroy_cb(NULL, sw_ch);
+	free(sw_ch);
+}
+
+int
+accel_sw_exec_task(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *task)
+{
+	return _sw_accel_execute_task(sw_ch, task);
+}
+
 static struct spdk_io_channel *
 sw_accel_get_io_channel(void)
 {
@@ -883,35 +1090,165 @@ static void
 sw_accel_module_fini(void *ctxt)
 {
 	spdk_io_device_unregister(&g_sw_module, NULL);
+
+	/* All of the keys have already been destroyed by now */
+	pthread_mutex_lock(&g_sw_key_cache.mutex);
+	sw_accel_key_arena_free();
+	pthread_mutex_unlock(&g_sw_key_cache.mutex);
+
 	spdk_accel_module_finish();
 }
 
 static int
-sw_accel_create_aes_xts(struct spdk_accel_crypto_key *key)
+sw_accel_crypto_key_data_cmp(struct sw_accel_crypto_key_data *k1,
+			     struct sw_accel_crypto_key_data *k2)
+{
+	int rc;
+
+	if (k1->key_size != k2->key_size) {
+		return k1->key_size < k2->key_size ? -1 : 1;
+	}
+
+	rc = memcmp(k1->key_enc, k2->key_enc, sizeof(k1->key_enc));
+	if (rc != 0) {
+		return rc;
+	}
+
+	return memcmp(k1->key2_enc, k2->key2_enc, sizeof(k1->key2_enc));
+}
+
+static struct sw_accel_crypto_key_data *
+sw_accel_key_arena_get(void)
 {
-#ifdef SPDK_CONFIG_ISAL_CRYPTO
 	struct sw_accel_crypto_key_data *key_data;
+	struct sw_accel_key_arena_slab *slab;
+	uint32_t i;
 
-	key_data = calloc(1, sizeof(*key_data));
-	if (!key_data) {
-		return -ENOMEM;
+	if (SLIST_EMPTY(&g_sw_key_cache.free_keys)) {
+		slab = calloc(1, sizeof(*slab));
+		if (slab == NULL) {
+			return NULL;
+		}
+
+		slab->keys = spdk_zmalloc(sizeof(*slab->keys) * SW_ACCEL_KEY_ARENA_SLAB_KEYS,
+					  SPDK_CACHE_LINE_SIZE, NULL, SPDK_ENV_NUMA_ID_ANY,
+					  SPDK_MALLOC_DMA);
+		if (slab->keys == NULL) {
+			SPDK_ERRLOG("Failed to allocate the key schedule arena\n");
+			free(slab);
+			return NULL;
+		}
+
+		for (i = 0; i < SW_ACCEL_KEY_ARENA_SLAB_KEYS; i++) {
+			SLIST_INSERT_HEAD(&g_sw_key_cache.free_keys, &slab->keys[i], free_link);
+		}
+
+		SLIST_INSERT_HEAD(&g_sw_key_cache.slabs, slab, link);
+		g_sw_key_cache.stats.arena_size += sizeof(*slab->keys) * SW_ACCEL_KEY_ARENA_SLAB_KEYS;
+	}
+
+	key_data = SLIST_FIRST(&g_sw_key_cache.free_keys);
+	SLIST_REMOVE_HEAD(&g_sw_key_cache.free_keys, free_link);
+
+	return key_data;
+}
+
+static void
+sw_accel_key_arena_put(struct sw_accel_crypto_key_data *key_data)
+{
+	spdk_memset_s(key_data, sizeof(*key_data), 0, sizeof(*key_data));
+	SLIST_INSERT_HEAD(&g_sw_key_cache.free_keys, key_data, free_link);
+}
+
+static void
+sw_accel_key_arena_free(void)
+{
+	struct sw_accel_key_arena_slab *slab;
+
+	assert(RB_EMPTY(&g_sw_key_cache.tree));
+
+	while ((slab = SLIST_FIRST(&g_sw_key_cache.slabs))) {
+		SLIST_REMOVE_HEAD(&g_sw_key_cache.slabs, link);
+		spdk_free(slab->keys);
+		free(slab);
 	}
 
+	SLIST_INIT(&g_sw_key_cache.free_keys);
+	g_sw_key_cache.stats.arena_size = 0;
+}
+
+void
+accel_sw_get_key_cache_stats(struct accel_sw_key_cache_stats *stats)
+{
+	pthread_mutex_lock(&g_sw_key_cache.mutex);
+	*stats = g_sw_key_cache.stats;
+	pthread_mutex_unlock(&g_sw_key_cache.mutex);
+}
+
+static int
+sw_accel_create_aes_xts(struct spdk_accel_crypto_key *key)
+{
+#ifdef SPDK_CONFIG_ISAL_CRYPTO
+	struct sw_accel_crypto_key_data tmp = {}, *key_data;
+	uint8_t key2_dec[ACCEL_AES_MAX_EXP_KEY_SIZE];
+	int rc;
+
+	tmp.key_size = key->key_size;
 	switch (key->key_size) {
 	case SPDK_ACCEL_AES_XTS_128_KEY_SIZE:
-		key_data->encrypt = isal_aes_xts_enc_128;
-		key_data->decrypt = isal_aes_xts_dec_128;
+		tmp.encrypt = isal_aes_xts_enc_128_expanded_key;
+		tmp.decrypt = isal_aes_xts_dec_128_expanded_key;
+		rc = isal_aes_keyexp_128((uint8_t *)key->key, tmp.key_enc, tmp.key_dec);
+		if (rc == ISAL_CRYPTO_ERR_NONE) {
+			rc = isal_aes_keyexp_128((uint8_t *)key->key2, tmp.key2_enc, key2_dec);
+		}
 		break;
 	case SPDK_ACCEL_AES_XTS_256_KEY_SIZE:
-		key_data->encrypt = isal_aes_xts_enc_256;
-		key_data->decrypt = isal_aes_xts_dec_256;
+		tmp.encrypt = isal_aes_xts_enc_256_expanded_key;
+		tmp.decrypt = isal_aes_xts_dec_256_expanded_key;
+		rc = isal_aes_keyexp_256((uint8_t *)key->key, tmp.key_enc, tmp.key_dec);
+		if (rc == ISAL_CRYPTO_ERR_NONE) {
+			rc = isal_aes_keyexp_256((uint8_t *)key->key2, tmp.key2_enc, key2_dec);
+		}
 		break;
 	default:
 		assert(0);
-		free(key_data);
 		return -EINVAL;
 	}
 
+	spdk_memset_s(key2_dec, sizeof(key2_dec), 0, sizeof(key2_dec));
+	if (rc != ISAL_CRYPTO_ERR_NONE) {
+		SPDK_ERRLOG("Failed to expand the key schedule of key %s: %d\n", key->param.key_name, rc);
+		spdk_memset_s(&tmp, sizeof(tmp), 0, sizeof(tmp));
+		return -EINVAL;
+	}
+
+	pthread_mutex_lock(&g_sw_key_cache.mutex);
+	/* Keys using the same key material (e.g. many volumes encrypted with the same key) share a
+	 * single copy of the expanded schedules */
+	key_data = RB_FIND(sw_accel_key_tree, &g_sw_key_cache.tree, &tmp);
+	if (key_data == NULL) {
+		key_data = sw_accel_key_arena_get();
+		if (key_data == NULL) {
+			pthread_mutex_unlock(&g_sw_key_cache.mutex);
+			spdk_memset_s(&tmp, sizeof(tmp), 0, sizeof(tmp));
+			return -ENOMEM;
+		}
+
+		memcpy(key_data->key_enc, tmp.key_enc, sizeof(tmp.key_enc));
+		memcpy(key_data->key_dec, tmp.key_dec, sizeof(tmp.key_dec));
+		memcpy(key_data->key2_enc, tmp.key2_enc, sizeof(tmp.key2_enc));
+		key_data->encrypt = tmp.encrypt;
+		key_data->decrypt = tmp.decrypt;
+		key_data->key_size = tmp.key_size;
+		RB_INSERT(sw_accel_key_tree, &g_sw_key_cache.tree, key_data);
+	}
+
+	key_data->refcnt++;
+	g_sw_key_cache.stats.num_keys++;
+	pthread_mutex_unlock(&g_sw_key_cache.mutex);
+
+	spdk_memset_s(&tmp, sizeof(tmp), 0, sizeof(tmp));
 	key->priv = key_data;
 
 	return 0;
@@ -929,11 +1266,23 @@ sw_accel_crypto_key_init(struct spdk_accel_crypto_key *key)
 static void
 sw_accel_crypto_key_deinit(struct spdk_accel_crypto_key *key)
 {
+	struct sw_accel_crypto_key_data *key_data;
+
 	if (!key || key->module_if != &g_sw_module || !key->priv) {
 		return;
 	}
 
-	free(key->priv);
+	key_data = key->priv;
+	key->priv = NULL;
+
+	pthread_mutex_lock(&g_sw_key_cache.mutex);
+	assert(key_data->refcnt > 0);
+	g_sw_key_cache.stats.num_keys--;
+	if (--key_data->refcnt == 0) {
+		RB_REMOVE(sw_accel_key_tree, &g_sw_key_cache.tree, key_data);
+		sw_accel_key_arena_put(key_data);
+	}
+	pthread_mutex_unlock(&g_sw_key_cache.mutex);
 }
 
 static bool
@@ -995,6 +1344,19 @@ sw_accel_get_compress_level_range(enum spdk_accel_comp_algo algo,
 	}
 }
 
+static bool
+sw_accel_supports_fused_crc32c(enum spdk_accel_opcode opcode)
+{
+	switch (opcode) {
+	case SPDK_ACCEL_OPC_ENCRYPT:
+	case SPDK_ACCEL_OPC_DECRYPT:
+	case SPDK_ACCEL_OPC_DECOMPRESS:
+		return true;
+	default:
+		return false;
+	}
+}
+
 static int
 sw_accel_get_operation_info(enum spdk_accel_opcode opcode,
 			    const struct spdk_accel_operation_exec_ctx *ctx,
@@ -1022,6 +1384,7 @@ static struct spdk_accel_module_if g_sw_module = {
 	.compress_supports_algo         = sw_accel_compress_supports_algo,
 	.get_compress_level_range       = sw_accel_get_compress_level_range,
 	.get_operation_info		= sw_accel_get_operation_info,
+	.supports_fused_crc32c		= sw_accel_supports_fused_crc32c,
 };
 
 SPDK_ACCEL_MODULE_REGISTER(sw, &g_sw_module)
@@ -0,0 +1,436 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2026 Samsung Electronics Co., Ltd.
+ *   All rights reserved.
+ */
+
+/*
+ * The software_async module executes operations using the software module's implementation, but
+ * instead of doing that inline on the submitting thread, it hands them to a pool of worker
+ * pthreads.  Tasks are passed to the workers through a shared submission ring and returned
+ * through a per-channel completion ring, which is polled on the channel's thread, so expensive
+ * operations (e.g. compression) don't stall the reactors.
+ */
+
+#include "spdk/stdinc.h"
+
+#include "spdk/accel_module.h"
+#include "accel_internal.h"
+
+#include "spdk/env.h"
+#include "spdk/json.h"
+#include "spdk/likely.h"
+#include "spdk/log.h"
+#include "spdk/string.h"
+#include "spdk/thread.h"
+#include "spdk/util.h"
+
+#define ACCEL_SW_ASYNC_RING_SIZE	4096
+#define ACCEL_SW_ASYNC_BATCH_SIZE	32
+
+struct accel_sw_async_worker {
+	pthread_t			thread;
+	struct sw_accel_io_channel	*ctx;
+};
+
+struct accel_sw_async_channel {
+	/* Tasks executed by the workers, waiting to be completed on this channel's thread */
+	struct spdk_ring		*cpl_ring;
+	/* Only runs while there are tasks submitted on this channel */
+	struct spdk_poller		*poller;
+	/* Tasks that couldn't be submitted to the workers yet */
+	STAILQ_HEAD(, spdk_accel_task)	queued_tasks;
+	/* Number of tasks submitted to the workers that haven't been completed yet.  It's
+	 * limited by the size of the completion ring, so that the workers never fail to
+	 * enqueue a completion. */
+	uint32_t			num_outstanding;
+};
+
+struct accel_sw_async_task {
+	struct spdk_accel_task		task;
+	struct accel_sw_async_channel	*ch;
+};
+
+static struct {
+	bool				enabled;
+	uint32_t			num_workers;
+	struct accel_sw_async_worker	*workers;
+	struct spdk_ring		*ring;
+	/* Counts the tasks in the submission ring, the workers sleep on it when it's empty */
+	sem_t				sem;
+	bool				stop;
+} g_sw_async = {
+	.num_workers = ACCEL_SW_ASYNC_DEFAULT_NUM_WORKERS,
+};
+
+static struct spdk_accel_module_if g_sw_async_module;
+static struct spdk_accel_module_if *g_software_module;
+
+int
+accel_sw_async_enable(uint32_t num_workers)
+{
+	if (num_workers == 0 || num_workers > ACCEL_SW_ASYNC_MAX_WORKERS) {
+		SPDK_ERRLOG("Number of workers must be between 1 and %u\n", ACCEL_SW_ASYNC_MAX_WORKERS);
+		return -EINVAL;
+	}
+
+	g_sw_async.enabled = true;
+	g_sw_async.num_workers = num_workers;
+
+	return 0;
+}
+
+static void *
+accel_sw_async_worker_fn(void *arg)
+{
+	struct accel_sw_async_worker *worker = arg;
+	struct accel_sw_async_task *atask;
+	struct spdk_accel_task *task;
+	size_t count;
+
+	spdk_unaffinitize_thread();
+
+	while (true) {
+		if (sem_wait(&g_sw_async.sem) != 0) {
+			assert(errno == EINTR);
+			continue;
+		}
+		if (__atomic_load_n(&g_sw_async.stop, __ATOMIC_ACQUIRE)) {
+			break;
+		}
+
+		count = spdk_ring_dequeue(g_sw_async.ring, (void **)&task, 1);
+		if (spdk_unlikely(count == 0)) {
+			continue;
+		}
+
+		task->status = accel_sw_exec_task(worker->ctx, task);
+
+		atask = SPDK_CONTAINEROF(task, struct accel_sw_async_task, task);
+		count = spdk_ring_enqueue(atask->ch->cpl_ring, (void **)&task, 1, NULL);
+		assert(count == 1);
+	}
+
+	return NULL;
+}
+
+static void
+accel_sw_async_submit_queued(struct accel_sw_async_channel *ch)
+{
+	struct spdk_accel_task *tasks[ACCEL_SW_ASYNC_BATCH_SIZE], *task;
+	size_t i, count, num_submitted;
+
+	while (!STAILQ_EMPTY(&ch->queued_tasks)) {
+		count = 0;
+		while (count < SPDK_COUNTOF(tasks) &&
+		       ch->num_outstanding + count < ACCEL_SW_ASYNC_RING_SIZE - 1) {
+			task = STAILQ_FIRST(&ch->queued_tasks);
+			if (task == NULL) {
+				break;
+			}
+			STAILQ_REMOVE_HEAD(&ch->queued_tasks, link);
+			tasks[count++] = task;
+		}
+		if (count == 0) {
+			break;
+		}
+
+		num_submitted = spdk_ring_enqueue(g_sw_async.ring, (void **)tasks, count, NULL);
+		for (i = 0; i < num_submitted; ++i) {
+			sem_post(&g_sw_async.sem);
+		}
+		ch->num_outstanding += num_submitted;
+
+		if (num_submitted < count) {
+			/* The submission ring is full, put the remaining tasks back in order and
+			 * retry once some of the outstanding tasks are completed */
+			for (i = count; i > num_submitted; --i) {
+				STAILQ_INSERT_HEAD(&ch->queued_tasks, tasks[i - 1], link);
+			}
+			break;
+		}
+	}
+}
+
+static int
+accel_sw_async_submit_tasks(struct spdk_io_channel *_ch, struct spdk_accel_task *task)
+{
+	struct accel_sw_async_channel *ch = spdk_io_channel_get_ctx(_ch);
+	struct accel_sw_async_task *atask;
+	struct spdk_accel_task *next;
+
+	while (task != NULL) {
+		next = STAILQ_NEXT(task, link);
+		atask = SPDK_CONTAINEROF(task, struct accel_sw_async_task, task);
+		atask->ch = ch;
+		STAILQ_INSERT_TAIL(&ch->queued_tasks, task, link);
+		task = next;
+	}
+
+	accel_sw_async_submit_queued(ch);
+	spdk_poller_resume(ch->poller);
+
+	return 0;
+}
+
+static int
+accel_sw_async_poll(void *arg)
+{
+	struct accel_sw_async_channel *ch = arg;
+	struct spdk_accel_task *tasks[ACCEL_SW_ASYNC_BATCH_SIZE];
+	size_t i, count;
+
+	count = spdk_ring_dequeue(ch->cpl_ring, (void **)tasks, SPDK_COUNTOF(tasks));
+	assert(ch->num_outstanding >= count);
+	ch->num_outstanding -= count;
+
+	for (i = 0; i < count; ++i) {
+		spdk_accel_task_complete(tasks[i], tasks[i]->status);
+	}
+
+	accel_sw_async_submit_queued(ch);
+
+	/* The completion callbacks might have submitted more tasks */
+	if (ch->num_outstanding == 0 && STAILQ_EMPTY(&ch->queued_tasks)) {
+		spdk_poller_pause(ch->poller);
+	}
+
+	return count > 0 ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
+}
+
+static int
+accel_sw_async_create_cb(void *io_device, void *ctx_buf)
+{
+	struct accel_sw_async_channel *ch = ctx_buf;
+
+	ch->cpl_ring = spdk_ring_create(SPDK_RING_TYPE_MP_SC, ACCEL_SW_ASYNC_RING_SIZE,
+					SPDK_ENV_NUMA_ID_ANY);
+	if (ch->cpl_ring == NULL) {
+		SPDK_ERRLOG("Failed to allocate completion ring\n");
+		return -ENOMEM;
+	}
+
+	ch->poller = SPDK_POLLER_REGISTER(accel_sw_async_poll, ch, 0);
+	if (ch->poller == NULL) {
+		SPDK_ERRLOG("Failed to register completion poller\n");
+		spdk_ring_free(ch->cpl_ring);
+		return -ENOMEM;
+	}
+
+	/* Resumed once tasks are submitted */
+	spdk_poller_pause(ch->poller);
+	STAILQ_INIT(&ch->queued_tasks);
+	ch->num_outstanding = 0;
+
+	return 0;
+}
+
+static void
+accel_sw_async_destroy_cb(void *io_device, void *ctx_buf)
+{
+	struct accel_sw_async_channel *ch = ctx_buf;
+
+	assert(ch->num_outstanding == 0);
+	assert(STAILQ_EMPTY(&ch->queued_tasks));
+
+	spdk_poller_unregister(&ch->poller);
+	spdk_ring_free(ch->cpl_ring);
+}
+
+static void
+accel_sw_async_stop_workers(uint32_t num_workers)
+{
+	struct accel_sw_async_worker *worker;
+	uint32_t i;
+
+	__atomic_store_n(&g_sw_async.stop, true, __ATOMIC_RELEASE);
+	for (i = 0; i < num_workers; ++i) {
+		sem_post(&g_sw_async.sem);
+	}
+
+	for (i = 0; i < num_workers; ++i) {
+		worker = &g_sw_async.workers[i];
+		pthread_join(worker->thread, NULL);
+		accel_sw_exec_ctx_destroy(worker->ctx);
+	}
+
+	free(g_sw_async.workers);
+	g_sw_async.workers = NULL;
+	sem_destroy(&g_sw_async.sem);
+	spdk_ring_free(g_sw_async.ring);
+	g_sw_async.ring = NULL;
+}
+
+static int
+accel_sw_async_module_init(void)
+{
+	struct accel_sw_async_worker *worker;
+	uint32_t i;
+	int rc;
+
+	if (!g_sw_async.enabled) {
+		return -ENODEV;
+	}
+
+	g_software_module = spdk_accel_get_module("software");
+	if (g_software_module == NULL) {
+		/* Should never really happen */
+		return -ENOTSUP;
+	}
+
+	g_sw_async.ring = spdk_ring_create(SPDK_RING_TYPE_MP_MC, ACCEL_SW_ASYNC_RING_SIZE,
+					   SPDK_ENV_NUMA_ID_ANY);
+	if (g_sw_async.ring == NULL) {
+		SPDK_ERRLOG("Failed to allocate submission ring\n");
+		return -ENOMEM;
+	}
+
+	g_sw_async.workers = calloc(g_sw_async.num_workers, sizeof(*g_sw_async.workers));
+	if (g_sw_async.workers == NULL) {
+		spdk_ring_free(g_sw_async.ring);
+		return -ENOMEM;
+	}
+
+	rc = sem_init(&g_sw_async.sem, 0, 0);
+	if (rc != 0) {
+		rc = -errno;
+		SPDK_ERRLOG("Failed to initialize semaphore: %s\n", spdk_strerror(-rc));
+		free(g_sw_async.workers);
+		g_sw_async.workers = NULL;
+		spdk_ring_free(g_sw_async.ring);
+		g_sw_async.ring = NULL;
+		return rc;
+	}
+	g_sw_async.stop = false;
+
+	for (i = 0; i < g_sw_async.num_workers; ++i) {
+		worker = &g_sw_async.workers[i];
+		worker->ctx = accel_sw_exec_ctx_create();
+		if (worker->ctx == NULL) {
+			rc = -ENOMEM;
+			goto error;
+		}
+
+		rc = pthread_create(&worker->thread, NULL, accel_sw_async_worker_fn, worker);
+		if (rc != 0) {
+			SPDK_ERRLOG("Failed to create worker thread: %s\n", spdk_strerror(rc));
+			accel_sw_exec_ctx_destroy(worker->ctx);
+			rc = -rc;
+			goto error;
+		}
+		pthread_setname_np(worker->thread, "accel_sw_async");
+	}
+
+	spdk_io_device_register(&g_sw_async_module, accel_sw_async_create_cb,
+				accel_sw_async_destroy_cb, sizeof(struct accel_sw_async_channel),
+				"accel_sw_async");
+	SPDK_NOTICELOG("Accel software_async module started with %u workers\n",
+		       g_sw_async.num_workers);
+
+	return 0;
+error:
+	accel_sw_async_stop_workers(i);
+	return rc;
+}
+
+static void
+accel_sw_async_unregister_cb(void *unused)
+{
+	accel_sw_async_stop_workers(g_sw_async.num_workers);
+	spdk_accel_module_finish();
+}
+
+static void
+accel_sw_async_module_fini(void *unused)
+{
+	spdk_io_device_unregister(&g_sw_async_module, accel_sw_async_unregister_cb);
+}
+
+static bool
+accel_sw_async_supports_opcode(enum spdk_accel_opcode opcode)
+{
+	if (!g_sw_async.enabled) {
+		return false;
+	}
+
+	/* Crypto operations aren't supported, as the keys are bound to the module that created
+	 * them */
+	switch (opcode) {
+	case SPDK_ACCEL_OPC_CRC32C:
+	case SPDK_ACCEL_OPC_COPY_CRC32C:
+	case SPDK_ACCEL_OPC_COMPRESS:
+	case SPDK_ACCEL_OPC_DECOMPRESS:
+	case SPDK_ACCEL_OPC_XOR:
+	case SPDK_ACCEL_OPC_DIF_VERIFY:
+	case SPDK_ACCEL_OPC_DIF_GENERATE:
+	case SPDK_ACCEL_OPC_DIF_GENERATE_COPY:
+	case SPDK_ACCEL_OPC_DIF_VERIFY_COPY:
+	case SPDK_ACCEL_OPC_DIX_GENERATE:
+	case SPDK_ACCEL_OPC_DIX_VERIFY:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static struct spdk_io_channel *
+accel_sw_async_get_io_channel(void)
+{
+	return spdk_get_io_channel(&g_sw_async_module);
+}
+
+static size_t
+accel_sw_async_get_ctx_size(void)
+{
+	return sizeof(struct accel_sw_async_task);
+}
+
+static bool
+accel_sw_async_compress_supports_algo(enum spdk_accel_comp_algo algo)
+{
+	return g_software_module->compress_supports_algo(algo);
+}
+
+static int
+accel_sw_async_get_compress_level_range(enum spdk_accel_comp_algo algo,
+					uint32_t *min_level, uint32_t *max_level)
+{
+	return g_software_module->get_compress_level_range(algo, min_level, max_level);
+}
+
+static bool
+accel_sw_async_supports_fused_crc32c(enum spdk_accel_opcode opcode)
+{
+	return opcode == SPDK_ACCEL_OPC_DECOMPRESS;
+}
+
+static void
+accel_sw_async_write_config_json(struct spdk_json_write_ctx *w)
+{
+	if (!g_sw_async.enabled) {
+		return;
+	}
+
+	spdk_json_write_object_begin(w);
+	spdk_json_write_named_string(w, "method", "accel_sw_async_enable");
+	spdk_json_write_named_object_begin(w, "params");
+	spdk_json_write_named_uint32(w, "num_workers", g_sw_async.num_workers);
+	spdk_json_write_object_end(w);
+	spdk_json_write_object_end(w);
+}
+
+static struct spdk_accel_module_if g_sw_async_module = {
+	.name				= "software_async",
+	.priority			= INT_MIN,
+	.module_init			= accel_sw_async_module_init,
+	.module_fini			= accel_sw_async_module_fini,
+	.write_config_json		= accel_sw_async_write_config_json,
+	.get_ctx_size			= accel_sw_async_get_ctx_size,
+	.supports_opcode		= accel_sw_async_supports_opcode,
+	.get_io_channel			= accel_sw_async_get_io_channel,
+	.submit_tasks			= accel_sw_async_submit_tasks,
+	.compress_supports_algo		= accel_sw_async_compress_supports_algo,
+	.get_compress_level_range	= accel_sw_async_get_compress_level_range,
+	.supports_fused_crc32c		= accel_sw_async_supports_fused_crc32c,
+};
+
+SPDK_ACCEL_MODULE_REGISTER(sw_async, &g_sw_async_module)
@@ -10613,6 +10613,531 @@ spdk_bdev_copy_blocks(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
 	return 0;
 }
 
+#define BDEV_COPY_BETWEEN_QD_DEFAULT		8
+#define BDEV_COPY_BETWEEN_CHUNK_SIZE_DEFAULT	(64 * 1024)
+
+void
+spdk_bdev_copy_opts_init(struct spdk_bdev_copy_opts *opts, size_t size)
+{
+	if (opts == NULL) {
+		SPDK_ERRLOG("opts should not be NULL\n");
+		assert(opts != NULL);
+		return;
+	}
+	if (size == 0) {
+		SPDK_ERRLOG("size should not be zero\n");
+		assert(size != 0);
+		return;
+	}
+
+	memset(opts, 0, size);
+	opts->size = size;
+
+#define FIELD_OK(field) \
+        offsetof(struct spdk_bdev_copy_opts, field) + sizeof(opts->field) <= size
+
+#define SET_FIELD(field, value) \
+        if (FIELD_OK(field)) { \
+                opts->field = value; \
+        } \
+
+	SET_FIELD(queue_depth, BDEV_COPY_BETWEEN_QD_DEFAULT);
+	SET_FIELD(chunk_size, BDEV_COPY_BETWEEN_CHUNK_SIZE_DEFAULT);
+	SET_FIELD(max_bandwidth_mb_sec, 0);
+	SET_FIELD(progress_cb, NULL);
+	SET_FIELD(progress_cb_arg, NULL);
+
+	/* You should not remove this statement, but need to update the assert statement
+	 * if you add a new field, and also add a corresponding SET_FIELD statement */
+	SPDK_STATIC_ASSERT(sizeof(struct spdk_bdev_copy_opts) == 36, "Incorrect size");
+
+#undef FIELD_OK
+#undef SET_FIELD
+}
+
+static void
+bdev_copy_opts_copy(struct spdk_bdev_copy_opts *opts, const struct spdk_bdev_copy_opts *opts_src)
+{
+	size_t size = opts_src->size;
+
+#define FIELD_OK(field) \
+        offsetof(struct spdk_bdev_copy_opts, field) + sizeof(opts->field) <= size
+
+#define SET_FIELD(field) \
+        if (FIELD_OK(field)) { \
+                opts->field = opts_src->field; \
+        } \
+
+	SET_FIELD(queue_depth);
+	SET_FIELD(chunk_size);
+	SET_FIELD(max_bandwidth_mb_sec);
+	SET_FIELD(progress_cb);
+	SET_FIELD(progress_cb_arg);
+
+#undef FIELD_OK
+#undef SET_FIELD
+}
+
+enum bdev_copy_between_mode {
+	/* Same bdev with native copy support */
+	BDEV_COPY_BETWEEN_OFFLOAD,
+	/* Source buffers obtained through zcopy start/end */
+	BDEV_COPY_BETWEEN_ZCOPY,
+	/* Source buffers allocated by the source bdev from the iobuf pool */
+	BDEV_COPY_BETWEEN_READ_WRITE,
+};
+
+struct bdev_copy_between_ctx;
+
+struct bdev_copy_between_chunk {
+	struct bdev_copy_between_ctx		*ctx;
+	uint64_t				src_offset_blocks;
+	uint64_t				dst_offset_blocks;
+	uint64_t				num_bytes;
+	int					status;
+	/* I/O holding the source data buffer until the chunk has been written */
+	struct spdk_bdev_io			*src_io;
+	struct spdk_bdev_io_wait_entry		waitq_entry;
+	TAILQ_ENTRY(bdev_copy_between_chunk)	link;
+};
+
+struct bdev_copy_between_ctx {
+	struct spdk_bdev_desc			*src_desc;
+	struct spdk_io_channel			*src_ch;
+	struct spdk_bdev_desc			*dst_desc;
+	struct spdk_io_channel			*dst_ch;
+	uint32_t				src_block_size;
+	uint32_t				dst_block_size;
+	uint64_t				src_offset_blocks;
+	uint64_t				dst_offset_blocks;
+	uint64_t				remaining_bytes;
+	enum bdev_copy_between_mode		mode;
+	struct spdk_bdev_copy_opts		opts;
+	uint32_t				outstanding;
+	int					status;
+	bool					submitting;
+
+	struct {
+		bool				enabled;
+		uint64_t			last_tsc;
+		double				bytes_per_tsc;
+		double				bytes_available;
+		double				bytes_max;
+		struct spdk_poller		*poller;
+	} qos;
+
+	spdk_bdev_copy_between_cb		cb;
+	void					*cb_arg;
+	TAILQ_HEAD(, bdev_copy_between_chunk)	free_chunks;
+	struct bdev_copy_between_chunk		chunks[];
+};
+
+static void bdev_copy_between_submit(struct bdev_copy_between_ctx *ctx);
+static void bdev_copy_between_chunk_start(void *_chunk);
+static void bdev_copy_between_chunk_write(void *_chunk);
+
+static void
+bdev_copy_between_done(struct bdev_copy_between_ctx *ctx)
+{
+	spdk_poller_unregister(&ctx->qos.poller);
+	ctx->cb(ctx->cb_arg, ctx->status);
+	free(ctx);
+}
+
+static void
+bdev_copy_between_chunk_done(struct bdev_copy_between_chunk *chunk, int status)
+{
+	struct bdev_copy_between_ctx *ctx = chunk->ctx;
+
+	if (status == 0 && ctx->opts.progress_cb != NULL) {
+		/* Stopping after the last chunk has been submitted doesn't cancel anything */
+		if (!ctx->opts.progress_cb(ctx->opts.progress_cb_arg,
+					   chunk->num_bytes / ctx->src_block_size) &&
+		    ctx->remaining_bytes > 0) {
+			status = -ECANCELED;
+		}
+	}
+
+	if (status != 0 && ctx->status == 0) {
+		ctx->status = status;
+	}
+
+	assert(ctx->outstanding > 0);
+	ctx->outstanding--;
+	TAILQ_INSERT_TAIL(&ctx->free_chunks, chunk, link);
+
+	bdev_copy_between_submit(ctx);
+}
+
+static void
+bdev_copy_between_queue_io_wait(struct bdev_copy_between_chunk *chunk, struct spdk_bdev_desc *desc,
+				struct spdk_io_channel *ch, spdk_bdev_io_wait_cb cb_fn)
+{
+	int rc;
+
+	chunk->waitq_entry.bdev = spdk_bdev_desc_get_bdev(desc);
+	chunk->waitq_entry.cb_fn = cb_fn;
+	chunk->waitq_entry.cb_arg = chunk;
+
+	rc = spdk_bdev_queue_io_wait(chunk->waitq_entry.bdev, ch, &chunk->waitq_entry);
+	if (rc != 0) {
+		SPDK_ERRLOG("Queue IO failed, rc=%d\n", rc);
+		bdev_copy_between_chunk_done(chunk, rc);
+	}
+}
+
+static void
+bdev_copy_between_release_src_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct bdev_copy_between_chunk *chunk = cb_arg;
+
+	spdk_bdev_free_io(bdev_io);
+
+	if (!success && chunk->status == 0) {
+		chunk->status = -EIO;
+	}
+
+	bdev_copy_between_chunk_done(chunk, chunk->status);
+}
+
+static void
+bdev_copy_between_release_src(struct bdev_copy_between_chunk *chunk, int status)
+{
+	struct spdk_bdev_io *src_io = chunk->src_io;
+	int rc;
+
+	chunk->src_io = NULL;
+	chunk->status = status;
+
+	if (chunk->ctx->mode == BDEV_COPY_BETWEEN_ZCOPY) {
+		rc = spdk_bdev_zcopy_end(src_io, false, bdev_copy_between_release_src_done, chunk);
+		if (rc == 0) {
+			return;
+		}
+		chunk->status = status != 0 ? status : rc;
+	}
+
+	spdk_bdev_free_io(src_io);
+	bdev_copy_between_chunk_done(chunk, chunk->status);
+}
+
+static void
+bdev_copy_between_write_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct bdev_copy_between_chunk *chunk = cb_arg;
+
+	spdk_bdev_free_io(bdev_io);
+
+	bdev_copy_between_release_src(chunk, success ? 0 : -EIO);
+}
+
+static void
+bdev_copy_between_chunk_write(void *_chunk)
+{
+	struct bdev_copy_between_chunk *chunk = _chunk;
+	struct bdev_copy_between_ctx *ctx = chunk->ctx;
+	struct iovec *iovs;
+	int iovcnt, rc;
+
+	spdk_bdev_io_get_iovec(chunk->src_io, &iovs, &iovcnt);
+
+	rc = spdk_bdev_writev_blocks(ctx->dst_desc, ctx->dst_ch, iovs, iovcnt,
+				     chunk->dst_offset_blocks, chunk->num_bytes / ctx->dst_block_size,
+				     bdev_copy_between_write_done, chunk);
+	if (rc == -ENOMEM) {
+		bdev_copy_between_queue_io_wait(chunk, ctx->dst_desc, ctx->dst_ch,
+						bdev_copy_between_chunk_write);
+	} else if (rc != 0) {
+		bdev_copy_between_release_src(chunk, rc);
+	}
+}
+
+static void
+bdev_copy_between_read_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct bdev_copy_between_chunk *chunk = cb_arg;
+
+	if (!success) {
+		spdk_bdev_free_io(bdev_io);
+		bdev_copy_between_chunk_done(chunk, -EIO);
+		return;
+	}
+
+	chunk->src_io = bdev_io;
+
+	/* Another chunk has already failed, don't bother writing this one */
+	if (chunk->ctx->status != 0) {
+		bdev_copy_between_release_src(chunk, 0);
+		return;
+	}
+
+	bdev_copy_between_chunk_write(chunk);
+}
+
+static void
+bdev_copy_between_offload_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct bdev_copy_between_chunk *chunk = cb_arg;
+
+	spdk_bdev_free_io(bdev_io);
+
+	bdev_copy_between_chunk_done(chunk, success ? 0 : -EIO);
+}
+
+static void
+bdev_copy_between_chunk_start(void *_chunk)
+{
+	struct bdev_copy_between_chunk *chunk = _chunk;
+	struct bdev_copy_between_ctx *ctx = chunk->ctx;
+	uint64_t num_blocks = chunk->num_bytes / ctx->src_block_size;
+	int rc;
+
+	switch (ctx->mode) {
+	case BDEV_COPY_BETWEEN_OFFLOAD:
+		rc = spdk_bdev_copy_blocks(ctx->dst_desc, ctx->dst_ch, chunk->dst_offset_blocks,
+					   chunk->src_offset_blocks, num_blocks,
+					   bdev_copy_between_offload_done, chunk);
+		if (rc == -ENOMEM) {
+			bdev_copy_between_queue_io_wait(chunk, ctx->dst_desc, ctx->dst_ch,
+							bdev_copy_between_chunk_start);
+			return;
+		}
+		break;
+	case BDEV_COPY_BETWEEN_ZCOPY:
+		rc = spdk_bdev_zcopy_start(ctx->src_desc, ctx->src_ch, NULL, 0, chunk->src_offset_blocks,
+					   num_blocks, true, bdev_copy_between_read_done, chunk);
+		break;
+	case BDEV_COPY_BETWEEN_READ_WRITE:
+		rc = spdk_bdev_read_blocks(ctx->src_desc, ctx->src_ch, NULL, chunk->src_offset_blocks,
+					   num_blocks, bdev_copy_between_read_done, chunk);
+		break;
+	default:
+		assert(false);
+		rc = -EINVAL;
+		break;
+	}
+
+	if (rc == -ENOMEM) {
+		bdev_copy_between_queue_io_wait(chunk, ctx->src_desc, ctx->src_ch,
+						bdev_copy_between_chunk_start);
+	} else if (rc != 0) {
+		bdev_copy_between_chunk_done(chunk, rc);
+	}
+}
+
+static bool
+bdev_copy_between_consume_token(struct bdev_copy_between_ctx *ctx, uint64_t num_bytes)
+{
+	uint64_t now = spdk_get_ticks();
+
+	ctx->qos.bytes_available = spdk_min(ctx->qos.bytes_max,
+					    ctx->qos.bytes_available +
+					    (now - ctx->qos.last_tsc) * ctx->qos.bytes_per_tsc);
+	ctx->qos.last_tsc = now;
+	if (ctx->qos.bytes_available > 0.0) {
+		ctx->qos.bytes_available -= num_bytes;
+		return true;
+	}
+	return false;
+}
+
+static void
+bdev_copy_between_submit(struct bdev_copy_between_ctx *ctx)
+{
+	struct bdev_copy_between_chunk *chunk;
+	uint64_t num_bytes;
+
+	/* Chunks completed inline from within this loop will call back into it, so just
+	 * let the outer invocation pick up the freed chunks. */
+	if (ctx->submitting) {
+		return;
+	}
+	ctx->submitting = true;
+
+	while (ctx->status == 0 && ctx->remaining_bytes > 0) {
+		chunk = TAILQ_FIRST(&ctx->free_chunks);
+		if (chunk == NULL) {
+			break;
+		}
+
+		num_bytes = spdk_min(ctx->remaining_bytes, ctx->opts.chunk_size);
+		if (ctx->qos.enabled) {
+			if (!bdev_copy_between_consume_token(ctx, num_bytes)) {
+				spdk_poller_resume(ctx->qos.poller);
+				break;
+			}
+			spdk_poller_pause(ctx->qos.poller);
+		}
+
+		TAILQ_REMOVE(&ctx->free_chunks, chunk, link);
+		chunk->src_offset_blocks = ctx->src_offset_blocks;
+		chunk->dst_offset_blocks = ctx->dst_offset_blocks;
+		chunk->num_bytes = num_bytes;
+		chunk->status = 0;
+		chunk->src_io = NULL;
+
+		ctx->src_offset_blocks += num_bytes / ctx->src_block_size;
+		ctx->dst_offset_blocks += num_bytes / ctx->dst_block_size;
+		ctx->remaining_bytes -= num_bytes;
+		ctx->outstanding++;
+
+		bdev_copy_between_chunk_start(chunk);
+	}
+
+	ctx->submitting = false;
+
+	if (ctx->outstanding == 0 && (ctx->status != 0 || ctx->remaining_bytes == 0)) {
+		bdev_copy_between_done(ctx);
+	}
+}
+
+static void
+bdev_copy_between_start(void *_ctx)
+{
+	bdev_copy_between_submit(_ctx);
+}
+
+static int
+bdev_copy_between_qos_poll(void *arg)
+{
+	/* The context may be freed by the submit call, so don't touch it afterwards */
+	bdev_copy_between_submit(arg);
+
+	return SPDK_POLLER_BUSY;
+}
+
+int
+spdk_bdev_copy_between(struct spdk_bdev_desc *src_desc, struct spdk_io_channel *src_ch,
+		       uint64_t src_offset_blocks,
+		       struct spdk_bdev_desc *dst_desc, struct spdk_io_channel *dst_ch,
+		       uint64_t dst_offset_blocks, uint64_t num_blocks,
+		       const struct spdk_bdev_copy_opts *opts,
+		       spdk_bdev_copy_between_cb cb, void *cb_arg)
+{
+	struct spdk_bdev *src_bdev = spdk_bdev_desc_get_bdev(src_desc);
+	struct spdk_bdev *dst_bdev = spdk_bdev_desc_get_bdev(dst_desc);
+	struct bdev_copy_between_ctx *ctx;
+	struct spdk_bdev_copy_opts copy_opts;
+	struct spdk_iobuf_opts iobuf_opts;
+	enum bdev_copy_between_mode mode;
+	uint32_t src_block_size, dst_block_size, md_size;
+	uint64_t num_bytes, dst_num_blocks, max_chunk_size;
+	uint32_t i;
+
+	if (!dst_desc->write) {
+		return -EBADF;
+	}
+
+	spdk_bdev_copy_opts_init(&copy_opts, sizeof(copy_opts));
+	if (opts != NULL) {
+		bdev_copy_opts_copy(&copy_opts, opts);
+	}
+
+	src_block_size = spdk_bdev_get_block_size(src_bdev);
+	dst_block_size = spdk_bdev_get_block_size(dst_bdev);
+	num_bytes = num_blocks * src_block_size;
+	dst_num_blocks = num_bytes / dst_block_size;
+
+	if (copy_opts.queue_depth == 0 || copy_opts.chunk_size == 0 ||
+	    copy_opts.chunk_size % src_block_size != 0 ||
+	    copy_opts.chunk_size % dst_block_size != 0 ||
+	    num_bytes % dst_block_size != 0) {
+		SPDK_ERRLOG("Invalid copy options: queue depth %u, chunk size %u\n",
+			    copy_opts.queue_depth, copy_opts.chunk_size);
+		return -EINVAL;
+	}
+
+	if (!bdev_io_valid_blocks(src_bdev, src_offset_blocks, num_blocks) ||
+	    !bdev_io_valid_blocks(dst_bdev, dst_offset_blocks, dst_num_blocks)) {
+		SPDK_DEBUGLOG(bdev, "Invalid offset or number of blocks: dst %lu, src %lu, count %lu\n",
+			      dst_offset_blocks, src_offset_blocks, num_blocks);
+		return -EINVAL;
+	}
+
+	if (src_bdev == dst_bdev && num_blocks != 0 && src_offset_blocks != dst_offset_blocks &&
+	    src_offset_blocks < dst_offset_blocks + num_blocks &&
+	    dst_offset_blocks < src_offset_blocks + num_blocks) {
+		SPDK_ERRLOG("Source and destination ranges overlap\n");
+		return -EINVAL;
+	}
+
+	if (src_bdev == dst_bdev && spdk_bdev_io_type_supported(src_bdev, SPDK_BDEV_IO_TYPE_COPY)) {
+		mode = BDEV_COPY_BETWEEN_OFFLOAD;
+	} else if (src_desc->write &&
+		   spdk_bdev_io_type_supported(src_bdev, SPDK_BDEV_IO_TYPE_ZCOPY)) {
+		mode = BDEV_COPY_BETWEEN_ZCOPY;
+	} else {
+		mode = BDEV_COPY_BETWEEN_READ_WRITE;
+	}
+
+	if (mode == BDEV_COPY_BETWEEN_READ_WRITE) {
+		/* Each chunk is read into a single iobuf large buffer, which also has to fit the
+		 * alignment and the separate metadata, so reduce the chunk size to fit in it. */
+		spdk_iobuf_get_opts(&iobuf_opts, sizeof(iobuf_opts));
+		max_chunk_size = iobuf_opts.large_bufsize - (spdk_bdev_get_buf_align(src_bdev) - 1);
+		md_size = spdk_bdev_is_md_separate(src_bdev) ? spdk_bdev_get_md_size(src_bdev) : 0;
+		max_chunk_size = max_chunk_size / (src_block_size + md_size) * src_block_size;
+		while (max_chunk_size % dst_block_size != 0) {
+			max_chunk_size -= src_block_size;
+		}
+		if (max_chunk_size == 0) {
+			SPDK_ERRLOG("Block size %u doesn't fit in an iobuf large buffer\n",
+				    src_block_size);
+			return -EINVAL;
+		}
+		copy_opts.chunk_size = spdk_min(copy_opts.chunk_size, max_chunk_size);
+	}
+
+	ctx = calloc(1, sizeof(*ctx) + copy_opts.queue_depth * sizeof(struct bdev_copy_between_chunk));
+	if (ctx == NULL) {
+		return -ENOMEM;
+	}
+
+	ctx->src_desc = src_desc;
+	ctx->src_ch = src_ch;
+	ctx->dst_desc = dst_desc;
+	ctx->dst_ch = dst_ch;
+	ctx->src_block_size = src_block_size;
+	ctx->dst_block_size = dst_block_size;
+	ctx->src_offset_blocks = src_offset_blocks;
+	ctx->dst_offset_blocks = dst_offset_blocks;
+	ctx->remaining_bytes = num_bytes;
+	ctx->opts = copy_opts;
+	ctx->cb = cb;
+	ctx->cb_arg = cb_arg;
+	ctx->mode = mode;
+
+	TAILQ_INIT(&ctx->free_chunks);
+	for (i = 0; i < copy_opts.queue_depth; i++) {
+		ctx->chunks[i].ctx = ctx;
+		TAILQ_INSERT_TAIL(&ctx->free_chunks, &ctx->chunks[i], link);
+	}
+
+	if (copy_opts.max_bandwidth_mb_sec != 0) {
+		ctx->qos.enabled = true;
+		ctx->qos.last_tsc = spdk_get_ticks();
+		ctx->qos.bytes_per_tsc = copy_opts.max_bandwidth_mb_sec * 1024 * 1024.0 /
+					 spdk_get_ticks_hz();
+		ctx->qos.bytes_max = copy_opts.max_bandwidth_mb_sec * 1024 * 1024.0 / SPDK_SEC_TO_MSEC;
+		ctx->qos.bytes_available = 0.0;
+		ctx->qos.poller = SPDK_POLLER_REGISTER(bdev_copy_between_qos_poll, ctx, 0);
+		if (ctx->qos.poller == NULL) {
+			free(ctx);
+			return -ENOMEM;
+		}
+		spdk_poller_pause(ctx->qos.poller);
+	}
+
+	SPDK_DEBUGLOG(bdev, "Copying %lu bytes from %s to %s (mode %d, qd %u, chunk %u)\n",
+		      num_bytes, src_bdev->name, dst_bdev->name, ctx->mode,
+		      copy_opts.queue_depth, copy_opts.chunk_size);
+
+	/* Always complete asynchronously, even if there's nothing to copy */
+	spdk_thread_send_msg(spdk_get_thread(), bdev_copy_between_start, ctx);
+
+	return 0;
+}
+
 SPDK_LOG_REGISTER_COMPONENT(bdev)
 
 static void
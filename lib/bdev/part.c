@@ -286,9 +286,8 @@ bdev_part_init_ext_io_opts(struct spdk_bdev_io *bdev_io, struct spdk_bdev_ext_io
 	opts->metadata = bdev_io->u.bdev.md_buf;
 }
 
-int
-spdk_bdev_part_submit_request_ext(struct spdk_bdev_part_channel *ch, struct spdk_bdev_io *bdev_io,
-				  spdk_bdev_io_completion_cb cb)
+static int
+bdev_part_submit_request(struct spdk_bdev_part_channel *ch, struct spdk_bdev_io *bdev_io)
 {
 	struct spdk_bdev_part *part = ch->part;
 	struct spdk_io_channel *base_ch = ch->base_ch;
@@ -297,11 +296,6 @@ spdk_bdev_part_submit_request_ext(struct spdk_bdev_part_channel *ch, struct spdk
 	uint64_t offset, remapped_offset, remapped_src_offset;
 	int rc = 0;
 
-	if (cb != NULL) {
-		bdev_io->internal.f.split = true;
-		bdev_io->internal.split.stored_user_cb = cb;
-	}
-
 	offset = bdev_io->u.bdev.offset_blocks;
 	remapped_offset = offset + part->internal.offset_blocks;
 
@@ -394,6 +388,51 @@ spdk_bdev_part_submit_request_ext(struct spdk_bdev_part_channel *ch, struct spdk
 	return rc;
 }
 
+static void
+bdev_part_get_buf_cb(struct spdk_io_channel *_ch, struct spdk_bdev_io *bdev_io, bool success)
+{
+	struct spdk_bdev_part_channel *ch = spdk_io_channel_get_ctx(_ch);
+	enum spdk_bdev_io_status status = SPDK_BDEV_IO_STATUS_FAILED;
+	int rc;
+
+	if (success) {
+		rc = bdev_part_submit_request(ch, bdev_io);
+		if (rc == 0) {
+			return;
+		}
+		if (rc == -ENOMEM) {
+			status = SPDK_BDEV_IO_STATUS_NOMEM;
+		}
+	}
+
+	if (bdev_io->internal.f.split) {
+		bdev_io->internal.split.stored_user_cb(bdev_io, false, NULL);
+	} else {
+		spdk_bdev_io_complete(bdev_io, status);
+	}
+}
+
+int
+spdk_bdev_part_submit_request_ext(struct spdk_bdev_part_channel *ch, struct spdk_bdev_io *bdev_io,
+				  spdk_bdev_io_completion_cb cb)
+{
+	if (cb != NULL) {
+		bdev_io->internal.f.split = true;
+		bdev_io->internal.split.stored_user_cb = cb;
+	}
+
+	/* Reads without a buffer must get one from the bdev layer rather than from the base
+	 * bdev, whose buffer would be released as soon as the base I/O completes.
+	 */
+	if (bdev_io->type == SPDK_BDEV_IO_TYPE_READ && bdev_io->u.bdev.iovs[0].iov_base == NULL) {
+		spdk_bdev_io_get_buf(bdev_io, bdev_part_get_buf_cb,
+				     bdev_io->u.bdev.num_blocks * bdev_io->bdev->blocklen);
+		return 0;
+	}
+
+	return bdev_part_submit_request(ch, bdev_io);
+}
+
 int
 spdk_bdev_part_submit_request(struct spdk_bdev_part_channel *ch, struct spdk_bdev_io *bdev_io)
 {
@@ -6,6 +6,7 @@
 
 #include "spdk/stdinc.h"
 
+#include "spdk/accel.h"
 #include "spdk/blob.h"
 #include "spdk/crc32.h"
 #include "spdk/env.h"
@@ -2924,6 +2925,131 @@ bs_allocate_and_copy_cluster(struct spdk_blob *blob,
 	}
 }
 
+/* Check if the cluster containing the given io_unit reads back as zeroes while it's unallocated,
+ * in which case writing zeroes to it doesn't need to allocate it. */
+static bool
+blob_unallocated_cluster_is_zeroes(struct spdk_blob *blob, uint64_t io_unit)
+{
+	struct spdk_bs_dev *back_bs_dev = blob->back_bs_dev;
+	uint64_t lba, lba_count;
+
+	assert(back_bs_dev != NULL);
+
+	lba = bs_dev_page_to_lba(back_bs_dev, bs_io_unit_to_cluster_start(blob, io_unit));
+	lba_count = bs_dev_byte_to_lba(back_bs_dev, blob->bs->cluster_sz);
+
+	return back_bs_dev->is_range_valid(back_bs_dev, lba, lba_count) &&
+	       back_bs_dev->is_zeroes(back_bs_dev, lba, lba_count);
+}
+
+struct blob_zero_check_ctx {
+	spdk_bs_user_op_t	*op;
+	struct iovec		iov;
+	bool			is_zero;
+};
+
+static void
+blob_zero_check_done(void *cb_arg, int status)
+{
+	struct blob_zero_check_ctx *ctx = cb_arg;
+	struct spdk_bs_request_set *set = (struct spdk_bs_request_set *)ctx->op;
+	struct spdk_bs_user_op_args *args = &set->u.user_op;
+	struct spdk_blob *blob = args->blob;
+	bool is_zero = status == 0 && ctx->is_zero;
+
+	free(ctx);
+
+	/* The blob could have been frozen or the cluster could have been allocated by another
+	 * write while the data was being checked, so let the op go through the regular path. */
+	if (blob->frozen_refcnt || bs_io_unit_is_allocated(blob, args->offset) ||
+	    !blob_unallocated_cluster_is_zeroes(blob, args->offset)) {
+		bs_user_op_execute(set);
+	} else if (is_zero) {
+		/* The cluster already reads back as zeroes, so there's nothing to write */
+		bs_user_op_abort(set, 0);
+	} else {
+		bs_allocate_and_copy_cluster(blob, spdk_io_channel_from_ctx(set->channel),
+					     args->offset, set);
+	}
+}
+
+static bool
+blob_iovs_all_zero(struct iovec *iovs, int iovcnt)
+{
+	int i;
+
+	for (i = 0; i < iovcnt; i++) {
+		if (!spdk_mem_all_zero(iovs[i].iov_base, iovs[i].iov_len)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Handle a write to an unallocated cluster.  If the cluster reads back as zeroes and the write
+ * only carries zeroes, it's completed without allocating the cluster, keeping thin provisioned
+ * blobs thin.  Otherwise, the cluster is allocated (and copied from the backing dev if needed). */
+static void
+blob_write_unallocated_cluster(struct spdk_blob *blob, struct spdk_io_channel *_ch,
+			       uint64_t io_unit, spdk_bs_user_op_t *op)
+{
+	struct spdk_bs_channel *ch = spdk_io_channel_get_ctx(_ch);
+	struct spdk_bs_request_set *set = (struct spdk_bs_request_set *)op;
+	struct spdk_bs_user_op_args *args = &set->u.user_op;
+	struct blob_zero_check_ctx *ctx;
+	struct iovec *iovs;
+	int iovcnt, rc;
+
+	/* Ops queued behind a cluster allocation are re-executed once it's done, so don't
+	 * reorder them by completing this one early. */
+	if (!TAILQ_EMPTY(&ch->need_cluster_alloc) ||
+	    !blob_unallocated_cluster_is_zeroes(blob, io_unit)) {
+		bs_allocate_and_copy_cluster(blob, _ch, io_unit, op);
+		return;
+	}
+
+	if (args->type == SPDK_BLOB_WRITE_ZEROES) {
+		bs_user_op_abort(op, 0);
+		return;
+	}
+
+	/* Payloads described by a memory domain might not be accessible by the CPU */
+	if (set->ext_io_opts != NULL && set->ext_io_opts->memory_domain != NULL) {
+		bs_allocate_and_copy_cluster(blob, _ch, io_unit, op);
+		return;
+	}
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		bs_allocate_and_copy_cluster(blob, _ch, io_unit, op);
+		return;
+	}
+
+	ctx->op = op;
+	if (args->type == SPDK_BLOB_WRITE) {
+		ctx->iov.iov_base = args->payload;
+		ctx->iov.iov_len = args->length * blob->bs->io_unit_size;
+		iovs = &ctx->iov;
+		iovcnt = 1;
+	} else {
+		assert(args->type == SPDK_BLOB_WRITEV);
+		iovs = args->payload;
+		iovcnt = args->iovcnt;
+	}
+
+	if (ch->accel_channel != NULL) {
+		rc = spdk_accel_submit_check_zero(ch->accel_channel, iovs, iovcnt, &ctx->is_zero,
+						  blob_zero_check_done, ctx);
+		if (spdk_likely(rc == 0)) {
+			return;
+		}
+	}
+
+	ctx->is_zero = blob_iovs_all_zero(iovs, iovcnt);
+	blob_zero_check_done(ctx, 0);
+}
+
 static inline bool
 blob_calculate_lba_and_lba_count(struct spdk_blob *blob, uint64_t io_unit, uint64_t length,
 				 uint64_t *lba,	uint64_t *lba_count)
@@ -3202,7 +3328,7 @@ blob_request_submit_op_single(struct spdk_io_channel *_ch, struct spdk_blob *blo
 				return;
 			}
 
-			bs_allocate_and_copy_cluster(blob, _ch, offset, op);
+			blob_write_unallocated_cluster(blob, _ch, offset, op);
 		}
 		break;
 	}
@@ -3513,7 +3639,7 @@ blob_request_submit_rw_iov(struct spdk_blob *blob, struct spdk_io_channel *_chan
 
 				op->ext_io_opts = ext_io_opts;
 
-				bs_allocate_and_copy_cluster(blob, _channel, offset, op);
+				blob_write_unallocated_cluster(blob, _channel, offset, op);
 			}
 		}
 	} else {
@@ -3624,6 +3750,9 @@ bs_channel_create(void *io_device, void *ctx_buf)
 		return -1;
 	}
 
+	/* Zero detection is offloaded to the accel framework when it's available */
+	channel->accel_channel = spdk_accel_get_io_channel();
+
 	TAILQ_INIT(&channel->need_cluster_alloc);
 	TAILQ_INIT(&channel->queued_io);
 	RB_INIT(&channel->esnap_channels);
@@ -3651,6 +3780,10 @@ bs_channel_destroy(void *io_device, void *ctx_buf)
 
 	blob_esnap_destroy_bs_channel(channel);
 
+	if (channel->accel_channel != NULL) {
+		spdk_put_io_channel(channel->accel_channel);
+	}
+
 	free(channel->req_mem);
 	spdk_free(channel->new_cluster_page);
 	channel->dev->destroy_channel(channel->dev, channel->dev_channel);
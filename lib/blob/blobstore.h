@@ -211,6 +211,10 @@ struct spdk_bs_channel {
 	struct spdk_bs_dev		*dev;
 	struct spdk_io_channel		*dev_channel;
 
+	/* Used to check whether data written to unallocated clusters is all zeroes. May be NULL,
+	 * in which case the check is done synchronously. */
+	struct spdk_io_channel		*accel_channel;
+
 	/* This page is only used during insert of a new cluster. */
 	struct spdk_blob_md_page	*new_cluster_page;
 
@@ -2604,13 +2604,21 @@ nvme_ctrlr_identify_active_ns(struct spdk_nvme_ctrlr *ctrlr)
 	return 0;
 }
 
+static int nvme_ctrlr_identify_namespaces_next(struct spdk_nvme_ctrlr *ctrlr);
+
 static void
 nvme_ctrlr_identify_ns_async_done(void *arg, const struct spdk_nvme_cpl *cpl)
 {
 	struct spdk_nvme_ns *ns = (struct spdk_nvme_ns *)arg;
 	struct spdk_nvme_ctrlr *ctrlr = ns->ctrlr;
-	uint32_t nsid;
-	int rc;
+
+	assert(ctrlr->identify_ns_outstanding > 0);
+	ctrlr->identify_ns_outstanding--;
+
+	if (ctrlr->state == NVME_CTRLR_STATE_ERROR) {
+		/* Another identify command already failed */
+		return;
+	}
 
 	if (spdk_nvme_cpl_is_error(cpl)) {
 		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_ERROR, NVME_TIMEOUT_INFINITE);
@@ -2619,21 +2627,7 @@ nvme_ctrlr_identify_ns_async_done(void *arg, const struct spdk_nvme_cpl *cpl)
 
 	nvme_ns_set_identify_data(ns);
 
-	/* move on to the next active NS */
-	nsid = spdk_nvme_ctrlr_get_next_active_ns(ctrlr, ns->id);
-	ns = spdk_nvme_ctrlr_get_ns(ctrlr, nsid);
-	if (ns == NULL) {
-		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_IDENTIFY_ID_DESCS,
-				     ctrlr->opts.admin_timeout_ms);
-		return;
-	}
-	ns->ctrlr = ctrlr;
-	ns->id = nsid;
-
-	rc = nvme_ctrlr_identify_ns_async(ns);
-	if (rc) {
-		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_ERROR, NVME_TIMEOUT_INFINITE);
-	}
+	nvme_ctrlr_identify_namespaces_next(ctrlr);
 }
 
 static int
@@ -2651,31 +2645,56 @@ nvme_ctrlr_identify_ns_async(struct spdk_nvme_ns *ns)
 				       nvme_ctrlr_identify_ns_async_done, ns);
 }
 
+/*
+ * Keep up to NVME_MAX_IDENTIFY_NS_OUTSTANDING identify namespace commands in flight, so that
+ * the time to identify all active namespaces does not grow with the admin queue round trip
+ * time multiplied by the number of namespaces.
+ */
 static int
-nvme_ctrlr_identify_namespaces(struct spdk_nvme_ctrlr *ctrlr)
+nvme_ctrlr_identify_namespaces_next(struct spdk_nvme_ctrlr *ctrlr)
 {
-	uint32_t nsid;
 	struct spdk_nvme_ns *ns;
+	uint32_t nsid;
 	int rc;
 
-	nsid = spdk_nvme_ctrlr_get_first_active_ns(ctrlr);
-	ns = spdk_nvme_ctrlr_get_ns(ctrlr, nsid);
-	if (ns == NULL) {
-		/* No active NS, move on to the next state */
+	while (ctrlr->identify_ns_next_nsid != 0 &&
+	       ctrlr->identify_ns_outstanding < NVME_MAX_IDENTIFY_NS_OUTSTANDING) {
+		nsid = ctrlr->identify_ns_next_nsid;
+		ctrlr->identify_ns_next_nsid = spdk_nvme_ctrlr_get_next_active_ns(ctrlr, nsid);
+
+		ns = spdk_nvme_ctrlr_get_ns(ctrlr, nsid);
+		if (ns == NULL) {
+			ctrlr->identify_ns_next_nsid = 0;
+			break;
+		}
+		ns->ctrlr = ctrlr;
+		ns->id = nsid;
+
+		ctrlr->identify_ns_outstanding++;
+		rc = nvme_ctrlr_identify_ns_async(ns);
+		if (rc) {
+			ctrlr->identify_ns_outstanding--;
+			nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_ERROR, NVME_TIMEOUT_INFINITE);
+			return rc;
+		}
+	}
+
+	if (ctrlr->identify_ns_outstanding == 0) {
+		/* All active namespaces were identified, move on to the next state */
 		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_IDENTIFY_ID_DESCS,
 				     ctrlr->opts.admin_timeout_ms);
-		return 0;
 	}
 
-	ns->ctrlr = ctrlr;
-	ns->id = nsid;
+	return 0;
+}
 
-	rc = nvme_ctrlr_identify_ns_async(ns);
-	if (rc) {
-		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_ERROR, NVME_TIMEOUT_INFINITE);
-	}
+static int
+nvme_ctrlr_identify_namespaces(struct spdk_nvme_ctrlr *ctrlr)
+{
+	ctrlr->identify_ns_next_nsid = spdk_nvme_ctrlr_get_first_active_ns(ctrlr);
+	ctrlr->identify_ns_outstanding = 0;
 
-	return rc;
+	return nvme_ctrlr_identify_namespaces_next(ctrlr);
 }
 
 static int
@@ -2836,20 +2855,28 @@ nvme_ctrlr_identify_namespaces_iocs_specific(struct spdk_nvme_ctrlr *ctrlr)
 	return nvme_ctrlr_identify_namespaces_iocs_specific_next(ctrlr, 0);
 }
 
+static int nvme_ctrlr_identify_id_desc_namespaces_next(struct spdk_nvme_ctrlr *ctrlr);
+
 static void
 nvme_ctrlr_identify_id_desc_async_done(void *arg, const struct spdk_nvme_cpl *cpl)
 {
 	struct spdk_nvme_ns *ns = (struct spdk_nvme_ns *)arg;
 	struct spdk_nvme_ctrlr *ctrlr = ns->ctrlr;
-	uint32_t nsid;
-	int rc;
+
+	assert(ctrlr->identify_ns_outstanding > 0);
+	ctrlr->identify_ns_outstanding--;
+
+	if (ctrlr->state == NVME_CTRLR_STATE_ERROR) {
+		return;
+	}
 
 	if (spdk_nvme_cpl_is_error(cpl)) {
 		/*
 		 * Many controllers claim to be compatible with NVMe 1.3, however,
 		 * they do not implement NS ID Desc List. Therefore, instead of setting
 		 * the state to NVME_CTRLR_STATE_ERROR, silently ignore the completion
-		 * error and move on to the next state.
+		 * error and move on to the next state once the commands that are still
+		 * outstanding have completed.
 		 *
 		 * The proper way is to create a new quirk for controllers that violate
 		 * the NVMe 1.3 spec by not supporting NS ID Desc List.
@@ -2857,26 +2884,12 @@ nvme_ctrlr_identify_id_desc_async_done(void *arg, const struct spdk_nvme_cpl *cp
 		 * it is too generic and was added in order to handle controllers that
 		 * violate the NVMe 1.1 spec by not supporting ACTIVE LIST).
 		 */
-		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_IDENTIFY_NS_IOCS_SPECIFIC,
-				     ctrlr->opts.admin_timeout_ms);
-		return;
-	}
-
-	nvme_ns_set_id_desc_list_data(ns);
-
-	/* move on to the next active NS */
-	nsid = spdk_nvme_ctrlr_get_next_active_ns(ctrlr, ns->id);
-	ns = spdk_nvme_ctrlr_get_ns(ctrlr, nsid);
-	if (ns == NULL) {
-		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_IDENTIFY_NS_IOCS_SPECIFIC,
-				     ctrlr->opts.admin_timeout_ms);
-		return;
+		ctrlr->identify_ns_next_nsid = 0;
+	} else {
+		nvme_ns_set_id_desc_list_data(ns);
 	}
 
-	rc = nvme_ctrlr_identify_id_desc_async(ns);
-	if (rc) {
-		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_ERROR, NVME_TIMEOUT_INFINITE);
-	}
+	nvme_ctrlr_identify_id_desc_namespaces_next(ctrlr);
 }
 
 static int
@@ -2894,12 +2907,43 @@ nvme_ctrlr_identify_id_desc_async(struct spdk_nvme_ns *ns)
 }
 
 static int
-nvme_ctrlr_identify_id_desc_namespaces(struct spdk_nvme_ctrlr *ctrlr)
+nvme_ctrlr_identify_id_desc_namespaces_next(struct spdk_nvme_ctrlr *ctrlr)
 {
-	uint32_t nsid;
 	struct spdk_nvme_ns *ns;
+	uint32_t nsid;
 	int rc;
 
+	while (ctrlr->identify_ns_next_nsid != 0 &&
+	       ctrlr->identify_ns_outstanding < NVME_MAX_IDENTIFY_NS_OUTSTANDING) {
+		nsid = ctrlr->identify_ns_next_nsid;
+		ctrlr->identify_ns_next_nsid = spdk_nvme_ctrlr_get_next_active_ns(ctrlr, nsid);
+
+		ns = spdk_nvme_ctrlr_get_ns(ctrlr, nsid);
+		if (ns == NULL) {
+			ctrlr->identify_ns_next_nsid = 0;
+			break;
+		}
+
+		ctrlr->identify_ns_outstanding++;
+		rc = nvme_ctrlr_identify_id_desc_async(ns);
+		if (rc) {
+			ctrlr->identify_ns_outstanding--;
+			nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_ERROR, NVME_TIMEOUT_INFINITE);
+			return rc;
+		}
+	}
+
+	if (ctrlr->identify_ns_outstanding == 0) {
+		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_IDENTIFY_NS_IOCS_SPECIFIC,
+				     ctrlr->opts.admin_timeout_ms);
+	}
+
+	return 0;
+}
+
+static int
+nvme_ctrlr_identify_id_desc_namespaces(struct spdk_nvme_ctrlr *ctrlr)
+{
 	if ((ctrlr->vs.raw < SPDK_NVME_VERSION(1, 3, 0) &&
 	     !(ctrlr->cap.bits.css & SPDK_NVME_CAP_CSS_IOCS)) ||
 	    (ctrlr->quirks & NVME_QUIRK_IDENTIFY_CNS)) {
@@ -2910,21 +2954,10 @@ nvme_ctrlr_identify_id_desc_namespaces(struct spdk_nvme_ctrlr *ctrlr)
 		return 0;
 	}
 
-	nsid = spdk_nvme_ctrlr_get_first_active_ns(ctrlr);
-	ns = spdk_nvme_ctrlr_get_ns(ctrlr, nsid);
-	if (ns == NULL) {
-		/* No active NS, move on to the next state */
-		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_IDENTIFY_NS_IOCS_SPECIFIC,
-				     ctrlr->opts.admin_timeout_ms);
-		return 0;
-	}
-
-	rc = nvme_ctrlr_identify_id_desc_async(ns);
-	if (rc) {
-		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_ERROR, NVME_TIMEOUT_INFINITE);
-	}
+	ctrlr->identify_ns_next_nsid = spdk_nvme_ctrlr_get_first_active_ns(ctrlr);
+	ctrlr->identify_ns_outstanding = 0;
 
-	return rc;
+	return nvme_ctrlr_identify_id_desc_namespaces_next(ctrlr);
 }
 
 static void
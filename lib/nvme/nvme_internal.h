@@ -151,6 +151,12 @@ extern struct spdk_nvme_transport_opts g_spdk_nvme_transport_opts;
 
 #define NVME_MAX_ASYNC_EVENTS	(8)
 
+/*
+ * Maximum number of per namespace identify commands that are submitted at once during
+ * controller initialization.
+ */
+#define NVME_MAX_IDENTIFY_NS_OUTSTANDING	(8)
+
 #define NVME_MAX_ADMIN_TIMEOUT_IN_SECS	(30)
 
 /* Maximum log page size to fetch for AERs. */
@@ -988,6 +994,10 @@ struct spdk_nvme_ctrlr {
 	int				state;
 	uint64_t			state_timeout_tsc;
 
+	/* Per namespace identify commands are pipelined during initialization */
+	uint32_t			identify_ns_next_nsid;
+	uint32_t			identify_ns_outstanding;
+
 	uint64_t			next_keep_alive_tick;
 	uint64_t			keep_alive_interval_ticks;
 
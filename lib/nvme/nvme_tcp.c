@@ -1519,6 +1519,33 @@ nvme_tcp_accel_recv_compute_crc32(struct nvme_tcp_req *treq, struct nvme_tcp_pdu
 	return false;
 }
 
+/*
+ * Decide whether the data digest of a C2H PDU should be accumulated while its payload is read
+ * from the socket.  Doing so saves a second pass over the (by then likely evicted) data, but
+ * is only worth it if the digest won't be offloaded to accel anyway.
+ */
+static bool
+nvme_tcp_pdu_recv_ddgst_inline(struct nvme_tcp_qpair *tqpair, struct nvme_tcp_pdu *pdu)
+{
+	struct nvme_tcp_req *treq = pdu->req;
+	struct nvme_tcp_poll_group *tgroup;
+
+	if (spdk_unlikely(treq == NULL || pdu->dif_ctx != NULL)) {
+		return false;
+	}
+
+	if (tqpair->qpair.poll_group == NULL ||
+	    pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT != 0 ||
+	    pdu->data_len != treq->req->payload_size) {
+		return true;
+	}
+
+	tgroup = nvme_tcp_poll_group(tqpair->qpair.poll_group);
+
+	return tgroup->group.group->accel_fn_table.append_crc32c == NULL &&
+	       tgroup->group.group->accel_fn_table.submit_accel_crc32c == NULL;
+}
+
 static void
 nvme_tcp_pdu_payload_handle(struct nvme_tcp_qpair *tqpair,
 			    uint32_t *reaped)
@@ -1540,11 +1567,15 @@ nvme_tcp_pdu_payload_handle(struct nvme_tcp_qpair *tqpair,
 	if (pdu->ddgst_enable) {
 		/* But if the data digest is enabled, tcp_req cannot be NULL */
 		assert(tcp_req != NULL);
-		if (nvme_tcp_accel_recv_compute_crc32(tcp_req, pdu)) {
-			return;
-		}
+		if (pdu->ddgst_inline) {
+			crc32c = nvme_tcp_pdu_pad_data_digest(pdu, pdu->data_digest_crc32);
+		} else {
+			if (nvme_tcp_accel_recv_compute_crc32(tcp_req, pdu)) {
+				return;
+			}
 
-		crc32c = nvme_tcp_pdu_calc_data_digest(pdu);
+			crc32c = nvme_tcp_pdu_calc_data_digest(pdu);
+		}
 		crc32c = crc32c ^ SPDK_CRC32C_XOR;
 		rc = MATCH_DIGEST_WORD(pdu->data_digest, crc32c);
 		if (rc == 0) {
@@ -2099,6 +2130,10 @@ nvme_tcp_read_pdu(struct nvme_tcp_qpair *tqpair, uint32_t *reaped, uint32_t max_
 					  tqpair->flags.host_ddgst_enable)) {
 				data_len += SPDK_NVME_TCP_DIGEST_LEN;
 				pdu->ddgst_enable = true;
+				if (pdu->rw_offset == 0) {
+					pdu->ddgst_inline = nvme_tcp_pdu_recv_ddgst_inline(tqpair, pdu);
+					pdu->data_digest_crc32 = SPDK_CRC32C_XOR;
+				}
 			}
 
 			rc = nvme_tcp_read_payload_data(tqpair->sock, pdu);
@@ -2107,6 +2142,10 @@ nvme_tcp_read_pdu(struct nvme_tcp_qpair *tqpair, uint32_t *reaped, uint32_t max_
 				break;
 			}
 
+			if (pdu->ddgst_inline) {
+				nvme_tcp_pdu_update_data_digest(pdu, pdu->rw_offset, rc);
+			}
+
 			pdu->rw_offset += rc;
 			if (pdu->rw_offset < data_len) {
 				return NVME_TCP_PDU_IN_PROGRESS;
@@ -19,6 +19,8 @@
 #define NVMF_AUTH_FAILURE1_DELAY_US	(100ull * 1000)
 #define NVMF_AUTH_DIGEST_MAX_SIZE	64
 #define NVMF_AUTH_DH_KEY_MAX_SIZE	1024
+#define NVMF_AUTH_DEFAULT_QUEUE_DEPTH	256
+#define NVMF_AUTH_QUEUE_RETRY_US	1000
 
 #define AUTH_ERRLOG(q, fmt, ...) \
 	SPDK_ERRLOG("[%s:%s:%u] " fmt, (q)->ctrlr->subsys->subnqn, (q)->ctrlr->hostnqn, \
@@ -40,6 +42,48 @@ enum nvmf_qpair_auth_state {
 	NVMF_QPAIR_AUTH_ERROR,
 };
 
+struct nvmf_auth_job;
+typedef void (*nvmf_auth_job_fn)(struct nvmf_auth_job *job);
+
+/* DH and HMAC computations of a single message, executed by one of the authentication threads
+ * or, if there are none, directly on the qpair's thread.  A job only accesses its own fields
+ * and the request's payload until it is handed back to the qpair's thread.
+ */
+struct nvmf_auth_job {
+	struct spdk_nvmf_request	*req;
+	struct spdk_thread		*thread;
+	nvmf_auth_job_fn		exec_fn;
+	nvmf_auth_job_fn		done_fn;
+	struct spdk_poller		*retry_poller;
+	int				fail_reason;
+	int				digest;
+	int				dhgroup;
+	uint16_t			tid;
+	uint32_t			seqnum;
+	const char			*hostnqn;
+	const char			*subnqn;
+	struct spdk_key			*key;
+	struct spdk_key			*ckey;
+	struct spdk_nvme_dhchap_dhkey	*dhkey;
+	struct spdk_nvmf_dhchap_reply	*reply;
+	uint8_t				cval[NVMF_AUTH_DIGEST_MAX_SIZE];
+	uint8_t				dhv[NVMF_AUTH_DH_KEY_MAX_SIZE];
+	size_t				dhvlen;
+	STAILQ_ENTRY(nvmf_auth_job)	link;
+};
+
+struct nvmf_auth_workers {
+	pthread_mutex_t			mutex;
+	pthread_cond_t			cond;
+	STAILQ_HEAD(, nvmf_auth_job)	jobs;
+	/* Jobs queued or being executed */
+	uint32_t			num_jobs;
+	uint32_t			queue_depth;
+	uint32_t			num_threads;
+	bool				exit;
+	pthread_t			threads[];
+};
+
 struct spdk_nvmf_qpair_auth {
 	enum nvmf_qpair_auth_state	state;
 	struct spdk_poller		*poller;
@@ -51,6 +95,11 @@ struct spdk_nvmf_qpair_auth {
 	uint32_t			seqnum;
 	struct spdk_nvme_dhchap_dhkey	*dhkey;
 	bool				cvalid;
+	bool				job_inflight;
+	/* Start of the transaction and of the message being processed */
+	uint64_t			start_tsc;
+	uint64_t			phase_tsc;
+	struct nvmf_auth_job		job;
 };
 
 struct nvmf_auth_common_header {
@@ -219,6 +268,170 @@ nvmf_auth_get_message(struct spdk_nvmf_request *req, size_t size)
 	return NULL;
 }
 
+static void
+nvmf_auth_job_done(void *ctx)
+{
+	struct nvmf_auth_job *job = ctx;
+	struct spdk_nvmf_qpair_auth *auth = job->req->qpair->auth;
+
+	assert(auth->job_inflight);
+	auth->job_inflight = false;
+	job->done_fn(job);
+}
+
+static void
+nvmf_auth_job_execute(struct nvmf_auth_workers *workers, struct nvmf_auth_job *job)
+{
+	int rc;
+
+	job->exec_fn(job);
+
+	/* The job mustn't be touched once it's sent back, as it's part of the qpair */
+	do {
+		rc = spdk_thread_send_msg(job->thread, nvmf_auth_job_done, job);
+		if (spdk_unlikely(rc != 0)) {
+			assert(rc == -ENOMEM);
+			usleep(NVMF_AUTH_QUEUE_RETRY_US);
+		}
+	} while (rc != 0);
+
+	pthread_mutex_lock(&workers->mutex);
+	assert(workers->num_jobs > 0);
+	workers->num_jobs--;
+	pthread_mutex_unlock(&workers->mutex);
+}
+
+static void *
+nvmf_auth_worker(void *ctx)
+{
+	struct nvmf_auth_workers *workers = ctx;
+	struct nvmf_auth_job *job;
+
+	pthread_mutex_lock(&workers->mutex);
+	while (true) {
+		while (STAILQ_EMPTY(&workers->jobs) && !workers->exit) {
+			pthread_cond_wait(&workers->cond, &workers->mutex);
+		}
+
+		job = STAILQ_FIRST(&workers->jobs);
+		if (job == NULL) {
+			break;
+		}
+
+		STAILQ_REMOVE_HEAD(&workers->jobs, link);
+		pthread_mutex_unlock(&workers->mutex);
+		nvmf_auth_job_execute(workers, job);
+		pthread_mutex_lock(&workers->mutex);
+	}
+	pthread_mutex_unlock(&workers->mutex);
+
+	return NULL;
+}
+
+static bool
+nvmf_auth_workers_enqueue(struct nvmf_auth_workers *workers, struct nvmf_auth_job *job)
+{
+	pthread_mutex_lock(&workers->mutex);
+	if (workers->num_jobs >= workers->queue_depth) {
+		pthread_mutex_unlock(&workers->mutex);
+		return false;
+	}
+
+	workers->num_jobs++;
+	STAILQ_INSERT_TAIL(&workers->jobs, job, link);
+	pthread_cond_signal(&workers->cond);
+	pthread_mutex_unlock(&workers->mutex);
+
+	return true;
+}
+
+static int
+nvmf_auth_job_retry(void *ctx)
+{
+	struct nvmf_auth_job *job = ctx;
+	struct nvmf_auth_workers *workers = job->req->qpair->group->tgt->auth_workers;
+
+	if (!nvmf_auth_workers_enqueue(workers, job)) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	spdk_poller_unregister(&job->retry_poller);
+
+	return SPDK_POLLER_BUSY;
+}
+
+static void
+nvmf_auth_job_submit(struct nvmf_auth_job *job, nvmf_auth_job_fn exec_fn, nvmf_auth_job_fn done_fn)
+{
+	struct spdk_nvmf_qpair *qpair = job->req->qpair;
+	struct nvmf_auth_workers *workers = qpair->group->tgt->auth_workers;
+
+	assert(!qpair->auth->job_inflight);
+	qpair->auth->job_inflight = true;
+	job->thread = spdk_get_thread();
+	job->exec_fn = exec_fn;
+	job->done_fn = done_fn;
+	job->fail_reason = 0;
+
+	if (workers == NULL) {
+		exec_fn(job);
+		nvmf_auth_job_done(job);
+		return;
+	}
+
+	if (nvmf_auth_workers_enqueue(workers, job)) {
+		return;
+	}
+
+	/* Too many computations are pending, wait for some of them to be done instead of
+	 * delaying the I/O on this thread.
+	 */
+	qpair->group->stat.auth_deferred++;
+	job->retry_poller = SPDK_POLLER_REGISTER(nvmf_auth_job_retry, job, NVMF_AUTH_QUEUE_RETRY_US);
+	if (job->retry_poller == NULL) {
+		exec_fn(job);
+		nvmf_auth_job_done(job);
+	}
+}
+
+/* Returns false (and completes the request) if the transaction moved on while the job was
+ * executed, e.g. because it timed out.
+ */
+static bool
+nvmf_auth_job_check_state(struct nvmf_auth_job *job, enum nvmf_qpair_auth_state state)
+{
+	struct spdk_nvmf_request *req = job->req;
+	struct spdk_nvmf_qpair *qpair = req->qpair;
+
+	if (qpair->auth->state != state) {
+		AUTH_ERRLOG(qpair, "auth state changed to %s while processing a message\n",
+			    nvmf_auth_get_state_name(qpair->auth->state));
+		nvmf_auth_request_complete(req, SPDK_NVME_SCT_GENERIC,
+					   SPDK_NVME_SC_COMMAND_SEQUENCE_ERROR, 1);
+		return false;
+	}
+
+	return true;
+}
+
+static void
+nvmf_auth_stat_phase(uint64_t *count, uint64_t *ticks, uint64_t start_tsc)
+{
+	(*count)++;
+	*ticks += spdk_get_ticks() - start_tsc;
+}
+
+static void
+nvmf_auth_completed(struct spdk_nvmf_qpair *qpair)
+{
+	struct spdk_nvmf_qpair_auth *auth = qpair->auth;
+	struct spdk_nvmf_poll_group_stat *stat = &qpair->group->stat;
+
+	nvmf_auth_stat_phase(&stat->auth_completed, &stat->auth_ticks, auth->start_tsc);
+	nvmf_auth_set_state(qpair, NVMF_QPAIR_AUTH_COMPLETED);
+	nvmf_auth_qpair_cleanup(auth);
+}
+
 static void
 nvmf_auth_negotiate_exec(struct spdk_nvmf_request *req, struct spdk_nvmf_auth_negotiate *msg)
 {
@@ -338,139 +551,193 @@ nvmf_auth_negotiate_exec(struct spdk_nvmf_request *req, struct spdk_nvmf_auth_ne
 	nvmf_auth_request_complete(req, SPDK_NVME_SCT_GENERIC, SPDK_NVME_SC_SUCCESS, 0);
 }
 
+static void
+nvmf_auth_reply_compute(struct nvmf_auth_job *job)
+{
+	struct spdk_nvmf_qpair *qpair = job->req->qpair;
+	struct spdk_nvmf_dhchap_reply *msg = job->reply;
+	uint8_t response[NVMF_AUTH_DIGEST_MAX_SIZE];
+	uint8_t dhsec[NVMF_AUTH_DH_KEY_MAX_SIZE];
+	size_t dhseclen = 0;
+	uint8_t hl;
+	int rc;
+
+	hl = spdk_nvme_dhchap_get_digest_length(job->digest);
+	if (job->dhgroup != SPDK_NVMF_DHCHAP_DHGROUP_NULL) {
+		AUTH_LOGDUMP("host pubkey:", &msg->rval[2 * hl], msg->dhvlen);
+		dhseclen = sizeof(dhsec);
+		rc = spdk_nvme_dhchap_dhkey_derive_secret(job->dhkey, &msg->rval[2 * hl],
+				msg->dhvlen, dhsec, &dhseclen);
+		if (rc != 0) {
+			AUTH_ERRLOG(qpair, "couldn't derive DH secret\n");
+			job->fail_reason = SPDK_NVMF_AUTH_FAILED;
+			return;
+		}
+
+		AUTH_LOGDUMP("dh secret:", dhsec, dhseclen);
+	}
+
+	assert(hl <= sizeof(response) && hl <= sizeof(job->cval));
+	rc = spdk_nvme_dhchap_calculate(job->key, (enum spdk_nvmf_dhchap_hash)job->digest,
+					"HostHost", job->seqnum, job->tid, 0,
+					job->hostnqn, job->subnqn,
+					dhseclen > 0 ? dhsec : NULL, dhseclen,
+					job->cval, response);
+	if (rc != 0) {
+		AUTH_ERRLOG(qpair, "failed to calculate challenge response: %s\n",
+			    spdk_strerror(-rc));
+		job->fail_reason = SPDK_NVMF_AUTH_FAILED;
+		return;
+	}
+
+	if (memcmp(msg->rval, response, hl) != 0) {
+		AUTH_ERRLOG(qpair, "challenge response mismatch\n");
+		AUTH_LOGDUMP("response:", msg->rval, hl);
+		AUTH_LOGDUMP("expected:", response, hl);
+		job->fail_reason = SPDK_NVMF_AUTH_FAILED;
+		return;
+	}
+
+	if (msg->cvalid) {
+		rc = spdk_nvme_dhchap_calculate(job->ckey, (enum spdk_nvmf_dhchap_hash)job->digest,
+						"Controller", msg->seqnum, job->tid, 0,
+						job->subnqn, job->hostnqn,
+						dhseclen > 0 ? dhsec : NULL, dhseclen,
+						&msg->rval[hl], job->cval);
+		if (rc != 0) {
+			AUTH_ERRLOG(qpair, "failed to calculate ctrlr challenge response: %s\n",
+				    spdk_strerror(-rc));
+			job->fail_reason = SPDK_NVMF_AUTH_FAILED;
+			return;
+		}
+	}
+}
+
+static void
+nvmf_auth_reply_done(struct nvmf_auth_job *job)
+{
+	struct spdk_nvmf_request *req = job->req;
+	struct spdk_nvmf_qpair *qpair = req->qpair;
+	struct spdk_nvmf_qpair_auth *auth = qpair->auth;
+	struct spdk_nvmf_poll_group_stat *stat = &qpair->group->stat;
+
+	spdk_keyring_put_key(job->ckey);
+	spdk_keyring_put_key(job->key);
+	spdk_nvme_dhchap_dhkey_free(&job->dhkey);
+	job->ckey = job->key = NULL;
+
+	if (!nvmf_auth_job_check_state(job, NVMF_QPAIR_AUTH_REPLY)) {
+		return;
+	}
+	if (job->fail_reason != 0) {
+		nvmf_auth_request_fail1(req, job->fail_reason);
+		return;
+	}
+	if (job->reply->cvalid) {
+		memcpy(auth->cval, job->cval, sizeof(auth->cval));
+		auth->cvalid = true;
+	}
+
+	if (nvmf_auth_rearm_poller(qpair)) {
+		nvmf_auth_request_complete(req, SPDK_NVME_SCT_GENERIC,
+					   SPDK_NVME_SC_INTERNAL_DEVICE_ERROR, 1);
+		nvmf_auth_disconnect_qpair(qpair);
+		return;
+	}
+
+	nvmf_auth_stat_phase(&stat->auth_replies, &stat->auth_reply_ticks, auth->phase_tsc);
+	nvmf_auth_set_state(qpair, NVMF_QPAIR_AUTH_SUCCESS1);
+	nvmf_auth_request_complete(req, SPDK_NVME_SCT_GENERIC, SPDK_NVME_SC_SUCCESS, 0);
+}
+
 static void
 nvmf_auth_reply_exec(struct spdk_nvmf_request *req, struct spdk_nvmf_dhchap_reply *msg)
 {
 	struct spdk_nvmf_qpair *qpair = req->qpair;
 	struct spdk_nvmf_ctrlr *ctrlr = qpair->ctrlr;
 	struct spdk_nvmf_qpair_auth *auth = qpair->auth;
-	uint8_t response[NVMF_AUTH_DIGEST_MAX_SIZE];
-	uint8_t dhsec[NVMF_AUTH_DH_KEY_MAX_SIZE];
+	struct nvmf_auth_job *job = &auth->job;
 	struct spdk_key *key = NULL, *ckey = NULL;
-	size_t dhseclen = 0;
 	uint8_t hl;
-	int rc;
 
 	if (auth->state != NVMF_QPAIR_AUTH_REPLY) {
 		AUTH_ERRLOG(qpair, "invalid state=%s\n", nvmf_auth_get_state_name(auth->state));
 		nvmf_auth_request_fail1(req, SPDK_NVMF_AUTH_INCORRECT_PROTOCOL_MESSAGE);
-		goto out;
+		return;
 	}
 	if (req->length < sizeof(*msg)) {
 		AUTH_ERRLOG(qpair, "invalid message length=%"PRIu32"\n", req->length);
 		nvmf_auth_request_fail1(req, SPDK_NVMF_AUTH_INCORRECT_PAYLOAD);
-		goto out;
+		return;
 	}
 
 	hl = spdk_nvme_dhchap_get_digest_length(auth->digest);
 	if (hl == 0 || msg->hl != hl) {
 		AUTH_ERRLOG(qpair, "hash length mismatch: %u != %u\n", msg->hl, hl);
 		nvmf_auth_request_fail1(req, SPDK_NVMF_AUTH_INCORRECT_PAYLOAD);
-		goto out;
+		return;
 	}
 	if ((msg->dhvlen % 4) != 0) {
 		AUTH_ERRLOG(qpair, "dhvlen=%u is not multiple of 4\n", msg->dhvlen);
 		nvmf_auth_request_fail1(req, SPDK_NVMF_AUTH_INCORRECT_PAYLOAD);
-		goto out;
+		return;
 	}
 	if (req->length != sizeof(*msg) + 2 * hl + msg->dhvlen) {
 		AUTH_ERRLOG(qpair, "invalid message length: %"PRIu32" != %zu\n",
 			    req->length, sizeof(*msg) + 2 * hl);
 		nvmf_auth_request_fail1(req, SPDK_NVMF_AUTH_INCORRECT_PAYLOAD);
-		goto out;
+		return;
 	}
 	if (msg->t_id != auth->tid) {
 		AUTH_ERRLOG(qpair, "transaction id mismatch: %u != %u\n", msg->t_id, auth->tid);
 		nvmf_auth_request_fail1(req, SPDK_NVMF_AUTH_INCORRECT_PAYLOAD);
-		goto out;
+		return;
 	}
 	if (msg->cvalid != 0 && msg->cvalid != 1) {
 		AUTH_ERRLOG(qpair, "unexpected cvalid=%d\n", msg->cvalid);
 		nvmf_auth_request_fail1(req, SPDK_NVMF_AUTH_INCORRECT_PAYLOAD);
-		goto out;
+		return;
 	}
 	if (msg->cvalid && msg->seqnum == 0) {
 		AUTH_ERRLOG(qpair, "unexpected seqnum=0 with cvalid=1\n");
 		nvmf_auth_request_fail1(req, SPDK_NVMF_AUTH_INCORRECT_PAYLOAD);
-		goto out;
+		return;
 	}
 
 	key = nvmf_subsystem_get_dhchap_key(ctrlr->subsys, ctrlr->hostnqn, NVMF_AUTH_KEY_HOST);
 	if (key == NULL) {
 		AUTH_ERRLOG(qpair, "couldn't get DH-HMAC-CHAP key\n");
 		nvmf_auth_request_fail1(req, SPDK_NVMF_AUTH_FAILED);
-		goto out;
-	}
-
-	if (auth->dhgroup != SPDK_NVMF_DHCHAP_DHGROUP_NULL) {
-		AUTH_LOGDUMP("host pubkey:", &msg->rval[2 * hl], msg->dhvlen);
-		dhseclen = sizeof(dhsec);
-		rc = spdk_nvme_dhchap_dhkey_derive_secret(auth->dhkey, &msg->rval[2 * hl],
-				msg->dhvlen, dhsec, &dhseclen);
-		if (rc != 0) {
-			AUTH_ERRLOG(qpair, "couldn't derive DH secret\n");
-			nvmf_auth_request_fail1(req, SPDK_NVMF_AUTH_FAILED);
-			goto out;
-		}
-
-		AUTH_LOGDUMP("dh secret:", dhsec, dhseclen);
-	}
-
-	assert(hl <= sizeof(response) && hl <= sizeof(auth->cval));
-	rc = spdk_nvme_dhchap_calculate(key, (enum spdk_nvmf_dhchap_hash)auth->digest,
-					"HostHost", auth->seqnum, auth->tid, 0,
-					ctrlr->hostnqn, ctrlr->subsys->subnqn,
-					dhseclen > 0 ? dhsec : NULL, dhseclen,
-					auth->cval, response);
-	if (rc != 0) {
-		AUTH_ERRLOG(qpair, "failed to calculate challenge response: %s\n",
-			    spdk_strerror(-rc));
-		nvmf_auth_request_fail1(req, SPDK_NVMF_AUTH_FAILED);
-		goto out;
-	}
-
-	if (memcmp(msg->rval, response, hl) != 0) {
-		AUTH_ERRLOG(qpair, "challenge response mismatch\n");
-		AUTH_LOGDUMP("response:", msg->rval, hl);
-		AUTH_LOGDUMP("expected:", response, hl);
-		nvmf_auth_request_fail1(req, SPDK_NVMF_AUTH_FAILED);
-		goto out;
+		return;
 	}
-
 	if (msg->cvalid) {
 		ckey = nvmf_subsystem_get_dhchap_key(ctrlr->subsys, ctrlr->hostnqn,
 						     NVMF_AUTH_KEY_CTRLR);
 		if (ckey == NULL) {
 			AUTH_ERRLOG(qpair, "missing DH-HMAC-CHAP ctrlr key\n");
+			spdk_keyring_put_key(key);
 			nvmf_auth_request_fail1(req, SPDK_NVMF_AUTH_FAILED);
-			goto out;
+			return;
 		}
-		rc = spdk_nvme_dhchap_calculate(ckey, (enum spdk_nvmf_dhchap_hash)auth->digest,
-						"Controller", msg->seqnum, auth->tid, 0,
-						ctrlr->subsys->subnqn, ctrlr->hostnqn,
-						dhseclen > 0 ? dhsec : NULL, dhseclen,
-						&msg->rval[hl], auth->cval);
-		if (rc != 0) {
-			AUTH_ERRLOG(qpair, "failed to calculate ctrlr challenge response: %s\n",
-				    spdk_strerror(-rc));
-			nvmf_auth_request_fail1(req, SPDK_NVMF_AUTH_FAILED);
-			goto out;
-		}
-		auth->cvalid = true;
-	}
-
-	if (nvmf_auth_rearm_poller(qpair)) {
-		nvmf_auth_request_complete(req, SPDK_NVME_SCT_GENERIC,
-					   SPDK_NVME_SC_INTERNAL_DEVICE_ERROR, 1);
-		nvmf_auth_disconnect_qpair(qpair);
-		goto out;
 	}
 
-	nvmf_auth_set_state(qpair, NVMF_QPAIR_AUTH_SUCCESS1);
-	nvmf_auth_request_complete(req, SPDK_NVME_SCT_GENERIC, SPDK_NVME_SC_SUCCESS, 0);
-out:
-	spdk_keyring_put_key(ckey);
-	spdk_keyring_put_key(key);
+	auth->phase_tsc = spdk_get_ticks();
+	job->req = req;
+	job->reply = msg;
+	job->key = key;
+	job->ckey = ckey;
+	job->digest = auth->digest;
+	job->dhgroup = auth->dhgroup;
+	job->tid = auth->tid;
+	job->seqnum = auth->seqnum;
+	job->hostnqn = ctrlr->hostnqn;
+	job->subnqn = ctrlr->subsys->subnqn;
+	memcpy(job->cval, auth->cval, sizeof(job->cval));
+	/* The DH key is only needed to derive the secret, so the job takes its ownership */
+	job->dhkey = auth->dhkey;
+	auth->dhkey = NULL;
+
+	nvmf_auth_job_submit(job, nvmf_auth_reply_compute, nvmf_auth_reply_done);
 }
 
 static void
@@ -497,8 +764,7 @@ nvmf_auth_success2_exec(struct spdk_nvmf_request *req, struct spdk_nvmf_dhchap_s
 
 	AUTH_DEBUGLOG(qpair, "controller authentication successful\n");
 	nvmf_qpair_set_state(qpair, SPDK_NVMF_QPAIR_ENABLED);
-	nvmf_auth_set_state(qpair, NVMF_QPAIR_AUTH_COMPLETED);
-	nvmf_auth_qpair_cleanup(auth);
+	nvmf_auth_completed(qpair);
 	nvmf_auth_request_complete(req, SPDK_NVME_SCT_GENERIC, SPDK_NVME_SC_SUCCESS, 0);
 }
 
@@ -662,35 +928,18 @@ nvmf_auth_get_seqnum(struct spdk_nvmf_qpair *qpair)
 }
 
 static int
-nvmf_auth_recv_challenge(struct spdk_nvmf_request *req)
+nvmf_auth_send_challenge(struct spdk_nvmf_request *req, const uint8_t *dhv, size_t dhvlen)
 {
 	struct spdk_nvmf_qpair *qpair = req->qpair;
 	struct spdk_nvmf_qpair_auth *auth = qpair->auth;
+	struct spdk_nvmf_poll_group_stat *stat = &qpair->group->stat;
 	struct spdk_nvmf_dhchap_challenge *challenge;
-	uint8_t hl, dhv[NVMF_AUTH_DH_KEY_MAX_SIZE];
-	size_t dhvlen = 0;
+	uint8_t hl;
 	int rc;
 
 	hl = spdk_nvme_dhchap_get_digest_length(auth->digest);
 	assert(hl > 0 && hl <= sizeof(auth->cval));
 
-	if (auth->dhgroup != SPDK_NVMF_DHCHAP_DHGROUP_NULL) {
-		auth->dhkey = spdk_nvme_dhchap_generate_dhkey(auth->dhgroup);
-		if (auth->dhkey == NULL) {
-			AUTH_ERRLOG(qpair, "failed to generate DH key\n");
-			return SPDK_NVMF_AUTH_FAILED;
-		}
-
-		dhvlen = sizeof(dhv);
-		rc = spdk_nvme_dhchap_dhkey_get_pubkey(auth->dhkey, dhv, &dhvlen);
-		if (rc != 0) {
-			AUTH_ERRLOG(qpair, "failed to get DH public key\n");
-			return SPDK_NVMF_AUTH_FAILED;
-		}
-
-		AUTH_LOGDUMP("ctrlr pubkey:", dhv, dhvlen);
-	}
-
 	challenge = nvmf_auth_get_message(req, sizeof(*challenge) + hl + dhvlen);
 	if (challenge == NULL) {
 		AUTH_ERRLOG(qpair, "invalid message length: %"PRIu32"\n", req->length);
@@ -722,12 +971,82 @@ nvmf_auth_recv_challenge(struct spdk_nvmf_request *req)
 	challenge->dhvlen = dhvlen;
 	challenge->seqnum = auth->seqnum;
 
+	nvmf_auth_stat_phase(&stat->auth_challenges, &stat->auth_challenge_ticks, auth->phase_tsc);
 	nvmf_auth_set_state(qpair, NVMF_QPAIR_AUTH_REPLY);
 	nvmf_auth_recv_complete(req, sizeof(*challenge) + hl + dhvlen);
 
 	return 0;
 }
 
+static void
+nvmf_auth_challenge_compute(struct nvmf_auth_job *job)
+{
+	struct spdk_nvmf_qpair *qpair = job->req->qpair;
+	int rc;
+
+	job->dhkey = spdk_nvme_dhchap_generate_dhkey(job->dhgroup);
+	if (job->dhkey == NULL) {
+		AUTH_ERRLOG(qpair, "failed to generate DH key\n");
+		job->fail_reason = SPDK_NVMF_AUTH_FAILED;
+		return;
+	}
+
+	job->dhvlen = sizeof(job->dhv);
+	rc = spdk_nvme_dhchap_dhkey_get_pubkey(job->dhkey, job->dhv, &job->dhvlen);
+	if (rc != 0) {
+		AUTH_ERRLOG(qpair, "failed to get DH public key\n");
+		job->fail_reason = SPDK_NVMF_AUTH_FAILED;
+		return;
+	}
+
+	AUTH_LOGDUMP("ctrlr pubkey:", job->dhv, job->dhvlen);
+}
+
+static void
+nvmf_auth_challenge_done(struct nvmf_auth_job *job)
+{
+	struct spdk_nvmf_request *req = job->req;
+	struct spdk_nvmf_qpair_auth *auth = req->qpair->auth;
+	int rc;
+
+	if (!nvmf_auth_job_check_state(job, NVMF_QPAIR_AUTH_CHALLENGE)) {
+		spdk_nvme_dhchap_dhkey_free(&job->dhkey);
+		return;
+	}
+
+	spdk_nvme_dhchap_dhkey_free(&auth->dhkey);
+	auth->dhkey = job->dhkey;
+	job->dhkey = NULL;
+
+	rc = job->fail_reason;
+	if (rc == 0) {
+		rc = nvmf_auth_send_challenge(req, job->dhv, job->dhvlen);
+	}
+	if (rc != 0) {
+		nvmf_auth_recv_failure1(req, rc);
+	}
+}
+
+static int
+nvmf_auth_recv_challenge(struct spdk_nvmf_request *req)
+{
+	struct spdk_nvmf_qpair_auth *auth = req->qpair->auth;
+	struct nvmf_auth_job *job = &auth->job;
+
+	auth->phase_tsc = spdk_get_ticks();
+	if (auth->dhgroup == SPDK_NVMF_DHCHAP_DHGROUP_NULL) {
+		return nvmf_auth_send_challenge(req, NULL, 0);
+	}
+
+	job->req = req;
+	job->dhgroup = auth->dhgroup;
+	job->dhkey = NULL;
+	job->dhvlen = 0;
+	nvmf_auth_job_submit(job, nvmf_auth_challenge_compute, nvmf_auth_challenge_done);
+
+	return 0;
+}
+
 static int
 nvmf_auth_recv_success1(struct spdk_nvmf_request *req)
 {
@@ -754,8 +1073,7 @@ nvmf_auth_recv_success1(struct spdk_nvmf_request *req)
 	if (!auth->cvalid) {
 		/* Host didn't request to authenticate us, we're done */
 		nvmf_qpair_set_state(qpair, SPDK_NVMF_QPAIR_ENABLED);
-		nvmf_auth_set_state(qpair, NVMF_QPAIR_AUTH_COMPLETED);
-		nvmf_auth_qpair_cleanup(auth);
+		nvmf_auth_completed(qpair);
 	} else {
 		if (nvmf_auth_rearm_poller(qpair)) {
 			nvmf_auth_request_complete(req, SPDK_NVME_SCT_GENERIC,
@@ -817,6 +1135,13 @@ nvmf_auth_check_state(struct spdk_nvmf_qpair *qpair, struct spdk_nvmf_request *r
 	struct spdk_nvmf_qpair_auth *auth = qpair->auth;
 	int rc;
 
+	if (auth != NULL && auth->job_inflight) {
+		AUTH_ERRLOG(qpair, "received a command while processing previous message\n");
+		nvmf_auth_request_complete(req, SPDK_NVME_SCT_GENERIC,
+					   SPDK_NVME_SC_COMMAND_SEQUENCE_ERROR, 0);
+		return false;
+	}
+
 	switch (qpair->state) {
 	case SPDK_NVMF_QPAIR_AUTHENTICATING:
 		break;
@@ -881,6 +1206,7 @@ nvmf_qpair_auth_init(struct spdk_nvmf_qpair *qpair)
 	}
 
 	auth->digest = -1;
+	auth->start_tsc = spdk_get_ticks();
 	qpair->auth = auth;
 	nvmf_auth_set_state(qpair, NVMF_QPAIR_AUTH_NEGOTIATE);
 
@@ -925,6 +1251,68 @@ nvmf_qpair_auth_dump(struct spdk_nvmf_qpair *qpair, struct spdk_json_write_ctx *
 	spdk_json_write_object_end(w);
 }
 
+int
+nvmf_auth_workers_create(struct spdk_nvmf_tgt *tgt, uint32_t num_threads, uint32_t queue_depth)
+{
+	struct nvmf_auth_workers *workers;
+	uint32_t i;
+	int rc;
+
+	assert(num_threads > 0);
+	workers = calloc(1, sizeof(*workers) + num_threads * sizeof(pthread_t));
+	if (workers == NULL) {
+		return -ENOMEM;
+	}
+
+	STAILQ_INIT(&workers->jobs);
+	workers->queue_depth = queue_depth > 0 ? queue_depth : NVMF_AUTH_DEFAULT_QUEUE_DEPTH;
+	pthread_mutex_init(&workers->mutex, NULL);
+	pthread_cond_init(&workers->cond, NULL);
+
+	for (i = 0; i < num_threads; ++i) {
+		rc = pthread_create(&workers->threads[i], NULL, nvmf_auth_worker, workers);
+		if (rc != 0) {
+			SPDK_ERRLOG("Failed to create authentication thread: %s\n", spdk_strerror(rc));
+			break;
+		}
+		workers->num_threads++;
+	}
+
+	tgt->auth_workers = workers;
+	if (workers->num_threads != num_threads) {
+		nvmf_auth_workers_destroy(tgt);
+		return -rc;
+	}
+
+	return 0;
+}
+
+void
+nvmf_auth_workers_destroy(struct spdk_nvmf_tgt *tgt)
+{
+	struct nvmf_auth_workers *workers = tgt->auth_workers;
+	uint32_t i;
+
+	if (workers == NULL) {
+		return;
+	}
+
+	pthread_mutex_lock(&workers->mutex);
+	workers->exit = true;
+	pthread_cond_broadcast(&workers->cond);
+	pthread_mutex_unlock(&workers->mutex);
+
+	for (i = 0; i < workers->num_threads; ++i) {
+		pthread_join(workers->threads[i], NULL);
+	}
+
+	assert(STAILQ_EMPTY(&workers->jobs));
+	pthread_cond_destroy(&workers->cond);
+	pthread_mutex_destroy(&workers->mutex);
+	free(workers);
+	tgt->auth_workers = NULL;
+}
+
 bool
 nvmf_auth_is_supported(void)
 {
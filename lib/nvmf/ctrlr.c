@@ -4438,8 +4438,22 @@ nvmf_ctrlr_use_zcopy(struct spdk_nvmf_request *req)
 		return false;
 	}
 
+	if (req->qpair->ctrlr->subsys->passthrough) {
+		/* Passthrough commands are submitted as is */
+		return false;
+	}
+
 	ns = nvmf_ctrlr_get_ns(req->qpair->ctrlr, req->cmd->nvme_cmd.nsid);
-	if (ns == NULL || ns->bdev == NULL || !ns->zcopy) {
+	if (ns == NULL || ns->bdev == NULL) {
+		return false;
+	}
+
+	/* Reads can be served from buffers owned by the bdev, even if it doesn't support
+	 * ZCOPY, which saves the transport from allocating and copying its own.  This only
+	 * works if the bdev layer can get a single buffer for the whole read though.
+	 */
+	if (!ns->zcopy && (req->cmd->nvme_cmd.opc != SPDK_NVME_OPC_READ ||
+			   !nvmf_bdev_ctrlr_read_buf_fits(ns->bdev, req))) {
 		return false;
 	}
 
@@ -4650,7 +4664,6 @@ _nvmf_request_complete(void *ctx)
 	struct spdk_nvmf_subsystem_pg_ns_info *ns_info;
 	bool is_aer = false;
 	uint32_t nsid;
-	bool paused;
 	uint8_t opcode;
 
 	rsp->sqid = 0;
@@ -4666,6 +4679,7 @@ _nvmf_request_complete(void *ctx)
 		is_aer = req->cmd->nvme_cmd.opc == SPDK_NVME_OPC_ASYNC_EVENT_REQUEST;
 		if (spdk_likely(qpair->qid != 0)) {
 			qpair->group->stat.completed_nvme_io++;
+			qpair->load.completed_nvme_io++;
 		}
 
 		/*
@@ -4727,30 +4741,25 @@ _nvmf_request_complete(void *ctx)
 
 				/* NOTE: This implicitly also checks for 0, since 0 - 1 wraps around to UINT32_MAX. */
 				if (spdk_likely(nsid - 1 < sgroup->num_ns)) {
-					sgroup->ns_info[nsid - 1].io_outstanding--;
+					ns_info = &sgroup->ns_info[nsid - 1];
+					ns_info->io_outstanding--;
+					if (spdk_unlikely(ns_info->state == SPDK_NVMF_SUBSYSTEM_PAUSING &&
+							  ns_info->io_outstanding == 0)) {
+						assert(sgroup->num_ns_pausing > 0);
+						ns_info->state = SPDK_NVMF_SUBSYSTEM_PAUSED;
+						sgroup->num_ns_pausing--;
+					}
 				}
 			}
 		}
 
 		if (spdk_unlikely(sgroup->state == SPDK_NVMF_SUBSYSTEM_PAUSING &&
-				  sgroup->mgmt_io_outstanding == 0)) {
-			paused = true;
-			for (nsid = 0; nsid < sgroup->num_ns; nsid++) {
-				ns_info = &sgroup->ns_info[nsid];
-
-				if (ns_info->state == SPDK_NVMF_SUBSYSTEM_PAUSING &&
-				    ns_info->io_outstanding > 0) {
-					paused = false;
-					break;
-				}
-			}
-
-			if (paused) {
-				sgroup->state = SPDK_NVMF_SUBSYSTEM_PAUSED;
-				sgroup->cb_fn(sgroup->cb_arg, 0);
-				sgroup->cb_fn = NULL;
-				sgroup->cb_arg = NULL;
-			}
+				  sgroup->mgmt_io_outstanding == 0 &&
+				  sgroup->num_ns_pausing == 0)) {
+			sgroup->state = SPDK_NVMF_SUBSYSTEM_PAUSED;
+			sgroup->cb_fn(sgroup->cb_arg, 0);
+			sgroup->cb_fn = NULL;
+			sgroup->cb_arg = NULL;
 		}
 
 	}
@@ -4891,6 +4900,21 @@ nvmf_check_qpair_active(struct spdk_nvmf_request *req)
 	return false;
 }
 
+static inline bool
+nvmf_ctrlr_qos_admit(struct spdk_nvmf_request *req)
+{
+	struct spdk_nvmf_qpair *qpair = req->qpair;
+	struct spdk_nvmf_subsystem_pg_ns_info *ns_info;
+
+	/* The namespace ID was validated by nvmf_check_subsystem_active() */
+	ns_info = &qpair->group->sgroups[qpair->ctrlr->subsys->id].ns_info[req->cmd->nvme_cmd.nsid - 1];
+	if (spdk_likely(ns_info->qos_buckets == NULL)) {
+		return true;
+	}
+
+	return nvmf_qos_admit(req, ns_info);
+}
+
 void
 spdk_nvmf_request_exec(struct spdk_nvmf_request *req)
 {
@@ -4916,6 +4940,9 @@ spdk_nvmf_request_exec(struct spdk_nvmf_request *req)
 	} else if (spdk_unlikely(nvmf_qpair_is_admin_queue(qpair))) {
 		status = nvmf_ctrlr_process_admin_cmd(req);
 	} else {
+		if (spdk_unlikely(!nvmf_ctrlr_qos_admit(req))) {
+			return;
+		}
 		status = nvmf_ctrlr_process_io_cmd(req);
 	}
 
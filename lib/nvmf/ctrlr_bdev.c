@@ -9,6 +9,7 @@
 #include "nvmf_internal.h"
 
 #include "spdk/bdev.h"
+#include "spdk/bdev_module.h"
 #include "spdk/endian.h"
 #include "spdk/thread.h"
 #include "spdk/likely.h"
@@ -330,6 +331,31 @@ nvmf_bdev_zcopy_enabled(struct spdk_bdev *bdev)
 	return spdk_bdev_io_type_supported(bdev, SPDK_BDEV_IO_TYPE_ZCOPY);
 }
 
+/* The iobuf options can't change once it's initialized, so its large buffer size is read once */
+static uint64_t g_nvmf_iobuf_large_bufsize;
+
+bool
+nvmf_bdev_ctrlr_read_buf_fits(struct spdk_bdev *bdev, struct spdk_nvmf_request *req)
+{
+	struct spdk_iobuf_opts opts;
+	uint64_t start_lba, num_blocks, length;
+
+	if (spdk_unlikely(g_nvmf_iobuf_large_bufsize == 0)) {
+		spdk_iobuf_get_opts(&opts, sizeof(opts));
+		g_nvmf_iobuf_large_bufsize = opts.large_bufsize;
+	}
+
+	/* Mirrors the space the bdev layer needs to get a single buffer for a read */
+	nvmf_bdev_ctrlr_get_rw_params(&req->cmd->nvme_cmd, &start_lba, &num_blocks);
+	length = num_blocks * spdk_bdev_get_block_size(bdev);
+	if (spdk_bdev_is_md_separate(bdev)) {
+		length += num_blocks * spdk_bdev_get_md_size(bdev);
+	}
+	length += spdk_bdev_get_buf_align(bdev) - 1;
+
+	return length <= g_nvmf_iobuf_large_bufsize;
+}
+
 int
 nvmf_bdev_ctrlr_read_cmd(struct spdk_bdev *bdev, struct spdk_bdev_desc *desc,
 			 struct spdk_io_channel *ch, struct spdk_nvmf_request *req)
@@ -1030,8 +1056,20 @@ nvmf_bdev_ctrlr_zcopy_start(struct spdk_bdev *bdev,
 
 	bool populate = (req->cmd->nvme_cmd.opc == SPDK_NVME_OPC_READ) ? true : false;
 
-	rc = spdk_bdev_zcopy_start(desc, ch, req->iov, req->iovcnt, start_lba,
-				   num_blocks, populate, nvmf_bdev_ctrlr_zcopy_start_complete, req);
+	if (populate && !nvmf_bdev_zcopy_enabled(bdev)) {
+		/* The bdev doesn't support ZCOPY, so read into a buffer owned by the bdev_io
+		 * instead.  The transport sends directly from that buffer and the bdev_io is
+		 * held until zcopy end, exactly like a ZCOPY bdev_io.
+		 */
+		req->iov[0].iov_base = NULL;
+		req->iov[0].iov_len = num_blocks * block_size;
+		req->iovcnt = 1;
+		rc = spdk_bdev_readv_blocks(desc, ch, req->iov, req->iovcnt, start_lba, num_blocks,
+					    nvmf_bdev_ctrlr_zcopy_start_complete, req);
+	} else {
+		rc = spdk_bdev_zcopy_start(desc, ch, req->iov, req->iovcnt, start_lba,
+					   num_blocks, populate, nvmf_bdev_ctrlr_zcopy_start_complete, req);
+	}
 	if (spdk_unlikely(rc != 0)) {
 		if (rc == -ENOMEM) {
 			nvmf_bdev_ctrl_queue_io(req, bdev, ch, nvmf_ctrlr_process_io_cmd_resubmit, req);
@@ -1072,6 +1110,15 @@ nvmf_bdev_ctrlr_zcopy_end(struct spdk_nvmf_request *req, bool commit)
 {
 	int rc __attribute__((unused));
 
+	if (req->zcopy_bdev_io->type == SPDK_BDEV_IO_TYPE_READ) {
+		/* A READ issued by nvmf_bdev_ctrlr_zcopy_start() on a bdev without ZCOPY support.
+		 * Releasing its buffer only requires freeing it.
+		 */
+		assert(!commit);
+		nvmf_bdev_ctrlr_zcopy_end_complete(req->zcopy_bdev_io, true, req);
+		return;
+	}
+
 	rc = spdk_bdev_zcopy_end(req->zcopy_bdev_io, commit, nvmf_bdev_ctrlr_zcopy_end_complete, req);
 
 	/* The only way spdk_bdev_zcopy_end() can fail is if we pass a bdev_io type that isn't ZCOPY */
@@ -22,6 +22,15 @@ SPDK_LOG_REGISTER_COMPONENT(nvmf)
 
 #define SPDK_NVMF_DEFAULT_MAX_SUBSYSTEMS 1024
 
+/* How often the load of each poll group is sampled */
+#define NVMF_POLL_GROUP_LOAD_PERIOD_US (100 * 1000)
+/* Poll groups whose busy percentages differ by less than this are considered equally busy */
+#define NVMF_POLL_GROUP_LOAD_TOLERANCE 5
+/* Number of consecutive load periods an imbalance must last before a qpair is migrated */
+#define NVMF_QPAIR_MIGRATION_PERIODS 10
+/* How long a busy qpair may stop taking new commands to drain before it's moved */
+#define NVMF_QPAIR_DRAIN_TIMEOUT_US (10 * 1000)
+
 static TAILQ_HEAD(, spdk_nvmf_tgt) g_nvmf_tgts = TAILQ_HEAD_INITIALIZER(g_nvmf_tgts);
 
 typedef void (*nvmf_qpair_disconnect_cpl)(void *ctx, int status);
@@ -45,6 +54,8 @@ struct nvmf_qpair_disconnect_many_ctx {
 	void *cpl_ctx;
 };
 
+static void nvmf_poll_group_stop_drain(struct spdk_nvmf_poll_group *group);
+
 static struct spdk_nvmf_referral *
 nvmf_tgt_find_referral(struct spdk_nvmf_tgt *tgt,
 		       const struct spdk_nvme_transport_id *trid)
@@ -164,6 +175,8 @@ nvmf_poll_group_poll(void *ctx)
 	return count > 0 ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
 }
 
+static int nvmf_poll_group_sample_load(void *ctx);
+
 /*
  * Reset and clean up the poll group (I/O channel code will actually free the
  * group).
@@ -190,6 +203,7 @@ nvmf_tgt_cleanup_poll_group(struct spdk_nvmf_poll_group *group)
 				spdk_put_io_channel(sgroup->ns_info[nsid].channel);
 				sgroup->ns_info[nsid].channel = NULL;
 			}
+			nvmf_ns_qos_update_buckets(&sgroup->ns_info[nsid], NULL);
 		}
 
 		free(sgroup->ns_info);
@@ -198,6 +212,8 @@ nvmf_tgt_cleanup_poll_group(struct spdk_nvmf_poll_group *group)
 	free(group->sgroups);
 
 	spdk_poller_unregister(&group->poller);
+	spdk_poller_unregister(&group->load.poller);
+	spdk_poller_unregister(&group->load.drain_poller);
 
 	if (group->destroy_cb_fn) {
 		group->destroy_cb_fn(group->destroy_cb_arg, 0);
@@ -269,6 +285,11 @@ nvmf_tgt_create_poll_group(void *io_device, void *ctx_buf)
 	group->poller = SPDK_POLLER_REGISTER(nvmf_poll_group_poll, group, 0);
 	spdk_poller_register_interrupt(group->poller, NULL, NULL);
 
+	if (tgt->load_aware_placement || tgt->qpair_migration_threshold != 0) {
+		group->load.poller = SPDK_POLLER_REGISTER(nvmf_poll_group_sample_load, group,
+				     NVMF_POLL_GROUP_LOAD_PERIOD_US);
+	}
+
 	SPDK_DTRACE_PROBE1_TICKS(nvmf_create_poll_group, spdk_thread_get_id(thread));
 
 	TAILQ_FOREACH(transport, &tgt->transports, link) {
@@ -394,6 +415,8 @@ spdk_nvmf_tgt_create(struct spdk_nvmf_target_opts *_opts)
 	tgt->discovery_genctr = 0;
 	tgt->dhchap_digests = opts.dhchap_digests;
 	tgt->dhchap_dhgroups = opts.dhchap_dhgroups;
+	tgt->load_aware_placement = opts.load_aware_placement;
+	tgt->qpair_migration_threshold = opts.qpair_migration_threshold;
 	TAILQ_INIT(&tgt->transports);
 	TAILQ_INIT(&tgt->poll_groups);
 	TAILQ_INIT(&tgt->referrals);
@@ -405,6 +428,15 @@ spdk_nvmf_tgt_create(struct spdk_nvmf_target_opts *_opts)
 		return NULL;
 	}
 
+	if (opts.auth_threads > 0) {
+		if (nvmf_auth_workers_create(tgt, opts.auth_threads, opts.auth_queue_depth) != 0) {
+			SPDK_ERRLOG("Failed to create authentication threads\n");
+			spdk_bit_array_free(&tgt->subsystem_ids);
+			free(tgt);
+			return NULL;
+		}
+	}
+
 	RB_INIT(&tgt->subsystems);
 
 	pthread_mutex_init(&tgt->mutex, NULL);
@@ -436,6 +468,7 @@ _nvmf_tgt_destroy_next_transport(void *ctx)
 		spdk_nvmf_tgt_destroy_done_fn *destroy_cb_fn = tgt->destroy_cb_fn;
 		void *destroy_cb_arg = tgt->destroy_cb_arg;
 
+		nvmf_auth_workers_destroy(tgt);
 		pthread_mutex_destroy(&tgt->mutex);
 		free(tgt);
 
@@ -551,6 +584,7 @@ nvmf_write_nvme_subsystem_config(struct spdk_json_write_ctx *w,
 				 struct spdk_nvmf_subsystem *subsystem)
 {
 	struct spdk_nvmf_host *host;
+	struct spdk_nvmf_ns_qos *qos;
 	struct spdk_nvmf_ns *ns;
 	struct spdk_nvmf_ns_opts ns_opts;
 	uint32_t max_namespaces;
@@ -678,6 +712,20 @@ nvmf_write_nvme_subsystem_config(struct spdk_json_write_ctx *w,
 			spdk_json_write_object_end(w);
 			spdk_json_write_object_end(w);
 		}
+
+		TAILQ_FOREACH(qos, &ns->qos, link) {
+			spdk_json_write_object_begin(w);
+			spdk_json_write_named_string(w, "method", "nvmf_ns_set_qos_limits");
+			spdk_json_write_named_object_begin(w, "params");
+			spdk_json_write_named_string(w, "nqn", spdk_nvmf_subsystem_get_nqn(subsystem));
+			spdk_json_write_named_uint32(w, "nsid", spdk_nvmf_ns_get_id(ns));
+			spdk_json_write_named_string(w, "host", qos->hostnqn);
+			spdk_json_write_named_uint64(w, "rw_ios_per_sec", qos->limits[NVMF_QOS_RW_IOPS_RATE_LIMIT]);
+			spdk_json_write_named_uint64(w, "rw_mbytes_per_sec",
+						     qos->limits[NVMF_QOS_RW_BPS_RATE_LIMIT] / (1024 * 1024));
+			spdk_json_write_object_end(w);
+			spdk_json_write_object_end(w);
+		}
 	}
 }
 
@@ -752,6 +800,8 @@ spdk_nvmf_tgt_write_config_json(struct spdk_json_write_ctx *w, struct spdk_nvmf_
 	spdk_json_write_object_end(w);
 	spdk_json_write_object_end(w);
 
+	nvmf_reservation_bdev_store_write_config_json(w);
+
 	/* write transports */
 	TAILQ_FOREACH(transport, &tgt->transports, link) {
 		spdk_json_write_object_begin(w);
@@ -1130,6 +1180,90 @@ spdk_nvmf_tgt_get_transport(struct spdk_nvmf_tgt *tgt, const char *transport_nam
 	return NULL;
 }
 
+static uint32_t
+nvmf_poll_group_get_num_qpairs(struct spdk_nvmf_poll_group *group)
+{
+	return group->stat.current_admin_qpairs + group->stat.current_io_qpairs +
+	       group->current_unassociated_qpairs;
+}
+
+/*
+ * Compare the load of two poll groups. The busy percentage decides, then the number of
+ * qpairs (which also accounts for qpairs placed since the last sample), then the IOPS.
+ * Returns a negative value if group1 is less loaded than group2.
+ */
+static int
+nvmf_poll_group_load_cmp(struct spdk_nvmf_poll_group *group1, struct spdk_nvmf_poll_group *group2)
+{
+	uint32_t qpairs1, qpairs2;
+
+	if (group1->load.busy_pct + NVMF_POLL_GROUP_LOAD_TOLERANCE < group2->load.busy_pct) {
+		return -1;
+	} else if (group2->load.busy_pct + NVMF_POLL_GROUP_LOAD_TOLERANCE < group1->load.busy_pct) {
+		return 1;
+	}
+
+	qpairs1 = nvmf_poll_group_get_num_qpairs(group1);
+	qpairs2 = nvmf_poll_group_get_num_qpairs(group2);
+	if (qpairs1 != qpairs2) {
+		return qpairs1 < qpairs2 ? -1 : 1;
+	}
+
+	if (group1->load.iops != group2->load.iops) {
+		return group1->load.iops < group2->load.iops ? -1 : 1;
+	}
+
+	return 0;
+}
+
+static struct spdk_nvmf_poll_group *
+nvmf_tgt_get_least_loaded_poll_group(struct spdk_nvmf_tgt *tgt)
+{
+	struct spdk_nvmf_poll_group *group, *start, *result = NULL;
+
+	/* Start at the next round-robin poll group, so that equally loaded poll groups
+	 * take turns.
+	 */
+	start = tgt->next_poll_group != NULL ? tgt->next_poll_group : TAILQ_FIRST(&tgt->poll_groups);
+	group = start;
+	while (group != NULL) {
+		if (result == NULL || nvmf_poll_group_load_cmp(group, result) < 0) {
+			result = group;
+		}
+
+		group = TAILQ_NEXT(group, link);
+		if (group == NULL) {
+			group = TAILQ_FIRST(&tgt->poll_groups);
+		}
+		if (group == start) {
+			break;
+		}
+	}
+
+	if (result != NULL) {
+		tgt->next_poll_group = TAILQ_NEXT(result, link);
+	}
+
+	return result;
+}
+
+struct spdk_nvmf_transport_poll_group *
+nvmf_transport_get_least_loaded_poll_group(struct spdk_nvmf_transport *transport)
+{
+	struct spdk_nvmf_poll_group *group;
+
+	if (!transport->tgt->load_aware_placement) {
+		return NULL;
+	}
+
+	group = nvmf_tgt_get_least_loaded_poll_group(transport->tgt);
+	if (group == NULL) {
+		return NULL;
+	}
+
+	return nvmf_get_transport_poll_group(group, transport);
+}
+
 struct nvmf_new_qpair_ctx {
 	struct spdk_nvmf_qpair *qpair;
 	struct spdk_nvmf_poll_group *group;
@@ -1157,6 +1291,9 @@ spdk_nvmf_tgt_new_qpair(struct spdk_nvmf_tgt *tgt, struct spdk_nvmf_qpair *qpair
 	struct nvmf_new_qpair_ctx *ctx;
 
 	group = spdk_nvmf_get_optimal_poll_group(qpair);
+	if (group == NULL && tgt->load_aware_placement) {
+		group = nvmf_tgt_get_least_loaded_poll_group(tgt);
+	}
 	if (group == NULL) {
 		if (tgt->next_poll_group == NULL) {
 			tgt->next_poll_group = TAILQ_FIRST(&tgt->poll_groups);
@@ -1318,6 +1455,10 @@ spdk_nvmf_poll_group_remove(struct spdk_nvmf_qpair *qpair)
 		}
 	}
 
+	if (qpair->group->load.draining_qpair == qpair) {
+		nvmf_poll_group_stop_drain(qpair->group);
+	}
+
 	TAILQ_REMOVE(&qpair->group->qpairs, qpair, link);
 	qpair->group = NULL;
 }
@@ -1406,7 +1547,8 @@ spdk_nvmf_qpair_disconnect(struct spdk_nvmf_qpair *qpair)
 	}
 
 	assert(group != NULL);
-	if (spdk_get_thread() != group->thread) {
+	/* A qpair which is being moved to another poll group is disconnected once it arrives there */
+	if (spdk_get_thread() != group->thread || qpair->migrating) {
 		/* clear the atomic so we can set it on the next call on the proper thread. */
 		__atomic_clear(&qpair->disconnect_started, __ATOMIC_RELAXED);
 		qpair_ctx = calloc(1, sizeof(struct nvmf_qpair_disconnect_ctx));
@@ -1446,6 +1588,314 @@ spdk_nvmf_qpair_disconnect(struct spdk_nvmf_qpair *qpair)
 	return 0;
 }
 
+struct nvmf_qpair_migrate_ctx {
+	struct spdk_nvmf_qpair		*qpair;
+	struct spdk_nvmf_poll_group	*group;
+};
+
+static void
+_nvmf_poll_group_attach_qpair(void *_ctx)
+{
+	struct nvmf_qpair_migrate_ctx *ctx = _ctx;
+	struct spdk_nvmf_qpair *qpair = ctx->qpair;
+	struct spdk_nvmf_poll_group *group = ctx->group, *tmp;
+	struct spdk_nvmf_tgt *tgt = qpair->transport->tgt;
+	struct spdk_nvmf_transport_poll_group *tgroup = NULL;
+	struct nvmf_qpair_disconnect_ctx *qpair_ctx;
+	int rc = -ENOENT;
+
+	free(ctx);
+
+	/* The poll group may have been destroyed while the qpair was on its way */
+	pthread_mutex_lock(&tgt->mutex);
+	TAILQ_FOREACH(tmp, &tgt->poll_groups, link) {
+		if (tmp == group && tmp->thread == spdk_get_thread()) {
+			tgroup = nvmf_get_transport_poll_group(group, qpair->transport);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&tgt->mutex);
+
+	if (tgroup != NULL) {
+		rc = nvmf_transport_poll_group_attach(tgroup, qpair);
+	}
+	qpair->migrating = false;
+
+	if (rc != 0) {
+		SPDK_ERRLOG("Unable to attach qpair %p to poll group %p: %s\n", qpair, group,
+			    spdk_strerror(-rc));
+		qpair->group = NULL;
+		qpair_ctx = calloc(1, sizeof(*qpair_ctx));
+		if (qpair_ctx == NULL) {
+			SPDK_ERRLOG("Unable to allocate context for nvmf_qpair_disconnect\n");
+			nvmf_transport_qpair_fini(qpair, NULL, NULL);
+			return;
+		}
+		qpair_ctx->qpair = qpair;
+		qpair_ctx->ctrlr = qpair->ctrlr;
+		qpair_ctx->qid = qpair->qid;
+		nvmf_transport_qpair_fini(qpair, _nvmf_transport_qpair_fini_complete, qpair_ctx);
+		return;
+	}
+
+	TAILQ_INSERT_TAIL(&group->qpairs, qpair, link);
+	group->stat.current_io_qpairs++;
+
+	SPDK_DEBUGLOG(nvmf, "qpair %p (qid %u) migrated to thread %s\n", qpair, qpair->qid,
+		      spdk_thread_get_name(group->thread));
+
+	/* The controller might have disconnected its qpairs while this one wasn't on any
+	 * poll group's list.
+	 */
+	if (qpair->ctrlr->in_destruct || qpair->ctrlr->disconnect_in_progress) {
+		spdk_nvmf_qpair_disconnect(qpair);
+	}
+}
+
+/*
+ * Move an I/O qpair from its current poll group to another one. Must be called on the
+ * qpair's current poll group thread. Only idle qpairs which their transport can detach
+ * can be moved. -EBUSY is returned for qpairs with work in progress, which can be drained
+ * first, -EINVAL or -ENOTSUP if the qpair can't be moved at all.
+ */
+static int
+nvmf_poll_group_migrate_qpair(struct spdk_nvmf_qpair *qpair, struct spdk_nvmf_poll_group *group)
+{
+	struct spdk_nvmf_poll_group *old_group = qpair->group;
+	struct spdk_nvmf_transport_poll_group *tgroup;
+	struct nvmf_qpair_migrate_ctx *ctx;
+	int rc;
+
+	assert(old_group->thread == spdk_get_thread());
+
+	if (qpair->qid == 0 || qpair->ctrlr == NULL || qpair->state != SPDK_NVMF_QPAIR_ENABLED ||
+	    qpair->disconnect_started) {
+		return -EINVAL;
+	}
+
+	tgroup = nvmf_get_transport_poll_group(old_group, qpair->transport);
+	if (tgroup == NULL) {
+		return -ENOENT;
+	}
+
+	/* Don't let the caller drain a qpair which can't be moved anyway */
+	if (!nvmf_transport_poll_group_can_detach(tgroup, qpair)) {
+		return -ENOTSUP;
+	}
+
+	if (!TAILQ_EMPTY(&qpair->outstanding)) {
+		return -EBUSY;
+	}
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		return -ENOMEM;
+	}
+
+	rc = nvmf_transport_poll_group_detach(tgroup, qpair);
+	if (rc != 0) {
+		free(ctx);
+		return rc;
+	}
+
+	TAILQ_REMOVE(&old_group->qpairs, qpair, link);
+	assert(old_group->stat.current_io_qpairs > 0);
+	old_group->stat.current_io_qpairs--;
+
+	qpair->migrating = true;
+	qpair->draining = false;
+	qpair->group = group;
+
+	ctx->qpair = qpair;
+	ctx->group = group;
+	spdk_thread_send_msg(group->thread, _nvmf_poll_group_attach_qpair, ctx);
+
+	return 0;
+}
+
+static void
+nvmf_poll_group_stop_drain(struct spdk_nvmf_poll_group *group)
+{
+	struct spdk_nvmf_qpair *qpair = group->load.draining_qpair;
+
+	/* A qpair which was moved isn't on this poll group anymore */
+	if (qpair->group == group) {
+		qpair->draining = false;
+	}
+
+	group->load.draining_qpair = NULL;
+	group->load.migrate_to = NULL;
+	spdk_poller_unregister(&group->load.drain_poller);
+}
+
+static int
+nvmf_poll_group_drain_qpair_poll(void *ctx)
+{
+	struct spdk_nvmf_poll_group *group = ctx;
+	struct spdk_nvmf_qpair *qpair = group->load.draining_qpair;
+	int rc;
+
+	rc = nvmf_poll_group_migrate_qpair(qpair, group->load.migrate_to);
+	if (rc == -EBUSY && spdk_get_ticks() < group->load.drain_deadline_tsc) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	if (rc != 0) {
+		SPDK_DEBUGLOG(nvmf, "Unable to drain qpair %p (qid %u): %s\n", qpair, qpair->qid,
+			      spdk_strerror(-rc));
+	}
+
+	nvmf_poll_group_stop_drain(group);
+
+	return SPDK_POLLER_BUSY;
+}
+
+/*
+ * Stop taking new commands on a busy qpair and move it to another poll group once its
+ * outstanding commands complete, or resume it if that doesn't happen in time.
+ */
+static void
+nvmf_poll_group_drain_qpair(struct spdk_nvmf_qpair *qpair, struct spdk_nvmf_poll_group *group)
+{
+	struct spdk_nvmf_poll_group *old_group = qpair->group;
+
+	assert(old_group->load.draining_qpair == NULL);
+
+	old_group->load.drain_poller = SPDK_POLLER_REGISTER(nvmf_poll_group_drain_qpair_poll,
+				       old_group, 0);
+	if (old_group->load.drain_poller == NULL) {
+		return;
+	}
+
+	old_group->load.draining_qpair = qpair;
+	old_group->load.migrate_to = group;
+	old_group->load.drain_deadline_tsc = spdk_get_ticks() + spdk_get_ticks_hz() *
+					     NVMF_QPAIR_DRAIN_TIMEOUT_US / SPDK_SEC_TO_USEC;
+	qpair->draining = true;
+}
+
+/*
+ * Pick the I/O qpair which evens out the IOPS of a poll group and the one it's moved to the
+ * most. Qpairs without I/O don't change anything and moving one with at least the difference
+ * would just move the imbalance. Qpairs which their transport can't detach are skipped.
+ */
+static struct spdk_nvmf_qpair *
+nvmf_poll_group_get_qpair_to_migrate(struct spdk_nvmf_poll_group *group,
+				     struct spdk_nvmf_poll_group *to)
+{
+	struct spdk_nvmf_transport_poll_group *tgroup;
+	struct spdk_nvmf_qpair *qpair, *best = NULL;
+	uint64_t gap, moved, diff, best_diff = UINT64_MAX;
+
+	if (group->load.iops <= to->load.iops) {
+		return NULL;
+	}
+
+	gap = group->load.iops - to->load.iops;
+	TAILQ_FOREACH(qpair, &group->qpairs, link) {
+		if (qpair->qid == 0 || qpair->load.iops == 0 || qpair->load.iops >= gap) {
+			continue;
+		}
+
+		tgroup = nvmf_get_transport_poll_group(group, qpair->transport);
+		if (tgroup == NULL || !nvmf_transport_poll_group_can_detach(tgroup, qpair)) {
+			continue;
+		}
+
+		moved = 2 * qpair->load.iops;
+		diff = gap > moved ? gap - moved : moved - gap;
+		if (diff < best_diff) {
+			best = qpair;
+			best_diff = diff;
+		}
+	}
+
+	return best;
+}
+
+/*
+ * Called on every load sample of a poll group. If the poll group stays busier than the least
+ * busy poll group by at least qpair_migration_threshold points, move the I/O qpair whose load
+ * balances them best there, draining it first if it's busy.
+ */
+static void
+nvmf_poll_group_rebalance(struct spdk_nvmf_poll_group *group)
+{
+	struct spdk_nvmf_tgt *tgt = group->tgt;
+	struct spdk_nvmf_poll_group *tmp, *least_busy = NULL;
+	struct spdk_nvmf_qpair *qpair;
+
+	/* Moving the only I/O qpair would just move the hot spot */
+	if (tgt->state != NVMF_TGT_RUNNING || group->stat.current_io_qpairs < 2 ||
+	    group->load.draining_qpair != NULL) {
+		group->load.imbalance_periods = 0;
+		return;
+	}
+
+	pthread_mutex_lock(&tgt->mutex);
+	TAILQ_FOREACH(tmp, &tgt->poll_groups, link) {
+		if (least_busy == NULL || tmp->load.busy_pct < least_busy->load.busy_pct) {
+			least_busy = tmp;
+		}
+	}
+	pthread_mutex_unlock(&tgt->mutex);
+
+	if (least_busy == NULL || least_busy == group ||
+	    group->load.busy_pct < least_busy->load.busy_pct + tgt->qpair_migration_threshold) {
+		group->load.imbalance_periods = 0;
+		return;
+	}
+
+	if (++group->load.imbalance_periods < NVMF_QPAIR_MIGRATION_PERIODS) {
+		return;
+	}
+
+	group->load.imbalance_periods = 0;
+	qpair = nvmf_poll_group_get_qpair_to_migrate(group, least_busy);
+	if (qpair == NULL) {
+		return;
+	}
+
+	if (nvmf_poll_group_migrate_qpair(qpair, least_busy) == -EBUSY) {
+		nvmf_poll_group_drain_qpair(qpair, least_busy);
+	}
+}
+
+static int
+nvmf_poll_group_sample_load(void *ctx)
+{
+	struct spdk_nvmf_poll_group *group = ctx;
+	struct spdk_nvmf_qpair *qpair;
+	struct spdk_thread_stats stats;
+	uint64_t busy_tsc, idle_tsc, completed;
+
+	if (spdk_thread_get_stats(&stats) != 0) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	busy_tsc = stats.busy_tsc - group->load.last_busy_tsc;
+	idle_tsc = stats.idle_tsc - group->load.last_idle_tsc;
+	completed = group->stat.completed_nvme_io - group->load.last_completed_nvme_io;
+
+	group->load.busy_pct = busy_tsc + idle_tsc > 0 ? busy_tsc * 100 / (busy_tsc + idle_tsc) : 0;
+	group->load.iops = completed * SPDK_SEC_TO_USEC / NVMF_POLL_GROUP_LOAD_PERIOD_US;
+	group->load.last_busy_tsc = stats.busy_tsc;
+	group->load.last_idle_tsc = stats.idle_tsc;
+	group->load.last_completed_nvme_io = group->stat.completed_nvme_io;
+
+	TAILQ_FOREACH(qpair, &group->qpairs, link) {
+		completed = qpair->load.completed_nvme_io - qpair->load.last_completed_nvme_io;
+		qpair->load.iops = completed * SPDK_SEC_TO_USEC / NVMF_POLL_GROUP_LOAD_PERIOD_US;
+		qpair->load.last_completed_nvme_io = qpair->load.completed_nvme_io;
+	}
+
+	if (group->tgt->qpair_migration_threshold != 0) {
+		nvmf_poll_group_rebalance(group);
+	}
+
+	return SPDK_POLLER_IDLE;
+}
+
 int
 spdk_nvmf_qpair_get_peer_trid(struct spdk_nvmf_qpair *qpair,
 			      struct spdk_nvme_transport_id *trid)
@@ -1471,17 +1921,118 @@ spdk_nvmf_qpair_get_listen_trid(struct spdk_nvmf_qpair *qpair,
 }
 
 static int
-poll_group_update_subsystem(struct spdk_nvmf_poll_group *group,
-			    struct spdk_nvmf_subsystem *subsystem)
+poll_group_update_ns(struct spdk_nvmf_poll_group *group,
+		     struct spdk_nvmf_subsystem *subsystem,
+		     struct spdk_nvmf_subsystem_poll_group *sgroup,
+		     uint32_t i, bool *ns_changed)
 {
-	struct spdk_nvmf_subsystem_poll_group *sgroup;
-	uint32_t i, j;
+	uint32_t j;
 	struct spdk_nvmf_ns *ns;
 	struct spdk_nvmf_registrant *reg, *tmp;
 	struct spdk_io_channel *ch;
 	struct spdk_nvmf_subsystem_pg_ns_info *ns_info;
+	int rc;
+
+	ns = subsystem->ns[i];
+	ns_info = &sgroup->ns_info[i];
+	ch = ns_info->channel;
+
+	if (ns == NULL && ch == NULL) {
+		/* Both NULL. Leave empty */
+	} else if (ns == NULL && ch != NULL) {
+		/* There was a channel here, but the namespace is gone. */
+		*ns_changed = true;
+		spdk_put_io_channel(ch);
+		ns_info->channel = NULL;
+	} else if (ns != NULL && ch == NULL) {
+		/* A namespace appeared but there is no channel yet */
+		*ns_changed = true;
+		ch = spdk_bdev_get_io_channel(ns->desc);
+		if (ch == NULL) {
+			SPDK_ERRLOG("Could not allocate I/O channel.\n");
+			return -ENOMEM;
+		}
+		ns_info->channel = ch;
+	} else if (spdk_uuid_compare(&ns_info->uuid, spdk_bdev_get_uuid(ns->bdev)) != 0) {
+		/* A namespace was here before, but was replaced by a new one. */
+		*ns_changed = true;
+		spdk_put_io_channel(ns_info->channel);
+		nvmf_ns_qos_update_buckets(ns_info, NULL);
+		memset(ns_info, 0, sizeof(*ns_info));
+
+		ch = spdk_bdev_get_io_channel(ns->desc);
+		if (ch == NULL) {
+			SPDK_ERRLOG("Could not allocate I/O channel.\n");
+			return -ENOMEM;
+		}
+		ns_info->channel = ch;
+	} else if (ns_info->num_blocks != spdk_bdev_get_num_blocks(ns->bdev)) {
+		/* Namespace is still there but size has changed */
+		SPDK_DEBUGLOG(nvmf, "Namespace resized: subsystem_id %u,"
+			      " nsid %u, pg %p, old %" PRIu64 ", new %" PRIu64 "\n",
+			      subsystem->id,
+			      ns->nsid,
+			      group,
+			      ns_info->num_blocks,
+			      spdk_bdev_get_num_blocks(ns->bdev));
+		*ns_changed = true;
+	} else if (ns_info->anagrpid != ns->anagrpid) {
+		/* Namespace is still there but ANA group ID has changed */
+		SPDK_DEBUGLOG(nvmf, "ANA group ID changed: subsystem_id %u,"
+			      "nsid %u, pg %p, old %u, new %u\n",
+			      subsystem->id,
+			      ns->nsid,
+			      group,
+			      ns_info->anagrpid,
+			      ns->anagrpid);
+		*ns_changed = true;
+	}
+
+	if (ns == NULL) {
+		nvmf_ns_qos_update_buckets(ns_info, NULL);
+		memset(ns_info, 0, sizeof(*ns_info));
+	} else {
+		ns_info->uuid = *spdk_bdev_get_uuid(ns->bdev);
+		ns_info->num_blocks = spdk_bdev_get_num_blocks(ns->bdev);
+		ns_info->anagrpid = ns->anagrpid;
+		ns_info->crkey = ns->crkey;
+		ns_info->rtype = ns->rtype;
+		if (ns->holder) {
+			ns_info->holder_id = ns->holder->hostid;
+		}
+
+		memset(&ns_info->reg_hostid, 0, SPDK_NVMF_MAX_NUM_REGISTRANTS * sizeof(struct spdk_uuid));
+		j = 0;
+		TAILQ_FOREACH_SAFE(reg, &ns->registrants, link, tmp) {
+			if (j >= SPDK_NVMF_MAX_NUM_REGISTRANTS) {
+				SPDK_ERRLOG("Maximum %u registrants can support.\n", SPDK_NVMF_MAX_NUM_REGISTRANTS);
+				return -EINVAL;
+			}
+			ns_info->reg_hostid[j++] = reg->hostid;
+		}
+
+		rc = nvmf_ns_qos_update_buckets(ns_info, ns);
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+/* Refresh the poll group's view of the subsystem's namespaces. If nsid is non-zero, only
+ * that namespace is refreshed, which keeps namespace add/remove independent of the total
+ * number of namespaces in the subsystem.
+ */
+static int
+poll_group_update_subsystem(struct spdk_nvmf_poll_group *group,
+			    struct spdk_nvmf_subsystem *subsystem, uint32_t nsid)
+{
+	struct spdk_nvmf_subsystem_poll_group *sgroup;
 	struct spdk_nvmf_ctrlr *ctrlr;
+	uint32_t i;
 	bool ns_changed;
+	int rc;
 
 	/* Make sure our poll group has memory for this subsystem allocated */
 	if (subsystem->id >= group->num_sgroups) {
@@ -1503,81 +2054,18 @@ poll_group_update_subsystem(struct spdk_nvmf_poll_group *group,
 	ns_changed = false;
 
 	/* Detect bdevs that were added or removed */
-	for (i = 0; i < sgroup->num_ns; i++) {
-		ns = subsystem->ns[i];
-		ns_info = &sgroup->ns_info[i];
-		ch = ns_info->channel;
-
-		if (ns == NULL && ch == NULL) {
-			/* Both NULL. Leave empty */
-		} else if (ns == NULL && ch != NULL) {
-			/* There was a channel here, but the namespace is gone. */
-			ns_changed = true;
-			spdk_put_io_channel(ch);
-			ns_info->channel = NULL;
-		} else if (ns != NULL && ch == NULL) {
-			/* A namespace appeared but there is no channel yet */
-			ns_changed = true;
-			ch = spdk_bdev_get_io_channel(ns->desc);
-			if (ch == NULL) {
-				SPDK_ERRLOG("Could not allocate I/O channel.\n");
-				return -ENOMEM;
-			}
-			ns_info->channel = ch;
-		} else if (spdk_uuid_compare(&ns_info->uuid, spdk_bdev_get_uuid(ns->bdev)) != 0) {
-			/* A namespace was here before, but was replaced by a new one. */
-			ns_changed = true;
-			spdk_put_io_channel(ns_info->channel);
-			memset(ns_info, 0, sizeof(*ns_info));
-
-			ch = spdk_bdev_get_io_channel(ns->desc);
-			if (ch == NULL) {
-				SPDK_ERRLOG("Could not allocate I/O channel.\n");
-				return -ENOMEM;
+	if (nsid != 0) {
+		if (nsid - 1 < sgroup->num_ns) {
+			rc = poll_group_update_ns(group, subsystem, sgroup, nsid - 1, &ns_changed);
+			if (rc != 0) {
+				return rc;
 			}
-			ns_info->channel = ch;
-		} else if (ns_info->num_blocks != spdk_bdev_get_num_blocks(ns->bdev)) {
-			/* Namespace is still there but size has changed */
-			SPDK_DEBUGLOG(nvmf, "Namespace resized: subsystem_id %u,"
-				      " nsid %u, pg %p, old %" PRIu64 ", new %" PRIu64 "\n",
-				      subsystem->id,
-				      ns->nsid,
-				      group,
-				      ns_info->num_blocks,
-				      spdk_bdev_get_num_blocks(ns->bdev));
-			ns_changed = true;
-		} else if (ns_info->anagrpid != ns->anagrpid) {
-			/* Namespace is still there but ANA group ID has changed */
-			SPDK_DEBUGLOG(nvmf, "ANA group ID changed: subsystem_id %u,"
-				      "nsid %u, pg %p, old %u, new %u\n",
-				      subsystem->id,
-				      ns->nsid,
-				      group,
-				      ns_info->anagrpid,
-				      ns->anagrpid);
-			ns_changed = true;
 		}
-
-		if (ns == NULL) {
-			memset(ns_info, 0, sizeof(*ns_info));
-		} else {
-			ns_info->uuid = *spdk_bdev_get_uuid(ns->bdev);
-			ns_info->num_blocks = spdk_bdev_get_num_blocks(ns->bdev);
-			ns_info->anagrpid = ns->anagrpid;
-			ns_info->crkey = ns->crkey;
-			ns_info->rtype = ns->rtype;
-			if (ns->holder) {
-				ns_info->holder_id = ns->holder->hostid;
-			}
-
-			memset(&ns_info->reg_hostid, 0, SPDK_NVMF_MAX_NUM_REGISTRANTS * sizeof(struct spdk_uuid));
-			j = 0;
-			TAILQ_FOREACH_SAFE(reg, &ns->registrants, link, tmp) {
-				if (j >= SPDK_NVMF_MAX_NUM_REGISTRANTS) {
-					SPDK_ERRLOG("Maximum %u registrants can support.\n", SPDK_NVMF_MAX_NUM_REGISTRANTS);
-					return -EINVAL;
-				}
-				ns_info->reg_hostid[j++] = reg->hostid;
+	} else {
+		for (i = 0; i < sgroup->num_ns; i++) {
+			rc = poll_group_update_ns(group, subsystem, sgroup, i, &ns_changed);
+			if (rc != 0) {
+				return rc;
 			}
 		}
 	}
@@ -1605,9 +2093,9 @@ poll_group_update_subsystem(struct spdk_nvmf_poll_group *group,
 
 int
 nvmf_poll_group_update_subsystem(struct spdk_nvmf_poll_group *group,
-				 struct spdk_nvmf_subsystem *subsystem)
+				 struct spdk_nvmf_subsystem *subsystem, uint32_t nsid)
 {
-	return poll_group_update_subsystem(group, subsystem);
+	return poll_group_update_subsystem(group, subsystem, nsid);
 }
 
 int
@@ -1630,7 +2118,7 @@ nvmf_poll_group_add_subsystem(struct spdk_nvmf_poll_group *group,
 		}
 	}
 
-	rc = poll_group_update_subsystem(group, subsystem);
+	rc = poll_group_update_subsystem(group, subsystem, 0);
 	if (rc) {
 		nvmf_poll_group_remove_subsystem(group, subsystem, NULL, NULL);
 		goto fini;
@@ -1679,6 +2167,7 @@ _nvmf_poll_group_remove_subsystem_cb(void *ctx, int status)
 			spdk_put_io_channel(sgroup->ns_info[nsid].channel);
 			sgroup->ns_info[nsid].channel = NULL;
 		}
+		nvmf_ns_qos_update_buckets(&sgroup->ns_info[nsid], NULL);
 	}
 
 	sgroup->num_ns = 0;
@@ -1761,6 +2250,21 @@ nvmf_poll_group_remove_subsystem(struct spdk_nvmf_poll_group *group,
 	nvmf_poll_group_remove_subsystem_msg(ctx);
 }
 
+static void
+poll_group_pause_ns(struct spdk_nvmf_subsystem_poll_group *sgroup,
+		    struct spdk_nvmf_subsystem_pg_ns_info *ns_info)
+{
+	/* Namespaces without I/O outstanding are paused right away, the others are
+	 * accounted for and get paused by the completion of their last request.
+	 */
+	if (ns_info->io_outstanding > 0) {
+		ns_info->state = SPDK_NVMF_SUBSYSTEM_PAUSING;
+		sgroup->num_ns_pausing++;
+	} else {
+		ns_info->state = SPDK_NVMF_SUBSYSTEM_PAUSED;
+	}
+}
+
 void
 nvmf_poll_group_pause_subsystem(struct spdk_nvmf_poll_group *group,
 				struct spdk_nvmf_subsystem *subsystem,
@@ -1768,7 +2272,6 @@ nvmf_poll_group_pause_subsystem(struct spdk_nvmf_poll_group *group,
 				spdk_nvmf_poll_group_mod_done cb_fn, void *cb_arg)
 {
 	struct spdk_nvmf_subsystem_poll_group *sgroup;
-	struct spdk_nvmf_subsystem_pg_ns_info *ns_info = NULL;
 	int rc = 0;
 	uint32_t i;
 
@@ -1782,21 +2285,20 @@ nvmf_poll_group_pause_subsystem(struct spdk_nvmf_poll_group *group,
 		goto fini;
 	}
 	sgroup->state = SPDK_NVMF_SUBSYSTEM_PAUSING;
+	sgroup->num_ns_pausing = 0;
 
 	if (nsid == SPDK_NVME_GLOBAL_NS_TAG) {
 		for (i = 0; i < sgroup->num_ns; i++) {
-			ns_info = &sgroup->ns_info[i];
-			ns_info->state = SPDK_NVMF_SUBSYSTEM_PAUSING;
+			poll_group_pause_ns(sgroup, &sgroup->ns_info[i]);
 		}
 	} else {
 		/* NOTE: This implicitly also checks for 0, since 0 - 1 wraps around to UINT32_MAX. */
 		if (nsid - 1 < sgroup->num_ns) {
-			ns_info  = &sgroup->ns_info[nsid - 1];
-			ns_info->state = SPDK_NVMF_SUBSYSTEM_PAUSING;
+			poll_group_pause_ns(sgroup, &sgroup->ns_info[nsid - 1]);
 		}
 	}
 
-	if (sgroup->mgmt_io_outstanding > 0) {
+	if (sgroup->mgmt_io_outstanding > 0 || sgroup->num_ns_pausing > 0) {
 		assert(sgroup->cb_fn == NULL);
 		sgroup->cb_fn = cb_fn;
 		assert(sgroup->cb_arg == NULL);
@@ -1804,28 +2306,6 @@ nvmf_poll_group_pause_subsystem(struct spdk_nvmf_poll_group *group,
 		return;
 	}
 
-	if (nsid == SPDK_NVME_GLOBAL_NS_TAG) {
-		for (i = 0; i < sgroup->num_ns; i++) {
-			ns_info = &sgroup->ns_info[i];
-
-			if (ns_info->io_outstanding > 0) {
-				assert(sgroup->cb_fn == NULL);
-				sgroup->cb_fn = cb_fn;
-				assert(sgroup->cb_arg == NULL);
-				sgroup->cb_arg = cb_arg;
-				return;
-			}
-		}
-	} else {
-		if (ns_info != NULL && ns_info->io_outstanding > 0) {
-			assert(sgroup->cb_fn == NULL);
-			sgroup->cb_fn = cb_fn;
-			assert(sgroup->cb_arg == NULL);
-			sgroup->cb_arg = cb_arg;
-			return;
-		}
-	}
-
 	assert(sgroup->mgmt_io_outstanding == 0);
 	sgroup->state = SPDK_NVMF_SUBSYSTEM_PAUSED;
 fini:
@@ -1842,7 +2322,7 @@ nvmf_poll_group_resume_subsystem(struct spdk_nvmf_poll_group *group,
 	struct spdk_nvmf_request *req, *tmp;
 	struct spdk_nvmf_subsystem_poll_group *sgroup;
 	int rc = 0;
-	uint32_t i;
+	uint32_t i, nsid;
 
 	if (subsystem->id >= group->num_sgroups) {
 		rc = -1;
@@ -1855,13 +2335,21 @@ nvmf_poll_group_resume_subsystem(struct spdk_nvmf_poll_group *group,
 		goto fini;
 	}
 
-	rc = poll_group_update_subsystem(group, subsystem);
+	nsid = subsystem->paused_nsid;
+	rc = poll_group_update_subsystem(group, subsystem, nsid);
 	if (rc) {
 		goto fini;
 	}
 
-	for (i = 0; i < sgroup->num_ns; i++) {
-		sgroup->ns_info[i].state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
+	if (nsid != 0) {
+		/* Only the namespace the pause was scoped to could have been touched */
+		if (nsid - 1 < sgroup->num_ns) {
+			sgroup->ns_info[nsid - 1].state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
+		}
+	} else {
+		for (i = 0; i < sgroup->num_ns; i++) {
+			sgroup->ns_info[i].state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
+		}
 	}
 
 	sgroup->state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
@@ -1911,6 +2399,13 @@ spdk_nvmf_poll_group_dump_stat(struct spdk_nvmf_poll_group *group, struct spdk_j
 	spdk_json_write_named_uint32(w, "current_io_qpairs", group->stat.current_io_qpairs);
 	spdk_json_write_named_uint64(w, "pending_bdev_io", group->stat.pending_bdev_io);
 	spdk_json_write_named_uint64(w, "completed_nvme_io", group->stat.completed_nvme_io);
+	spdk_json_write_named_uint64(w, "auth_challenges", group->stat.auth_challenges);
+	spdk_json_write_named_uint64(w, "auth_challenge_ticks", group->stat.auth_challenge_ticks);
+	spdk_json_write_named_uint64(w, "auth_replies", group->stat.auth_replies);
+	spdk_json_write_named_uint64(w, "auth_reply_ticks", group->stat.auth_reply_ticks);
+	spdk_json_write_named_uint64(w, "auth_completed", group->stat.auth_completed);
+	spdk_json_write_named_uint64(w, "auth_ticks", group->stat.auth_ticks);
+	spdk_json_write_named_uint64(w, "auth_deferred", group->stat.auth_deferred);
 
 	spdk_json_write_named_array_begin(w, "transports");
 
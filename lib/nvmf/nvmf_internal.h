@@ -48,6 +48,8 @@ enum spdk_nvmf_subsystem_state {
 
 RB_HEAD(subsystem_tree, spdk_nvmf_subsystem);
 
+struct nvmf_auth_workers;
+
 struct spdk_nvmf_tgt {
 	char					name[NVMF_TGT_NAME_MAX_LENGTH];
 
@@ -82,6 +84,13 @@ struct spdk_nvmf_tgt {
 	uint32_t				dhchap_digests;
 	uint32_t				dhchap_dhgroups;
 
+	/* Load balancing of qpairs across poll groups */
+	bool					load_aware_placement;
+	uint32_t				qpair_migration_threshold;
+
+	/* Threads computing DH-HMAC-CHAP messages off the poll group threads */
+	struct nvmf_auth_workers		*auth_workers;
+
 	TAILQ_ENTRY(spdk_nvmf_tgt)		link;
 };
 
@@ -113,6 +122,34 @@ struct spdk_nvmf_referral {
 	TAILQ_ENTRY(spdk_nvmf_referral) link;
 };
 
+enum nvmf_qos_rate_limit_type {
+	NVMF_QOS_RW_IOPS_RATE_LIMIT,
+	NVMF_QOS_RW_BPS_RATE_LIMIT,
+	NVMF_QOS_NUM_RATE_LIMIT_TYPES
+};
+
+/*
+ * Rate limits of the I/O a host sends to a namespace. The limits are shared by all poll
+ * groups: each of them keeps a token bucket that is topped up from the common pool, which
+ * is in turn replenished with the configured rate as the tokens are consumed.
+ */
+struct spdk_nvmf_ns_qos {
+	char					hostnqn[SPDK_NVMF_NQN_MAX_LEN + 1];
+	/* Limits per second, 0 if unlimited */
+	uint64_t				limits[NVMF_QOS_NUM_RATE_LIMIT_TYPES];
+	/* Tokens not handed out to the poll groups yet, accessed atomically */
+	int64_t					pool[NVMF_QOS_NUM_RATE_LIMIT_TYPES];
+	/* Fraction of a token carried over between the refills of the pool, in tokens * us */
+	uint64_t				remainder[NVMF_QOS_NUM_RATE_LIMIT_TYPES];
+	uint64_t				last_refill_tsc;
+	/* Number of poll groups with a token bucket for these limits */
+	uint32_t				num_buckets;
+	uint32_t				refcnt;
+	TAILQ_ENTRY(spdk_nvmf_ns_qos)		link;
+};
+
+struct nvmf_qos_bucket;
+
 struct spdk_nvmf_subsystem_pg_ns_info {
 	struct spdk_io_channel		*channel;
 	struct spdk_uuid		uuid;
@@ -130,6 +167,9 @@ struct spdk_nvmf_subsystem_pg_ns_info {
 	/* I/O outstanding to this namespace */
 	uint64_t			io_outstanding;
 	enum spdk_nvmf_subsystem_state	state;
+
+	/* Token buckets of the hosts with rate limits on this namespace */
+	struct nvmf_qos_bucket		*qos_buckets;
 };
 
 typedef void(*spdk_nvmf_poll_group_mod_done)(void *cb_arg, int status);
@@ -142,6 +182,8 @@ struct spdk_nvmf_subsystem_poll_group {
 
 	/* Number of ADMIN and FABRICS requests outstanding */
 	uint64_t				mgmt_io_outstanding;
+	/* Number of namespaces being paused that still have I/O outstanding */
+	uint32_t				num_ns_pausing;
 	spdk_nvmf_poll_group_mod_done		cb_fn;
 	void					*cb_arg;
 
@@ -188,6 +230,8 @@ struct spdk_nvmf_ns {
 	bool always_visible;
 	/* Namespace id of the underlying device, used for passthrough commands */
 	uint32_t passthrough_nsid;
+	/* Rate limits of the hosts accessing this namespace */
+	TAILQ_HEAD(, spdk_nvmf_ns_qos) qos;
 };
 
 /*
@@ -314,6 +358,10 @@ struct spdk_nvmf_subsystem {
 	/* Array of pointers to namespaces of size max_nsid indexed by nsid - 1 */
 	struct spdk_nvmf_ns				**ns;
 	uint32_t					max_nsid;
+	/* Namespace the current pause is scoped to, 0 if the whole subsystem needs
+	 * to be refreshed when it is resumed.
+	 */
+	uint32_t					paused_nsid;
 
 	uint16_t					min_cntlid;
 	uint16_t					max_cntlid;
@@ -363,7 +411,7 @@ subsystem_cmp(struct spdk_nvmf_subsystem *subsystem1, struct spdk_nvmf_subsystem
 RB_GENERATE_STATIC(subsystem_tree, spdk_nvmf_subsystem, link, subsystem_cmp);
 
 int nvmf_poll_group_update_subsystem(struct spdk_nvmf_poll_group *group,
-				     struct spdk_nvmf_subsystem *subsystem);
+				     struct spdk_nvmf_subsystem *subsystem, uint32_t nsid);
 int nvmf_poll_group_add_subsystem(struct spdk_nvmf_poll_group *group,
 				  struct spdk_nvmf_subsystem *subsystem,
 				  spdk_nvmf_poll_group_mod_done cb_fn, void *cb_arg);
@@ -376,11 +424,41 @@ void nvmf_poll_group_pause_subsystem(struct spdk_nvmf_poll_group *group,
 void nvmf_poll_group_resume_subsystem(struct spdk_nvmf_poll_group *group,
 				      struct spdk_nvmf_subsystem *subsystem, spdk_nvmf_poll_group_mod_done cb_fn, void *cb_arg);
 
+/*
+ * Returns the transport's poll group on the least loaded poll group of the target, or NULL if
+ * load-aware placement is disabled. Used by transports to pick poll groups for new qpairs.
+ */
+struct spdk_nvmf_transport_poll_group *nvmf_transport_get_least_loaded_poll_group(
+	struct spdk_nvmf_transport *transport);
+
 void nvmf_update_discovery_log(struct spdk_nvmf_tgt *tgt, const char *hostnqn);
 void nvmf_get_discovery_log_page(struct spdk_nvmf_tgt *tgt, const char *hostnqn, struct iovec *iov,
 				 uint32_t iovcnt, uint64_t offset, uint32_t length,
 				 struct spdk_nvme_transport_id *cmd_source_trid);
 
+/*
+ * Synchronize the poll group's token buckets of a namespace with its rate limits. Passing
+ * NULL ns releases all of them.
+ */
+int nvmf_ns_qos_update_buckets(struct spdk_nvmf_subsystem_pg_ns_info *ns_info,
+			       struct spdk_nvmf_ns *ns);
+/* Drop all rate limits of a namespace that is being removed */
+void nvmf_ns_qos_clear(struct spdk_nvmf_ns *ns);
+/*
+ * Charge an I/O against the rate limits of its host. Returns false if the request was
+ * queued until enough tokens are available, in which case it is executed later on.
+ */
+bool nvmf_qos_admit(struct spdk_nvmf_request *req, struct spdk_nvmf_subsystem_pg_ns_info *ns_info);
+
+typedef void (*nvmf_reservation_bdev_store_init_cb)(void *cb_arg, int status);
+/*
+ * Load the reservation information stored on a bdev and keep it there from now on. cb_fn
+ * is called once it's loaded, unless an error is returned.
+ */
+int nvmf_reservation_bdev_store_init(const char *bdev_name,
+				     nvmf_reservation_bdev_store_init_cb cb_fn, void *cb_arg);
+void nvmf_reservation_bdev_store_write_config_json(struct spdk_json_write_ctx *w);
+
 void nvmf_ctrlr_destruct(struct spdk_nvmf_ctrlr *ctrlr);
 int nvmf_ctrlr_process_admin_cmd(struct spdk_nvmf_request *req);
 int nvmf_ctrlr_process_io_cmd(struct spdk_nvmf_request *req);
@@ -415,6 +493,7 @@ int nvmf_bdev_ctrlr_nvme_passthru_io(struct spdk_bdev *bdev, struct spdk_bdev_de
 bool nvmf_bdev_ctrlr_get_dif_ctx(struct spdk_bdev *bdev, struct spdk_nvme_cmd *cmd,
 				 struct spdk_dif_ctx *dif_ctx);
 bool nvmf_bdev_zcopy_enabled(struct spdk_bdev *bdev);
+bool nvmf_bdev_ctrlr_read_buf_fits(struct spdk_bdev *bdev, struct spdk_nvmf_request *req);
 
 int nvmf_subsystem_add_ctrlr(struct spdk_nvmf_subsystem *subsystem,
 			     struct spdk_nvmf_ctrlr *ctrlr);
@@ -529,6 +608,9 @@ void nvmf_qpair_auth_dump(struct spdk_nvmf_qpair *qpair, struct spdk_json_write_
 
 int nvmf_auth_request_exec(struct spdk_nvmf_request *req);
 bool nvmf_auth_is_supported(void);
+int nvmf_auth_workers_create(struct spdk_nvmf_tgt *tgt, uint32_t num_threads,
+			     uint32_t queue_depth);
+void nvmf_auth_workers_destroy(struct spdk_nvmf_tgt *tgt);
 
 static inline bool
 nvmf_request_is_fabric_connect(struct spdk_nvmf_request *req)
@@ -1948,6 +1948,170 @@ rpc_nvmf_ns_remove_host(struct spdk_jsonrpc_request *request,
 }
 SPDK_RPC_REGISTER("nvmf_ns_remove_host", rpc_nvmf_ns_remove_host, SPDK_RPC_RUNTIME)
 
+struct nvmf_rpc_ns_qos_ctx {
+	struct spdk_jsonrpc_request *request;
+	char *nqn;
+	uint32_t nsid;
+	char *host;
+	char *tgt_name;
+	uint64_t rw_ios_per_sec;
+	uint64_t rw_mbytes_per_sec;
+	bool response_sent;
+};
+
+static const struct spdk_json_object_decoder nvmf_rpc_ns_qos_decoder[] = {
+	{"nqn", offsetof(struct nvmf_rpc_ns_qos_ctx, nqn), spdk_json_decode_string},
+	{"nsid", offsetof(struct nvmf_rpc_ns_qos_ctx, nsid), spdk_json_decode_uint32},
+	{"host", offsetof(struct nvmf_rpc_ns_qos_ctx, host), spdk_json_decode_string},
+	{"rw_ios_per_sec", offsetof(struct nvmf_rpc_ns_qos_ctx, rw_ios_per_sec), spdk_json_decode_uint64, true},
+	{"rw_mbytes_per_sec", offsetof(struct nvmf_rpc_ns_qos_ctx, rw_mbytes_per_sec), spdk_json_decode_uint64, true},
+	{"tgt_name", offsetof(struct nvmf_rpc_ns_qos_ctx, tgt_name), spdk_json_decode_string, true},
+};
+
+static void
+nvmf_rpc_ns_qos_ctx_free(struct nvmf_rpc_ns_qos_ctx *ctx)
+{
+	free(ctx->nqn);
+	free(ctx->host);
+	free(ctx->tgt_name);
+	free(ctx);
+}
+
+static void
+nvmf_rpc_ns_qos_resumed(struct spdk_nvmf_subsystem *subsystem,
+			void *cb_arg, int status)
+{
+	struct nvmf_rpc_ns_qos_ctx *ctx = cb_arg;
+	struct spdk_jsonrpc_request *request = ctx->request;
+	bool response_sent = ctx->response_sent;
+
+	nvmf_rpc_ns_qos_ctx_free(ctx);
+
+	if (!response_sent) {
+		spdk_jsonrpc_send_bool_response(request, true);
+	}
+}
+
+static void
+nvmf_rpc_ns_qos_paused(struct spdk_nvmf_subsystem *subsystem,
+		       void *cb_arg, int status)
+{
+	struct nvmf_rpc_ns_qos_ctx *ctx = cb_arg;
+	int ret;
+
+	ret = spdk_nvmf_ns_set_qos_limits(subsystem, ctx->nsid, ctx->host, ctx->rw_ios_per_sec,
+					  ctx->rw_mbytes_per_sec);
+	if (ret < 0) {
+		SPDK_ERRLOG("Unable to set QoS limits of %s on namespace ID %u\n", ctx->host, ctx->nsid);
+		spdk_jsonrpc_send_error_response(ctx->request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
+						 spdk_strerror(-ret));
+		ctx->response_sent = true;
+	}
+
+	if (spdk_nvmf_subsystem_resume(subsystem, nvmf_rpc_ns_qos_resumed, ctx)) {
+		if (!ctx->response_sent) {
+			spdk_jsonrpc_send_error_response(ctx->request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR, "Internal error");
+		}
+		nvmf_rpc_ns_qos_ctx_free(ctx);
+	}
+}
+
+static void
+rpc_nvmf_ns_set_qos_limits(struct spdk_jsonrpc_request *request,
+			   const struct spdk_json_val *params)
+{
+	struct nvmf_rpc_ns_qos_ctx *ctx;
+	struct spdk_nvmf_subsystem *subsystem;
+	struct spdk_nvmf_tgt *tgt;
+	int rc;
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (!ctx) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR, "Out of memory");
+		return;
+	}
+
+	if (spdk_json_decode_object(params, nvmf_rpc_ns_qos_decoder,
+				    SPDK_COUNTOF(nvmf_rpc_ns_qos_decoder),
+				    ctx)) {
+		SPDK_ERRLOG("spdk_json_decode_object failed\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS, "Invalid parameters");
+		nvmf_rpc_ns_qos_ctx_free(ctx);
+		return;
+	}
+	ctx->request = request;
+
+	tgt = spdk_nvmf_get_tgt(ctx->tgt_name);
+	if (!tgt) {
+		SPDK_ERRLOG("Unable to find a target object.\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+						 "Unable to find a target.");
+		nvmf_rpc_ns_qos_ctx_free(ctx);
+		return;
+	}
+
+	subsystem = spdk_nvmf_tgt_find_subsystem(tgt, ctx->nqn);
+	if (!subsystem) {
+		SPDK_ERRLOG("Unable to find subsystem with NQN %s\n", ctx->nqn);
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS, "Invalid parameters");
+		nvmf_rpc_ns_qos_ctx_free(ctx);
+		return;
+	}
+
+	rc = spdk_nvmf_subsystem_pause(subsystem, ctx->nsid, nvmf_rpc_ns_qos_paused, ctx);
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR, "Internal error");
+		nvmf_rpc_ns_qos_ctx_free(ctx);
+	}
+}
+SPDK_RPC_REGISTER("nvmf_ns_set_qos_limits", rpc_nvmf_ns_set_qos_limits, SPDK_RPC_RUNTIME)
+
+struct nvmf_rpc_reservation_store {
+	char *bdev_name;
+};
+
+static const struct spdk_json_object_decoder nvmf_rpc_reservation_store_decoder[] = {
+	{"bdev_name", offsetof(struct nvmf_rpc_reservation_store, bdev_name), spdk_json_decode_string},
+};
+
+static void
+rpc_nvmf_set_reservation_store_done(void *cb_arg, int status)
+{
+	struct spdk_jsonrpc_request *request = cb_arg;
+
+	if (status != 0) {
+		spdk_jsonrpc_send_error_response(request, status, spdk_strerror(-status));
+		return;
+	}
+
+	spdk_jsonrpc_send_bool_response(request, true);
+}
+
+static void
+rpc_nvmf_set_reservation_store(struct spdk_jsonrpc_request *request,
+			       const struct spdk_json_val *params)
+{
+	struct nvmf_rpc_reservation_store req = {};
+	int rc;
+
+	if (spdk_json_decode_object(params, nvmf_rpc_reservation_store_decoder,
+				    SPDK_COUNTOF(nvmf_rpc_reservation_store_decoder),
+				    &req)) {
+		SPDK_ERRLOG("spdk_json_decode_object failed\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS, "Invalid parameters");
+		return;
+	}
+
+	rc = nvmf_reservation_bdev_store_init(req.bdev_name, rpc_nvmf_set_reservation_store_done,
+					      request);
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response(request, rc, spdk_strerror(-rc));
+	}
+
+	free(req.bdev_name);
+}
+SPDK_RPC_REGISTER("nvmf_set_reservation_store", rpc_nvmf_set_reservation_store, SPDK_RPC_RUNTIME)
+
 struct nvmf_rpc_host_ctx {
 	struct spdk_jsonrpc_request *request;
 	char *nqn;
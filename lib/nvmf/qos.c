@@ -0,0 +1,403 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2026 Samsung Electronics Co., Ltd.
+ *   All rights reserved.
+ */
+
+#include "spdk/stdinc.h"
+
+#include "spdk/env.h"
+#include "spdk/log.h"
+#include "spdk/nvmf.h"
+#include "spdk/thread.h"
+#include "spdk/util.h"
+
+#include "nvmf_internal.h"
+
+/*
+ * Period in which the shared pool of tokens is replenished. It is also the amount of tokens
+ * a poll group takes from the pool at once (divided by the number of poll groups) and the
+ * period of the poller retrying the requests that had to wait for tokens.
+ */
+#define NVMF_QOS_TIMESLICE_US	1000
+/* Limit of the tokens accumulated in the pool while the host is idle */
+#define NVMF_QOS_MAX_BURST_US	(4 * NVMF_QOS_TIMESLICE_US)
+
+struct nvmf_qos_bucket {
+	struct spdk_nvmf_ns_qos			*qos;
+	/*
+	 * Tokens available to the poll group. The count can drop below zero if an I/O larger
+	 * than what is left is let through, the debt is paid off by the next refills.
+	 */
+	int64_t					tokens[NVMF_QOS_NUM_RATE_LIMIT_TYPES];
+	/* Requests waiting for tokens, linked through buf_link */
+	STAILQ_HEAD(, spdk_nvmf_request)	queued;
+	struct spdk_poller			*poller;
+	struct nvmf_qos_bucket			*next;
+};
+
+static inline int64_t
+nvmf_qos_tokens_per_us(const struct spdk_nvmf_ns_qos *qos, int type, uint64_t us)
+{
+	return spdk_max(qos->limits[type] * us / SPDK_SEC_TO_USEC, 1);
+}
+
+static void
+nvmf_qos_pool_refill(struct spdk_nvmf_ns_qos *qos)
+{
+	uint64_t now, last, ticks_hz, elapsed_us, tokens;
+	int64_t avail, burst;
+	int i;
+
+	now = spdk_get_ticks();
+	ticks_hz = spdk_get_ticks_hz();
+	last = __atomic_load_n(&qos->last_refill_tsc, __ATOMIC_ACQUIRE);
+	if (now - last < ticks_hz * NVMF_QOS_TIMESLICE_US / SPDK_SEC_TO_USEC) {
+		return;
+	}
+
+	/* Whichever poll group gets here first replenishes the pool for this timeslice */
+	if (!__atomic_compare_exchange_n(&qos->last_refill_tsc, &last, now, false,
+					 __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+		return;
+	}
+
+	elapsed_us = spdk_min(now - last, ticks_hz) * SPDK_SEC_TO_USEC / ticks_hz;
+	for (i = 0; i < NVMF_QOS_NUM_RATE_LIMIT_TYPES; i++) {
+		if (qos->limits[i] == 0) {
+			continue;
+		}
+
+		tokens = qos->limits[i] * elapsed_us + qos->remainder[i];
+		qos->remainder[i] = tokens % SPDK_SEC_TO_USEC;
+		burst = nvmf_qos_tokens_per_us(qos, i, NVMF_QOS_MAX_BURST_US);
+
+		avail = __atomic_load_n(&qos->pool[i], __ATOMIC_RELAXED);
+		while (!__atomic_compare_exchange_n(&qos->pool[i], &avail,
+						    spdk_min(avail + (int64_t)(tokens / SPDK_SEC_TO_USEC), burst),
+						    true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+		}
+	}
+}
+
+static int64_t
+nvmf_qos_pool_get(struct spdk_nvmf_ns_qos *qos, int type, int64_t count)
+{
+	int64_t avail, taken;
+
+	nvmf_qos_pool_refill(qos);
+
+	avail = __atomic_load_n(&qos->pool[type], __ATOMIC_RELAXED);
+	do {
+		if (avail <= 0) {
+			return 0;
+		}
+		taken = spdk_min(avail, count);
+	} while (!__atomic_compare_exchange_n(&qos->pool[type], &avail, avail - taken, true,
+					      __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	return taken;
+}
+
+static bool
+nvmf_qos_bucket_take(struct nvmf_qos_bucket *bucket, uint64_t length)
+{
+	struct spdk_nvmf_ns_qos *qos = bucket->qos;
+	const int64_t cost[NVMF_QOS_NUM_RATE_LIMIT_TYPES] = { 1, length };
+	uint32_t num_buckets;
+	int64_t batch;
+	int i;
+
+	for (i = 0; i < NVMF_QOS_NUM_RATE_LIMIT_TYPES; i++) {
+		if (qos->limits[i] == 0 || spdk_likely(bucket->tokens[i] > 0)) {
+			continue;
+		}
+
+		/* Take this poll group's share of a timeslice from the pool */
+		num_buckets = spdk_max(__atomic_load_n(&qos->num_buckets, __ATOMIC_RELAXED), 1);
+		batch = spdk_max(nvmf_qos_tokens_per_us(qos, i, NVMF_QOS_TIMESLICE_US) / num_buckets, 1);
+		bucket->tokens[i] += nvmf_qos_pool_get(qos, i, batch - bucket->tokens[i]);
+		if (bucket->tokens[i] <= 0) {
+			return false;
+		}
+	}
+
+	for (i = 0; i < NVMF_QOS_NUM_RATE_LIMIT_TYPES; i++) {
+		if (qos->limits[i] != 0) {
+			bucket->tokens[i] -= cost[i];
+		}
+	}
+
+	return true;
+}
+
+static void
+nvmf_qos_exec(struct spdk_nvmf_request *req)
+{
+	if (spdk_unlikely(req->qpair->state != SPDK_NVMF_QPAIR_ENABLED)) {
+		req->rsp->nvme_cpl.status.sct = SPDK_NVME_SCT_GENERIC;
+		req->rsp->nvme_cpl.status.sc = SPDK_NVME_SC_ABORTED_SQ_DELETION;
+		spdk_nvmf_request_complete(req);
+		return;
+	}
+
+	if (nvmf_ctrlr_process_io_cmd(req) == SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE) {
+		spdk_nvmf_request_complete(req);
+	}
+}
+
+static int
+nvmf_qos_bucket_poll(void *ctx)
+{
+	struct nvmf_qos_bucket *bucket = ctx;
+	struct spdk_nvmf_request *req;
+	int count = 0;
+
+	while ((req = STAILQ_FIRST(&bucket->queued)) != NULL) {
+		if (!nvmf_qos_bucket_take(bucket, req->length)) {
+			break;
+		}
+
+		STAILQ_REMOVE_HEAD(&bucket->queued, buf_link);
+		nvmf_qos_exec(req);
+		count++;
+	}
+
+	if (STAILQ_EMPTY(&bucket->queued)) {
+		spdk_poller_unregister(&bucket->poller);
+	}
+
+	return count > 0 ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
+}
+
+static struct nvmf_qos_bucket *
+nvmf_qos_find_bucket(struct spdk_nvmf_subsystem_pg_ns_info *ns_info, const char *hostnqn)
+{
+	struct nvmf_qos_bucket *bucket;
+
+	for (bucket = ns_info->qos_buckets; bucket != NULL; bucket = bucket->next) {
+		if (strcmp(bucket->qos->hostnqn, hostnqn) == 0) {
+			return bucket;
+		}
+	}
+
+	return NULL;
+}
+
+bool
+nvmf_qos_admit(struct spdk_nvmf_request *req, struct spdk_nvmf_subsystem_pg_ns_info *ns_info)
+{
+	struct spdk_nvme_cmd *cmd = &req->cmd->nvme_cmd;
+	struct nvmf_qos_bucket *bucket;
+
+	/* Only reads and writes are limited. Fused commands are never held back so that the
+	 * two halves stay together.
+	 */
+	if ((cmd->opc != SPDK_NVME_OPC_READ && cmd->opc != SPDK_NVME_OPC_WRITE) ||
+	    cmd->fuse != SPDK_NVME_CMD_FUSE_NONE) {
+		return true;
+	}
+
+	bucket = nvmf_qos_find_bucket(ns_info, req->qpair->ctrlr->hostnqn);
+	if (bucket == NULL) {
+		return true;
+	}
+
+	if (spdk_likely(STAILQ_EMPTY(&bucket->queued)) && nvmf_qos_bucket_take(bucket, req->length)) {
+		return true;
+	}
+
+	if (bucket->poller == NULL) {
+		bucket->poller = SPDK_POLLER_REGISTER(nvmf_qos_bucket_poll, bucket, NVMF_QOS_TIMESLICE_US);
+		if (spdk_unlikely(bucket->poller == NULL)) {
+			SPDK_ERRLOG("Failed to register QoS poller, not throttling I/O from %s\n",
+				    bucket->qos->hostnqn);
+			return true;
+		}
+	}
+
+	STAILQ_INSERT_TAIL(&bucket->queued, req, buf_link);
+
+	return false;
+}
+
+static void
+nvmf_ns_qos_put(struct spdk_nvmf_ns_qos *qos)
+{
+	if (__atomic_sub_fetch(&qos->refcnt, 1, __ATOMIC_ACQ_REL) == 0) {
+		free(qos);
+	}
+}
+
+static void
+nvmf_qos_bucket_free(struct nvmf_qos_bucket *bucket)
+{
+	/* The namespace is paused while the buckets are updated, nothing can be waiting */
+	assert(STAILQ_EMPTY(&bucket->queued));
+	spdk_poller_unregister(&bucket->poller);
+
+	__atomic_fetch_sub(&bucket->qos->num_buckets, 1, __ATOMIC_RELAXED);
+	nvmf_ns_qos_put(bucket->qos);
+	free(bucket);
+}
+
+static bool
+nvmf_ns_has_qos(struct spdk_nvmf_ns *ns, struct spdk_nvmf_ns_qos *qos)
+{
+	struct spdk_nvmf_ns_qos *tmp;
+
+	TAILQ_FOREACH(tmp, &ns->qos, link) {
+		if (tmp == qos) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int
+nvmf_ns_qos_update_buckets(struct spdk_nvmf_subsystem_pg_ns_info *ns_info,
+			   struct spdk_nvmf_ns *ns)
+{
+	struct nvmf_qos_bucket **prev, *bucket;
+	struct spdk_nvmf_ns_qos *qos;
+
+	prev = &ns_info->qos_buckets;
+	while ((bucket = *prev) != NULL) {
+		if (ns != NULL && nvmf_ns_has_qos(ns, bucket->qos)) {
+			prev = &bucket->next;
+			continue;
+		}
+
+		*prev = bucket->next;
+		nvmf_qos_bucket_free(bucket);
+	}
+
+	if (ns == NULL) {
+		return 0;
+	}
+
+	TAILQ_FOREACH(qos, &ns->qos, link) {
+		for (bucket = ns_info->qos_buckets; bucket != NULL; bucket = bucket->next) {
+			if (bucket->qos == qos) {
+				break;
+			}
+		}
+		if (bucket != NULL) {
+			continue;
+		}
+
+		bucket = calloc(1, sizeof(*bucket));
+		if (bucket == NULL) {
+			SPDK_ERRLOG("Failed to allocate QoS bucket\n");
+			return -ENOMEM;
+		}
+
+		STAILQ_INIT(&bucket->queued);
+		bucket->qos = qos;
+		__atomic_fetch_add(&qos->refcnt, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&qos->num_buckets, 1, __ATOMIC_RELAXED);
+
+		bucket->next = ns_info->qos_buckets;
+		ns_info->qos_buckets = bucket;
+	}
+
+	return 0;
+}
+
+static struct spdk_nvmf_ns_qos *
+nvmf_ns_find_qos(struct spdk_nvmf_ns *ns, const char *hostnqn)
+{
+	struct spdk_nvmf_ns_qos *qos;
+
+	TAILQ_FOREACH(qos, &ns->qos, link) {
+		if (strcmp(qos->hostnqn, hostnqn) == 0) {
+			return qos;
+		}
+	}
+
+	return NULL;
+}
+
+static void
+nvmf_ns_remove_qos(struct spdk_nvmf_ns *ns, struct spdk_nvmf_ns_qos *qos)
+{
+	TAILQ_REMOVE(&ns->qos, qos, link);
+	nvmf_ns_qos_put(qos);
+}
+
+void
+nvmf_ns_qos_clear(struct spdk_nvmf_ns *ns)
+{
+	struct spdk_nvmf_ns_qos *qos, *tmp;
+
+	TAILQ_FOREACH_SAFE(qos, &ns->qos, link, tmp) {
+		nvmf_ns_remove_qos(ns, qos);
+	}
+}
+
+int
+spdk_nvmf_ns_set_qos_limits(struct spdk_nvmf_subsystem *subsystem, uint32_t nsid,
+			    const char *hostnqn, uint64_t rw_ios_per_sec,
+			    uint64_t rw_mbytes_per_sec)
+{
+	struct spdk_nvmf_ns *ns;
+	struct spdk_nvmf_ns_qos *qos;
+	int i;
+
+	if (!(subsystem->state == SPDK_NVMF_SUBSYSTEM_INACTIVE ||
+	      subsystem->state == SPDK_NVMF_SUBSYSTEM_PAUSED)) {
+		assert(false);
+		return -EBUSY;
+	}
+
+	if (hostnqn == NULL || !nvmf_nqn_is_valid(hostnqn)) {
+		return -EINVAL;
+	}
+
+	/* Keep the refill arithmetic, done in tokens * us, from overflowing */
+	if (rw_ios_per_sec > UINT64_MAX / SPDK_SEC_TO_USEC / 2 ||
+	    rw_mbytes_per_sec > UINT64_MAX / SPDK_SEC_TO_USEC / 2 / (1024 * 1024)) {
+		return -EINVAL;
+	}
+
+	if (nsid == 0 || nsid > subsystem->max_nsid) {
+		return -EINVAL;
+	}
+
+	ns = subsystem->ns[nsid - 1];
+	if (!ns) {
+		return -ENOENT;
+	}
+
+	qos = nvmf_ns_find_qos(ns, hostnqn);
+	if (rw_ios_per_sec == 0 && rw_mbytes_per_sec == 0) {
+		if (qos != NULL) {
+			nvmf_ns_remove_qos(ns, qos);
+		}
+		return 0;
+	}
+
+	if (qos == NULL) {
+		qos = calloc(1, sizeof(*qos));
+		if (qos == NULL) {
+			return -ENOMEM;
+		}
+		snprintf(qos->hostnqn, sizeof(qos->hostnqn), "%s", hostnqn);
+		qos->refcnt = 1;
+		TAILQ_INSERT_TAIL(&ns->qos, qos, link);
+	}
+
+	qos->limits[NVMF_QOS_RW_IOPS_RATE_LIMIT] = rw_ios_per_sec;
+	qos->limits[NVMF_QOS_RW_BPS_RATE_LIMIT] = rw_mbytes_per_sec * 1024 * 1024;
+
+	/* Start out with a timeslice worth of tokens. Nothing can be using the pool while the
+	 * namespace is paused.
+	 */
+	for (i = 0; i < NVMF_QOS_NUM_RATE_LIMIT_TYPES; i++) {
+		qos->pool[i] = qos->limits[i] ? nvmf_qos_tokens_per_us(qos, i, NVMF_QOS_TIMESLICE_US) : 0;
+		qos->remainder[i] = 0;
+	}
+	qos->last_refill_tsc = spdk_get_ticks();
+
+	return 0;
+}
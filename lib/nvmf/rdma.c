@@ -350,6 +350,9 @@ struct spdk_nvmf_rdma_qpair {
 	/* The maximum number of SGEs per WR on the recv queue */
 	uint32_t				max_recv_sge;
 
+	/* Responses are sent inline, i.e. copied into the WQE */
+	bool					inline_rsp;
+
 	struct spdk_nvmf_rdma_resources		*resources;
 
 	STAILQ_HEAD(, spdk_nvmf_rdma_request)	pending_rdma_read_queue;
@@ -1003,6 +1006,9 @@ nvmf_rdma_qpair_initialize(struct spdk_nvmf_qpair *qpair)
 	qp_init_attr.cap.max_send_wr	= (uint32_t)rqpair->max_queue_depth * 2;
 	qp_init_attr.cap.max_send_sge	= spdk_min((uint32_t)device->attr.max_sge, NVMF_DEFAULT_TX_SGE);
 	qp_init_attr.cap.max_recv_sge	= spdk_min((uint32_t)device->attr.max_sge, NVMF_DEFAULT_RX_SGE);
+	/* Completions are small enough to be sent inline, which saves the NIC a DMA read of
+	 * the completion for every request. */
+	qp_init_attr.cap.max_inline_data = sizeof(struct spdk_nvme_cpl);
 	qp_init_attr.stats		= &rqpair->poller->stat.qp_stats;
 
 	if (rqpair->srq == NULL && nvmf_rdma_resize_cq(rqpair, device) < 0) {
@@ -1012,10 +1018,16 @@ nvmf_rdma_qpair_initialize(struct spdk_nvmf_qpair *qpair)
 
 	rqpair->rdma_qp = spdk_rdma_provider_qp_create(rqpair->cm_id, &qp_init_attr);
 	if (!rqpair->rdma_qp) {
-		goto error;
+		SPDK_NOTICELOG("Retrying to create qpair without inline data\n");
+		qp_init_attr.cap.max_inline_data = 0;
+		rqpair->rdma_qp = spdk_rdma_provider_qp_create(rqpair->cm_id, &qp_init_attr);
+		if (!rqpair->rdma_qp) {
+			goto error;
+		}
 	}
 
 	rqpair->qp_num = rqpair->rdma_qp->qp->qp_num;
+	rqpair->inline_rsp = qp_init_attr.cap.max_inline_data >= sizeof(struct spdk_nvme_cpl);
 
 	rqpair->max_send_depth = spdk_min((uint32_t)(rqpair->max_queue_depth * 2),
 					  qp_init_attr.cap.max_send_wr);
@@ -1192,6 +1204,9 @@ request_transfer_out(struct spdk_nvmf_request *req, int *data_posted)
 	 * containing the response.
 	 */
 	first = &rdma_req->rsp.wr;
+	/* The request may come from a shared receive queue, so set this on every send */
+	rdma_req->rsp.wr.send_flags = rqpair->inline_rsp ? IBV_SEND_SIGNALED | IBV_SEND_INLINE :
+				      IBV_SEND_SIGNALED;
 
 	if (spdk_unlikely(rsp->status.sc != SPDK_NVME_SC_SUCCESS)) {
 		/* On failure, data was not read from the controller. So clear the
@@ -4161,6 +4176,11 @@ nvmf_rdma_get_optimal_poll_group(struct spdk_nvmf_qpair *qpair)
 		return NULL;
 	}
 
+	result = nvmf_transport_get_least_loaded_poll_group(qpair->transport);
+	if (result != NULL) {
+		return result;
+	}
+
 	if (qpair->qid == 0) {
 		pg = &rtransport->conn_sched.next_admin_pg;
 	} else {
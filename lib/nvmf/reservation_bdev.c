@@ -0,0 +1,644 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2026 Samsung Electronics Co., Ltd.
+ *   All rights reserved.
+ */
+
+/*
+ * Reservation store keeping the namespace reservation information on a small bdev instead of
+ * in local JSON files.
+ *
+ * The bdev is divided into slots, one per namespace. A slot holds two copies of the record,
+ * written alternately, so that a torn write never loses the previously persisted state.
+ * Updates are written asynchronously and the updates received while a slot is being written
+ * are persisted together by the next write.
+ *
+ * The store supports a single writer. The slots are read once, when the store is set up, and
+ * are assigned from the in-memory state afterwards, so the bdev must not be used by more than
+ * one target at a time and the updates made by any other writer are never seen.
+ */
+
+#include "spdk/stdinc.h"
+
+#include "spdk/bdev.h"
+#include "spdk/bdev_module.h"
+#include "spdk/crc32.h"
+#include "spdk/env.h"
+#include "spdk/json.h"
+#include "spdk/log.h"
+#include "spdk/nvmf.h"
+#include "spdk/string.h"
+#include "spdk/thread.h"
+#include "spdk/util.h"
+
+#include "nvmf_internal.h"
+
+/* "SPDKRSV1" */
+#define NVMF_RSV_RECORD_MAGIC	0x5350444b52535631ULL
+#define NVMF_RSV_MAX_SLOTS	1024
+
+struct nvmf_rsv_record {
+	uint64_t				magic;
+	uint64_t				seq;
+	uint32_t				crc;
+	uint32_t				reserved;
+	struct spdk_nvmf_reservation_info	info;
+};
+
+struct nvmf_rsv_update {
+	struct spdk_nvmf_reservation_info	info;
+	spdk_nvmf_ns_reservation_update_cb	cb_fn;
+	void					*cb_arg;
+	struct spdk_thread			*thread;
+	int					status;
+	TAILQ_ENTRY(nvmf_rsv_update)		link;
+};
+
+struct nvmf_rsv_bdev_store;
+
+struct nvmf_rsv_slot {
+	struct nvmf_rsv_bdev_store		*store;
+	uint32_t				index;
+	bool					in_use;
+	bool					writing;
+	/* Sequence number of the last record written to the slot */
+	uint64_t				seq;
+	/* Latest reservation information, persisted or not */
+	struct spdk_nvmf_reservation_info	info;
+	struct nvmf_rsv_record			*buf;
+	struct spdk_bdev_io_wait_entry		bdev_io_wait;
+	/* Updates to be persisted by the next write */
+	TAILQ_HEAD(, nvmf_rsv_update)		pending;
+	/* Updates persisted by the write in progress */
+	TAILQ_HEAD(, nvmf_rsv_update)		inflight;
+};
+
+struct nvmf_rsv_bdev_store {
+	char					*bdev_name;
+	struct spdk_bdev_desc			*desc;
+	struct spdk_io_channel			*ch;
+	struct spdk_thread			*thread;
+	uint32_t				block_size;
+	uint32_t				slot_blocks;
+	uint32_t				num_slots;
+	struct nvmf_rsv_slot			*slots;
+	uint32_t				num_writing;
+	bool					loaded;
+	bool					removed;
+
+	/* Only used while the store is loaded */
+	void					*load_buf;
+	nvmf_reservation_bdev_store_init_cb	init_cb_fn;
+	void					*init_cb_arg;
+};
+
+static struct nvmf_rsv_bdev_store *g_rsv_store;
+/* Protects g_rsv_store and the slots' state read by the load callback on other threads */
+static pthread_mutex_t g_rsv_store_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static struct spdk_bdev_module rsv_bdev_module = {
+	.name	= "NVMe-oF Target reservations",
+};
+
+static uint32_t
+nvmf_rsv_record_crc(struct nvmf_rsv_record *record)
+{
+	uint32_t crc, saved_crc = record->crc;
+
+	record->crc = 0;
+	crc = spdk_crc32c_update(record, sizeof(*record), ~0);
+	record->crc = saved_crc;
+
+	return crc;
+}
+
+static bool
+nvmf_rsv_record_is_valid(struct nvmf_rsv_record *record)
+{
+	struct spdk_nvmf_reservation_info *info = &record->info;
+	uint32_t i;
+
+	if (record->magic != NVMF_RSV_RECORD_MAGIC || record->crc != nvmf_rsv_record_crc(record)) {
+		return false;
+	}
+
+	if (info->num_regs > SPDK_NVMF_MAX_NUM_REGISTRANTS ||
+	    strnlen(info->bdev_uuid, sizeof(info->bdev_uuid)) == sizeof(info->bdev_uuid) ||
+	    strnlen(info->holder_uuid, sizeof(info->holder_uuid)) == sizeof(info->holder_uuid)) {
+		return false;
+	}
+
+	for (i = 0; i < info->num_regs; i++) {
+		if (strnlen(info->registrants[i].host_uuid, sizeof(info->registrants[i].host_uuid)) ==
+		    sizeof(info->registrants[i].host_uuid)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static struct nvmf_rsv_slot *
+nvmf_rsv_slot_get(struct nvmf_rsv_bdev_store *store, const char *bdev_uuid, bool alloc)
+{
+	struct nvmf_rsv_slot *slot, *free_slot = NULL, *inactive_slot = NULL;
+	uint32_t i;
+
+	for (i = 0; i < store->num_slots; i++) {
+		slot = &store->slots[i];
+		if (!slot->in_use) {
+			free_slot = free_slot ? free_slot : slot;
+			continue;
+		}
+
+		if (strcmp(slot->info.bdev_uuid, bdev_uuid) == 0) {
+			return slot;
+		}
+
+		/* A slot with PTPL deactivated holds no state and can be reused if it's idle */
+		if (alloc && !slot->info.ptpl_activated && !slot->writing &&
+		    TAILQ_EMPTY(&slot->pending)) {
+			inactive_slot = inactive_slot ? inactive_slot : slot;
+		}
+	}
+
+	if (!alloc) {
+		return NULL;
+	}
+
+	slot = free_slot ? free_slot : inactive_slot;
+	if (slot != NULL) {
+		slot->in_use = true;
+		snprintf(slot->info.bdev_uuid, sizeof(slot->info.bdev_uuid), "%s", bdev_uuid);
+	}
+
+	return slot;
+}
+
+static void
+nvmf_rsv_store_free(struct nvmf_rsv_bdev_store *store)
+{
+	uint32_t i;
+
+	pthread_mutex_lock(&g_rsv_store_mutex);
+	if (g_rsv_store == store) {
+		g_rsv_store = NULL;
+	}
+	pthread_mutex_unlock(&g_rsv_store_mutex);
+
+	if (store->ch != NULL) {
+		spdk_put_io_channel(store->ch);
+	}
+	if (store->desc != NULL) {
+		spdk_bdev_module_release_bdev(spdk_bdev_desc_get_bdev(store->desc));
+		spdk_bdev_close(store->desc);
+	}
+
+	for (i = 0; i < store->num_slots; i++) {
+		spdk_dma_free(store->slots[i].buf);
+	}
+
+	spdk_dma_free(store->load_buf);
+	free(store->slots);
+	free(store->bdev_name);
+	free(store);
+}
+
+static void
+_nvmf_rsv_update_complete(void *ctx)
+{
+	struct nvmf_rsv_update *update = ctx;
+
+	update->cb_fn(update->cb_arg, update->status);
+	free(update);
+}
+
+static void
+nvmf_rsv_update_complete(struct nvmf_rsv_update *update, int status)
+{
+	update->status = status;
+
+	if (update->thread == spdk_get_thread()) {
+		_nvmf_rsv_update_complete(update);
+	} else {
+		spdk_thread_send_msg(update->thread, _nvmf_rsv_update_complete, update);
+	}
+}
+
+static void
+nvmf_rsv_slot_complete_updates(struct nvmf_rsv_slot *slot, int status)
+{
+	struct nvmf_rsv_update *update, *tmp;
+
+	TAILQ_FOREACH_SAFE(update, &slot->inflight, link, tmp) {
+		TAILQ_REMOVE(&slot->inflight, update, link);
+		nvmf_rsv_update_complete(update, status);
+	}
+}
+
+static void nvmf_rsv_slot_write(struct nvmf_rsv_slot *slot);
+static void nvmf_rsv_slot_submit(void *ctx);
+
+static void
+nvmf_rsv_slot_write_done(struct nvmf_rsv_slot *slot, int status)
+{
+	struct nvmf_rsv_bdev_store *store = slot->store;
+
+	assert(slot->writing);
+	slot->writing = false;
+	store->num_writing--;
+
+	if (status == 0) {
+		slot->seq++;
+	}
+
+	nvmf_rsv_slot_complete_updates(slot, status);
+
+	if (store->removed) {
+		TAILQ_CONCAT(&slot->inflight, &slot->pending, link);
+		nvmf_rsv_slot_complete_updates(slot, -ENODEV);
+		if (store->num_writing == 0) {
+			nvmf_rsv_store_free(store);
+		}
+		return;
+	}
+
+	if (!TAILQ_EMPTY(&slot->pending)) {
+		nvmf_rsv_slot_write(slot);
+	}
+}
+
+static void
+nvmf_rsv_slot_write_cpl(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct nvmf_rsv_slot *slot = cb_arg;
+
+	spdk_bdev_free_io(bdev_io);
+
+	if (!success) {
+		SPDK_ERRLOG("Failed to write reservation slot %u to bdev %s\n", slot->index,
+			    slot->store->bdev_name);
+	}
+
+	nvmf_rsv_slot_write_done(slot, success ? 0 : -EIO);
+}
+
+static void
+nvmf_rsv_slot_submit(void *ctx)
+{
+	struct nvmf_rsv_slot *slot = ctx;
+	struct nvmf_rsv_bdev_store *store = slot->store;
+	uint64_t seq = slot->seq + 1;
+	int rc;
+
+	if (store->removed) {
+		nvmf_rsv_slot_write_done(slot, -ENODEV);
+		return;
+	}
+
+	/* Always overwrite the older copy, the newer one stays valid until the write is done */
+	rc = spdk_bdev_write_blocks(store->desc, store->ch, slot->buf,
+				    (2 * slot->index + seq % 2) * store->slot_blocks,
+				    store->slot_blocks, nvmf_rsv_slot_write_cpl, slot);
+	if (rc == -ENOMEM) {
+		slot->bdev_io_wait.bdev = spdk_bdev_desc_get_bdev(store->desc);
+		slot->bdev_io_wait.cb_fn = nvmf_rsv_slot_submit;
+		slot->bdev_io_wait.cb_arg = slot;
+		spdk_bdev_queue_io_wait(slot->bdev_io_wait.bdev, store->ch, &slot->bdev_io_wait);
+	} else if (rc != 0) {
+		nvmf_rsv_slot_write_done(slot, rc);
+	}
+}
+
+static void
+nvmf_rsv_slot_write(struct nvmf_rsv_slot *slot)
+{
+	struct nvmf_rsv_bdev_store *store = slot->store;
+	struct nvmf_rsv_record *record;
+
+	assert(!slot->writing);
+	slot->writing = true;
+	store->num_writing++;
+	TAILQ_CONCAT(&slot->inflight, &slot->pending, link);
+
+	if (slot->buf == NULL) {
+		slot->buf = spdk_dma_zmalloc(store->slot_blocks * store->block_size,
+					     spdk_bdev_get_buf_align(spdk_bdev_desc_get_bdev(store->desc)),
+					     NULL);
+		if (slot->buf == NULL) {
+			nvmf_rsv_slot_write_done(slot, -ENOMEM);
+			return;
+		}
+	}
+
+	record = slot->buf;
+	memset(record, 0, store->slot_blocks * store->block_size);
+	record->magic = NVMF_RSV_RECORD_MAGIC;
+	record->seq = slot->seq + 1;
+	record->info = slot->info;
+	record->crc = nvmf_rsv_record_crc(record);
+
+	nvmf_rsv_slot_submit(slot);
+}
+
+static void
+_nvmf_rsv_bdev_update(void *ctx)
+{
+	struct nvmf_rsv_update *update = ctx;
+	struct nvmf_rsv_bdev_store *store = g_rsv_store;
+	struct nvmf_rsv_slot *slot;
+
+	if (store == NULL || store->removed) {
+		nvmf_rsv_update_complete(update, -ENODEV);
+		return;
+	}
+
+	pthread_mutex_lock(&g_rsv_store_mutex);
+	slot = nvmf_rsv_slot_get(store, update->info.bdev_uuid, true);
+	if (slot == NULL) {
+		pthread_mutex_unlock(&g_rsv_store_mutex);
+		SPDK_ERRLOG("No free reservation slot on bdev %s\n", store->bdev_name);
+		nvmf_rsv_update_complete(update, -ENOSPC);
+		return;
+	}
+
+	slot->info = update->info;
+	pthread_mutex_unlock(&g_rsv_store_mutex);
+
+	TAILQ_INSERT_TAIL(&slot->pending, update, link);
+
+	if (!slot->writing) {
+		nvmf_rsv_slot_write(slot);
+	}
+}
+
+static int
+nvmf_rsv_bdev_update(const struct spdk_nvmf_ns *ns, const struct spdk_nvmf_reservation_info *info,
+		     spdk_nvmf_ns_reservation_update_cb cb_fn, void *cb_arg)
+{
+	struct nvmf_rsv_bdev_store *store = g_rsv_store;
+	struct nvmf_rsv_update *update;
+
+	if (store == NULL || store->removed) {
+		return -ENODEV;
+	}
+
+	update = calloc(1, sizeof(*update));
+	if (update == NULL) {
+		return -ENOMEM;
+	}
+
+	update->info = *info;
+	update->cb_fn = cb_fn;
+	update->cb_arg = cb_arg;
+	update->thread = spdk_get_thread();
+
+	if (update->thread == store->thread) {
+		_nvmf_rsv_bdev_update(update);
+	} else {
+		spdk_thread_send_msg(store->thread, _nvmf_rsv_bdev_update, update);
+	}
+
+	return 0;
+}
+
+static int
+nvmf_rsv_bdev_load(const struct spdk_nvmf_ns *ns, struct spdk_nvmf_reservation_info *info)
+{
+	struct nvmf_rsv_bdev_store *store;
+	struct nvmf_rsv_slot *slot;
+	char bdev_uuid[SPDK_UUID_STRING_LEN];
+	int rc = 0;
+
+	spdk_uuid_fmt_lower(bdev_uuid, sizeof(bdev_uuid), spdk_bdev_get_uuid(ns->bdev));
+
+	/*
+	 * The namespace is added on its subsystem's thread, which doesn't have to be the store
+	 * thread, and the load callback has to return the information synchronously.
+	 */
+	pthread_mutex_lock(&g_rsv_store_mutex);
+	store = g_rsv_store;
+	if (store == NULL || store->removed) {
+		rc = -ENODEV;
+		goto out;
+	}
+
+	/* It's not an error if the namespace has no reservation information yet */
+	slot = nvmf_rsv_slot_get(store, bdev_uuid, false);
+	if (slot != NULL) {
+		*info = slot->info;
+	}
+out:
+	pthread_mutex_unlock(&g_rsv_store_mutex);
+	return rc;
+}
+
+static bool
+nvmf_rsv_bdev_is_ptpl_capable(const struct spdk_nvmf_ns *ns)
+{
+	bool capable;
+
+	pthread_mutex_lock(&g_rsv_store_mutex);
+	capable = g_rsv_store != NULL && !g_rsv_store->removed;
+	pthread_mutex_unlock(&g_rsv_store_mutex);
+
+	return capable;
+}
+
+static const struct spdk_nvmf_ns_reservation_ops g_rsv_bdev_ops = {
+	.is_ptpl_capable = nvmf_rsv_bdev_is_ptpl_capable,
+	.load = nvmf_rsv_bdev_load,
+	.update_async = nvmf_rsv_bdev_update,
+};
+
+static void
+nvmf_rsv_bdev_event_cb(enum spdk_bdev_event_type type, struct spdk_bdev *bdev, void *event_ctx)
+{
+	struct nvmf_rsv_bdev_store *store = event_ctx;
+
+	switch (type) {
+	case SPDK_BDEV_EVENT_REMOVE:
+		SPDK_NOTICELOG("Reservation store bdev %s removed\n", store->bdev_name);
+		pthread_mutex_lock(&g_rsv_store_mutex);
+		store->removed = true;
+		pthread_mutex_unlock(&g_rsv_store_mutex);
+		/* The store is freed by the last write if there are any in progress */
+		if (store->loaded && store->num_writing == 0) {
+			nvmf_rsv_store_free(store);
+		}
+		break;
+	default:
+		SPDK_NOTICELOG("Unsupported bdev event: type %d\n", type);
+		break;
+	}
+}
+
+static void
+nvmf_rsv_store_load_cpl(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct nvmf_rsv_bdev_store *store = cb_arg;
+	nvmf_reservation_bdev_store_init_cb cb_fn = store->init_cb_fn;
+	void *ctx = store->init_cb_arg;
+	struct nvmf_rsv_record *record, *latest;
+	struct nvmf_rsv_slot *slot;
+	uint32_t i, copy;
+
+	spdk_bdev_free_io(bdev_io);
+
+	if (!success || store->removed) {
+		SPDK_ERRLOG("Failed to load reservations from bdev %s\n", store->bdev_name);
+		nvmf_rsv_store_free(store);
+		cb_fn(ctx, -EIO);
+		return;
+	}
+
+	for (i = 0; i < store->num_slots; i++) {
+		slot = &store->slots[i];
+		latest = NULL;
+		for (copy = 0; copy < 2; copy++) {
+			record = (struct nvmf_rsv_record *)((uint8_t *)store->load_buf +
+							    (2 * i + copy) * store->slot_blocks * store->block_size);
+			if (nvmf_rsv_record_is_valid(record) && (latest == NULL || record->seq > latest->seq)) {
+				latest = record;
+			}
+		}
+
+		if (latest != NULL) {
+			slot->in_use = true;
+			slot->seq = latest->seq;
+			slot->info = latest->info;
+		}
+	}
+
+	spdk_dma_free(store->load_buf);
+	store->load_buf = NULL;
+	store->loaded = true;
+
+	spdk_nvmf_set_custom_ns_reservation_ops(&g_rsv_bdev_ops);
+
+	SPDK_NOTICELOG("Reservations are stored on bdev %s\n", store->bdev_name);
+	cb_fn(ctx, 0);
+}
+
+int
+nvmf_reservation_bdev_store_init(const char *bdev_name, nvmf_reservation_bdev_store_init_cb cb_fn,
+				 void *cb_arg)
+{
+	struct nvmf_rsv_bdev_store *store;
+	struct spdk_bdev *bdev;
+	uint64_t num_slots;
+	uint32_t i;
+	int rc;
+
+	if (g_rsv_store != NULL) {
+		if (g_rsv_store->loaded && strcmp(g_rsv_store->bdev_name, bdev_name) == 0) {
+			cb_fn(cb_arg, 0);
+			return 0;
+		}
+		SPDK_ERRLOG("Reservations are already stored on bdev %s\n", g_rsv_store->bdev_name);
+		return -EEXIST;
+	}
+
+	store = calloc(1, sizeof(*store));
+	if (store == NULL) {
+		return -ENOMEM;
+	}
+
+	store->thread = spdk_get_thread();
+	store->init_cb_fn = cb_fn;
+	store->init_cb_arg = cb_arg;
+	store->bdev_name = strdup(bdev_name);
+	if (store->bdev_name == NULL) {
+		rc = -ENOMEM;
+		goto err;
+	}
+
+	rc = spdk_bdev_open_ext(bdev_name, true, nvmf_rsv_bdev_event_cb, store, &store->desc);
+	if (rc != 0) {
+		SPDK_ERRLOG("Could not open bdev %s: %s\n", bdev_name, spdk_strerror(-rc));
+		goto err;
+	}
+
+	bdev = spdk_bdev_desc_get_bdev(store->desc);
+	rc = spdk_bdev_module_claim_bdev(bdev, store->desc, &rsv_bdev_module);
+	if (rc != 0) {
+		SPDK_ERRLOG("Could not claim bdev %s: %s\n", bdev_name, spdk_strerror(-rc));
+		spdk_bdev_close(store->desc);
+		store->desc = NULL;
+		goto err;
+	}
+
+	if (spdk_bdev_is_md_interleaved(bdev)) {
+		SPDK_ERRLOG("Bdev %s with interleaved metadata can't store reservations\n", bdev_name);
+		rc = -EINVAL;
+		goto err;
+	}
+
+	store->block_size = spdk_bdev_get_block_size(bdev);
+	store->slot_blocks = SPDK_CEIL_DIV(sizeof(struct nvmf_rsv_record), store->block_size);
+	num_slots = spdk_bdev_get_num_blocks(bdev) / (2 * store->slot_blocks);
+	store->num_slots = spdk_min(num_slots, NVMF_RSV_MAX_SLOTS);
+	if (store->num_slots == 0) {
+		SPDK_ERRLOG("Bdev %s is too small to store reservations\n", bdev_name);
+		rc = -ENOSPC;
+		goto err;
+	}
+
+	store->slots = calloc(store->num_slots, sizeof(*store->slots));
+	if (store->slots == NULL) {
+		rc = -ENOMEM;
+		goto err;
+	}
+
+	for (i = 0; i < store->num_slots; i++) {
+		store->slots[i].store = store;
+		store->slots[i].index = i;
+		TAILQ_INIT(&store->slots[i].pending);
+		TAILQ_INIT(&store->slots[i].inflight);
+	}
+
+	store->ch = spdk_bdev_get_io_channel(store->desc);
+	if (store->ch == NULL) {
+		rc = -ENOMEM;
+		goto err;
+	}
+
+	store->load_buf = spdk_dma_zmalloc((uint64_t)store->num_slots * 2 * store->slot_blocks *
+					   store->block_size, spdk_bdev_get_buf_align(bdev), NULL);
+	if (store->load_buf == NULL) {
+		rc = -ENOMEM;
+		goto err;
+	}
+
+	rc = spdk_bdev_read_blocks(store->desc, store->ch, store->load_buf, 0,
+				   (uint64_t)store->num_slots * 2 * store->slot_blocks,
+				   nvmf_rsv_store_load_cpl, store);
+	if (rc != 0) {
+		goto err;
+	}
+
+	pthread_mutex_lock(&g_rsv_store_mutex);
+	g_rsv_store = store;
+	pthread_mutex_unlock(&g_rsv_store_mutex);
+
+	return 0;
+err:
+	nvmf_rsv_store_free(store);
+	return rc;
+}
+
+void
+nvmf_reservation_bdev_store_write_config_json(struct spdk_json_write_ctx *w)
+{
+	if (g_rsv_store == NULL || !g_rsv_store->loaded || g_rsv_store->removed) {
+		return;
+	}
+
+	spdk_json_write_object_begin(w);
+	spdk_json_write_named_string(w, "method", "nvmf_set_reservation_store");
+
+	spdk_json_write_named_object_begin(w, "params");
+	spdk_json_write_named_string(w, "bdev_name", g_rsv_store->bdev_name);
+	spdk_json_write_object_end(w);
+
+	spdk_json_write_object_end(w);
+}
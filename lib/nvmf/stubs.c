@@ -45,6 +45,17 @@ nvmf_auth_is_supported(void)
 	return false;
 }
 
+int
+nvmf_auth_workers_create(struct spdk_nvmf_tgt *tgt, uint32_t num_threads, uint32_t queue_depth)
+{
+	return 0;
+}
+
+void
+nvmf_auth_workers_destroy(struct spdk_nvmf_tgt *tgt)
+{
+}
+
 SPDK_LOG_REGISTER_COMPONENT(nvmf_auth)
 #endif /* !SPDK_CONFIG_HAVE_EVP_MAC */
 
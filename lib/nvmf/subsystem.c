@@ -724,6 +724,17 @@ nvmf_subsystem_do_state_change(struct nvmf_subsystem_state_change_ctx *ctx)
 	SPDK_DTRACE_PROBE3(nvmf_subsystem_change_state, subsystem->subnqn,
 			   ctx->requested_state, subsystem->state);
 
+	if (ctx->requested_state == SPDK_NVMF_SUBSYSTEM_PAUSED) {
+		if (subsystem->state != SPDK_NVMF_SUBSYSTEM_PAUSED) {
+			/* Remember which namespace is paused, so that resuming only needs to
+			 * refresh that one instead of every namespace in every poll group.
+			 */
+			subsystem->paused_nsid = (uint32_t)ctx->nsid - 1 < subsystem->max_nsid ? ctx->nsid : 0;
+		} else if (subsystem->paused_nsid != ctx->nsid) {
+			subsystem->paused_nsid = 0;
+		}
+	}
+
 	/* If we are already in the requested state, just call the callback immediately. */
 	if (subsystem->state == ctx->requested_state) {
 		nvmf_subsystem_state_change_complete(ctx, 0);
@@ -1683,6 +1694,7 @@ spdk_nvmf_subsystem_any_listener_allowed(struct spdk_nvmf_subsystem *subsystem)
 
 struct subsystem_update_ns_ctx {
 	struct spdk_nvmf_subsystem *subsystem;
+	uint32_t nsid;
 
 	spdk_nvmf_subsystem_state_change_done cb_fn;
 	void *cb_arg;
@@ -1711,12 +1723,12 @@ subsystem_update_ns_on_pg(struct spdk_io_channel_iter *i)
 	group = spdk_io_channel_get_ctx(spdk_io_channel_iter_get_channel(i));
 	subsystem = ctx->subsystem;
 
-	rc = nvmf_poll_group_update_subsystem(group, subsystem);
+	rc = nvmf_poll_group_update_subsystem(group, subsystem, ctx->nsid);
 	spdk_for_each_channel_continue(i, rc);
 }
 
 static int
-nvmf_subsystem_update_ns(struct spdk_nvmf_subsystem *subsystem,
+nvmf_subsystem_update_ns(struct spdk_nvmf_subsystem *subsystem, uint32_t nsid,
 			 spdk_nvmf_subsystem_state_change_done cb_fn, void *cb_arg)
 {
 	struct subsystem_update_ns_ctx *ctx;
@@ -1727,6 +1739,7 @@ nvmf_subsystem_update_ns(struct spdk_nvmf_subsystem *subsystem,
 		return -ENOMEM;
 	}
 	ctx->subsystem = subsystem;
+	ctx->nsid = nsid;
 	ctx->cb_fn = cb_fn;
 	ctx->cb_arg = cb_arg;
 
@@ -1742,6 +1755,13 @@ nvmf_subsystem_ns_changed(struct spdk_nvmf_subsystem *subsystem, uint32_t nsid)
 {
 	struct spdk_nvmf_ctrlr *ctrlr;
 
+	/* A namespace other than the one the pause was scoped to has been modified, so
+	 * the poll groups need to refresh all of them on resume.
+	 */
+	if (subsystem->paused_nsid != nsid) {
+		subsystem->paused_nsid = 0;
+	}
+
 	TAILQ_FOREACH(ctrlr, &subsystem->ctrlrs, link) {
 		if (nvmf_ctrlr_ns_is_visible(ctrlr, nsid)) {
 			nvmf_ctrlr_ns_changed(ctrlr, nsid);
@@ -1785,6 +1805,8 @@ spdk_nvmf_subsystem_remove_ns(struct spdk_nvmf_subsystem *subsystem, uint32_t ns
 		nvmf_ns_remove_host(ns, host);
 	}
 
+	nvmf_ns_qos_clear(ns);
+
 	free(ns->ptpl_file);
 	nvmf_ns_reservation_clear_all_registrants(ns);
 	spdk_bdev_module_release_bdev(ns->bdev);
@@ -2048,8 +2070,9 @@ static struct spdk_bdev_module ns_bdev_module = {
 	.name	= "NVMe-oF Target",
 };
 
-static int nvmf_ns_reservation_update(const struct spdk_nvmf_ns *ns,
-				      const struct spdk_nvmf_reservation_info *info);
+static void nvmf_ns_reservation_update(const struct spdk_nvmf_ns *ns,
+				       const struct spdk_nvmf_reservation_info *info,
+				       spdk_nvmf_ns_reservation_update_cb cb_fn, void *cb_arg);
 static int nvmf_ns_reservation_load(const struct spdk_nvmf_ns *ns,
 				    struct spdk_nvmf_reservation_info *info);
 static int nvmf_ns_reservation_restore(struct spdk_nvmf_ns *ns,
@@ -2145,6 +2168,7 @@ spdk_nvmf_subsystem_add_ns_ext(struct spdk_nvmf_subsystem *subsystem, const char
 	}
 
 	TAILQ_INIT(&ns->hosts);
+	TAILQ_INIT(&ns->qos);
 	ns->always_visible = !opts.no_auto_visible;
 	if (ns->always_visible) {
 		TAILQ_FOREACH(ctrlr, &subsystem->ctrlrs, link) {
@@ -2877,8 +2901,9 @@ exit:
 	return rc;
 }
 
-static int
-nvmf_ns_update_reservation_info(struct spdk_nvmf_ns *ns)
+static void
+nvmf_ns_update_reservation_info(struct spdk_nvmf_ns *ns,
+				spdk_nvmf_ns_reservation_update_cb cb_fn, void *cb_arg)
 {
 	struct spdk_nvmf_reservation_info info;
 	struct spdk_nvmf_registrant *reg, *tmp;
@@ -2887,7 +2912,8 @@ nvmf_ns_update_reservation_info(struct spdk_nvmf_ns *ns)
 	assert(ns != NULL);
 
 	if (!ns->bdev || !nvmf_ns_is_ptpl_capable(ns)) {
-		return 0;
+		cb_fn(cb_arg, 0);
+		return;
 	}
 
 	memset(&info, 0, sizeof(info));
@@ -2911,7 +2937,7 @@ nvmf_ns_update_reservation_info(struct spdk_nvmf_ns *ns)
 	info.num_regs = i;
 	info.ptpl_activated = ns->ptpl_activated;
 
-	return nvmf_ns_reservation_update(ns, &info);
+	nvmf_ns_reservation_update(ns, &info, cb_fn, cb_arg);
 }
 
 static struct spdk_nvmf_registrant *
@@ -3657,6 +3683,31 @@ _nvmf_ns_reservation_update_done(struct spdk_nvmf_subsystem *subsystem,
 	spdk_thread_send_msg(group->thread, nvmf_ns_reservation_complete, req);
 }
 
+static void
+nvmf_ns_reservation_update_sgroups(struct spdk_nvmf_request *req)
+{
+	struct spdk_nvmf_subsystem *subsystem = req->qpair->ctrlr->subsys;
+	int status;
+
+	status = nvmf_subsystem_update_ns(subsystem, req->cmd->nvme_cmd.nsid,
+					  _nvmf_ns_reservation_update_done, req);
+	if (status != 0) {
+		_nvmf_ns_reservation_update_done(subsystem, req, status);
+	}
+}
+
+static void
+nvmf_ns_reservation_persist_done(void *cb_arg, int status)
+{
+	struct spdk_nvmf_request *req = cb_arg;
+
+	if (status != 0) {
+		req->rsp->nvme_cpl.status.sc = SPDK_NVME_SC_INTERNAL_DEVICE_ERROR;
+	}
+
+	nvmf_ns_reservation_update_sgroups(req);
+}
+
 void
 nvmf_ns_reservation_request(void *ctx)
 {
@@ -3666,7 +3717,6 @@ nvmf_ns_reservation_request(void *ctx)
 	uint32_t nsid;
 	struct spdk_nvmf_ns *ns;
 	bool update_sgroup = false;
-	int status = 0;
 
 	nsid = cmd->nsid;
 	ns = _nvmf_subsystem_get_ns(ctrlr->subsys, nsid);
@@ -3692,17 +3742,15 @@ nvmf_ns_reservation_request(void *ctx)
 	/* update reservation information to subsystem's poll group */
 	if (update_sgroup) {
 		if (ns->ptpl_activated || cmd->opc == SPDK_NVME_OPC_RESERVATION_REGISTER) {
-			if (nvmf_ns_update_reservation_info(ns) != 0) {
-				req->rsp->nvme_cpl.status.sc = SPDK_NVME_SC_INTERNAL_DEVICE_ERROR;
-			}
-		}
-		status = nvmf_subsystem_update_ns(ctrlr->subsys, _nvmf_ns_reservation_update_done, req);
-		if (status == 0) {
-			return;
+			/* Poll groups are only updated once the new state is persisted */
+			nvmf_ns_update_reservation_info(ns, nvmf_ns_reservation_persist_done, req);
+		} else {
+			nvmf_ns_reservation_update_sgroups(req);
 		}
+		return;
 	}
 
-	_nvmf_ns_reservation_update_done(ctrlr->subsys, req, status);
+	_nvmf_ns_reservation_update_done(ctrlr->subsys, req, 0);
 }
 
 static bool
@@ -3723,11 +3771,23 @@ nvmf_ns_is_ptpl_capable(const struct spdk_nvmf_ns *ns)
 	return g_reservation_ops.is_ptpl_capable(ns);
 }
 
-static int
+static void
 nvmf_ns_reservation_update(const struct spdk_nvmf_ns *ns,
-			   const struct spdk_nvmf_reservation_info *info)
+			   const struct spdk_nvmf_reservation_info *info,
+			   spdk_nvmf_ns_reservation_update_cb cb_fn, void *cb_arg)
 {
-	return g_reservation_ops.update(ns, info);
+	int rc;
+
+	if (g_reservation_ops.update_async != NULL) {
+		rc = g_reservation_ops.update_async(ns, info, cb_fn, cb_arg);
+		if (rc == 0) {
+			return;
+		}
+	} else {
+		rc = g_reservation_ops.update(ns, info);
+	}
+
+	cb_fn(cb_arg, rc);
 }
 
 static int
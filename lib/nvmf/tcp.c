@@ -31,6 +31,8 @@
 #define SPDK_NVMF_TCP_DEFAULT_SOCK_PRIORITY 0
 #define SPDK_NVMF_TCP_DEFAULT_CONTROL_MSG_NUM 32
 #define SPDK_NVMF_TCP_DEFAULT_SUCCESS_OPTIMIZATION true
+#define SPDK_NVMF_TCP_DEFAULT_RECV_BUF_COUNT 0
+#define NVMF_TCP_RECV_BUF_SIZE (32 * 1024)
 
 #define SPDK_NVMF_TCP_MIN_IO_QUEUE_DEPTH 2
 #define SPDK_NVMF_TCP_MAX_IO_QUEUE_DEPTH 65535
@@ -346,8 +348,13 @@ struct spdk_nvmf_tcp_poll_group {
 	TAILQ_HEAD(, spdk_nvmf_tcp_qpair)	await_req;
 
 	struct spdk_io_channel			*accel_channel;
+	/* CRC32C is executed by a module other than the software one */
+	bool					crc32c_offload;
 	struct spdk_nvmf_tcp_control_msg_list	*control_msg_list;
 
+	/* Receive buffers provided to the sock group */
+	void					*recv_bufs;
+
 	TAILQ_ENTRY(spdk_nvmf_tcp_poll_group)	link;
 };
 
@@ -362,6 +369,7 @@ struct tcp_transport_opts {
 	bool		c2h_success;
 	uint16_t	control_msg_num;
 	uint32_t	sock_priority;
+	uint32_t	recv_buf_count;
 };
 
 struct tcp_psk_entry {
@@ -404,6 +412,10 @@ static const struct spdk_json_object_decoder tcp_transport_opts_decoder[] = {
 		"sock_priority", offsetof(struct tcp_transport_opts, sock_priority),
 		spdk_json_decode_uint32, true
 	},
+	{
+		"recv_buf_count", offsetof(struct tcp_transport_opts, recv_buf_count),
+		spdk_json_decode_uint32, true
+	},
 };
 
 static bool nvmf_tcp_req_process(struct spdk_nvmf_tcp_transport *ttransport,
@@ -659,6 +671,7 @@ nvmf_tcp_dump_opts(struct spdk_nvmf_transport *transport, struct spdk_json_write
 	ttransport = SPDK_CONTAINEROF(transport, struct spdk_nvmf_tcp_transport, transport);
 	spdk_json_write_named_bool(w, "c2h_success", ttransport->tcp_opts.c2h_success);
 	spdk_json_write_named_uint32(w, "sock_priority", ttransport->tcp_opts.sock_priority);
+	spdk_json_write_named_uint32(w, "recv_buf_count", ttransport->tcp_opts.recv_buf_count);
 }
 
 static void
@@ -726,6 +739,7 @@ nvmf_tcp_create(struct spdk_nvmf_transport_opts *opts)
 	ttransport->tcp_opts.c2h_success = SPDK_NVMF_TCP_DEFAULT_SUCCESS_OPTIMIZATION;
 	ttransport->tcp_opts.sock_priority = SPDK_NVMF_TCP_DEFAULT_SOCK_PRIORITY;
 	ttransport->tcp_opts.control_msg_num = SPDK_NVMF_TCP_DEFAULT_CONTROL_MSG_NUM;
+	ttransport->tcp_opts.recv_buf_count = SPDK_NVMF_TCP_DEFAULT_RECV_BUF_COUNT;
 	if (opts->transport_specific != NULL &&
 	    spdk_json_decode_object_relaxed(opts->transport_specific, tcp_transport_opts_decoder,
 					    SPDK_COUNTOF(tcp_transport_opts_decoder),
@@ -744,7 +758,7 @@ nvmf_tcp_create(struct spdk_nvmf_transport_opts *opts)
 		     "  num_shared_buffers=%d, c2h_success=%d,\n"
 		     "  dif_insert_or_strip=%d, sock_priority=%d\n"
 		     "  abort_timeout_sec=%d, control_msg_num=%hu\n"
-		     "  ack_timeout=%d\n",
+		     "  ack_timeout=%d, recv_buf_count=%u\n",
 		     opts->max_queue_depth,
 		     opts->max_io_size,
 		     opts->max_qpairs_per_ctrlr - 1,
@@ -757,7 +771,8 @@ nvmf_tcp_create(struct spdk_nvmf_transport_opts *opts)
 		     ttransport->tcp_opts.sock_priority,
 		     opts->abort_timeout_sec,
 		     ttransport->tcp_opts.control_msg_num,
-		     opts->ack_timeout);
+		     opts->ack_timeout,
+		     ttransport->tcp_opts.recv_buf_count);
 
 	if (ttransport->tcp_opts.sock_priority > SPDK_NVMF_TCP_DEFAULT_MAX_SOCK_PRIORITY) {
 		SPDK_ERRLOG("Unsupported socket_priority=%d, the current range is: 0 to %d\n"
@@ -1630,6 +1645,47 @@ nvmf_tcp_poll_group_intr(void *ctx)
 	return ret != 0 ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
 }
 
+static bool
+nvmf_tcp_crc32c_is_offloaded(void)
+{
+	const char *module_name = NULL;
+	int rc;
+
+	rc = spdk_accel_get_opc_module_name(SPDK_ACCEL_OPC_CRC32C, &module_name);
+	if (rc != 0 || module_name == NULL) {
+		return false;
+	}
+
+	return strcmp(module_name, "software") != 0;
+}
+
+static int
+nvmf_tcp_poll_group_provide_recv_bufs(struct spdk_nvmf_tcp_poll_group *tgroup, uint32_t count)
+{
+	uint32_t i;
+	int rc;
+
+	/* With a sock implementation which supports it (e.g. uring with recv pipe disabled),
+	 * the kernel receives straight into these buffers, so that the PDUs are parsed out
+	 * of memory instead of issuing a readv() for every header and payload.
+	 */
+	tgroup->recv_bufs = calloc(count, NVMF_TCP_RECV_BUF_SIZE);
+	if (tgroup->recv_bufs == NULL) {
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < count; i++) {
+		rc = spdk_sock_group_provide_buf(tgroup->sock_group,
+						 (uint8_t *)tgroup->recv_bufs + i * NVMF_TCP_RECV_BUF_SIZE,
+						 NVMF_TCP_RECV_BUF_SIZE, NULL);
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
 static struct spdk_nvmf_transport_poll_group *
 nvmf_tcp_poll_group_create(struct spdk_nvmf_transport *transport,
 			   struct spdk_nvmf_poll_group *group)
@@ -1669,6 +1725,16 @@ nvmf_tcp_poll_group_create(struct spdk_nvmf_transport *transport,
 		goto cleanup;
 	}
 
+	tgroup->crc32c_offload = nvmf_tcp_crc32c_is_offloaded();
+
+	if (ttransport->tcp_opts.recv_buf_count > 0) {
+		rc = nvmf_tcp_poll_group_provide_recv_bufs(tgroup, ttransport->tcp_opts.recv_buf_count);
+		if (rc != 0) {
+			SPDK_ERRLOG("Cannot allocate receive buffers for tgroup=%p\n", tgroup);
+			goto cleanup;
+		}
+	}
+
 	TAILQ_INSERT_TAIL(&ttransport->poll_groups, tgroup, link);
 	if (ttransport->next_pg == NULL) {
 		ttransport->next_pg = tgroup;
@@ -1696,6 +1762,7 @@ nvmf_tcp_get_optimal_poll_group(struct spdk_nvmf_qpair *qpair)
 	struct spdk_nvmf_tcp_transport *ttransport;
 	struct spdk_nvmf_tcp_poll_group **pg;
 	struct spdk_nvmf_tcp_qpair *tqpair;
+	struct spdk_nvmf_transport_poll_group *least_loaded;
 	struct spdk_sock_group *group = NULL, *hint = NULL;
 	int rc;
 
@@ -1706,6 +1773,11 @@ nvmf_tcp_get_optimal_poll_group(struct spdk_nvmf_qpair *qpair)
 	}
 
 	pg = &ttransport->next_pg;
+	least_loaded = nvmf_transport_get_least_loaded_poll_group(qpair->transport);
+	if (least_loaded != NULL) {
+		/* Suggest the least loaded poll group unless the socket has a placement id */
+		*pg = SPDK_CONTAINEROF(least_loaded, struct spdk_nvmf_tcp_poll_group, group);
+	}
 	assert(*pg != NULL);
 	hint = (*pg)->sock_group;
 
@@ -1736,6 +1808,8 @@ nvmf_tcp_poll_group_destroy(struct spdk_nvmf_transport_poll_group *group)
 	tgroup = SPDK_CONTAINEROF(group, struct spdk_nvmf_tcp_poll_group, group);
 	spdk_sock_group_unregister_interrupt(tgroup->sock_group);
 	spdk_sock_group_close(&tgroup->sock_group);
+	/* The buffers may only be released once the sock group no longer references them */
+	free(tgroup->recv_bufs);
 	if (tgroup->control_msg_list) {
 		nvmf_tcp_control_msg_list_free(tgroup->control_msg_list);
 	}
@@ -2238,6 +2312,59 @@ data_crc32_calc_done(void *cb_arg, int status)
 	_nvmf_tcp_pdu_payload_handle(tqpair, pdu);
 }
 
+/*
+ * Decide whether the data digest of a PDU should be accumulated while its payload is read from
+ * the socket, i.e. while the data is still in the cache.  That's the case unless the digest is
+ * going to be offloaded to an accel module which doesn't run on this core.
+ */
+static bool
+nvmf_tcp_pdu_recv_ddgst_inline(struct spdk_nvmf_tcp_qpair *tqpair, struct nvme_tcp_pdu *pdu)
+{
+	if (tqpair->qpair.qid == 0 || pdu->dif_ctx != NULL || tqpair->group == NULL ||
+	    pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT != 0) {
+		return true;
+	}
+
+	return !tqpair->group->crc32c_offload;
+}
+
+/*
+ * Process the payload bytes which have just been read from the socket. offset and len describe
+ * the bytes returned by the last read, which may also cover the data digest itself. If DIF is
+ * inserted, it is generated for the blocks completed by this read, and the data digest is
+ * accumulated over the same blocks, so that the data is walked only once.
+ */
+static int
+nvmf_tcp_pdu_recv_data(struct nvme_tcp_pdu *pdu, uint32_t offset, uint32_t len)
+{
+	int rc;
+
+	if (spdk_likely(pdu->dif_ctx == NULL)) {
+		if (pdu->ddgst_inline) {
+			nvme_tcp_pdu_update_data_digest(pdu, offset, len);
+		}
+		return 0;
+	}
+
+	if (offset >= pdu->data_len) {
+		return 0;
+	}
+
+	len = spdk_min(len, pdu->data_len - offset);
+
+	rc = spdk_dif_generate_stream(pdu->data_iov, pdu->data_iovcnt, offset, len, pdu->dif_ctx);
+	if (rc != 0) {
+		return rc;
+	}
+
+	if (pdu->ddgst_inline) {
+		rc = spdk_dif_update_crc32c_stream(pdu->data_iov, pdu->data_iovcnt, offset, len,
+						   &pdu->data_digest_crc32, pdu->dif_ctx);
+	}
+
+	return rc;
+}
+
 static void
 nvmf_tcp_pdu_payload_handle(struct spdk_nvmf_tcp_qpair *tqpair, struct nvme_tcp_pdu *pdu)
 {
@@ -2248,8 +2375,10 @@ nvmf_tcp_pdu_payload_handle(struct spdk_nvmf_tcp_qpair *tqpair, struct nvme_tcp_
 	SPDK_DEBUGLOG(nvmf_tcp, "enter\n");
 	/* check data digest if need */
 	if (pdu->ddgst_enable) {
-		if (tqpair->qpair.qid != 0 && !pdu->dif_ctx && tqpair->group &&
-		    (pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT == 0)) {
+		if (pdu->ddgst_inline) {
+			pdu->data_digest_crc32 = nvme_tcp_pdu_pad_data_digest(pdu, pdu->data_digest_crc32);
+		} else if (tqpair->qpair.qid != 0 && !pdu->dif_ctx && tqpair->group &&
+			   (pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT == 0)) {
 			rc = spdk_accel_submit_crc32cv(tqpair->group->accel_channel, &pdu->data_digest_crc32, pdu->data_iov,
 						       pdu->data_iovcnt, 0, data_crc32_calc_done, pdu);
 			if (spdk_likely(rc == 0)) {
@@ -2491,6 +2620,21 @@ err:
 	nvmf_tcp_send_c2h_term_req(tqpair, pdu, fes, error_offset);
 }
 
+/* Requests which may still need data PDUs from the host */
+static bool
+nvmf_tcp_qpair_awaits_h2c_data(struct spdk_nvmf_tcp_qpair *tqpair)
+{
+	int state;
+
+	for (state = TCP_REQUEST_STATE_NEW; state < TCP_REQUEST_STATE_READY_TO_EXECUTE; state++) {
+		if (tqpair->state_cntr[state] != 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 static int
 nvmf_tcp_sock_process(struct spdk_nvmf_tcp_qpair *tqpair)
 {
@@ -2532,6 +2676,14 @@ nvmf_tcp_sock_process(struct spdk_nvmf_tcp_qpair *tqpair)
 				return rc;
 			}
 
+			/* A draining qpair doesn't take new commands, so that it can be moved to
+			 * another poll group.  Data for commands in progress is still received.
+			 */
+			if (spdk_unlikely(tqpair->qpair.draining && pdu->ch_valid_bytes == 0 &&
+					  !nvmf_tcp_qpair_awaits_h2c_data(tqpair))) {
+				return rc;
+			}
+
 			rc = nvme_tcp_read_data(tqpair->sock,
 						sizeof(struct spdk_nvme_tcp_common_pdu_hdr) - pdu->ch_valid_bytes,
 						(void *)&pdu->hdr.common + pdu->ch_valid_bytes);
@@ -2590,6 +2742,10 @@ nvmf_tcp_sock_process(struct spdk_nvmf_tcp_qpair *tqpair)
 					  tqpair->host_ddgst_enable)) {
 				data_len += SPDK_NVME_TCP_DIGEST_LEN;
 				pdu->ddgst_enable = true;
+				if (pdu->rw_offset == 0) {
+					pdu->ddgst_inline = nvmf_tcp_pdu_recv_ddgst_inline(tqpair, pdu);
+					pdu->data_digest_crc32 = SPDK_CRC32C_XOR;
+				}
 			}
 
 			rc = nvme_tcp_read_payload_data(tqpair->sock, pdu);
@@ -2597,21 +2753,19 @@ nvmf_tcp_sock_process(struct spdk_nvmf_tcp_qpair *tqpair)
 				nvmf_tcp_qpair_set_recv_state(tqpair, NVME_TCP_PDU_RECV_STATE_QUIESCING);
 				break;
 			}
-			pdu->rw_offset += rc;
-
-			if (pdu->rw_offset < data_len) {
-				return NVME_TCP_PDU_IN_PROGRESS;
-			}
 
-			/* Generate and insert DIF to whole data block received if DIF is enabled */
-			if (spdk_unlikely(pdu->dif_ctx != NULL) &&
-			    spdk_dif_generate_stream(pdu->data_iov, pdu->data_iovcnt, 0, data_len,
-						     pdu->dif_ctx) != 0) {
+			/* Generate and insert DIF to the data blocks received if DIF is enabled */
+			if (spdk_unlikely(nvmf_tcp_pdu_recv_data(pdu, pdu->rw_offset, rc) != 0)) {
 				SPDK_ERRLOG("DIF generate failed\n");
 				nvmf_tcp_qpair_set_recv_state(tqpair, NVME_TCP_PDU_RECV_STATE_QUIESCING);
 				break;
 			}
 
+			pdu->rw_offset += rc;
+			if (pdu->rw_offset < data_len) {
+				return NVME_TCP_PDU_IN_PROGRESS;
+			}
+
 			/* All of this PDU has now been read from the socket. */
 			nvmf_tcp_pdu_payload_handle(tqpair, pdu);
 			break;
@@ -3489,6 +3643,93 @@ nvmf_tcp_poll_group_remove(struct spdk_nvmf_transport_poll_group *group,
 	return rc;
 }
 
+static int
+nvmf_tcp_poll_group_detach(struct spdk_nvmf_transport_poll_group *group,
+			   struct spdk_nvmf_qpair *qpair)
+{
+	struct spdk_nvmf_tcp_poll_group	*tgroup;
+	struct spdk_nvmf_tcp_qpair		*tqpair;
+	bool				recv_idle;
+	int				rc;
+
+	tgroup = SPDK_CONTAINEROF(group, struct spdk_nvmf_tcp_poll_group, group);
+	tqpair = SPDK_CONTAINEROF(qpair, struct spdk_nvmf_tcp_qpair, qpair);
+
+	assert(tqpair->group == tgroup);
+
+	/* The qpair can only be moved between PDUs, with all of its requests free. Everything
+	 * else (requests waiting for buffers or control messages, in-flight accel operations,
+	 * queued writes) is tied to the current poll group.
+	 */
+	recv_idle = tqpair->recv_state == NVME_TCP_PDU_RECV_STATE_AWAIT_PDU_READY ||
+		    (tqpair->recv_state == NVME_TCP_PDU_RECV_STATE_AWAIT_PDU_CH &&
+		     tqpair->pdu_in_progress->ch_valid_bytes == 0);
+	if (tqpair->state != NVMF_TCP_QPAIR_STATE_RUNNING || !recv_idle ||
+	    tqpair->state_cntr[TCP_REQUEST_STATE_FREE] != tqpair->resource_count ||
+	    tqpair->fused_first != NULL || tqpair->pending_flush) {
+		return -EBUSY;
+	}
+
+	/* Data which was already received into this group's buffers can't follow the socket */
+	if (tgroup->recv_bufs != NULL) {
+		return -ENOTSUP;
+	}
+
+	rc = spdk_sock_group_remove_sock(tgroup->sock_group, tqpair->sock);
+	if (rc != 0) {
+		SPDK_ERRLOG("Could not remove sock from sock_group: %s (%d)\n",
+			    spdk_strerror(errno), errno);
+		return -EBUSY;
+	}
+
+	SPDK_DEBUGLOG(nvmf_tcp, "detach tqpair=%p from the tgroup=%p\n", tqpair, tgroup);
+	TAILQ_REMOVE(&tgroup->qpairs, tqpair, link);
+	tqpair->group = NULL;
+
+	return 0;
+}
+
+static bool
+nvmf_tcp_poll_group_can_detach(struct spdk_nvmf_transport_poll_group *group,
+			       struct spdk_nvmf_qpair *qpair)
+{
+	struct spdk_nvmf_tcp_poll_group	*tgroup;
+
+	tgroup = SPDK_CONTAINEROF(group, struct spdk_nvmf_tcp_poll_group, group);
+
+	/* Sockets can't take data which was received into provided buffers along */
+	return tgroup->recv_bufs == NULL;
+}
+
+static int
+nvmf_tcp_poll_group_attach(struct spdk_nvmf_transport_poll_group *group,
+			   struct spdk_nvmf_qpair *qpair)
+{
+	struct spdk_nvmf_tcp_poll_group	*tgroup;
+	struct spdk_nvmf_tcp_qpair		*tqpair;
+	int				rc;
+
+	tgroup = SPDK_CONTAINEROF(group, struct spdk_nvmf_tcp_poll_group, group);
+	tqpair = SPDK_CONTAINEROF(qpair, struct spdk_nvmf_tcp_qpair, qpair);
+
+	assert(tqpair->group == NULL);
+
+	/* Data which arrived in the meantime is picked up by the new sock group */
+	rc = spdk_sock_group_add_sock(tgroup->sock_group, tqpair->sock,
+				      nvmf_tcp_sock_cb, tqpair);
+	if (rc != 0) {
+		SPDK_ERRLOG("Could not add sock to sock_group: %s (%d)\n",
+			    spdk_strerror(errno), errno);
+		return -EIO;
+	}
+
+	SPDK_DEBUGLOG(nvmf_tcp, "attach tqpair=%p to the tgroup=%p\n", tqpair, tgroup);
+	tqpair->group = tgroup;
+	TAILQ_INSERT_TAIL(&tgroup->qpairs, tqpair, link);
+
+	return 0;
+}
+
 static int
 nvmf_tcp_req_complete(struct spdk_nvmf_request *req)
 {
@@ -3962,6 +4203,9 @@ const struct spdk_nvmf_transport_ops spdk_nvmf_transport_tcp = {
 	.poll_group_destroy = nvmf_tcp_poll_group_destroy,
 	.poll_group_add = nvmf_tcp_poll_group_add,
 	.poll_group_remove = nvmf_tcp_poll_group_remove,
+	.poll_group_detach = nvmf_tcp_poll_group_detach,
+	.poll_group_can_detach = nvmf_tcp_poll_group_can_detach,
+	.poll_group_attach = nvmf_tcp_poll_group_attach,
 	.poll_group_poll = nvmf_tcp_poll_group_poll,
 
 	.req_free = nvmf_tcp_req_free,
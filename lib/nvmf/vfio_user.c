@@ -93,6 +93,9 @@ SPDK_STATIC_ASSERT(NVME_BAR5_SIZE > 0, "Incorrect size");
 #define NVME_BAR4_SIZE SPDK_ALIGN_CEIL((NVME_IRQ_MSIX_NUM * 16), 0x1000)
 SPDK_STATIC_ASSERT(NVME_BAR4_SIZE > 0, "Incorrect size");
 
+/* Interrupt Coalescing aggregation time is specified in 100 microsecond increments */
+#define NVMF_VFIO_USER_IRQ_COALESCING_PERIOD_US 100
+
 struct nvmf_vfio_user_req;
 
 typedef int (*nvmf_vfio_user_req_cb_fn)(struct nvmf_vfio_user_req *req, void *cb_arg);
@@ -195,10 +198,13 @@ struct vfio_user_nvme_migr_header {
 	uint64_t	shadow_doorbell_buffer;
 	uint64_t	eventidx_buffer;
 
+	/* Interrupt vectors for which interrupt coalescing is disabled. */
+	uint8_t		irq_coalescing_disabled[NVME_IRQ_MSIX_NUM / CHAR_BIT];
+
 	/* Reserved memory space for new added fields, the
 	 * field is always at the end of this data structure.
 	 */
-	uint8_t		unused[3856];
+	uint8_t		unused[3856 - NVME_IRQ_MSIX_NUM / CHAR_BIT];
 };
 SPDK_STATIC_ASSERT(sizeof(struct vfio_user_nvme_migr_header) == 0x1000, "Incorrect size");
 
@@ -356,6 +362,13 @@ struct nvmf_vfio_user_cq {
 
 	uint32_t				last_head;
 	uint32_t				last_trigger_irq_tail;
+
+	/*
+	 * Completions posted without an interrupt because of interrupt
+	 * coalescing, and when the first of them was posted.
+	 */
+	uint32_t				irq_pending;
+	uint64_t				irq_pending_tsc;
 };
 
 struct nvmf_vfio_user_poll_group {
@@ -364,6 +377,12 @@ struct nvmf_vfio_user_poll_group {
 	TAILQ_HEAD(, nvmf_vfio_user_sq)		sqs;
 	struct spdk_interrupt			*intr;
 	int					intr_fd;
+	/*
+	 * Fires the interrupts held back by interrupt coalescing once their
+	 * aggregation time expires. Only runs while some are pending.
+	 */
+	struct spdk_poller			*irq_poller;
+	bool					irq_poller_active;
 	struct {
 
 		/*
@@ -417,6 +436,8 @@ struct nvmf_vfio_user_poll_group {
 		uint64_t poll_reqs_squared;
 		uint64_t cqh_admin_writes;
 		uint64_t cqh_io_writes;
+		/* Completions posted without an interrupt because of interrupt coalescing */
+		uint64_t irqs_coalesced;
 	} stats;
 };
 
@@ -472,6 +493,9 @@ struct nvmf_vfio_user_ctrlr {
 	uint64_t				eventidx_buffer;
 
 	bool					adaptive_irqs_enabled;
+
+	/* Interrupt vectors for which the host disabled interrupt coalescing */
+	uint8_t					irq_coalescing_disabled[NVME_IRQ_MSIX_NUM / CHAR_BIT];
 };
 
 /* Endpoint in vfio-user is associated with a socket file, which
@@ -1735,6 +1759,90 @@ cq_is_full(struct nvmf_vfio_user_cq *cq)
 	return free_cq_slots == 0;
 }
 
+static inline bool
+irq_coalescing_disabled(struct nvmf_vfio_user_ctrlr *ctrlr, uint16_t iv)
+{
+	return ctrlr->irq_coalescing_disabled[iv / CHAR_BIT] & (1u << (iv % CHAR_BIT));
+}
+
+static inline void
+set_irq_coalescing_disabled(struct nvmf_vfio_user_ctrlr *ctrlr, uint16_t iv, bool disabled)
+{
+	if (disabled) {
+		ctrlr->irq_coalescing_disabled[iv / CHAR_BIT] |= (1u << (iv % CHAR_BIT));
+	} else {
+		ctrlr->irq_coalescing_disabled[iv / CHAR_BIT] &= ~(1u << (iv % CHAR_BIT));
+	}
+}
+
+/*
+ * Whether the host configured Interrupt Coalescing (NVMe spec 1.4, section
+ * 5.21.1.8) for this I/O CQ. Both the aggregation threshold and time need to
+ * be non-zero for any interrupt to be held back.
+ */
+static inline bool
+cq_irq_coalescing_enabled(struct nvmf_vfio_user_ctrlr *ctrlr, struct nvmf_vfio_user_cq *cq)
+{
+	union spdk_nvme_feat_interrupt_coalescing coalescing;
+
+	assert(cq->qid != 0);
+
+	coalescing = ctrlr->ctrlr->feat.interrupt_coalescing;
+
+	return coalescing.bits.thr != 0 && coalescing.bits.time != 0 &&
+	       !irq_coalescing_disabled(ctrlr, cq->iv);
+}
+
+/*
+ * Returns true if the interrupt for a completion just posted to @cq can be
+ * held back: until the aggregation threshold is reached, or until the
+ * aggregation time expires and the poll group's IRQ poller fires it. The
+ * interrupt isn't delayed if @sq has no other commands in flight, as there
+ * is no other completion to aggregate this one with.
+ */
+static bool
+cq_hold_irq(struct nvmf_vfio_user_ctrlr *ctrlr, struct nvmf_vfio_user_cq *cq,
+	    struct nvmf_vfio_user_sq *sq)
+{
+	struct nvmf_vfio_user_poll_group *vu_group;
+
+	/* The aggregation threshold is 0's based. */
+	if (cq->irq_pending >= ctrlr->ctrlr->feat.interrupt_coalescing.bits.thr ||
+	    TAILQ_EMPTY(&sq->qpair.outstanding)) {
+		return false;
+	}
+
+	vu_group = SPDK_CONTAINEROF(cq->group, struct nvmf_vfio_user_poll_group, group);
+	assert(spdk_get_thread() == cq->group->group->thread);
+
+	if (cq->irq_pending++ == 0) {
+		cq->irq_pending_tsc = spdk_get_ticks();
+		if (!vu_group->irq_poller_active) {
+			spdk_poller_resume(vu_group->irq_poller);
+			vu_group->irq_poller_active = true;
+		}
+	}
+	vu_group->stats.irqs_coalesced++;
+
+	return true;
+}
+
+static int
+cq_trigger_irq(struct nvmf_vfio_user_ctrlr *ctrlr, struct nvmf_vfio_user_cq *cq)
+{
+	int err;
+
+	cq->irq_pending = 0;
+
+	err = vfu_irq_trigger(ctrlr->endpoint->vfu_ctx, cq->iv);
+	if (err != 0) {
+		SPDK_ERRLOG("%s: failed to trigger interrupt: %m\n",
+			    ctrlr_id(ctrlr));
+	}
+
+	return err;
+}
+
 /*
  * Posts a CQE in the completion queue.
  *
@@ -1752,7 +1860,6 @@ post_completion(struct nvmf_vfio_user_ctrlr *ctrlr, struct nvmf_vfio_user_cq *cq
 {
 	struct spdk_nvme_status cpl_status = { 0 };
 	struct spdk_nvme_cpl *cpl;
-	int err;
 
 	assert(ctrlr != NULL);
 
@@ -1807,17 +1914,21 @@ post_completion(struct nvmf_vfio_user_ctrlr *ctrlr, struct nvmf_vfio_user_cq *cq
 	spdk_wmb();
 	cq_tail_advance(cq);
 
-	if ((cq->qid == 0 || !ctrlr->adaptive_irqs_enabled) &&
-	    cq->ien && ctrlr_interrupt_enabled(ctrlr)) {
-		err = vfu_irq_trigger(ctrlr->endpoint->vfu_ctx, cq->iv);
-		if (err != 0) {
-			SPDK_ERRLOG("%s: failed to trigger interrupt: %m\n",
-				    ctrlr_id(ctrlr));
-			return err;
+	if (!cq->ien || !ctrlr_interrupt_enabled(ctrlr)) {
+		return 0;
+	}
+
+	if (cq->qid != 0) {
+		if (cq_irq_coalescing_enabled(ctrlr, cq)) {
+			if (cq_hold_irq(ctrlr, cq, ctrlr->sqs[sqid])) {
+				return 0;
+			}
+		} else if (ctrlr->adaptive_irqs_enabled) {
+			return 0;
 		}
 	}
 
-	return 0;
+	return cq_trigger_irq(ctrlr, cq);
 }
 
 static void
@@ -1838,6 +1949,7 @@ delete_cq_done(struct nvmf_vfio_user_ctrlr *ctrlr, struct nvmf_vfio_user_cq *cq)
 	cq->size = 0;
 	cq->cq_state = VFIO_USER_CQ_DELETED;
 	cq->group = NULL;
+	cq->irq_pending = 0;
 }
 
 /* Deletes a SQ, if this SQ is the last user of the associated CQ
@@ -2469,6 +2581,75 @@ out:
 	return post_completion(ctrlr, ctrlr->cqs[0], 0, 0, cmd->cid, sc, sct);
 }
 
+static bool
+is_irq_feature_cmd(struct spdk_nvme_cmd *cmd)
+{
+	uint8_t fid = cmd->cdw10_bits.set_features.fid;
+
+	if (cmd->opc == SPDK_NVME_OPC_SET_FEATURES) {
+		return fid == SPDK_NVME_FEAT_INTERRUPT_COALESCING ||
+		       fid == SPDK_NVME_FEAT_INTERRUPT_VECTOR_CONFIGURATION;
+	}
+
+	/* Get Features - Interrupt Coalescing is served from the NVMf controller. */
+	return cmd->opc == SPDK_NVME_OPC_GET_FEATURES &&
+	       fid == SPDK_NVME_FEAT_INTERRUPT_VECTOR_CONFIGURATION;
+}
+
+/*
+ * Interrupt Coalescing and Interrupt Vector Configuration only apply to the
+ * PCIe transport, so the NVMf library doesn't allow changing them: handle
+ * them here. The aggregation threshold and time are stored in the NVMf
+ * controller's features, so that they're reported by Get Features and
+ * migrated along with the other features.
+ */
+static int
+handle_irq_feature(struct nvmf_vfio_user_ctrlr *ctrlr, struct spdk_nvme_cmd *cmd)
+{
+	union spdk_nvme_feat_interrupt_coalescing coalescing = {};
+	union spdk_nvme_feat_interrupt_vector_configuration iv_conf = {};
+	uint16_t sc = SPDK_NVME_SC_SUCCESS;
+	uint16_t sct = SPDK_NVME_SCT_GENERIC;
+	uint32_t cdw0 = 0;
+	uint16_t iv;
+
+	assert(ctrlr->ctrlr != NULL);
+
+	if (cmd->opc == SPDK_NVME_OPC_SET_FEATURES && cmd->cdw10_bits.set_features.sv) {
+		sc = SPDK_NVME_SC_FEATURE_ID_NOT_SAVEABLE;
+		sct = SPDK_NVME_SCT_COMMAND_SPECIFIC;
+		goto out;
+	}
+
+	if (cmd->cdw10_bits.set_features.fid == SPDK_NVME_FEAT_INTERRUPT_COALESCING) {
+		coalescing.bits.thr = cmd->cdw11_bits.feat_interrupt_coalescing.bits.thr;
+		coalescing.bits.time = cmd->cdw11_bits.feat_interrupt_coalescing.bits.time;
+		SPDK_DEBUGLOG(nvmf_vfio, "%s: interrupt coalescing thr=%u time=%u\n",
+			      ctrlr_id(ctrlr), coalescing.bits.thr, coalescing.bits.time);
+		ctrlr->ctrlr->feat.interrupt_coalescing = coalescing;
+		goto out;
+	}
+
+	iv = cmd->cdw11_bits.feat_interrupt_vector_configuration.bits.iv;
+	if (iv > NVME_IRQ_MSIX_NUM - 1) {
+		sc = SPDK_NVME_SC_INVALID_FIELD;
+		goto out;
+	}
+
+	if (cmd->opc == SPDK_NVME_OPC_SET_FEATURES) {
+		set_irq_coalescing_disabled(ctrlr, iv,
+					    cmd->cdw11_bits.feat_interrupt_vector_configuration.bits.cd);
+	} else {
+		iv_conf.bits.iv = iv;
+		/* Interrupt coalescing never applies to the Admin CQ. */
+		iv_conf.bits.cd = iv == 0 || irq_coalescing_disabled(ctrlr, iv);
+		cdw0 = iv_conf.raw;
+	}
+
+out:
+	return post_completion(ctrlr, ctrlr->cqs[0], cdw0, 0, cmd->cid, sc, sct);
+}
+
 /* Returns 0 on success and -errno on error. */
 static int
 consume_admin_cmd(struct nvmf_vfio_user_ctrlr *ctrlr, struct spdk_nvme_cmd *cmd)
@@ -2499,6 +2680,12 @@ consume_admin_cmd(struct nvmf_vfio_user_ctrlr *ctrlr, struct spdk_nvme_cmd *cmd)
 		if (!ctrlr->transport->transport_opts.disable_shadow_doorbells) {
 			return handle_doorbell_buffer_config(ctrlr, cmd);
 		}
+		return handle_cmd_req(ctrlr, cmd, ctrlr->sqs[0]);
+	case SPDK_NVME_OPC_SET_FEATURES:
+	case SPDK_NVME_OPC_GET_FEATURES:
+		if (is_irq_feature_cmd(cmd)) {
+			return handle_irq_feature(ctrlr, cmd);
+		}
 	/* FALLTHROUGH */
 	default:
 		return handle_cmd_req(ctrlr, cmd, ctrlr->sqs[0]);
@@ -3582,6 +3769,9 @@ vfio_user_migr_ctrlr_save_data(struct nvmf_vfio_user_ctrlr *vu_ctrlr)
 	migr_state.ctrlr_header.bar_len[VFU_PCI_DEV_CFG_REGION_IDX] = NVME_REG_CFG_SIZE;
 	memcpy(data_ptr, &migr_state.cfg, NVME_REG_CFG_SIZE);
 
+	memcpy(migr_state.ctrlr_header.irq_coalescing_disabled, vu_ctrlr->irq_coalescing_disabled,
+	       sizeof(vu_ctrlr->irq_coalescing_disabled));
+
 	/* copy shadow doorbells */
 	if (vu_ctrlr->sdbl != NULL) {
 		migr_state.ctrlr_header.sdbl = true;
@@ -3767,6 +3957,9 @@ vfio_user_migr_ctrlr_restore(struct nvmf_vfio_user_ctrlr *vu_ctrlr)
 		return rc;
 	}
 
+	memcpy(vu_ctrlr->irq_coalescing_disabled, migr_state.ctrlr_header.irq_coalescing_disabled,
+	       sizeof(vu_ctrlr->irq_coalescing_disabled));
+
 	/* restore shadow doorbells */
 	if (migr_state.ctrlr_header.sdbl) {
 		struct nvmf_vfio_user_shadow_doorbells *sdbl;
@@ -4721,6 +4914,87 @@ vfio_user_poll_group_add_intr(struct nvmf_vfio_user_poll_group *vu_group,
 	assert(vu_group->intr != NULL);
 }
 
+/*
+ * Fires the interrupts held back by interrupt coalescing whose aggregation time
+ * has expired, and pauses itself once there are none left.
+ */
+static int
+vfio_user_poll_group_irq_poller(void *ctx)
+{
+	struct nvmf_vfio_user_poll_group *vu_group = ctx;
+	struct nvmf_vfio_user_ctrlr *ctrlr;
+	struct nvmf_vfio_user_sq *sq;
+	struct nvmf_vfio_user_cq *cq;
+	uint64_t now, timeout;
+	bool pending = false;
+	int count = 0;
+
+	now = spdk_get_ticks();
+
+	/* Multiple SQs can share a CQ, but its interrupt is only fired once. */
+	TAILQ_FOREACH(sq, &vu_group->sqs, link) {
+		ctrlr = sq->ctrlr;
+		cq = ctrlr->cqs[sq->cqid];
+		if (cq == NULL || cq->irq_pending == 0) {
+			continue;
+		}
+
+		timeout = 0;
+		if (ctrlr->ctrlr != NULL) {
+			timeout = (uint64_t)ctrlr->ctrlr->feat.interrupt_coalescing.bits.time *
+				  NVMF_VFIO_USER_IRQ_COALESCING_PERIOD_US * spdk_get_ticks_hz() / SPDK_SEC_TO_USEC;
+		}
+		if (now - cq->irq_pending_tsc < timeout) {
+			pending = true;
+			continue;
+		}
+
+		if (cq->ien && ctrlr_interrupt_enabled(ctrlr)) {
+			cq_trigger_irq(ctrlr, cq);
+		} else {
+			cq->irq_pending = 0;
+		}
+		count++;
+	}
+
+	if (!pending) {
+		spdk_poller_pause(vu_group->irq_poller);
+		vu_group->irq_poller_active = false;
+	}
+
+	return count > 0 ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
+}
+
+/*
+ * The IRQ poller only finds CQs through the SQs of its poll group, so once the
+ * last SQ of @sq's CQ leaves the group, the interrupt held back for the CQ is
+ * fired right away instead.
+ */
+static void
+vfio_user_poll_group_flush_cq_irq(struct nvmf_vfio_user_poll_group *vu_group,
+				  struct nvmf_vfio_user_sq *sq)
+{
+	struct nvmf_vfio_user_ctrlr *ctrlr = sq->ctrlr;
+	struct nvmf_vfio_user_cq *cq = ctrlr->cqs[sq->cqid];
+	struct nvmf_vfio_user_sq *other_sq;
+
+	if (cq == NULL || cq->irq_pending == 0) {
+		return;
+	}
+
+	TAILQ_FOREACH(other_sq, &vu_group->sqs, link) {
+		if (other_sq->ctrlr == ctrlr && other_sq->cqid == sq->cqid) {
+			return;
+		}
+	}
+
+	if (cq->ien && !ctrlr->disconnect && ctrlr_interrupt_enabled(ctrlr)) {
+		cq_trigger_irq(ctrlr, cq);
+	} else {
+		cq->irq_pending = 0;
+	}
+}
+
 static struct spdk_nvmf_transport_poll_group *
 nvmf_vfio_user_poll_group_create(struct spdk_nvmf_transport *transport,
 				 struct spdk_nvmf_poll_group *group)
@@ -4739,6 +5013,15 @@ nvmf_vfio_user_poll_group_create(struct spdk_nvmf_transport *transport,
 		return NULL;
 	}
 
+	vu_group->irq_poller = SPDK_POLLER_REGISTER(vfio_user_poll_group_irq_poller, vu_group,
+			       NVMF_VFIO_USER_IRQ_COALESCING_PERIOD_US);
+	if (vu_group->irq_poller == NULL) {
+		SPDK_ERRLOG("Error registering interrupt coalescing poller\n");
+		free(vu_group);
+		return NULL;
+	}
+	spdk_poller_pause(vu_group->irq_poller);
+
 	if (in_interrupt_mode(vu_transport)) {
 		vfio_user_poll_group_add_intr(vu_group, group);
 	}
@@ -4846,6 +5129,8 @@ nvmf_vfio_user_poll_group_destroy(struct spdk_nvmf_transport_poll_group *group)
 		vfio_user_poll_group_del_intr(vu_group);
 	}
 
+	spdk_poller_unregister(&vu_group->irq_poller);
+
 	pthread_mutex_lock(&vu_transport->pg_lock);
 	next_tgroup = TAILQ_NEXT(vu_group, link);
 	TAILQ_REMOVE(&vu_transport->poll_groups, vu_group, link);
@@ -5289,6 +5574,7 @@ nvmf_vfio_user_poll_group_remove(struct spdk_nvmf_transport_poll_group *group,
 
 	vu_group = SPDK_CONTAINEROF(group, struct nvmf_vfio_user_poll_group, group);
 	TAILQ_REMOVE(&vu_group->sqs, sq, link);
+	vfio_user_poll_group_flush_cq_irq(vu_group, sq);
 
 	return 0;
 }
@@ -5631,6 +5917,11 @@ handle_suppressed_irq(struct nvmf_vfio_user_ctrlr *ctrlr,
 		return;
 	}
 
+	/* Interrupt coalescing, if configured, takes care of this CQ's interrupts. */
+	if (cq_irq_coalescing_enabled(ctrlr, cq)) {
+		return;
+	}
+
 	cq_tail = *cq_tailp(cq);
 
 	/* Already sent? */
@@ -5871,6 +6162,7 @@ nvmf_vfio_user_poll_group_dump_stat(struct spdk_nvmf_transport_poll_group *group
 
 	spdk_json_write_named_uint64(w, "cqh_admin_writes", vu_group->stats.cqh_admin_writes);
 	spdk_json_write_named_uint64(w, "cqh_io_writes", vu_group->stats.cqh_io_writes);
+	spdk_json_write_named_uint64(w, "irqs_coalesced", vu_group->stats.irqs_coalesced);
 }
 
 static void
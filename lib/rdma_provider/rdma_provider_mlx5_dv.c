@@ -253,7 +253,8 @@ spdk_rdma_provider_qp_queue_send_wrs(struct spdk_rdma_provider_qp *spdk_rdma_qp,
 
 	for (tmp = first; tmp != NULL; tmp = tmp->next) {
 		mlx5_qp->qpex->wr_id = tmp->wr_id;
-		mlx5_qp->qpex->wr_flags = tmp->send_flags;
+		/* Inline data is passed with ibv_wr_set_inline_data() rather than as a flag */
+		mlx5_qp->qpex->wr_flags = tmp->send_flags & ~IBV_SEND_INLINE;
 
 		switch (tmp->opcode) {
 		case IBV_WR_SEND:
@@ -273,7 +274,12 @@ spdk_rdma_provider_qp_queue_send_wrs(struct spdk_rdma_provider_qp *spdk_rdma_qp,
 			assert(0);
 		}
 
-		ibv_wr_set_sge_list(mlx5_qp->qpex, tmp->num_sge, tmp->sg_list);
+		if ((tmp->send_flags & IBV_SEND_INLINE) && tmp->num_sge == 1) {
+			ibv_wr_set_inline_data(mlx5_qp->qpex, (void *)(uintptr_t)tmp->sg_list[0].addr,
+					       tmp->sg_list[0].length);
+		} else {
+			ibv_wr_set_sge_list(mlx5_qp->qpex, tmp->num_sge, tmp->sg_list);
+		}
 
 		spdk_rdma_qp->send_wrs.last = tmp;
 		spdk_rdma_qp->stats->send.num_submitted_wrs++;
@@ -60,9 +60,17 @@ struct spdk_reduce_pm_file {
 #define REDUCE_IO_READV		1
 #define REDUCE_IO_WRITEV	2
 
+/* comp_algo is valid.  Chunks without it were compressed with the algorithm of the volume.
+ * Chunk maps of volumes created before the flags were introduced have 0xFF in these fields,
+ * so they're only written and checked on volumes with SPDK_REDUCE_VOL_FLAG_ADAPTIVE set.
+ */
+#define REDUCE_CHUNK_FLAG_COMP_ALGO	(1u << 0)
+
 struct spdk_reduce_chunk_map {
 	uint32_t		compressed_size;
-	uint32_t		reserved;
+	uint8_t			flags;
+	uint8_t			comp_algo;
+	uint16_t		reserved;
 	uint64_t		io_unit_index[0];
 };
 
@@ -105,6 +113,7 @@ struct spdk_reduce_vol_request {
 	struct spdk_reduce_backing_io           *backing_io;
 	bool					chunk_is_compressed;
 	bool					copy_after_decompress;
+	bool					compress_skipped;
 	uint64_t				offset;
 	uint64_t				logical_map_index;
 	uint64_t				length;
@@ -150,6 +159,12 @@ struct spdk_reduce_vol {
 	struct iovec				*buf_iov_mem;
 	/* Single contiguous buffer used for backing io buffers for this volume. */
 	uint8_t					*buf_backing_io_mem;
+
+	/* Adaptive compression: number of consecutive sampled chunks that didn't compress and
+	 * number of chunks stored uncompressed without sampling since the last sample.
+	 */
+	uint32_t				incompressible_chunks;
+	uint32_t				unsampled_chunks;
 };
 
 static void _start_readv_request(struct spdk_reduce_vol_request *req);
@@ -165,6 +180,15 @@ static int g_vol_count = 0;
  */
 #define REDUCE_NUM_EXTRA_CHUNKS 128
 
+/*
+ * With adaptive compression, after this many consecutive chunks didn't compress, the following
+ *  chunks are written uncompressed without trying to compress them.  Every
+ *  REDUCE_ADAPTIVE_SAMPLE_INTERVAL-th chunk is still compressed to detect data becoming
+ *  compressible again.
+ */
+#define REDUCE_ADAPTIVE_INCOMPRESSIBLE_CHUNKS	4
+#define REDUCE_ADAPTIVE_SAMPLE_INTERVAL		32
+
 static void
 _reduce_persist(struct spdk_reduce_vol *vol, const void *addr, size_t len)
 {
@@ -259,6 +283,10 @@ _validate_vol_params(struct spdk_reduce_vol_params *params)
 		return -1;
 	}
 
+	if ((params->flags & ~SPDK_REDUCE_VOL_FLAG_ADAPTIVE) != 0) {
+		return -EINVAL;
+	}
+
 	return 0;
 }
 
@@ -808,6 +836,12 @@ _load_read_super_and_path_cpl(void *cb_arg, int reduce_errno)
 	}
 
 	memcpy(&vol->params, &vol->backing_super->params, sizeof(vol->params));
+	if ((vol->params.flags & ~SPDK_REDUCE_VOL_FLAG_ADAPTIVE) != 0) {
+		/* The volume was created by a newer release using features this one doesn't know */
+		SPDK_ERRLOG("Unsupported volume flags 0x%x\n", vol->params.flags);
+		rc = -EINVAL;
+		goto error;
+	}
 	vol->backing_io_units_per_chunk = vol->params.chunk_size / vol->params.backing_io_unit_size;
 	vol->logical_blocks_per_chunk = vol->params.chunk_size / vol->params.logical_block_size;
 	vol->backing_lba_per_io_unit = vol->params.backing_io_unit_size / vol->backing_dev->blocklen;
@@ -1363,6 +1397,10 @@ _reduce_vol_write_chunk(struct spdk_reduce_vol_request *req, reduce_request_fn n
 	req->chunk_is_compressed = (req->num_io_units != vol->backing_io_units_per_chunk);
 	req->chunk->compressed_size =
 		req->chunk_is_compressed ? compressed_size : vol->params.chunk_size;
+	if (vol->params.flags & SPDK_REDUCE_VOL_FLAG_ADAPTIVE) {
+		req->chunk->flags = REDUCE_CHUNK_FLAG_COMP_ALGO;
+		req->chunk->comp_algo = req->backing_cb_args.comp_algo;
+	}
 
 	/* if the chunk is uncompressed we need to copy the data from the host buffers. */
 	if (req->chunk_is_compressed == false) {
@@ -1411,6 +1449,36 @@ _reduce_vol_write_chunk(struct spdk_reduce_vol_request *req, reduce_request_fn n
 	_issue_backing_ops(req, vol, next_fn, true /* write */);
 }
 
+static void
+_reduce_vol_update_compressibility(struct spdk_reduce_vol *vol, uint32_t compressed_size)
+{
+	uint32_t num_io_units;
+
+	num_io_units = spdk_divide_round_up(compressed_size, vol->params.backing_io_unit_size);
+	if (num_io_units < vol->backing_io_units_per_chunk) {
+		vol->incompressible_chunks = 0;
+	} else if (vol->incompressible_chunks < REDUCE_ADAPTIVE_INCOMPRESSIBLE_CHUNKS) {
+		vol->incompressible_chunks++;
+	}
+}
+
+static bool
+_reduce_vol_skip_compress(struct spdk_reduce_vol *vol)
+{
+	if (!(vol->params.flags & SPDK_REDUCE_VOL_FLAG_ADAPTIVE) ||
+	    vol->incompressible_chunks < REDUCE_ADAPTIVE_INCOMPRESSIBLE_CHUNKS) {
+		return false;
+	}
+
+	if (++vol->unsampled_chunks < REDUCE_ADAPTIVE_SAMPLE_INTERVAL) {
+		return true;
+	}
+
+	vol->unsampled_chunks = 0;
+
+	return false;
+}
+
 static void
 _write_compress_done(void *_req, int reduce_errno)
 {
@@ -1426,6 +1494,10 @@ _write_compress_done(void *_req, int reduce_errno)
 		req->backing_cb_args.output_size = req->vol->params.chunk_size;
 	}
 
+	if ((req->vol->params.flags & SPDK_REDUCE_VOL_FLAG_ADAPTIVE) && !req->compress_skipped) {
+		_reduce_vol_update_compressibility(req->vol, req->backing_cb_args.output_size);
+	}
+
 	_reduce_vol_write_chunk(req, _write_write_done, req->backing_cb_args.output_size);
 }
 
@@ -1436,6 +1508,15 @@ _reduce_vol_compress_chunk(struct spdk_reduce_vol_request *req, reduce_request_f
 
 	req->backing_cb_args.cb_fn = next_fn;
 	req->backing_cb_args.cb_arg = req;
+	req->backing_cb_args.comp_algo = vol->params.comp_algo;
+	req->compress_skipped = _reduce_vol_skip_compress(vol);
+	if (req->compress_skipped) {
+		/* Recent chunks didn't compress, so store this one uncompressed right away */
+		req->backing_cb_args.output_size = vol->params.chunk_size;
+		next_fn(req, 0);
+		return;
+	}
+
 	req->comp_buf_iov[0].iov_base = req->comp_buf;
 	req->comp_buf_iov[0].iov_len = vol->params.chunk_size;
 	vol->backing_dev->compress(vol->backing_dev,
@@ -1443,6 +1524,17 @@ _reduce_vol_compress_chunk(struct spdk_reduce_vol_request *req, reduce_request_f
 				   &req->backing_cb_args);
 }
 
+static uint8_t
+_reduce_vol_get_chunk_comp_algo(struct spdk_reduce_vol *vol, struct spdk_reduce_chunk_map *chunk)
+{
+	if ((vol->params.flags & SPDK_REDUCE_VOL_FLAG_ADAPTIVE) &&
+	    (chunk->flags & REDUCE_CHUNK_FLAG_COMP_ALGO)) {
+		return chunk->comp_algo;
+	}
+
+	return vol->params.comp_algo;
+}
+
 static void
 _reduce_vol_decompress_chunk_scratch(struct spdk_reduce_vol_request *req, reduce_request_fn next_fn)
 {
@@ -1450,6 +1542,7 @@ _reduce_vol_decompress_chunk_scratch(struct spdk_reduce_vol_request *req, reduce
 
 	req->backing_cb_args.cb_fn = next_fn;
 	req->backing_cb_args.cb_arg = req;
+	req->backing_cb_args.comp_algo = _reduce_vol_get_chunk_comp_algo(vol, req->chunk);
 	req->comp_buf_iov[0].iov_base = req->comp_buf;
 	req->comp_buf_iov[0].iov_len = req->chunk->compressed_size;
 	req->decomp_buf_iov[0].iov_base = req->decomp_buf;
@@ -1517,6 +1610,7 @@ decompress:
 	assert(!req->copy_after_decompress || (req->copy_after_decompress && req->decomp_iovcnt == 1));
 	req->backing_cb_args.cb_fn = next_fn;
 	req->backing_cb_args.cb_arg = req;
+	req->backing_cb_args.comp_algo = _reduce_vol_get_chunk_comp_algo(vol, req->chunk);
 	req->comp_buf_iov[0].iov_base = req->comp_buf;
 	req->comp_buf_iov[0].iov_len = req->chunk->compressed_size;
 	vol->backing_dev->decompress(vol->backing_dev,
@@ -1968,6 +2062,7 @@ spdk_reduce_vol_print_info(struct spdk_reduce_vol *vol)
 	SPDK_NOTICELOG("\tvol->params.logical_block_size = 0x%x\n", vol->params.logical_block_size);
 	SPDK_NOTICELOG("\tvol->params.chunk_size = 0x%x\n", vol->params.chunk_size);
 	SPDK_NOTICELOG("\tvol->params.vol_size = 0x%" PRIx64 "\n", vol->params.vol_size);
+	SPDK_NOTICELOG("\tvol->params.flags = 0x%x\n", vol->params.flags);
 	num_chunks = _get_total_chunks(vol->params.vol_size, vol->params.chunk_size);
 	SPDK_NOTICELOG("\ttotal chunks (including extra) = 0x%" PRIx64 "\n", num_chunks);
 	SPDK_NOTICELOG("\ttotal chunks (excluding extra) = 0x%" PRIx64 "\n",
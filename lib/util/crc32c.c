@@ -6,6 +6,19 @@
 #include "util_internal.h"
 #include "crc_internal.h"
 #include "spdk/crc32.h"
+#include "spdk/util.h"
+
+/* CRC instructions used to calculate the checksums of multiple buffers concurrently, also when
+ * isa-l is used for single buffers */
+#if defined(__x86_64__) && defined(__SSE4_2__)
+#include <x86intrin.h>
+#define SPDK_CRC32C_INTERLEAVE
+#define crc32c_u64(crc, data) _mm_crc32_u64(crc, data)
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define SPDK_CRC32C_INTERLEAVE
+#define crc32c_u64(crc, data) __crc32cd(crc, data)
+#endif
 
 #ifdef SPDK_HAVE_ISAL
 
@@ -28,8 +41,10 @@ spdk_crc32c_update(const void *buf, size_t len, uint32_t crc)
 	 * passed to _mm_crc32_u64 is 8 byte aligned. This can avoid unaligned loads.
 	 */
 	count_pre = ((uint64_t)buf & 7) == 0 ? 0 : 8 - ((uint64_t)buf & 7);
-	count_post = (uint64_t)((uintptr_t)buf + len) & 7;
-	count_mid = (len - count_pre - count_post) / 8;
+	/* Short unaligned buffers may not even reach the next 8 byte boundary */
+	count_pre = spdk_min(count_pre, len);
+	count_post = (len - count_pre) & 7;
+	count_mid = (len - count_pre) / 8;
 
 	while (count_pre--) {
 		crc = _mm_crc32_u8(crc, *(const uint8_t *)buf);
@@ -67,8 +82,10 @@ spdk_crc32c_update(const void *buf, size_t len, uint32_t crc)
 	 * passed to crc32_cd is 8 byte aligned. This can avoid unaligned loads.
 	 */
 	count_pre = ((uint64_t)buf & 7) == 0 ? 0 : 8 - ((uint64_t)buf & 7);
-	count_post = (uint64_t)(buf + len) & 7;
-	count_mid = (len - count_pre - count_post) / 8;
+	/* Short unaligned buffers may not even reach the next 8 byte boundary */
+	count_pre = spdk_min(count_pre, len);
+	count_post = (len - count_pre) & 7;
+	count_mid = (len - count_pre) / 8;
 
 	while (count_pre--) {
 		crc = __crc32cb(crc, *(const uint8_t *)buf);
@@ -126,6 +143,90 @@ spdk_crc32c_iov_update(struct iovec *iov, int iovcnt, uint32_t crc32c)
 	return crc32c;
 }
 
+#ifdef SPDK_CRC32C_INTERLEAVE
+
+/* Number of buffers processed at the same time, enough to hide the latency of the CRC instruction */
+#define CRC32C_INTERLEAVE_STREAMS 4
+
+/* Above this size, isa-l's folding implementation is faster than interleaving the buffers */
+#define CRC32C_INTERLEAVE_MAX_LEN 1024
+
+static inline uint64_t
+crc32c_load64(const uint8_t *buf)
+{
+	uint64_t data;
+
+	memcpy(&data, buf, sizeof(data));
+
+	return data;
+}
+
+static void
+crc32c_update_interleaved(const struct iovec *iovs, uint32_t *crcs, const uint32_t *idx)
+{
+	const uint8_t *b0 = iovs[idx[0]].iov_base, *b1 = iovs[idx[1]].iov_base,
+		       *b2 = iovs[idx[2]].iov_base, *b3 = iovs[idx[3]].iov_base;
+	uint64_t c0 = crcs[idx[0]], c1 = crcs[idx[1]], c2 = crcs[idx[2]], c3 = crcs[idx[3]];
+	size_t len, i;
+
+	len = spdk_min(spdk_min(iovs[idx[0]].iov_len, iovs[idx[1]].iov_len),
+		       spdk_min(iovs[idx[2]].iov_len, iovs[idx[3]].iov_len));
+
+	/* Alternate between the buffers over the length they have in common, so that the CRC
+	 * instructions operating on different buffers don't depend on each other */
+	for (i = 0; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+		c0 = crc32c_u64(c0, crc32c_load64(b0 + i));
+		c1 = crc32c_u64(c1, crc32c_load64(b1 + i));
+		c2 = crc32c_u64(c2, crc32c_load64(b2 + i));
+		c3 = crc32c_u64(c3, crc32c_load64(b3 + i));
+	}
+
+	crcs[idx[0]] = spdk_crc32c_update(b0 + i, iovs[idx[0]].iov_len - i, (uint32_t)c0);
+	crcs[idx[1]] = spdk_crc32c_update(b1 + i, iovs[idx[1]].iov_len - i, (uint32_t)c1);
+	crcs[idx[2]] = spdk_crc32c_update(b2 + i, iovs[idx[2]].iov_len - i, (uint32_t)c2);
+	crcs[idx[3]] = spdk_crc32c_update(b3 + i, iovs[idx[3]].iov_len - i, (uint32_t)c3);
+}
+
+void
+spdk_crc32c_update_batch(const struct iovec *iovs, uint32_t *crcs, uint32_t count)
+{
+	uint32_t idx[CRC32C_INTERLEAVE_STREAMS], num = 0, i;
+
+	for (i = 0; i < count; i++) {
+#ifdef SPDK_HAVE_ISAL
+		if (iovs[i].iov_len > CRC32C_INTERLEAVE_MAX_LEN) {
+			crcs[i] = spdk_crc32c_update(iovs[i].iov_base, iovs[i].iov_len, crcs[i]);
+			continue;
+		}
+#endif
+		idx[num++] = i;
+		if (num == CRC32C_INTERLEAVE_STREAMS) {
+			crc32c_update_interleaved(iovs, crcs, idx);
+			num = 0;
+		}
+	}
+
+	/* Not enough buffers left to interleave them */
+	for (i = 0; i < num; i++) {
+		crcs[idx[i]] = spdk_crc32c_update(iovs[idx[i]].iov_base, iovs[idx[i]].iov_len,
+						  crcs[idx[i]]);
+	}
+}
+
+#else
+
+void
+spdk_crc32c_update_batch(const struct iovec *iovs, uint32_t *crcs, uint32_t count)
+{
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		crcs[i] = spdk_crc32c_update(iovs[i].iov_base, iovs[i].iov_len, crcs[i]);
+	}
+}
+
+#endif
+
 uint32_t
 spdk_crc32c_nvme(const void *buf, size_t len, uint32_t crc)
 {
@@ -5,6 +5,7 @@
 
 #include "crc_internal.h"
 #include "spdk/crc64.h"
+#include "spdk/util.h"
 
 #ifdef SPDK_CONFIG_ISAL
 #include "isa-l/include/crc64.h"
@@ -15,6 +16,17 @@ spdk_crc64_nvme(const void *buf, size_t len, uint64_t crc)
 	return crc64_rocksoft_refl(crc, (const uint8_t *)buf, len);
 }
 
+void
+spdk_crc64_nvme_batch(const struct iovec *iovs, uint64_t *crcs, uint32_t count)
+{
+	uint32_t i;
+
+	/* isa-l already folds multiple lanes of a single buffer */
+	for (i = 0; i < count; i++) {
+		crcs[i] = spdk_crc64_nvme(iovs[i].iov_base, iovs[i].iov_len, crcs[i]);
+	}
+}
+
 #else
 
 static const uint64_t crc64_rocksoft_refl_table[256] = {
@@ -166,4 +178,44 @@ spdk_crc64_nvme(const void *buf, size_t len, uint64_t crc)
 {
 	return crc64_rocksoft_refl_base(crc, (const uint8_t *)buf, len);
 }
+
+/* Number of buffers processed at the same time, to overlap the latency of the table lookups */
+#define CRC64_INTERLEAVE_STREAMS 4
+
+static void
+crc64_rocksoft_refl_interleaved(const struct iovec *iovs, uint64_t *crcs, uint32_t count)
+{
+	const uint8_t *buf[CRC64_INTERLEAVE_STREAMS];
+	uint64_t crc[CRC64_INTERLEAVE_STREAMS];
+	size_t len = SIZE_MAX, i;
+	uint32_t s;
+
+	assert(count <= CRC64_INTERLEAVE_STREAMS);
+	for (s = 0; s < count; s++) {
+		buf[s] = iovs[s].iov_base;
+		crc[s] = ~crcs[s];
+		len = spdk_min(len, iovs[s].iov_len);
+	}
+
+	for (i = 0; i < len; i++) {
+		for (s = 0; s < count; s++) {
+			crc[s] = crc64_rocksoft_refl_table[(uint8_t)crc[s] ^ buf[s][i]] ^ (crc[s] >> 8);
+		}
+	}
+
+	for (s = 0; s < count; s++) {
+		crcs[s] = crc64_rocksoft_refl_base(~crc[s], buf[s] + len, iovs[s].iov_len - len);
+	}
+}
+
+void
+spdk_crc64_nvme_batch(const struct iovec *iovs, uint64_t *crcs, uint32_t count)
+{
+	uint32_t i, num;
+
+	for (i = 0; i < count; i += num) {
+		num = spdk_min(count - i, CRC64_INTERLEAVE_STREAMS);
+		crc64_rocksoft_refl_interleaved(&iovs[i], &crcs[i], num);
+	}
+}
 #endif
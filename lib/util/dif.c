@@ -309,6 +309,48 @@ dif_generate_guard_split(uint64_t guard_seed, struct _dif_sgl *sgl, uint32_t sta
 	return guard;
 }
 
+/* Maximum number of blocks whose guards are calculated together by the contiguous fast path */
+#define DIF_GUARD_BATCH_BLOCKS	32
+
+/* Calculate the guards of count blocks placed stride bytes apart, each guard covering the
+ * first len bytes of its block.  On input, guards holds the seed of each guard.
+ */
+static void
+_dif_generate_guard_batch(uint64_t *guards, uint8_t *buf, uint32_t stride, uint32_t len,
+			  uint32_t count, enum spdk_dif_pi_format dif_pi_format)
+{
+	struct iovec iovs[DIF_GUARD_BATCH_BLOCKS];
+	uint32_t crcs[DIF_GUARD_BATCH_BLOCKS];
+	uint32_t i;
+
+	assert(count <= DIF_GUARD_BATCH_BLOCKS);
+
+	if (dif_pi_format == SPDK_DIF_PI_FORMAT_16) {
+		/* There is no batched CRC-16, the guards are calculated one by one. */
+		for (i = 0; i < count; i++) {
+			guards[i] = _dif_generate_guard(guards[i], buf + i * stride, len, dif_pi_format);
+		}
+		return;
+	}
+
+	for (i = 0; i < count; i++) {
+		iovs[i].iov_base = buf + i * stride;
+		iovs[i].iov_len = len;
+	}
+
+	if (dif_pi_format == SPDK_DIF_PI_FORMAT_32) {
+		for (i = 0; i < count; i++) {
+			crcs[i] = ~(uint32_t)guards[i];
+		}
+		spdk_crc32c_update_batch(iovs, crcs, count);
+		for (i = 0; i < count; i++) {
+			guards[i] = (uint64_t)(uint32_t)~crcs[i];
+		}
+	} else {
+		spdk_crc64_nvme_batch(iovs, guards, count);
+	}
+}
+
 static inline uint64_t
 _dif_generate_guard_copy(uint64_t guard_seed, void *dst, void *src, size_t buf_len,
 			 enum spdk_dif_pi_format dif_pi_format)
@@ -705,23 +747,48 @@ _dif_generate(void *_dif, uint64_t guard, uint32_t offset_blocks,
 	}
 }
 
+/* Number of whole blocks, up to DIF_GUARD_BATCH_BLOCKS, which are contiguous in the current
+ * iovec.  Used when every iovec holds a multiple of the block size.
+ */
+static inline uint32_t
+_dif_sgl_contig_blocks(struct _dif_sgl *sgl, uint8_t **buf, uint32_t block_size,
+		       uint32_t num_blocks)
+{
+	uint32_t buf_len;
+
+	_dif_sgl_get_buf(sgl, buf, &buf_len);
+	assert(buf_len >= block_size);
+
+	num_blocks = spdk_min(num_blocks, buf_len / block_size);
+
+	return spdk_min(num_blocks, DIF_GUARD_BATCH_BLOCKS);
+}
+
 static void
 dif_generate(struct _dif_sgl *sgl, uint32_t num_blocks, const struct spdk_dif_ctx *ctx)
 {
-	uint32_t offset_blocks;
+	uint32_t offset_blocks = 0, count, i;
 	uint8_t *buf;
-	uint64_t guard = 0;
+	uint64_t guards[DIF_GUARD_BATCH_BLOCKS] = {};
 
-	for (offset_blocks = 0; offset_blocks < num_blocks; offset_blocks++) {
-		_dif_sgl_get_buf(sgl, &buf, NULL);
+	while (offset_blocks < num_blocks) {
+		count = _dif_sgl_contig_blocks(sgl, &buf, ctx->block_size, num_blocks - offset_blocks);
 
 		if (ctx->dif_flags & SPDK_DIF_FLAGS_GUARD_CHECK) {
-			guard = _dif_generate_guard(ctx->guard_seed, buf, ctx->guard_interval, ctx->dif_pi_format);
+			for (i = 0; i < count; i++) {
+				guards[i] = ctx->guard_seed;
+			}
+			_dif_generate_guard_batch(guards, buf, ctx->block_size, ctx->guard_interval,
+						  count, ctx->dif_pi_format);
 		}
 
-		_dif_generate(buf + ctx->guard_interval, guard, offset_blocks, ctx);
+		for (i = 0; i < count; i++) {
+			_dif_generate(buf + ctx->guard_interval, guards[i], offset_blocks + i, ctx);
+			buf += ctx->block_size;
+		}
 
-		_dif_sgl_advance(sgl, ctx->block_size);
+		_dif_sgl_advance(sgl, count * ctx->block_size);
+		offset_blocks += count;
 	}
 }
 
@@ -940,24 +1007,33 @@ static int
 dif_verify(struct _dif_sgl *sgl, uint32_t num_blocks,
 	   const struct spdk_dif_ctx *ctx, struct spdk_dif_error *err_blk)
 {
-	uint32_t offset_blocks;
+	uint32_t offset_blocks = 0, count, i;
 	int rc;
 	uint8_t *buf;
-	uint64_t guard = 0;
+	uint64_t guards[DIF_GUARD_BATCH_BLOCKS] = {};
 
-	for (offset_blocks = 0; offset_blocks < num_blocks; offset_blocks++) {
-		_dif_sgl_get_buf(sgl, &buf, NULL);
+	while (offset_blocks < num_blocks) {
+		count = _dif_sgl_contig_blocks(sgl, &buf, ctx->block_size, num_blocks - offset_blocks);
 
 		if (ctx->dif_flags & SPDK_DIF_FLAGS_GUARD_CHECK) {
-			guard = _dif_generate_guard(ctx->guard_seed, buf, ctx->guard_interval, ctx->dif_pi_format);
+			for (i = 0; i < count; i++) {
+				guards[i] = ctx->guard_seed;
+			}
+			_dif_generate_guard_batch(guards, buf, ctx->block_size, ctx->guard_interval,
+						  count, ctx->dif_pi_format);
 		}
 
-		rc = _dif_verify(buf + ctx->guard_interval, guard, offset_blocks, ctx, err_blk);
-		if (rc != 0) {
-			return rc;
+		for (i = 0; i < count; i++) {
+			rc = _dif_verify(buf + ctx->guard_interval, guards[i], offset_blocks + i, ctx,
+					 err_blk);
+			if (rc != 0) {
+				return rc;
+			}
+			buf += ctx->block_size;
 		}
 
-		_dif_sgl_advance(sgl, ctx->block_size);
+		_dif_sgl_advance(sgl, count * ctx->block_size);
+		offset_blocks += count;
 	}
 
 	return 0;
@@ -1608,31 +1684,49 @@ spdk_dif_inject_error(struct iovec *iovs, int iovcnt, uint32_t num_blocks,
 	return 0;
 }
 
+/* The guard of each block covers its data followed by the metadata preceding the DIF field */
+static void
+dix_generate_guard_batch(uint64_t *guards, uint8_t *data_buf, uint8_t *md_buf, uint32_t count,
+			 const struct spdk_dif_ctx *ctx)
+{
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		guards[i] = ctx->guard_seed;
+	}
+
+	_dif_generate_guard_batch(guards, data_buf, ctx->block_size, ctx->block_size, count,
+				  ctx->dif_pi_format);
+	_dif_generate_guard_batch(guards, md_buf, ctx->md_size, ctx->guard_interval, count,
+				  ctx->dif_pi_format);
+}
+
 static void
 dix_generate(struct _dif_sgl *data_sgl, struct _dif_sgl *md_sgl,
 	     uint32_t num_blocks, const struct spdk_dif_ctx *ctx)
 {
-	uint32_t offset_blocks = 0;
+	uint32_t offset_blocks = 0, count, i;
 	uint8_t *data_buf, *md_buf;
-	uint64_t guard;
+	uint64_t guards[DIF_GUARD_BATCH_BLOCKS] = {};
 
 	while (offset_blocks < num_blocks) {
-		_dif_sgl_get_buf(data_sgl, &data_buf, NULL);
+		count = _dif_sgl_contig_blocks(data_sgl, &data_buf, ctx->block_size,
+					       num_blocks - offset_blocks);
+		/* The metadata is a single contiguous buffer */
 		_dif_sgl_get_buf(md_sgl, &md_buf, NULL);
 
-		guard = 0;
 		if (ctx->dif_flags & SPDK_DIF_FLAGS_GUARD_CHECK) {
-			guard = _dif_generate_guard(ctx->guard_seed, data_buf, ctx->block_size,
-						    ctx->dif_pi_format);
-			guard = _dif_generate_guard(guard, md_buf, ctx->guard_interval,
-						    ctx->dif_pi_format);
+			dix_generate_guard_batch(guards, data_buf, md_buf, count, ctx);
 		}
 
-		_dif_generate(md_buf + ctx->guard_interval, guard, offset_blocks, ctx);
+		for (i = 0; i < count; i++) {
+			_dif_generate(md_buf + ctx->guard_interval, guards[i], offset_blocks + i, ctx);
+			md_buf += ctx->md_size;
+		}
 
-		_dif_sgl_advance(data_sgl, ctx->block_size);
-		_dif_sgl_advance(md_sgl, ctx->md_size);
-		offset_blocks++;
+		_dif_sgl_advance(data_sgl, count * ctx->block_size);
+		_dif_sgl_advance(md_sgl, count * ctx->md_size);
+		offset_blocks += count;
 	}
 }
 
@@ -1718,31 +1812,33 @@ dix_verify(struct _dif_sgl *data_sgl, struct _dif_sgl *md_sgl,
 	   uint32_t num_blocks, const struct spdk_dif_ctx *ctx,
 	   struct spdk_dif_error *err_blk)
 {
-	uint32_t offset_blocks = 0;
+	uint32_t offset_blocks = 0, count, i;
 	uint8_t *data_buf, *md_buf;
-	uint64_t guard;
+	uint64_t guards[DIF_GUARD_BATCH_BLOCKS] = {};
 	int rc;
 
 	while (offset_blocks < num_blocks) {
-		_dif_sgl_get_buf(data_sgl, &data_buf, NULL);
+		count = _dif_sgl_contig_blocks(data_sgl, &data_buf, ctx->block_size,
+					       num_blocks - offset_blocks);
+		/* The metadata is a single contiguous buffer */
 		_dif_sgl_get_buf(md_sgl, &md_buf, NULL);
 
-		guard = 0;
 		if (ctx->dif_flags & SPDK_DIF_FLAGS_GUARD_CHECK) {
-			guard = _dif_generate_guard(ctx->guard_seed, data_buf, ctx->block_size,
-						    ctx->dif_pi_format);
-			guard = _dif_generate_guard(guard, md_buf, ctx->guard_interval,
-						    ctx->dif_pi_format);
+			dix_generate_guard_batch(guards, data_buf, md_buf, count, ctx);
 		}
 
-		rc = _dif_verify(md_buf + ctx->guard_interval, guard, offset_blocks, ctx, err_blk);
-		if (rc != 0) {
-			return rc;
+		for (i = 0; i < count; i++) {
+			rc = _dif_verify(md_buf + ctx->guard_interval, guards[i], offset_blocks + i, ctx,
+					 err_blk);
+			if (rc != 0) {
+				return rc;
+			}
+			md_buf += ctx->md_size;
 		}
 
-		_dif_sgl_advance(data_sgl, ctx->block_size);
-		_dif_sgl_advance(md_sgl, ctx->md_size);
-		offset_blocks++;
+		_dif_sgl_advance(data_sgl, count * ctx->block_size);
+		_dif_sgl_advance(md_sgl, count * ctx->md_size);
+		offset_blocks += count;
 	}
 
 	return 0;
@@ -8,6 +8,10 @@
 
 #include "spdk/string.h"
 
+#if defined(__x86_64__) && (defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE2__))
+#include <x86intrin.h>
+#endif
+
 char *
 spdk_vsprintf_append_realloc(char *buffer, const char *format, va_list args)
 {
@@ -381,6 +385,64 @@ bool
 spdk_mem_all_zero(const void *data, size_t size)
 {
 	const uint8_t *buf = data;
+	uint64_t word;
+
+	/* Check the bulk of the buffer using the widest vectors available, ORing four of them
+	 * together, so that there's only a single test (and branch) per iteration */
+#if defined(__x86_64__) && defined(__AVX512F__)
+	const __m512i *vbuf;
+	__m512i v0, v1;
+
+	while (size >= 4 * sizeof(v0)) {
+		vbuf = (const __m512i *)buf;
+		v0 = _mm512_or_si512(_mm512_loadu_si512(vbuf), _mm512_loadu_si512(vbuf + 1));
+		v1 = _mm512_or_si512(_mm512_loadu_si512(vbuf + 2), _mm512_loadu_si512(vbuf + 3));
+		v0 = _mm512_or_si512(v0, v1);
+		if (_mm512_test_epi64_mask(v0, v0) != 0) {
+			return false;
+		}
+		buf += 4 * sizeof(v0);
+		size -= 4 * sizeof(v0);
+	}
+#elif defined(__x86_64__) && defined(__AVX2__)
+	const __m256i *vbuf;
+	__m256i v0, v1;
+
+	while (size >= 4 * sizeof(v0)) {
+		vbuf = (const __m256i *)buf;
+		v0 = _mm256_or_si256(_mm256_loadu_si256(vbuf), _mm256_loadu_si256(vbuf + 1));
+		v1 = _mm256_or_si256(_mm256_loadu_si256(vbuf + 2), _mm256_loadu_si256(vbuf + 3));
+		v0 = _mm256_or_si256(v0, v1);
+		if (!_mm256_testz_si256(v0, v0)) {
+			return false;
+		}
+		buf += 4 * sizeof(v0);
+		size -= 4 * sizeof(v0);
+	}
+#elif defined(__x86_64__) && defined(__SSE2__)
+	const __m128i *vbuf;
+	__m128i v0, v1;
+
+	while (size >= 4 * sizeof(v0)) {
+		vbuf = (const __m128i *)buf;
+		v0 = _mm_or_si128(_mm_loadu_si128(vbuf), _mm_loadu_si128(vbuf + 1));
+		v1 = _mm_or_si128(_mm_loadu_si128(vbuf + 2), _mm_loadu_si128(vbuf + 3));
+		v0 = _mm_or_si128(v0, v1);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(v0, _mm_setzero_si128())) != 0xffff) {
+			return false;
+		}
+		buf += 4 * sizeof(v0);
+		size -= 4 * sizeof(v0);
+	}
+#endif
+	while (size >= sizeof(word)) {
+		memcpy(&word, buf, sizeof(word));
+		if (word != 0) {
+			return false;
+		}
+		buf += sizeof(word);
+		size -= sizeof(word);
+	}
 
 	while (size--) {
 		if (*buf++ != 0) {
@@ -49,7 +49,7 @@ ifeq ($(CONFIG_RDMA),y)
 DEPDIRS-nvme += rdma_provider rdma_utils
 endif
 
-DEPDIRS-blob := log util thread dma trace
+DEPDIRS-blob := log util thread dma trace accel
 DEPDIRS-accel := log util thread json rpc jsonrpc dma
 DEPDIRS-jsonrpc := log util json
 DEPDIRS-virtio := log util json thread vfio_user
@@ -150,7 +150,7 @@ DEPDIRS-bdev_delay := $(BDEV_DEPS_THREAD)
 DEPDIRS-bdev_iscsi := $(BDEV_DEPS_THREAD)
 DEPDIRS-bdev_malloc := $(BDEV_DEPS_THREAD) accel dma
 DEPDIRS-bdev_null := $(BDEV_DEPS_THREAD)
-DEPDIRS-bdev_nvme = $(BDEV_DEPS_THREAD) accel keyring nvme trace
+DEPDIRS-bdev_nvme = $(BDEV_DEPS_THREAD) accel keyring notify nvme trace
 DEPDIRS-bdev_ocf := $(BDEV_DEPS_THREAD)
 DEPDIRS-bdev_passthru := $(BDEV_DEPS_THREAD)
 DEPDIRS-bdev_raid := $(BDEV_DEPS_THREAD) trace
@@ -28,6 +28,15 @@
 /* This namespace UUID was generated using uuid_generate() method. */
 #define BDEV_COMPRESS_NAMESPACE_UUID "c3fad6da-832f-4cc0-9cdc-5c552b225e7b"
 
+/* Adaptive compression: how often the busy ratio of the reduce thread is sampled and the busy
+ * percentages above/below which the fast/strong compression algorithm is used.
+ */
+#define COMP_ADAPTIVE_SAMPLE_PERIOD_US	(100 * 1000)
+#define COMP_ADAPTIVE_BUSY_HIGH		80
+#define COMP_ADAPTIVE_BUSY_LOW		50
+/* lz4 level is the acceleration factor, higher values trade compression ratio for speed */
+#define COMP_ADAPTIVE_LZ4_FAST_LEVEL	16
+
 struct vbdev_comp_delete_ctx {
 	spdk_delete_compress_complete	cb_fn;
 	void				*cb_arg;
@@ -35,6 +44,20 @@ struct vbdev_comp_delete_ctx {
 	struct spdk_thread		*orig_thread;
 };
 
+/* Adaptive compression algorithm selection for a compress bdev. */
+struct vbdev_comp_adaptive {
+	bool				switch_algo;	/* switch between fast and strong algo */
+	bool				use_fast;	/* currently using the fast algorithm */
+	enum spdk_accel_comp_algo	fast_algo;
+	uint32_t			fast_level;
+	enum spdk_accel_comp_algo	strong_algo;
+	uint32_t			strong_level;
+	uint64_t			period_ticks;	/* busy ratio sampling period */
+	uint64_t			last_tsc;	/* time of the last sample */
+	uint64_t			busy_tsc;	/* thread's busy_tsc at the last sample */
+	uint64_t			idle_tsc;	/* thread's idle_tsc at the last sample */
+};
+
 /* List of virtual bdevs and associated info for each. */
 struct vbdev_compress {
 	struct spdk_bdev		*base_bdev;	/* the thing we're attaching to */
@@ -59,6 +82,7 @@ struct vbdev_compress {
 	struct spdk_thread		*thread;	/* thread where base device is opened */
 	enum spdk_accel_comp_algo       comp_algo;      /* compression algorithm for compress bdev */
 	uint32_t                        comp_level;     /* compression algorithm level */
+	struct vbdev_comp_adaptive	adaptive;	/* adaptive compression state */
 };
 static TAILQ_HEAD(, vbdev_compress) g_vbdev_comp = TAILQ_HEAD_INITIALIZER(g_vbdev_comp);
 
@@ -122,6 +146,52 @@ reduce_rw_blocks_cb(void *arg, int reduce_errno)
 	spdk_thread_exec_msg(orig_thread, _reduce_rw_blocks_cb, io_ctx);
 }
 
+/* Use the fast algorithm once the thread gets busy and go back to the strong one when it's
+ * mostly idle again.  In between, keep the current one to avoid flapping.
+ */
+static void
+_comp_adaptive_update_mode(struct vbdev_comp_adaptive *adaptive, uint64_t busy_tsc,
+			   uint64_t idle_tsc)
+{
+	uint64_t busy_pct;
+
+	if (busy_tsc + idle_tsc == 0) {
+		return;
+	}
+
+	busy_pct = busy_tsc * 100 / (busy_tsc + idle_tsc);
+	if (busy_pct >= COMP_ADAPTIVE_BUSY_HIGH) {
+		adaptive->use_fast = true;
+	} else if (busy_pct <= COMP_ADAPTIVE_BUSY_LOW) {
+		adaptive->use_fast = false;
+	}
+}
+
+static void
+_comp_adaptive_select_algo(struct vbdev_comp_adaptive *adaptive,
+			   enum spdk_accel_comp_algo *algo, uint32_t *level)
+{
+	struct spdk_thread_stats stats;
+	uint64_t now = spdk_get_ticks();
+
+	if (now - adaptive->last_tsc >= adaptive->period_ticks &&
+	    spdk_thread_get_stats(&stats) == 0) {
+		_comp_adaptive_update_mode(adaptive, stats.busy_tsc - adaptive->busy_tsc,
+					   stats.idle_tsc - adaptive->idle_tsc);
+		adaptive->last_tsc = now;
+		adaptive->busy_tsc = stats.busy_tsc;
+		adaptive->idle_tsc = stats.idle_tsc;
+	}
+
+	if (adaptive->use_fast) {
+		*algo = adaptive->fast_algo;
+		*level = adaptive->fast_level;
+	} else {
+		*algo = adaptive->strong_algo;
+		*level = adaptive->strong_level;
+	}
+}
+
 static int
 _compress_operation(struct spdk_reduce_backing_dev *backing_dev, struct iovec *src_iovs,
 		    int src_iovcnt, struct iovec *dst_iovs,
@@ -130,18 +200,27 @@ _compress_operation(struct spdk_reduce_backing_dev *backing_dev, struct iovec *s
 	struct spdk_reduce_vol_cb_args *reduce_cb_arg = cb_arg;
 	struct vbdev_compress *comp_bdev = SPDK_CONTAINEROF(backing_dev, struct vbdev_compress,
 					   backing_dev);
+	enum spdk_accel_comp_algo algo = comp_bdev->comp_algo;
+	uint32_t level = comp_bdev->comp_level;
 	int rc;
 
 	if (compress) {
 		assert(dst_iovcnt == 1);
+		if (comp_bdev->adaptive.switch_algo) {
+			_comp_adaptive_select_algo(&comp_bdev->adaptive, &algo, &level);
+		}
+		/* Tell reduce which algorithm to record for this chunk */
+		reduce_cb_arg->comp_algo = algo;
 		rc = spdk_accel_submit_compress_ext(comp_bdev->accel_channel, dst_iovs[0].iov_base,
 						    dst_iovs[0].iov_len, src_iovs, src_iovcnt,
-						    comp_bdev->comp_algo, comp_bdev->comp_level,
+						    algo, level,
 						    &reduce_cb_arg->output_size, reduce_cb_arg->cb_fn,
 						    reduce_cb_arg->cb_arg);
 	} else {
+		/* Chunks of adaptive volumes may use different algorithms */
 		rc = spdk_accel_submit_decompress_ext(comp_bdev->accel_channel, dst_iovs, dst_iovcnt,
-						      src_iovs, src_iovcnt, comp_bdev->comp_algo,
+						      src_iovs, src_iovcnt,
+						      reduce_cb_arg->comp_algo,
 						      &reduce_cb_arg->output_size, reduce_cb_arg->cb_fn,
 						      reduce_cb_arg->cb_arg);
 	}
@@ -469,6 +548,8 @@ vbdev_compress_dump_info_json(void *ctx, struct spdk_json_write_ctx *w)
 	spdk_json_write_named_string(w, "name", spdk_bdev_get_name(&comp_bdev->comp_bdev));
 	spdk_json_write_named_string(w, "base_bdev_name", spdk_bdev_get_name(comp_bdev->base_bdev));
 	spdk_json_write_named_string(w, "pm_path", spdk_reduce_vol_get_pm_path(comp_bdev->vol));
+	spdk_json_write_named_bool(w, "adaptive",
+				   comp_bdev->params.flags & SPDK_REDUCE_VOL_FLAG_ADAPTIVE);
 	spdk_json_write_object_end(w);
 
 	return 0;
@@ -790,7 +871,7 @@ _prepare_for_load_init(struct spdk_bdev_desc *bdev_desc, uint32_t lb_size, uint8
 /* Call reducelib to initialize a new volume */
 static int
 vbdev_init_reduce(const char *bdev_name, const char *pm_path, uint32_t lb_size, uint8_t comp_algo,
-		  uint32_t comp_level, bdev_compress_create_cb cb_fn, void *cb_arg)
+		  uint32_t comp_level, bool adaptive, bdev_compress_create_cb cb_fn, void *cb_arg)
 {
 	struct spdk_bdev_desc *bdev_desc = NULL;
 	struct vbdev_init_reduce_ctx *init_ctx;
@@ -821,6 +902,10 @@ vbdev_init_reduce(const char *bdev_name, const char *pm_path, uint32_t lb_size,
 		return -EINVAL;
 	}
 
+	if (adaptive) {
+		comp_bdev->params.flags |= SPDK_REDUCE_VOL_FLAG_ADAPTIVE;
+	}
+
 	init_ctx->comp_bdev = comp_bdev;
 
 	/* Save the thread where the base device is opened */
@@ -932,10 +1017,54 @@ _check_compress_bdev_comp_algo(enum spdk_accel_comp_algo algo, uint32_t comp_lev
 	return 0;
 }
 
+/* The configured algorithm and level of an adaptive volume are used as one of the settings and
+ * the other algorithm at a fast (lz4) or its strongest (deflate) level as the other one.
+ */
+static void
+_comp_adaptive_init(struct vbdev_compress *comp_bdev)
+{
+	struct vbdev_comp_adaptive *adaptive = &comp_bdev->adaptive;
+	uint32_t min_level, max_level;
+	int rc;
+
+	memset(adaptive, 0, sizeof(*adaptive));
+	if (!(comp_bdev->params.flags & SPDK_REDUCE_VOL_FLAG_ADAPTIVE)) {
+		return;
+	}
+
+	if (comp_bdev->comp_algo == SPDK_ACCEL_COMP_ALGO_DEFLATE) {
+		adaptive->strong_algo = SPDK_ACCEL_COMP_ALGO_DEFLATE;
+		adaptive->strong_level = comp_bdev->comp_level;
+		adaptive->fast_algo = SPDK_ACCEL_COMP_ALGO_LZ4;
+		rc = spdk_accel_get_compress_level_range(adaptive->fast_algo, &min_level,
+				&max_level);
+		adaptive->fast_level = spdk_max(min_level,
+						 spdk_min(max_level, COMP_ADAPTIVE_LZ4_FAST_LEVEL));
+	} else {
+		adaptive->fast_algo = comp_bdev->comp_algo;
+		adaptive->fast_level = comp_bdev->comp_level;
+		adaptive->strong_algo = SPDK_ACCEL_COMP_ALGO_DEFLATE;
+		rc = spdk_accel_get_compress_level_range(adaptive->strong_algo, &min_level,
+				&max_level);
+		adaptive->strong_level = max_level;
+	}
+
+	if (rc != 0) {
+		SPDK_NOTICELOG("%s: both lz4 and deflate are required to switch algorithms, "
+			       "only skipping compression of incompressible data\n",
+			       comp_bdev->comp_bdev.name);
+		return;
+	}
+
+	adaptive->period_ticks = spdk_get_ticks_hz() * COMP_ADAPTIVE_SAMPLE_PERIOD_US /
+				 SPDK_SEC_TO_USEC;
+	adaptive->switch_algo = true;
+}
+
 /* RPC entry point for compression vbdev creation. */
 int
 create_compress_bdev(const char *bdev_name, const char *pm_path, uint32_t lb_size,
-		     uint8_t comp_algo, uint32_t comp_level,
+		     uint8_t comp_algo, uint32_t comp_level, bool adaptive,
 		     bdev_compress_create_cb cb_fn, void *cb_arg)
 {
 	struct vbdev_compress *comp_bdev = NULL;
@@ -968,7 +1097,8 @@ create_compress_bdev(const char *bdev_name, const char *pm_path, uint32_t lb_siz
 			return -EBUSY;
 		}
 	}
-	return vbdev_init_reduce(bdev_name, pm_path, lb_size, comp_algo, comp_level, cb_fn, cb_arg);
+	return vbdev_init_reduce(bdev_name, pm_path, lb_size, comp_algo, comp_level, adaptive,
+				 cb_fn, cb_arg);
 }
 
 static int
@@ -1046,6 +1176,8 @@ vbdev_compress_claim(struct vbdev_compress *comp_bdev)
 		return -EINVAL;
 	}
 
+	_comp_adaptive_init(comp_bdev);
+
 	/* Note: some of the fields below will change in the future - for example,
 	 * blockcnt specifically will not match (the compressed volume size will
 	 * be slightly less than the base bdev size)
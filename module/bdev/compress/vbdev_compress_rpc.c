@@ -78,6 +78,7 @@ struct rpc_construct_compress {
 	uint32_t lb_size;
 	enum spdk_accel_comp_algo comp_algo;
 	uint32_t comp_level;
+	bool adaptive;
 };
 
 static int
@@ -133,6 +134,7 @@ static const struct spdk_json_object_decoder rpc_construct_compress_decoders[] =
 	{"lb_size", offsetof(struct rpc_construct_compress, lb_size), spdk_json_decode_uint32, true},
 	{"comp_algo", offsetof(struct rpc_construct_compress, comp_algo), rpc_decode_comp_algo, true},
 	{"comp_level", offsetof(struct rpc_construct_compress, comp_level), spdk_json_decode_uint32, true},
+	{"adaptive", offsetof(struct rpc_construct_compress, adaptive), spdk_json_decode_bool, true},
 };
 
 static void
@@ -188,7 +190,7 @@ rpc_bdev_compress_create(struct spdk_jsonrpc_request *request,
 	}
 
 	rc = create_compress_bdev(req->base_bdev_name, req->pm_path, req->lb_size, req->comp_algo,
-				  req->comp_level, rpc_bdev_compress_create_cb, ctx);
+				  req->comp_level, req->adaptive, rpc_bdev_compress_create_cb, ctx);
 	if (rc != 0) {
 		if (rc == -EBUSY) {
 			spdk_jsonrpc_send_error_response(request, rc, "Base bdev already in use for compression.");
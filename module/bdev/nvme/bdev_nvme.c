@@ -16,6 +16,7 @@
 #include "spdk/json.h"
 #include "spdk/keyring.h"
 #include "spdk/likely.h"
+#include "spdk/notify.h"
 #include "spdk/nvme.h"
 #include "spdk/nvme_ocssd.h"
 #include "spdk/nvme_zns.h"
@@ -110,6 +111,11 @@ struct nvme_probe_skip_entry {
 static TAILQ_HEAD(, nvme_probe_skip_entry) g_skipped_nvme_ctrlrs = TAILQ_HEAD_INITIALIZER(
 			g_skipped_nvme_ctrlrs);
 
+/* Attaches waiting for one of the ctrlr_attach_concurrency attaches in progress to finish. */
+static TAILQ_HEAD(, nvme_async_probe_ctx) g_pending_probe_ctxs = TAILQ_HEAD_INITIALIZER(
+			g_pending_probe_ctxs);
+static uint32_t g_num_probe_ctxs_in_progress;
+
 #define BDEV_NVME_DEFAULT_DIGESTS (SPDK_BIT(SPDK_NVMF_DHCHAP_HASH_SHA256) | \
 				   SPDK_BIT(SPDK_NVMF_DHCHAP_HASH_SHA384) | \
 				   SPDK_BIT(SPDK_NVMF_DHCHAP_HASH_SHA512))
@@ -148,8 +154,18 @@ static struct spdk_bdev_nvme_opts g_opts = {
 	.allow_accel_sequence = false,
 	.dhchap_digests = BDEV_NVME_DEFAULT_DIGESTS,
 	.dhchap_dhgroups = BDEV_NVME_DEFAULT_DHGROUPS,
+	.slow_io_path_factor = 0,
+	.slow_io_path_check_period_ms = 1000,
+	.ctrlr_attach_concurrency = 0,
 };
 
+/* Coarse buckets are enough to compare io_paths and keep the per io_path histogram small. */
+#define SLOW_IO_PATH_HISTOGRAM_BUCKET_SHIFT		3
+/* The minimum number of I/Os an io_path has to complete in a check period to be judged. */
+#define SLOW_IO_PATH_MIN_IOS				64
+/* A degraded io_path which gets no I/O is tried again after this many check periods. */
+#define SLOW_IO_PATH_PROBE_PERIODS			10
+
 #define NVME_HOTPLUG_POLL_PERIOD_MAX			10000000ULL
 #define NVME_HOTPLUG_POLL_PERIOD_DEFAULT		100000ULL
 
@@ -770,16 +786,212 @@ nvme_io_path_alloc(void)
 		spdk_bdev_reset_io_stat(io_path->stat, SPDK_BDEV_RESET_STAT_MAXMIN);
 	}
 
+	if (g_opts.slow_io_path_factor != 0) {
+		io_path->latency = spdk_histogram_data_alloc_sized(SLOW_IO_PATH_HISTOGRAM_BUCKET_SHIFT);
+		if (io_path->latency == NULL) {
+			free(io_path->stat);
+			free(io_path);
+			SPDK_ERRLOG("Failed to alloc io_path latency histogram.\n");
+			return NULL;
+		}
+	}
+
 	return io_path;
 }
 
 static void
 nvme_io_path_free(struct nvme_io_path *io_path)
 {
+	spdk_histogram_data_free(io_path->latency);
 	free(io_path->stat);
 	free(io_path);
 }
 
+static void
+nvme_io_path_p99_cb(void *ctx, uint64_t start, uint64_t end, uint64_t count,
+		    uint64_t total, uint64_t so_far)
+{
+	uint64_t *p99 = ctx;
+
+	if (*p99 == 0 && count != 0 && so_far * 100 >= total * 99) {
+		*p99 = end;
+	}
+}
+
+static void
+nvme_ns_set_degraded(struct nvme_ns *nvme_ns, bool degraded)
+{
+	struct nvme_bdev *nbdev = nvme_ns->bdev;
+	struct nvme_ctrlr *nvme_ctrlr = nvme_ns->ctrlr;
+	const struct spdk_nvme_transport_id *trid = &nvme_ctrlr->active_path_id->trid;
+	const char *trtype_str;
+	char ctx[SPDK_NOTIFY_MAX_CTX_SIZE];
+
+	nvme_ns->degraded = degraded;
+	nvme_ns->degraded_periods = 0;
+
+	/* Let the next I/O of each nvme_bdev_channel select an io_path again. */
+	nbdev->slow_io_path_gen++;
+
+	trtype_str = spdk_nvme_transport_id_trtype_str(trid->trtype);
+	if (trtype_str == NULL) {
+		trtype_str = trid->trstring;
+	}
+
+	/* Identify the path by its bdev, its controller and its transport ID. */
+	snprintf(ctx, sizeof(ctx), "%s %s trtype:%s traddr:%s trsvcid:%s", nbdev->disk.name,
+		 nvme_ctrlr->nbdev_ctrlr->name, trtype_str, trid->traddr, trid->trsvcid);
+
+	if (degraded) {
+		SPDK_NOTICELOG("io_path %s is degraded, p99 latency %" PRIu64 " us\n", ctx,
+			       nvme_ns->p99_latency_ticks * SPDK_SEC_TO_USEC / spdk_get_ticks_hz());
+		spdk_notify_send("bdev_nvme_io_path_degraded", ctx);
+	} else {
+		SPDK_NOTICELOG("io_path %s is no longer degraded\n", ctx);
+		spdk_notify_send("bdev_nvme_io_path_restored", ctx);
+	}
+}
+
+/* Compare the p99 latency of each nvme_ns of the bdev against the best of its peers over
+ * the last check period and mark the nvme_ns that are too slow as degraded, so that I/Os
+ * are steered to other io_paths as long as any is available.
+ *
+ * The caller must hold the mutex of the bdev.
+ */
+static void
+nvme_bdev_check_slow_io_paths(struct nvme_bdev *nbdev)
+{
+	struct nvme_ns *nvme_ns, *fastest = NULL;
+	uint64_t min_p99 = UINT64_MAX, second_min_p99 = UINT64_MAX, peer_p99, p99;
+	bool slow;
+
+	TAILQ_FOREACH(nvme_ns, &nbdev->nvme_ns_list, tailq) {
+		if (nvme_ns->latency == NULL) {
+			continue;
+		}
+
+		p99 = 0;
+		if (nvme_ns->latency_ios >= SLOW_IO_PATH_MIN_IOS) {
+			spdk_histogram_data_iterate(nvme_ns->latency, nvme_io_path_p99_cb, &p99);
+		}
+		nvme_ns->p99_latency_ticks = p99;
+
+		if (p99 == 0) {
+			continue;
+		}
+
+		if (p99 < min_p99) {
+			second_min_p99 = min_p99;
+			min_p99 = p99;
+			fastest = nvme_ns;
+		} else if (p99 < second_min_p99) {
+			second_min_p99 = p99;
+		}
+	}
+
+	TAILQ_FOREACH(nvme_ns, &nbdev->nvme_ns_list, tailq) {
+		if (nvme_ns->latency == NULL) {
+			continue;
+		}
+
+		spdk_histogram_data_reset(nvme_ns->latency);
+		nvme_ns->latency_ios = 0;
+
+		if (nvme_ns->p99_latency_ticks == 0) {
+			/* Not enough I/O to judge this path. This is expected for a degraded
+			 * path, so give it a chance again after a while.
+			 */
+			if (nvme_ns->degraded &&
+			    ++nvme_ns->degraded_periods >= SLOW_IO_PATH_PROBE_PERIODS) {
+				nvme_ns_set_degraded(nvme_ns, false);
+			}
+			continue;
+		}
+
+		peer_p99 = nvme_ns == fastest ? second_min_p99 : min_p99;
+		if (peer_p99 == UINT64_MAX) {
+			/* There is no peer to compare with. */
+			slow = false;
+		} else {
+			slow = nvme_ns->p99_latency_ticks > peer_p99 * g_opts.slow_io_path_factor;
+		}
+
+		if (slow != nvme_ns->degraded) {
+			nvme_ns_set_degraded(nvme_ns, slow);
+		}
+	}
+}
+
+/* Each nvme_bdev_channel which has more than one io_path merges the latencies of its
+ * io_paths into their nvme_ns periodically. The first channel which finds the check period
+ * of the bdev elapsed judges all its nvme_ns, so that each path is judged and notified
+ * once regardless of the number of channels.
+ */
+static int
+bdev_nvme_check_slow_io_paths(void *arg)
+{
+	struct nvme_bdev_channel *nbdev_ch = arg;
+	struct nvme_bdev *nbdev;
+	struct nvme_io_path *io_path;
+	struct nvme_ns *nvme_ns;
+	uint64_t now;
+	bool changed = false;
+
+	nbdev = spdk_io_channel_get_io_device(spdk_io_channel_from_ctx(nbdev_ch));
+	now = spdk_get_ticks();
+
+	pthread_mutex_lock(&nbdev->mutex);
+
+	STAILQ_FOREACH(io_path, &nbdev_ch->io_path_list, stailq) {
+		nvme_ns = io_path->nvme_ns;
+		if (io_path->latency_ios == 0 || nvme_ns->latency == NULL) {
+			continue;
+		}
+
+		spdk_histogram_data_merge(nvme_ns->latency, io_path->latency);
+		nvme_ns->latency_ios += io_path->latency_ios;
+		spdk_histogram_data_reset(io_path->latency);
+		io_path->latency_ios = 0;
+	}
+
+	if (now >= nbdev->slow_io_path_check_tsc) {
+		/* Nothing has been collected yet when the first channel starts checking. */
+		if (nbdev->slow_io_path_check_tsc != 0) {
+			nvme_bdev_check_slow_io_paths(nbdev);
+		}
+		nbdev->slow_io_path_check_tsc = now + g_opts.slow_io_path_check_period_ms *
+						spdk_get_ticks_hz() / SPDK_SEC_TO_MSEC;
+	}
+
+	if (nbdev_ch->slow_io_path_gen != nbdev->slow_io_path_gen) {
+		nbdev_ch->slow_io_path_gen = nbdev->slow_io_path_gen;
+		bdev_nvme_clear_current_io_path(nbdev_ch);
+		changed = true;
+	}
+
+	pthread_mutex_unlock(&nbdev->mutex);
+
+	return changed ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
+}
+
+static void
+bdev_nvme_start_slow_io_path_poller(struct nvme_bdev_channel *nbdev_ch)
+{
+	struct nvme_io_path *io_path;
+
+	/* Drop the latencies collected while the channel had a single io_path. */
+	STAILQ_FOREACH(io_path, &nbdev_ch->io_path_list, stailq) {
+		spdk_histogram_data_reset(io_path->latency);
+		io_path->latency_ios = 0;
+	}
+
+	nbdev_ch->slow_io_path_poller = SPDK_POLLER_REGISTER(bdev_nvme_check_slow_io_paths,
+					nbdev_ch, g_opts.slow_io_path_check_period_ms * 1000ULL);
+	if (nbdev_ch->slow_io_path_poller == NULL) {
+		SPDK_ERRLOG("Failed to register slow io_path poller.\n");
+	}
+}
+
 static int
 _bdev_nvme_add_io_path(struct nvme_bdev_channel *nbdev_ch, struct nvme_ns *nvme_ns)
 {
@@ -815,6 +1027,12 @@ _bdev_nvme_add_io_path(struct nvme_bdev_channel *nbdev_ch, struct nvme_ns *nvme_
 
 	bdev_nvme_clear_current_io_path(nbdev_ch);
 
+	/* A slow io_path can be avoided only if there is another one. */
+	if (io_path->latency != NULL && nbdev_ch->slow_io_path_poller == NULL &&
+	    STAILQ_FIRST(&nbdev_ch->io_path_list) != io_path) {
+		bdev_nvme_start_slow_io_path_poller(nbdev_ch);
+	}
+
 	return 0;
 }
 
@@ -854,6 +1072,11 @@ _bdev_nvme_delete_io_path(struct nvme_bdev_channel *nbdev_ch, struct nvme_io_pat
 	STAILQ_REMOVE(&nbdev_ch->io_path_list, io_path, nvme_io_path, stailq);
 	io_path->nbdev_ch = NULL;
 
+	if (STAILQ_EMPTY(&nbdev_ch->io_path_list) ||
+	    STAILQ_NEXT(STAILQ_FIRST(&nbdev_ch->io_path_list), stailq) == NULL) {
+		spdk_poller_unregister(&nbdev_ch->slow_io_path_poller);
+	}
+
 	nvme_qpair = io_path->qpair;
 	assert(nvme_qpair != NULL);
 
@@ -1093,13 +1316,22 @@ nvme_io_path_get_next(struct nvme_bdev_channel *nbdev_ch, struct nvme_io_path *p
 static struct nvme_io_path *
 _bdev_nvme_find_io_path(struct nvme_bdev_channel *nbdev_ch)
 {
-	struct nvme_io_path *io_path, *start, *non_optimized = NULL;
+	struct nvme_io_path *io_path, *start, *non_optimized = NULL, *degraded = NULL;
 
 	start = nvme_io_path_get_next(nbdev_ch, nbdev_ch->current_io_path);
 
 	io_path = start;
 	do {
 		if (spdk_likely(nvme_io_path_is_available(io_path))) {
+			if (spdk_unlikely(io_path->nvme_ns->degraded)) {
+				/* Use a degraded io_path only if there is no other choice. */
+				if (degraded == NULL) {
+					degraded = io_path;
+				}
+				io_path = nvme_io_path_get_next(nbdev_ch, io_path);
+				continue;
+			}
+
 			switch (io_path->nvme_ns->ana_state) {
 			case SPDK_NVME_ANA_OPTIMIZED_STATE:
 				nbdev_ch->current_io_path = io_path;
@@ -1117,6 +1349,10 @@ _bdev_nvme_find_io_path(struct nvme_bdev_channel *nbdev_ch)
 		io_path = nvme_io_path_get_next(nbdev_ch, io_path);
 	} while (io_path != start);
 
+	if (non_optimized == NULL) {
+		non_optimized = degraded;
+	}
+
 	if (nbdev_ch->mp_policy == BDEV_NVME_MP_POLICY_ACTIVE_ACTIVE) {
 		/* We come here only if there is no optimized path. Cache even non_optimized
 		 * path for load balance across multiple non_optimized paths.
@@ -1131,8 +1367,8 @@ static struct nvme_io_path *
 _bdev_nvme_find_io_path_min_qd(struct nvme_bdev_channel *nbdev_ch)
 {
 	struct nvme_io_path *io_path;
-	struct nvme_io_path *optimized = NULL, *non_optimized = NULL;
-	uint32_t opt_min_qd = UINT32_MAX, non_opt_min_qd = UINT32_MAX;
+	struct nvme_io_path *optimized = NULL, *non_optimized = NULL, *degraded = NULL;
+	uint32_t opt_min_qd = UINT32_MAX, non_opt_min_qd = UINT32_MAX, degraded_min_qd = UINT32_MAX;
 	uint32_t num_outstanding_reqs;
 
 	STAILQ_FOREACH(io_path, &nbdev_ch->io_path_list, stailq) {
@@ -1146,6 +1382,16 @@ _bdev_nvme_find_io_path_min_qd(struct nvme_bdev_channel *nbdev_ch)
 		}
 
 		num_outstanding_reqs = spdk_nvme_qpair_get_num_outstanding_reqs(io_path->qpair->qpair);
+		if (spdk_unlikely(io_path->nvme_ns->degraded)) {
+			/* Use a degraded io_path only if there is no other choice. */
+			if (nvme_ns_is_accessible(io_path->nvme_ns) &&
+			    num_outstanding_reqs < degraded_min_qd) {
+				degraded_min_qd = num_outstanding_reqs;
+				degraded = io_path;
+			}
+			continue;
+		}
+
 		switch (io_path->nvme_ns->ana_state) {
 		case SPDK_NVME_ANA_OPTIMIZED_STATE:
 			if (num_outstanding_reqs < opt_min_qd) {
@@ -1169,7 +1415,11 @@ _bdev_nvme_find_io_path_min_qd(struct nvme_bdev_channel *nbdev_ch)
 		return optimized;
 	}
 
-	return non_optimized;
+	if (non_optimized != NULL) {
+		return non_optimized;
+	}
+
+	return degraded;
 }
 
 static inline struct nvme_io_path *
@@ -1363,6 +1613,27 @@ bdev_nvme_update_nvme_error_stat(struct spdk_bdev_io *bdev_io, const struct spdk
 	pthread_mutex_unlock(&nbdev->mutex);
 }
 
+static inline void
+bdev_nvme_update_io_path_latency(struct nvme_bdev_io *bio)
+{
+	struct spdk_bdev_io *bdev_io = spdk_bdev_io_from_ctx(bio);
+	struct nvme_io_path *io_path = bio->io_path;
+
+	if (spdk_likely(io_path->latency == NULL)) {
+		return;
+	}
+
+	switch (bdev_io->type) {
+	case SPDK_BDEV_IO_TYPE_READ:
+	case SPDK_BDEV_IO_TYPE_WRITE:
+		spdk_histogram_data_tally(io_path->latency, spdk_get_ticks() - bio->submit_tsc);
+		io_path->latency_ios++;
+		break;
+	default:
+		break;
+	}
+}
+
 static inline void
 bdev_nvme_update_io_path_stat(struct nvme_bdev_io *bio)
 {
@@ -1508,6 +1779,7 @@ bdev_nvme_io_complete_nvme_status(struct nvme_bdev_io *bio,
 
 	if (spdk_likely(spdk_nvme_cpl_is_success(cpl))) {
 		bdev_nvme_update_io_path_stat(bio);
+		bdev_nvme_update_io_path_latency(bio);
 		goto complete;
 	}
 
@@ -4624,12 +4896,23 @@ nvme_ns_alloc(void)
 		spdk_bdev_reset_io_stat(nvme_ns->stat, SPDK_BDEV_RESET_STAT_MAXMIN);
 	}
 
+	if (g_opts.slow_io_path_factor != 0) {
+		nvme_ns->latency = spdk_histogram_data_alloc_sized(
+					   SLOW_IO_PATH_HISTOGRAM_BUCKET_SHIFT);
+		if (nvme_ns->latency == NULL) {
+			free(nvme_ns->stat);
+			free(nvme_ns);
+			return NULL;
+		}
+	}
+
 	return nvme_ns;
 }
 
 static void
 nvme_ns_free(struct nvme_ns *nvme_ns)
 {
+	spdk_histogram_data_free(nvme_ns->latency);
 	free(nvme_ns->stat);
 	free(nvme_ns);
 }
@@ -4841,6 +5124,11 @@ nvme_ctrlr_depopulate_namespace(struct nvme_ctrlr *nvme_ctrlr, struct nvme_ns *n
 			TAILQ_REMOVE(&bdev->nvme_ns_list, nvme_ns, tailq);
 			nvme_ns->bdev = NULL;
 
+			/* The last path is not compared with any other path anymore. */
+			if (bdev->ref == 1 && TAILQ_FIRST(&bdev->nvme_ns_list)->degraded) {
+				nvme_ns_set_degraded(TAILQ_FIRST(&bdev->nvme_ns_list), false);
+			}
+
 			pthread_mutex_unlock(&bdev->mutex);
 
 			/* Delete nvme_io_paths from nvme_bdev_channels dynamically. After that,
@@ -5926,6 +6214,16 @@ bdev_nvme_validate_opts(const struct spdk_bdev_nvme_opts *opts)
 		return -EINVAL;
 	}
 
+	if (opts->slow_io_path_factor == 1) {
+		SPDK_WARNLOG("Invalid option: slow_io_path_factor has to be 0 or at least 2.\n");
+		return -EINVAL;
+	}
+
+	if (opts->slow_io_path_factor != 0 && opts->slow_io_path_check_period_ms == 0) {
+		SPDK_WARNLOG("Invalid option: slow_io_path_check_period_ms can't be 0.\n");
+		return -EINVAL;
+	}
+
 	return 0;
 }
 
@@ -6260,6 +6558,8 @@ connect_set_failover_cb(void *cb_ctx, const struct spdk_nvme_transport_id *trid,
 	populate_namespaces_cb(ctx, rc);
 }
 
+static void bdev_nvme_start_pending_probes(void);
+
 static int
 bdev_nvme_async_poll(void *arg)
 {
@@ -6270,6 +6570,8 @@ bdev_nvme_async_poll(void *arg)
 	if (spdk_unlikely(rc != -EAGAIN)) {
 		ctx->probe_done = true;
 		spdk_poller_unregister(&ctx->poller);
+		assert(g_num_probe_ctxs_in_progress > 0);
+		g_num_probe_ctxs_in_progress--;
 		if (!ctx->ctrlr_attached) {
 			/* The probe is done, but no controller was attached.
 			 * That means we had a failure, so report -EIO back to
@@ -6285,11 +6587,74 @@ bdev_nvme_async_poll(void *arg)
 			 */
 			free_nvme_async_probe_ctx(ctx);
 		}
+
+		bdev_nvme_start_pending_probes();
 	}
 
 	return SPDK_POLLER_BUSY;
 }
 
+static int
+bdev_nvme_start_probe(struct nvme_async_probe_ctx *ctx)
+{
+	ctx->probe_ctx = spdk_nvme_connect_async(&ctx->trid, &ctx->drv_opts, ctx->attach_cb);
+	if (ctx->probe_ctx == NULL) {
+		SPDK_ERRLOG("No controller was found with provided trid (traddr: %s)\n", ctx->trid.traddr);
+		return -ENODEV;
+	}
+	ctx->poller = SPDK_POLLER_REGISTER(bdev_nvme_async_poll, ctx, 1000);
+	g_num_probe_ctxs_in_progress++;
+
+	return 0;
+}
+
+static inline bool
+bdev_nvme_probe_can_start(void)
+{
+	return g_opts.ctrlr_attach_concurrency == 0 ||
+	       g_num_probe_ctxs_in_progress < g_opts.ctrlr_attach_concurrency;
+}
+
+static void
+bdev_nvme_start_pending_probes(void)
+{
+	struct nvme_async_probe_ctx *ctx;
+	int rc;
+
+	while (!TAILQ_EMPTY(&g_pending_probe_ctxs) && bdev_nvme_probe_can_start()) {
+		ctx = TAILQ_FIRST(&g_pending_probe_ctxs);
+		TAILQ_REMOVE(&g_pending_probe_ctxs, ctx, tailq);
+
+		/* The same controller may have been attached while this attach was queued. */
+		if (nvme_ctrlr_get(&ctx->trid, ctx->drv_opts.hostnqn) != NULL) {
+			SPDK_ERRLOG("A controller with the provided trid (traddr: %s, hostnqn: %s) "
+				    "already exists.\n", ctx->trid.traddr, ctx->drv_opts.hostnqn);
+			rc = -EEXIST;
+		} else {
+			rc = bdev_nvme_start_probe(ctx);
+		}
+
+		if (rc != 0) {
+			ctx->probe_done = true;
+			ctx->reported_bdevs = 0;
+			populate_namespaces_cb(ctx, rc);
+		}
+	}
+}
+
+static void
+bdev_nvme_cancel_pending_probes(void)
+{
+	struct nvme_async_probe_ctx *ctx, *tmp;
+
+	TAILQ_FOREACH_SAFE(ctx, &g_pending_probe_ctxs, tailq, tmp) {
+		TAILQ_REMOVE(&g_pending_probe_ctxs, ctx, tailq);
+		ctx->probe_done = true;
+		ctx->reported_bdevs = 0;
+		populate_namespaces_cb(ctx, -ECANCELED);
+	}
+}
+
 static bool
 bdev_nvme_check_io_error_resiliency_params(int32_t ctrlr_loss_timeout_sec,
 		uint32_t reconnect_delay_sec,
@@ -6344,8 +6709,7 @@ spdk_bdev_nvme_create(struct spdk_nvme_transport_id *trid,
 {
 	struct nvme_probe_skip_entry *entry, *tmp;
 	struct nvme_async_probe_ctx *ctx;
-	spdk_nvme_attach_cb attach_cb;
-	int len;
+	int len, rc;
 
 	/* TODO expand this check to include both the host and target TRIDs.
 	 * Only if both are the same should we fail.
@@ -6437,18 +6801,24 @@ spdk_bdev_nvme_create(struct spdk_nvme_transport_id *trid,
 	}
 
 	if (nvme_bdev_ctrlr_get_by_name(base_name) == NULL || multipath) {
-		attach_cb = connect_attach_cb;
+		ctx->attach_cb = connect_attach_cb;
 	} else {
-		attach_cb = connect_set_failover_cb;
+		ctx->attach_cb = connect_set_failover_cb;
 	}
 
-	ctx->probe_ctx = spdk_nvme_connect_async(trid, &ctx->drv_opts, attach_cb);
-	if (ctx->probe_ctx == NULL) {
-		SPDK_ERRLOG("No controller was found with provided trid (traddr: %s)\n", trid->traddr);
+	if (!bdev_nvme_probe_can_start()) {
+		/* Too many controllers are being attached at the moment. The attach is started
+		 * as soon as one of them finished connecting and initializing.
+		 */
+		TAILQ_INSERT_TAIL(&g_pending_probe_ctxs, ctx, tailq);
+		return 0;
+	}
+
+	rc = bdev_nvme_start_probe(ctx);
+	if (rc != 0) {
 		free_nvme_async_probe_ctx(ctx);
-		return -ENODEV;
+		return rc;
 	}
-	ctx->poller = SPDK_POLLER_REGISTER(bdev_nvme_async_poll, ctx, 1000);
 
 	return 0;
 }
@@ -7398,6 +7768,9 @@ bdev_nvme_library_init(void)
 				bdev_nvme_destroy_poll_group_cb,
 				sizeof(struct nvme_poll_group),  "nvme_poll_groups");
 
+	spdk_notify_type_register("bdev_nvme_io_path_degraded");
+	spdk_notify_type_register("bdev_nvme_io_path_restored");
+
 	return 0;
 }
 
@@ -7455,6 +7828,8 @@ bdev_nvme_library_fini(void)
 	free(g_hotplug_probe_ctx);
 	g_hotplug_probe_ctx = NULL;
 
+	bdev_nvme_cancel_pending_probes();
+
 	TAILQ_FOREACH_SAFE(entry, &g_skipped_nvme_ctrlrs, tailq, entry_tmp) {
 		TAILQ_REMOVE(&g_skipped_nvme_ctrlrs, entry, tailq);
 		free(entry);
@@ -8521,6 +8896,10 @@ bdev_nvme_opts_config_json(struct spdk_json_write_ctx *w)
 	spdk_json_write_named_bool(w, "allow_accel_sequence", g_opts.allow_accel_sequence);
 	spdk_json_write_named_uint32(w, "rdma_max_cq_size", g_opts.rdma_max_cq_size);
 	spdk_json_write_named_uint16(w, "rdma_cm_event_timeout_ms", g_opts.rdma_cm_event_timeout_ms);
+	spdk_json_write_named_uint32(w, "slow_io_path_factor", g_opts.slow_io_path_factor);
+	spdk_json_write_named_uint32(w, "slow_io_path_check_period_ms",
+				     g_opts.slow_io_path_check_period_ms);
+	spdk_json_write_named_uint32(w, "ctrlr_attach_concurrency", g_opts.ctrlr_attach_concurrency);
 	spdk_json_write_named_array_begin(w, "dhchap_digests");
 	for (i = 0; i < 32; ++i) {
 		if (g_opts.dhchap_digests & SPDK_BIT(i)) {
@@ -9022,6 +9401,11 @@ nvme_io_path_info_json(struct spdk_json_write_ctx *w, struct nvme_io_path *io_pa
 	spdk_json_write_named_bool(w, "current", nvme_io_path_is_current(io_path));
 	spdk_json_write_named_bool(w, "connected", nvme_qpair_is_connected(io_path->qpair));
 	spdk_json_write_named_bool(w, "accessible", nvme_ns_is_accessible(nvme_ns));
+	spdk_json_write_named_bool(w, "degraded", nvme_ns->degraded);
+	if (nvme_ns->latency != NULL) {
+		spdk_json_write_named_uint64(w, "p99_latency_us", nvme_ns->p99_latency_ticks *
+					     SPDK_SEC_TO_USEC / spdk_get_ticks_hz());
+	}
 
 	spdk_json_write_named_object_begin(w, "transport");
 	spdk_json_write_named_string(w, "trtype", trid->trstring);
@@ -15,6 +15,7 @@
 #include "spdk/bdev_module.h"
 #include "spdk/module/bdev/nvme.h"
 #include "spdk/jsonrpc.h"
+#include "spdk/histogram_data.h"
 
 TAILQ_HEAD(nvme_bdev_ctrlrs, nvme_bdev_ctrlr);
 extern struct nvme_bdev_ctrlrs g_nvme_bdev_ctrlrs;
@@ -39,10 +40,12 @@ struct nvme_async_probe_ctx {
 	struct spdk_nvme_ctrlr_opts drv_opts;
 	spdk_bdev_nvme_create_cb cb_fn;
 	void *cb_ctx;
+	spdk_nvme_attach_cb attach_cb;
 	uint32_t populates_in_progress;
 	bool ctrlr_attached;
 	bool probe_done;
 	bool namespaces_populated;
+	TAILQ_ENTRY(nvme_async_probe_ctx) tailq;
 };
 
 struct nvme_ns {
@@ -65,6 +68,18 @@ struct nvme_ns {
 	 * bdev_nvme_set_options
 	 */
 	struct spdk_bdev_io_stat	*stat;
+
+	/* allocation of latency is decided by option slow_io_path_factor of RPC
+	 * bdev_nvme_set_options. It merges the read/write latencies of all io_paths to this
+	 * nvme_ns during the current check period and is protected by the mutex of the bdev.
+	 */
+	struct spdk_histogram_data	*latency;
+	uint64_t			latency_ios;
+	/* p99 latency measured during the last check period, 0 if not enough I/O was seen */
+	uint64_t			p99_latency_ticks;
+	uint32_t			degraded_periods;
+	/* The path is much slower than its peers and is used only if no other is available. */
+	bool				degraded;
 };
 
 struct nvme_bdev_io;
@@ -168,6 +183,9 @@ struct nvme_bdev {
 	bool					opal;
 	TAILQ_ENTRY(nvme_bdev)			tailq;
 	struct nvme_error_stat			*err_stat;
+	uint64_t				slow_io_path_check_tsc;
+	/* Incremented whenever an nvme_ns of this bdev becomes degraded or is restored. */
+	uint64_t				slow_io_path_gen;
 };
 
 struct nvme_qpair {
@@ -201,6 +219,13 @@ struct nvme_io_path {
 
 	/* allocation of stat is decided by option io_path_stat of RPC bdev_nvme_set_options */
 	struct spdk_bdev_io_stat	*stat;
+
+	/* allocation of latency is decided by option slow_io_path_factor of RPC
+	 * bdev_nvme_set_options. It collects read/write latencies of this channel until
+	 * they are merged into the nvme_ns.
+	 */
+	struct spdk_histogram_data	*latency;
+	uint64_t			latency_ios;
 };
 
 struct nvme_bdev_channel {
@@ -212,6 +237,8 @@ struct nvme_bdev_channel {
 	STAILQ_HEAD(, nvme_io_path)		io_path_list;
 	TAILQ_HEAD(retry_io_head, nvme_bdev_io)	retry_io_list;
 	struct spdk_poller			*retry_io_poller;
+	struct spdk_poller			*slow_io_path_poller;
+	uint64_t				slow_io_path_gen;
 	bool					resetting;
 };
 
@@ -318,6 +345,15 @@ struct spdk_bdev_nvme_opts {
 	uint16_t rdma_cm_event_timeout_ms;
 	uint32_t dhchap_digests;
 	uint32_t dhchap_dhgroups;
+	/* An io_path is degraded if its p99 latency exceeds that of its peers by this factor.
+	 * 0 disables slow io_path detection.
+	 */
+	uint32_t slow_io_path_factor;
+	uint32_t slow_io_path_check_period_ms;
+	/* The maximum number of controllers which are connected and initialized at the same time.
+	 * 0 means unlimited.
+	 */
+	uint32_t ctrlr_attach_concurrency;
 };
 
 struct spdk_nvme_qpair *bdev_nvme_get_io_qpair(struct spdk_io_channel *ctrlr_io_ch);
@@ -138,6 +138,9 @@ static const struct spdk_json_object_decoder rpc_bdev_nvme_options_decoders[] =
 	{"rdma_cm_event_timeout_ms", offsetof(struct spdk_bdev_nvme_opts, rdma_cm_event_timeout_ms), spdk_json_decode_uint16, true},
 	{"dhchap_digests", offsetof(struct spdk_bdev_nvme_opts, dhchap_digests), rpc_decode_digest_array, true},
 	{"dhchap_dhgroups", offsetof(struct spdk_bdev_nvme_opts, dhchap_dhgroups), rpc_decode_dhgroup_array, true},
+	{"slow_io_path_factor", offsetof(struct spdk_bdev_nvme_opts, slow_io_path_factor), spdk_json_decode_uint32, true},
+	{"slow_io_path_check_period_ms", offsetof(struct spdk_bdev_nvme_opts, slow_io_path_check_period_ms), spdk_json_decode_uint32, true},
+	{"ctrlr_attach_concurrency", offsetof(struct spdk_bdev_nvme_opts, ctrlr_attach_concurrency), spdk_json_decode_uint32, true},
 };
 
 static void
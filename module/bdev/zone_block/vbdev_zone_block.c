@@ -476,7 +476,7 @@ zone_block_read(struct bdev_zone_block *bdev_node, struct zone_block_io_channel
 }
 
 static void
-zone_block_submit_request(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_io)
+_zone_block_submit_request(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_io)
 {
 	struct bdev_zone_block *bdev_node = SPDK_CONTAINEROF(bdev_io->bdev, struct bdev_zone_block, bdev);
 	struct zone_block_io_channel *dev_ch = spdk_io_channel_get_ctx(ch);
@@ -513,6 +513,32 @@ zone_block_submit_request(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_
 	}
 }
 
+static void
+zone_block_get_buf_cb(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_io, bool success)
+{
+	if (!success) {
+		spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_FAILED);
+		return;
+	}
+
+	_zone_block_submit_request(ch, bdev_io);
+}
+
+static void
+zone_block_submit_request(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_io)
+{
+	/* Reads without a buffer must get one from the bdev layer rather than from the base
+	 * bdev, whose buffer would be released as soon as the base I/O completes.
+	 */
+	if (bdev_io->type == SPDK_BDEV_IO_TYPE_READ && bdev_io->u.bdev.iovs[0].iov_base == NULL) {
+		spdk_bdev_io_get_buf(bdev_io, zone_block_get_buf_cb,
+				     bdev_io->u.bdev.num_blocks * bdev_io->bdev->blocklen);
+		return;
+	}
+
+	_zone_block_submit_request(ch, bdev_io);
+}
+
 static bool
 zone_block_io_type_supported(void *ctx, enum spdk_bdev_io_type io_type)
 {
@@ -505,9 +505,10 @@ blob_bdev_init(struct blob_bdev *b, struct spdk_bdev_desc *desc)
 	b->bs_dev.writev_ext = bdev_blob_writev_ext;
 	b->bs_dev.write_zeroes = bdev_blob_write_zeroes;
 	b->bs_dev.unmap = bdev_blob_unmap;
-	if (spdk_bdev_io_type_supported(bdev, SPDK_BDEV_IO_TYPE_COPY)) {
-		b->bs_dev.copy = bdev_blob_copy;
-	}
+	/* Copy is always exposed: if the bdev doesn't support it natively, the bdev layer
+	 * emulates it with reads and writes split into iobuf-sized chunks, which is still
+	 * cheaper for cluster copy-on-write than allocating a DMA buffer for a whole cluster. */
+	b->bs_dev.copy = bdev_blob_copy;
 	b->bs_dev.get_base_bdev = bdev_blob_get_base_bdev;
 	b->bs_dev.is_zeroes = bdev_blob_is_zeroes;
 	b->bs_dev.is_range_valid = bdev_blob_is_range_valid;
@@ -231,6 +231,10 @@ static const struct spdk_json_object_decoder nvmf_rpc_subsystem_tgt_conf_decoder
 	{"discovery_filter", offsetof(struct spdk_nvmf_tgt_conf, opts.discovery_filter), decode_discovery_filter, true},
 	{"dhchap_digests", offsetof(struct spdk_nvmf_tgt_conf, opts.dhchap_digests), decode_digest_array, true},
 	{"dhchap_dhgroups", offsetof(struct spdk_nvmf_tgt_conf, opts.dhchap_dhgroups), decode_dhgroup_array, true},
+	{"load_aware_placement", offsetof(struct spdk_nvmf_tgt_conf, opts.load_aware_placement), spdk_json_decode_bool, true},
+	{"qpair_migration_threshold", offsetof(struct spdk_nvmf_tgt_conf, opts.qpair_migration_threshold), spdk_json_decode_uint32, true},
+	{"auth_threads", offsetof(struct spdk_nvmf_tgt_conf, opts.auth_threads), spdk_json_decode_uint32, true},
+	{"auth_queue_depth", offsetof(struct spdk_nvmf_tgt_conf, opts.auth_queue_depth), spdk_json_decode_uint32, true},
 };
 
 static void
@@ -251,6 +255,12 @@ rpc_nvmf_set_config(struct spdk_jsonrpc_request *request,
 		}
 	}
 
+	if (conf.opts.qpair_migration_threshold > 100) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
+						 "qpair_migration_threshold must be a percentage");
+		return;
+	}
+
 	memcpy(&g_spdk_nvmf_tgt_conf, &conf, sizeof(conf));
 
 	spdk_jsonrpc_send_bool_response(request, true);
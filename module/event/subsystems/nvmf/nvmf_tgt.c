@@ -47,7 +47,7 @@ struct nvmf_tgt_poll_group {
 
 struct spdk_nvmf_tgt_conf g_spdk_nvmf_tgt_conf = {
 	.opts = {
-		.size = SPDK_SIZEOF(&g_spdk_nvmf_tgt_conf.opts, dhchap_dhgroups),
+		.size = SPDK_SIZEOF(&g_spdk_nvmf_tgt_conf.opts, auth_queue_depth),
 		.name = "nvmf_tgt",
 		.max_subsystems = 0,
 		.crdt = { 0, 0, 0 },
@@ -593,6 +593,12 @@ nvmf_subsystem_write_config_json(struct spdk_json_write_ctx *w)
 		}
 	}
 	spdk_json_write_array_end(w);
+	spdk_json_write_named_bool(w, "load_aware_placement",
+				   g_spdk_nvmf_tgt_conf.opts.load_aware_placement);
+	spdk_json_write_named_uint32(w, "qpair_migration_threshold",
+				     g_spdk_nvmf_tgt_conf.opts.qpair_migration_threshold);
+	spdk_json_write_named_uint32(w, "auth_threads", g_spdk_nvmf_tgt_conf.opts.auth_threads);
+	spdk_json_write_named_uint32(w, "auth_queue_depth", g_spdk_nvmf_tgt_conf.opts.auth_queue_depth);
 	spdk_json_write_object_end(w);
 	spdk_json_write_object_end(w);
 
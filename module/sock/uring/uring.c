@@ -52,6 +52,14 @@ enum uring_task_type {
 /* We use 1 just so it's not zero and we can validate it's right. */
 #define URING_BUF_GROUP_ID 1
 
+#ifdef IORING_RECV_MULTISHOT
+/* A single receive stays armed and keeps picking buffers from the ring
+ * until it runs out of buffers, instead of being re-posted after every
+ * completion. */
+#define SPDK_URING_RECV_MULTISHOT
+static bool g_uring_recv_multishot = true;
+#endif
+
 enum spdk_uring_sock_task_status {
 	SPDK_URING_SOCK_TASK_NOT_IN_USE = 0,
 	SPDK_URING_SOCK_TASK_IN_PROCESS,
@@ -1293,7 +1301,16 @@ _sock_prep_read(struct spdk_sock *_sock)
 	sock->group->io_queued++;
 
 	sqe = io_uring_get_sqe(&sock->group->uring);
+#ifdef SPDK_URING_RECV_MULTISHOT
+	if (g_uring_recv_multishot) {
+		/* The length is taken from the selected buffer */
+		io_uring_prep_recv_multishot(sqe, sock->fd, NULL, 0, 0);
+	} else {
+		io_uring_prep_recv(sqe, sock->fd, NULL, URING_MAX_RECV_SIZE, 0);
+	}
+#else
 	io_uring_prep_recv(sqe, sock->fd, NULL, URING_MAX_RECV_SIZE, 0);
+#endif
 	sqe->buf_group = URING_BUF_GROUP_ID;
 	sqe->flags |= IOSQE_BUFFER_SELECT;
 	io_uring_sqe_set_data(sqe, task);
@@ -1346,7 +1363,7 @@ sock_uring_group_reap(struct spdk_uring_sock_group_impl *group, int max, int max
 	struct spdk_uring_sock *sock, *tmp;
 	struct spdk_uring_task *task;
 	int status, bid, flags;
-	bool is_zcopy;
+	bool is_zcopy, armed;
 
 	for (i = 0; i < max; i++) {
 		ret = io_uring_peek_cqe(&group->uring, &cqe);
@@ -1364,13 +1381,20 @@ sock_uring_group_reap(struct spdk_uring_sock_group_impl *group, int max, int max
 		assert(sock != NULL);
 		assert(sock->group != NULL);
 		assert(sock->group == group);
-		sock->group->io_inflight--;
-		sock->group->io_avail++;
 		status = cqe->res;
 		flags = cqe->flags;
 		io_uring_cqe_seen(&group->uring, cqe);
 
-		task->status = SPDK_URING_SOCK_TASK_NOT_IN_USE;
+		armed = false;
+#ifdef SPDK_URING_RECV_MULTISHOT
+		/* A multishot receive which is still armed keeps its task in use */
+		armed = task->type == URING_TASK_READ && (flags & IORING_CQE_F_MORE);
+#endif
+		if (!armed) {
+			sock->group->io_inflight--;
+			sock->group->io_avail++;
+			task->status = SPDK_URING_SOCK_TASK_NOT_IN_USE;
+		}
 
 		switch (task->type) {
 		case URING_TASK_READ:
@@ -1380,6 +1404,14 @@ sock_uring_group_reap(struct spdk_uring_sock_group_impl *group, int max, int max
 				_sock_prep_read(&sock->base);
 			} else if (status == -ECANCELED) {
 				continue;
+#ifdef SPDK_URING_RECV_MULTISHOT
+			} else if (status == -EINVAL && g_uring_recv_multishot) {
+				/* The kernel doesn't support multishot receives, fall back to
+				 * posting a single receive at a time. */
+				SPDK_NOTICELOG("Multishot receive is not supported, disabling it\n");
+				g_uring_recv_multishot = false;
+				_sock_prep_read(&sock->base);
+#endif
 			} else if (status == -ENOBUFS) {
 				/* There's data in the socket but the user hasn't provided any buffers.
 				 * We need to notify the user that the socket has data pending. */
@@ -1885,6 +1917,7 @@ uring_sock_group_impl_remove_sock(struct spdk_sock_group_impl *_group,
 {
 	struct spdk_uring_sock *sock = __uring_sock(_sock);
 	struct spdk_uring_sock_group_impl *group = __uring_group_impl(_group);
+	struct spdk_uring_buf_tracker *tr;
 
 	sock->pending_group_remove = true;
 
@@ -1929,10 +1962,15 @@ uring_sock_group_impl_remove_sock(struct spdk_sock_group_impl *_group,
 	}
 	assert(sock->pending_recv == false);
 
-	/* We have no way to handle this case. We could let the user read this
-	 * buffer, but the buffer came from a group and we have lost the association
-	 * to that so we couldn't release it. */
-	assert(STAILQ_EMPTY(&sock->recv_stream));
+	/* Data which the user hasn't read yet is dropped. Once the socket leaves the
+	 * group we lose the association to the group the buffers came from, so they
+	 * have to be given back to it now. */
+	while ((tr = STAILQ_FIRST(&sock->recv_stream)) != NULL) {
+		STAILQ_REMOVE_HEAD(&sock->recv_stream, link);
+		STAILQ_INSERT_HEAD(&group->free_trackers, tr, link);
+		spdk_sock_group_provide_buf(group->base.group, tr->buf, tr->buflen, tr->ctx);
+	}
+	sock->recv_offset = 0;
 
 	if (sock->placement_id != -1) {
 		spdk_sock_map_release(&g_map, sock->placement_id);
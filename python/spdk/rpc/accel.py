@@ -19,17 +19,20 @@ def accel_get_module_info(client):
     return client.call('accel_get_module_info')
 
 
-def accel_assign_opc(client, opname, module):
+def accel_assign_opc(client, opname, module, spread_modules=None):
     """Manually assign an operation to a module.
 
     Args:
         opname: name of operation
         module: name of module
+        spread_modules: list of additional modules to spread the operation across (optional)
     """
     params = {
         'opname': opname,
         'module': module,
     }
+    if spread_modules:
+        params['spread_modules'] = spread_modules
 
     return client.call('accel_assign_opc', params)
 
@@ -112,12 +115,32 @@ def accel_set_options(client, small_cache_size, large_cache_size,
     return client.call('accel_set_options', params)
 
 
+def accel_sw_async_enable(client, num_workers=None):
+    """Enable the software_async accel module.
+
+    Args:
+        num_workers: number of worker threads executing the operations (optional)
+    """
+    params = {}
+
+    if num_workers is not None:
+        params['num_workers'] = num_workers
+
+    return client.call('accel_sw_async_enable', params)
+
+
 def accel_get_stats(client):
     """Get accel framework's statistics"""
 
     return client.call('accel_get_stats')
 
 
+def accel_sw_get_key_cache_stats(client):
+    """Get the statistics of the software module's crypto key schedule cache"""
+
+    return client.call('accel_sw_get_key_cache_stats')
+
+
 def accel_error_inject_error(client, opcode, type, count=None, interval=None, errcode=None):
     """Inject an error to processing accel operation"""
     params = {}
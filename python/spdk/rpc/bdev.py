@@ -47,7 +47,8 @@ def bdev_wait_for_examine(client):
     return client.call('bdev_wait_for_examine')
 
 
-def bdev_compress_create(client, base_bdev_name, pm_path, lb_size=None, comp_algo=None, comp_level=None):
+def bdev_compress_create(client, base_bdev_name, pm_path, lb_size=None, comp_algo=None, comp_level=None,
+                         adaptive=None):
     """Construct a compress virtual block device.
     Args:
         base_bdev_name: name of the underlying base bdev
@@ -55,6 +56,8 @@ def bdev_compress_create(client, base_bdev_name, pm_path, lb_size=None, comp_alg
         lb_size: logical block size for the compressed vol in bytes.  Must be 4K or 512.
         comp_algo: compression algorithm for the compressed vol. Default is deflate.
         comp_level: compression algorithm level for the compressed vol. Default is 1.
+        adaptive: store incompressible chunks uncompressed and switch between lz4 and deflate
+        depending on the load (optional)
     Returns:
         Name of created virtual block device.
     """
@@ -67,6 +70,8 @@ def bdev_compress_create(client, base_bdev_name, pm_path, lb_size=None, comp_alg
         params['comp_algo'] = comp_algo
     if comp_level is not None:
         params['comp_level'] = comp_level
+    if adaptive is not None:
+        params['adaptive'] = adaptive
     return client.call('bdev_compress_create', params)
 
 
@@ -579,7 +584,8 @@ def bdev_nvme_set_options(client, action_on_timeout=None, timeout_us=None, timeo
                           fast_io_fail_timeout_sec=None, disable_auto_failback=None, generate_uuids=None,
                           transport_tos=None, nvme_error_stat=None, rdma_srq_size=None, io_path_stat=None,
                           allow_accel_sequence=None, rdma_max_cq_size=None, rdma_cm_event_timeout_ms=None,
-                          dhchap_digests=None, dhchap_dhgroups=None):
+                          dhchap_digests=None, dhchap_dhgroups=None, slow_io_path_factor=None,
+                          slow_io_path_check_period_ms=None, ctrlr_attach_concurrency=None):
     """Set options for the bdev nvme. This is startup command.
     Args:
         action_on_timeout:  action to take on command time out. Valid values are: none, reset, abort (optional)
@@ -628,6 +634,12 @@ def bdev_nvme_set_options(client, action_on_timeout=None, timeout_us=None, timeo
         rdma_cm_event_timeout_ms: Time to wait for RDMA CM event. Only applicable for RDMA transports.
         dhchap_digests: List of allowed DH-HMAC-CHAP digests. (optional)
         dhchap_dhgroups: List of allowed DH-HMAC-CHAP DH groups. (optional)
+        slow_io_path_factor: Mark an I/O path as degraded if its p99 latency is more than this many times
+        that of the fastest other I/O path of the same bdev. Default: 0 (disabled) (optional)
+        slow_io_path_check_period_ms: How often I/O path latencies are compared, in milliseconds.
+        Default: 1000 (optional)
+        ctrlr_attach_concurrency: The maximum number of controllers which are connected and initialized
+        at the same time. Further attaches are queued. Default: 0 (unlimited) (optional)
     """
     params = dict()
     if action_on_timeout is not None:
@@ -688,6 +700,12 @@ def bdev_nvme_set_options(client, action_on_timeout=None, timeout_us=None, timeo
         params['dhchap_digests'] = dhchap_digests
     if dhchap_dhgroups is not None:
         params['dhchap_dhgroups'] = dhchap_dhgroups
+    if slow_io_path_factor is not None:
+        params['slow_io_path_factor'] = slow_io_path_factor
+    if slow_io_path_check_period_ms is not None:
+        params['slow_io_path_check_period_ms'] = slow_io_path_check_period_ms
+    if ctrlr_attach_concurrency is not None:
+        params['ctrlr_attach_concurrency'] = ctrlr_attach_concurrency
     return client.call('bdev_nvme_set_options', params)
 
 
@@ -24,7 +24,9 @@ def nvmf_set_max_subsystems(client,
 def nvmf_set_config(client,
                     passthru_identify_ctrlr=None,
                     poll_groups_mask=None,
-                    discovery_filter=None, dhchap_digests=None, dhchap_dhgroups=None):
+                    discovery_filter=None, dhchap_digests=None, dhchap_dhgroups=None,
+                    load_aware_placement=None, qpair_migration_threshold=None,
+                    auth_threads=None, auth_queue_depth=None):
     """Set NVMe-oF target subsystem configuration.
 
     Args:
@@ -32,6 +34,12 @@ def nvmf_set_config(client,
          comma separated values: `transport`, `address`, `svcid`
         dhchap_digests: List of allowed DH-HMAC-CHAP digests. (optional)
         dhchap_dhgroups: List of allowed DH-HMAC-CHAP DH groups. (optional)
+        load_aware_placement: Place new qpairs on the least busy poll group (optional)
+        qpair_migration_threshold: Busy percentage difference between poll groups above which
+         I/O qpairs are migrated to the least busy poll group, 0 disables migration (optional)
+        auth_threads: Number of threads computing DH-HMAC-CHAP messages, 0 computes them on the
+         poll group threads (optional)
+        auth_queue_depth: Maximum number of DH-HMAC-CHAP computations queued to those threads (optional)
     Returns:
         True or False
     """
@@ -49,6 +57,14 @@ def nvmf_set_config(client,
         params['dhchap_digests'] = dhchap_digests
     if dhchap_dhgroups is not None:
         params['dhchap_dhgroups'] = dhchap_dhgroups
+    if load_aware_placement is not None:
+        params['load_aware_placement'] = load_aware_placement
+    if qpair_migration_threshold is not None:
+        params['qpair_migration_threshold'] = qpair_migration_threshold
+    if auth_threads is not None:
+        params['auth_threads'] = auth_threads
+    if auth_queue_depth is not None:
+        params['auth_queue_depth'] = auth_queue_depth
 
     return client.call('nvmf_set_config', params)
 
@@ -125,6 +141,7 @@ def nvmf_create_transport(client, **params):
         abort_timeout_sec: Abort execution timeout value, in seconds (optional)
         no_wr_batching: Boolean flag to disable work requests batching - RDMA specific (optional)
         control_msg_num: The number of control messages per poll group - TCP specific (optional)
+        recv_buf_count: The number of receive buffers provided to the socket layer per poll group - TCP specific (optional)
         disable_mappable_bar0: disable client mmap() of BAR0 - VFIO-USER specific (optional)
         disable_adaptive_irq: Disable adaptive interrupt feature - VFIO-USER specific (optional)
         disable_shadow_doorbells: disable shadow doorbell support - VFIO-USER specific (optional)
@@ -555,6 +572,35 @@ def nvmf_ns_visible(visible, client, nqn, nsid, host, tgt_name=None):
         return client.call('nvmf_ns_remove_host', params)
 
 
+def nvmf_ns_set_qos_limits(client, nqn, nsid, host, rw_ios_per_sec=None, rw_mbytes_per_sec=None,
+                           tgt_name=None):
+    """Set rate limits of a host's I/O to a namespace
+
+    Args:
+        nqn: Subsystem NQN.
+        nsid: Namespace ID.
+        host: Host NQN the limits apply to.
+        rw_ios_per_sec: Read and write I/O per second limit, 0 for unlimited (optional)
+        rw_mbytes_per_sec: Read and write MiB per second limit, 0 for unlimited (optional)
+        tgt_name: name of the parent NVMe-oF target (optional).
+
+    Returns:
+        True or False
+    """
+    params = {'nqn': nqn,
+              'nsid': nsid,
+              'host': host}
+
+    if rw_ios_per_sec is not None:
+        params['rw_ios_per_sec'] = rw_ios_per_sec
+    if rw_mbytes_per_sec is not None:
+        params['rw_mbytes_per_sec'] = rw_mbytes_per_sec
+    if tgt_name:
+        params['tgt_name'] = tgt_name
+
+    return client.call('nvmf_ns_set_qos_limits', params)
+
+
 def nvmf_subsystem_add_host(client, nqn, host, tgt_name=None, psk=None, dhchap_key=None,
                             dhchap_ctrlr_key=None):
     """Add a host NQN to the list of allowed hosts.
@@ -763,6 +809,21 @@ def nvmf_set_crdt(client, crdt1=None, crdt2=None, crdt3=None):
     return client.call('nvmf_set_crdt', params)
 
 
+def nvmf_set_reservation_store(client, bdev_name):
+    """Store the persistent reservations of all namespaces on a bdev. The store
+    supports a single writer, the bdev must not be used by more than one target.
+
+    Args:
+        bdev_name: Name of the bdev to store the reservations on
+
+    Returns:
+        True or False
+    """
+    params = {'bdev_name': bdev_name}
+
+    return client.call('nvmf_set_reservation_store', params)
+
+
 def nvmf_publish_mdns_prr(client, tgt_name=None):
     """Publish mdns pull registration request
 
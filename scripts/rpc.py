@@ -263,7 +263,8 @@ if __name__ == "__main__":
                                                  pm_path=args.pm_path,
                                                  lb_size=args.lb_size,
                                                  comp_algo=args.comp_algo,
-                                                 comp_level=args.comp_level))
+                                                 comp_level=args.comp_level,
+                                                 adaptive=args.adaptive))
 
     p = subparsers.add_parser('bdev_compress_create', help='Add a compress vbdev')
     p.add_argument('-b', '--base-bdev-name', help="Name of the base bdev", required=True)
@@ -275,6 +276,8 @@ if __name__ == "__main__":
                    if algo == deflate, level ranges from 0 to 3.
                    if algo == lz4, level ranges from 1 to 65537""",
                    default=1, type=int)
+    p.add_argument('-a', '--adaptive', help='Store incompressible chunks uncompressed and switch between lz4 '
+                   'and deflate depending on the load', action='store_true')
     p.set_defaults(func=bdev_compress_create)
 
     def bdev_compress_delete(args):
@@ -623,7 +626,10 @@ if __name__ == "__main__":
                                        rdma_max_cq_size=args.rdma_max_cq_size,
                                        rdma_cm_event_timeout_ms=args.rdma_cm_event_timeout_ms,
                                        dhchap_digests=args.dhchap_digests,
-                                       dhchap_dhgroups=args.dhchap_dhgroups)
+                                       dhchap_dhgroups=args.dhchap_dhgroups,
+                                       slow_io_path_factor=args.slow_io_path_factor,
+                                       slow_io_path_check_period_ms=args.slow_io_path_check_period_ms,
+                                       ctrlr_attach_concurrency=args.ctrlr_attach_concurrency)
 
     p = subparsers.add_parser('bdev_nvme_set_options',
                               help='Set options for the bdev nvme type. This is startup command.')
@@ -710,6 +716,14 @@ if __name__ == "__main__":
                    type=lambda d: d.split(','))
     p.add_argument('--dhchap-dhgroups', help='Comma-separated list of allowed DH-HMAC-CHAP DH groups',
                    type=lambda d: d.split(','))
+    p.add_argument('--slow-io-path-factor',
+                   help="""Mark an I/O path as degraded if its p99 latency is more than this many times
+                   that of the fastest other I/O path of the same bdev. Default: 0 (disabled)""", type=int)
+    p.add_argument('--slow-io-path-check-period-ms',
+                   help='How often I/O path latencies are compared, in milliseconds. Default: 1000', type=int)
+    p.add_argument('--ctrlr-attach-concurrency',
+                   help="""The maximum number of controllers which are connected and initialized at the
+                   same time. Further attaches are queued. Default: 0 (unlimited)""", type=int)
 
     p.set_defaults(func=bdev_nvme_set_options)
 
@@ -2586,7 +2600,11 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
                                  poll_groups_mask=args.poll_groups_mask,
                                  discovery_filter=args.discovery_filter,
                                  dhchap_digests=args.dhchap_digests,
-                                 dhchap_dhgroups=args.dhchap_dhgroups)
+                                 dhchap_dhgroups=args.dhchap_dhgroups,
+                                 load_aware_placement=args.load_aware_placement,
+                                 qpair_migration_threshold=args.qpair_migration_threshold,
+                                 auth_threads=args.auth_threads,
+                                 auth_queue_depth=args.auth_queue_depth)
 
     p = subparsers.add_parser('nvmf_set_config', help='Set NVMf target config')
     p.add_argument('-i', '--passthru-identify-ctrlr', help="""Passthrough fields like serial number and model number
@@ -2598,6 +2616,14 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
                    type=lambda d: d.split(','))
     p.add_argument('--dhchap-dhgroups', help='Comma-separated list of allowed DH-HMAC-CHAP DH groups',
                    type=lambda d: d.split(','))
+    p.add_argument('--load-aware-placement', help='Place new qpairs on the least busy poll group',
+                   action='store_true', default=None)
+    p.add_argument('--qpair-migration-threshold', help="""Busy percentage difference between poll groups
+    above which I/O qpairs are migrated to the least busy poll group. 0 disables migration""", type=int)
+    p.add_argument('--auth-threads', help="""Number of threads computing DH-HMAC-CHAP messages.
+    0 computes them on the poll group threads""", type=int)
+    p.add_argument('--auth-queue-depth', help='Maximum number of DH-HMAC-CHAP computations queued to those threads',
+                   type=int)
     p.set_defaults(func=nvmf_set_config)
 
     def nvmf_create_transport(args):
@@ -2628,6 +2654,8 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('-w', '--no-wr-batching', action='store_true', help='Disable work requests batching. Relevant only for RDMA transport')
     p.add_argument('-e', '--control-msg-num', help="""The number of control messages per poll group.
     Relevant only for TCP transport""", type=int)
+    p.add_argument('--recv-buf-count', help="""The number of receive buffers provided to the socket layer
+    per poll group. Relevant only for TCP transport""", type=int)
     p.add_argument('-M', '--disable-mappable-bar0', action='store_true', help="""Disable mmap() of BAR0.
     Relevant only for VFIO-USER transport""")
     p.add_argument('-I', '--disable-adaptive-irq', action='store_true', help="""Disable adaptive interrupt feature.
@@ -2872,6 +2900,24 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     nvmf_ns_visible_add_args(p)
     p.set_defaults(func=nvmf_ns_remove_host)
 
+    def nvmf_ns_set_qos_limits(args):
+        rpc.nvmf.nvmf_ns_set_qos_limits(args.client,
+                                        nqn=args.nqn,
+                                        nsid=args.nsid,
+                                        host=args.host,
+                                        rw_ios_per_sec=args.rw_ios_per_sec,
+                                        rw_mbytes_per_sec=args.rw_mbytes_per_sec,
+                                        tgt_name=args.tgt_name)
+
+    p = subparsers.add_parser('nvmf_ns_set_qos_limits', help='Set rate limits of I/O from a host to a namespace')
+    p.add_argument('nqn', help='NVMe-oF subsystem NQN')
+    p.add_argument('nsid', help='The requested NSID', type=int)
+    p.add_argument('host', help='Host NQN the limits apply to')
+    p.add_argument('--rw-ios-per-sec', help='Read and write I/O per second limit, 0 for unlimited', type=int)
+    p.add_argument('--rw-mbytes-per-sec', help='Read and write MiB per second limit, 0 for unlimited', type=int)
+    p.add_argument('-t', '--tgt-name', help='The name of the parent NVMe-oF target (optional)', type=str)
+    p.set_defaults(func=nvmf_ns_set_qos_limits)
+
     def nvmf_subsystem_add_host(args):
         rpc.nvmf.nvmf_subsystem_add_host(args.client,
                                          nqn=args.nqn,
@@ -2984,6 +3030,15 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('-t3', '--crdt3', help='Command Retry Delay Time 3, in units of 100 milliseconds', type=int)
     p.set_defaults(func=nvmf_set_crdt)
 
+    def nvmf_set_reservation_store(args):
+        print_dict(rpc.nvmf.nvmf_set_reservation_store(args.client, args.bdev_name))
+
+    p = subparsers.add_parser('nvmf_set_reservation_store',
+                              help="""Store the persistent reservations of all namespaces on a bdev.
+    The store supports a single writer, the bdev must not be used by more than one target.""")
+    p.add_argument('bdev_name', help='Name of the bdev to store the reservations on')
+    p.set_defaults(func=nvmf_set_reservation_store)
+
     def nvmf_publish_mdns_prr(args):
         rpc.nvmf.nvmf_publish_mdns_prr(args.client, args.tgt_name)
 
@@ -3270,11 +3325,14 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.set_defaults(func=accel_get_module_info)
 
     def accel_assign_opc(args):
-        rpc.accel.accel_assign_opc(args.client, opname=args.opname, module=args.module)
+        rpc.accel.accel_assign_opc(args.client, opname=args.opname, module=args.module,
+                                   spread_modules=args.spread_modules)
 
     p = subparsers.add_parser('accel_assign_opc', help='Manually assign an operation to a module.')
     p.add_argument('-o', '--opname', help='opname')
     p.add_argument('-m', '--module', help='name of module')
+    p.add_argument('-s', '--spread-modules', nargs='+',
+                   help='names of additional modules to spread the operation across, in order of preference')
     p.set_defaults(func=accel_assign_opc)
 
     def accel_crypto_key_create(args):
@@ -3329,12 +3387,27 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('--buf-count', type=int, help='Maximum number of buffers per IO channel')
     p.set_defaults(func=accel_set_options)
 
+    def accel_sw_async_enable(args):
+        rpc.accel.accel_sw_async_enable(args.client, num_workers=args.num_workers)
+
+    p = subparsers.add_parser('accel_sw_async_enable',
+                              help='Enable the software_async module, executing operations on worker threads')
+    p.add_argument('-w', '--num-workers', type=int, help='Number of worker threads')
+    p.set_defaults(func=accel_sw_async_enable)
+
     def accel_get_stats(args):
         print_dict(rpc.accel.accel_get_stats(args.client))
 
     p = subparsers.add_parser('accel_get_stats', help='Display accel framework\'s statistics')
     p.set_defaults(func=accel_get_stats)
 
+    def accel_sw_get_key_cache_stats(args):
+        print_dict(rpc.accel.accel_sw_get_key_cache_stats(args.client))
+
+    p = subparsers.add_parser('accel_sw_get_key_cache_stats',
+                              help='Display the statistics of the software module\'s crypto key cache')
+    p.set_defaults(func=accel_sw_get_key_cache_stats)
+
     # ioat
     def ioat_scan_accel_module(args):
         rpc.ioat.ioat_scan_accel_module(args.client)
@@ -95,6 +95,8 @@ run_test "accel_compress_verify" NOT accel_perf -t 1 -w compress -l $testdir/bib
 run_test "accel_wrong_workload" NOT accel_perf -t 1 -w foobar
 # Use negative number for source buffers parameters
 run_test "accel_negative_buffers" NOT accel_perf -t 1 -w xor -y -x -1
+# Sequence workload does not support verify option
+run_test "accel_sequence_verify" NOT accel_perf -t 1 -w sequence -O copy,crc32c -y
 
 #Run through all SW ops with defaults for a quick sanity check
 #To save time, only use verification case
@@ -113,6 +115,8 @@ run_test "accel_dif_generate" accel_test -t 1 -w dif_generate
 run_test "accel_dif_generate_copy" accel_test -t 1 -w dif_generate_copy
 run_test "accel_dix_verify" accel_test -t 1 -w dix_verify
 run_test "accel_dix_generate" accel_test -t 1 -w dif_generate
+run_test "accel_sequence" accel_perf -t 1 -w sequence -O fill,copy,crc32c -C 4 -F random -H
+run_test "accel_sequence_memory_domain" accel_perf -t 1 -w sequence -O copy,crc32c -C 3 -F unaligned -D
 # do not run compress/decompress unless ISAL is installed
 if [[ $CONFIG_ISAL == y ]]; then
 	run_test "accel_comp" accel_test -t 1 -w compress -l $testdir/bib
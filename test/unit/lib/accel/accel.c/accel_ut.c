@@ -167,6 +167,7 @@ test_setup(void)
 	/* Prevent lazy initialization of poller. */
 	g_sw_ch->completion_poller = (void *)0xdeadbeef;
 	STAILQ_INIT(&g_sw_ch->tasks_to_complete);
+	STAILQ_INIT(&g_sw_ch->crc32c_tasks);
 	g_module_if.supports_opcode = _supports_opcode;
 	return 0;
 }
@@ -378,6 +379,59 @@ test_spdk_accel_submit_compare(void)
 	free(src2);
 }
 
+static void
+test_spdk_accel_submit_check_zero(void)
+{
+	uint8_t *src;
+	struct iovec iovs[2];
+	bool is_zero;
+	int rc;
+	struct spdk_accel_task task;
+	struct spdk_accel_task *expected_accel_task = NULL;
+
+	STAILQ_INIT(&g_accel_ch->task_pool);
+
+	src = calloc(1, TEST_SUBMIT_SIZE);
+	SPDK_CU_ASSERT_FATAL(src != NULL);
+	iovs[0].iov_base = src;
+	iovs[0].iov_len = TEST_SUBMIT_SIZE / 2;
+	iovs[1].iov_base = src + TEST_SUBMIT_SIZE / 2;
+	iovs[1].iov_len = TEST_SUBMIT_SIZE / 2;
+
+	/* Fail with no iovs */
+	rc = spdk_accel_submit_check_zero(g_ch, iovs, 0, &is_zero, NULL, NULL);
+	CU_ASSERT(rc == -EINVAL);
+
+	/* Fail with no tasks on _get_task() */
+	rc = spdk_accel_submit_check_zero(g_ch, iovs, 2, &is_zero, NULL, NULL);
+	CU_ASSERT(rc == -ENOMEM);
+
+	/* All zero buffer */
+	STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task, link);
+	is_zero = false;
+	rc = spdk_accel_submit_check_zero(g_ch, iovs, 2, &is_zero, NULL, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(task.op_code == SPDK_ACCEL_OPC_CHECK_ZERO);
+	CU_ASSERT(task.nbytes == TEST_SUBMIT_SIZE);
+	CU_ASSERT(is_zero);
+	expected_accel_task = STAILQ_FIRST(&g_sw_ch->tasks_to_complete);
+	STAILQ_REMOVE_HEAD(&g_sw_ch->tasks_to_complete, link);
+	CU_ASSERT(expected_accel_task == &task);
+
+	/* A single non-zero byte in the last iov */
+	src[TEST_SUBMIT_SIZE - 1] = 1;
+	STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task, link);
+	is_zero = true;
+	rc = spdk_accel_submit_check_zero(g_ch, iovs, 2, &is_zero, NULL, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(!is_zero);
+	expected_accel_task = STAILQ_FIRST(&g_sw_ch->tasks_to_complete);
+	STAILQ_REMOVE_HEAD(&g_sw_ch->tasks_to_complete, link);
+	CU_ASSERT(expected_accel_task == &task);
+
+	free(src);
+}
+
 static void
 test_spdk_accel_submit_fill(void)
 {
@@ -448,11 +502,18 @@ test_spdk_accel_submit_crc32c(void)
 	SLIST_INSERT_HEAD(&g_accel_ch->task_aux_data_pool, &task_aux, link);
 
 	/* accel submission OK. */
+	memset(src, 0x5a, sizeof(src));
 	rc = spdk_accel_submit_crc32c(g_ch, &crc_dst, src, seed, nbytes, NULL, cb_arg);
 	CU_ASSERT(rc == 0);
 	CU_ASSERT(task.crc_dst == &crc_dst);
 	CU_ASSERT(task.seed == seed);
 	CU_ASSERT(task.op_code == SPDK_ACCEL_OPC_CRC32C);
+	/* Single buffer crc32c is deferred until the completion poller calculates the batch */
+	CU_ASSERT(STAILQ_EMPTY(&g_sw_ch->tasks_to_complete));
+	CU_ASSERT(STAILQ_FIRST(&g_sw_ch->crc32c_tasks) == &task);
+	_sw_accel_crc32c_batch(g_sw_ch);
+	CU_ASSERT(STAILQ_EMPTY(&g_sw_ch->crc32c_tasks));
+	CU_ASSERT(crc_dst == spdk_crc32c_update(src, nbytes, ~seed));
 	expected_accel_task = STAILQ_FIRST(&g_sw_ch->tasks_to_complete);
 	STAILQ_REMOVE_HEAD(&g_sw_ch->tasks_to_complete, link);
 	CU_ASSERT(expected_accel_task == &task);
@@ -663,6 +724,215 @@ test_spdk_accel_module_register(void)
 	free_cores();
 }
 
+static struct spdk_accel_task *g_spread_tasks[2][8];
+static int g_spread_num_tasks[2];
+static int g_spread_submit_status[2];
+
+static int
+ut_spread_submit_tasks(int idx, struct spdk_accel_task *task)
+{
+	if (g_spread_submit_status[idx] != 0) {
+		return g_spread_submit_status[idx];
+	}
+
+	SPDK_CU_ASSERT_FATAL(g_spread_num_tasks[idx] < (int)SPDK_COUNTOF(g_spread_tasks[idx]));
+	g_spread_tasks[idx][g_spread_num_tasks[idx]++] = task;
+
+	return 0;
+}
+
+static int
+ut_spread_submit_tasks0(struct spdk_io_channel *ch, struct spdk_accel_task *task)
+{
+	return ut_spread_submit_tasks(0, task);
+}
+
+static int
+ut_spread_submit_tasks1(struct spdk_io_channel *ch, struct spdk_accel_task *task)
+{
+	return ut_spread_submit_tasks(1, task);
+}
+
+static void
+ut_spread_complete(int idx)
+{
+	struct spdk_accel_task *task;
+
+	SPDK_CU_ASSERT_FATAL(g_spread_num_tasks[idx] > 0);
+	task = g_spread_tasks[idx][0];
+	memmove(&g_spread_tasks[idx][0], &g_spread_tasks[idx][1],
+		--g_spread_num_tasks[idx] * sizeof(task));
+	spdk_accel_task_complete(task, 0);
+}
+
+static void
+ut_spread_cb(void *cb_arg, int status)
+{
+	*(int *)cb_arg = status;
+}
+
+static void
+test_spdk_accel_spread_modules(void)
+{
+	struct spdk_accel_module_if mods[] = {
+		{ .name = "mod0", .priority = 0, .submit_tasks = ut_spread_submit_tasks0 },
+		{ .name = "mod1", .priority = 1, .submit_tasks = ut_spread_submit_tasks1 },
+	};
+	const char *names[SPDK_ACCEL_OPC_MAX_MODULES + 1] = { "mod1", "mod0", "mod0", "mod0", "mod0" };
+	struct spdk_accel_task tasks[8] = {};
+	struct spdk_accel_task_aux_data task_aux[8];
+	struct accel_module saved_module = g_modules_opc[SPDK_ACCEL_OPC_COPY];
+	struct accel_operation_stats *stats = &g_accel_ch->stats.operations[SPDK_ACCEL_OPC_COPY];
+	struct accel_dispatch dispatch = {};
+	uint8_t buf[16];
+	int rc, status, done = 0;
+	size_t i;
+
+	allocate_cores(1);
+	allocate_threads(1);
+	set_thread(0);
+
+	TAILQ_INIT(&spdk_accel_module_list);
+	for (i = 0; i < SPDK_COUNTOF(mods); ++i) {
+		mods[i].module_init = ut_module_init_nop;
+		mods[i].supports_opcode = ut_supports_opcode_all;
+		spdk_accel_module_list_add(&mods[i]);
+	}
+
+	/* Opcodes can only be assigned before the framework is initialized */
+	g_modules_started = true;
+	rc = spdk_accel_assign_opc_modules(SPDK_ACCEL_OPC_COPY, names, 2);
+	CU_ASSERT_EQUAL(rc, -EINVAL);
+	g_modules_started = false;
+
+	/* Check the number of modules */
+	rc = spdk_accel_assign_opc_modules(SPDK_ACCEL_OPC_COPY, names, 0);
+	CU_ASSERT_EQUAL(rc, -EINVAL);
+	rc = spdk_accel_assign_opc_modules(SPDK_ACCEL_OPC_COPY, names, SPDK_COUNTOF(names));
+	CU_ASSERT_EQUAL(rc, -EINVAL);
+
+	/* Spread copy across mod1 and mod0, while fill is only assigned to mod0 */
+	rc = spdk_accel_assign_opc_modules(SPDK_ACCEL_OPC_COPY, names, 2);
+	CU_ASSERT_EQUAL(rc, 0);
+	rc = spdk_accel_assign_opc_modules(SPDK_ACCEL_OPC_FILL, names, 2);
+	CU_ASSERT_EQUAL(rc, 0);
+	rc = spdk_accel_assign_opc(SPDK_ACCEL_OPC_FILL, "mod0");
+	CU_ASSERT_EQUAL(rc, 0);
+
+	rc = spdk_accel_initialize();
+	CU_ASSERT_EQUAL(rc, 0);
+	CU_ASSERT_EQUAL(g_modules_opc[SPDK_ACCEL_OPC_COPY].num_modules, 2);
+	CU_ASSERT_PTR_EQUAL(g_modules_opc[SPDK_ACCEL_OPC_COPY].module, &mods[1]);
+	CU_ASSERT_PTR_EQUAL(g_modules_opc[SPDK_ACCEL_OPC_COPY].modules[0], &mods[1]);
+	CU_ASSERT_PTR_EQUAL(g_modules_opc[SPDK_ACCEL_OPC_COPY].modules[1], &mods[0]);
+	CU_ASSERT_EQUAL(g_modules_opc[SPDK_ACCEL_OPC_FILL].num_modules, 0);
+	CU_ASSERT_PTR_EQUAL(g_modules_opc[SPDK_ACCEL_OPC_FILL].module, &mods[0]);
+
+	spdk_accel_finish(ut_accel_module_priority_finish_done, &done);
+	while (!done) {
+		poll_threads();
+	}
+	CU_ASSERT_EQUAL(g_modules_opc[SPDK_ACCEL_OPC_COPY].num_modules, 0);
+
+	TAILQ_INIT(&spdk_accel_module_list);
+	free_threads();
+	free_cores();
+
+	/* Encrypt can't be spread, as the keys are bound to a single module */
+	g_modules_opc[SPDK_ACCEL_OPC_ENCRYPT].module = &mods[1];
+	g_modules_opc_spread[SPDK_ACCEL_OPC_ENCRYPT][0] = (char *)"mod0";
+	TAILQ_INSERT_TAIL(&spdk_accel_module_list, &mods[0], tailq);
+	rc = accel_module_init_spread(SPDK_ACCEL_OPC_ENCRYPT);
+	CU_ASSERT_EQUAL(rc, -EINVAL);
+	g_modules_opc_spread[SPDK_ACCEL_OPC_ENCRYPT][0] = NULL;
+	g_modules_opc[SPDK_ACCEL_OPC_ENCRYPT] = g_module;
+	TAILQ_INIT(&spdk_accel_module_list);
+
+	/* Now dispatch copies on the test channel */
+	g_modules_opc[SPDK_ACCEL_OPC_COPY].module = &mods[0];
+	g_modules_opc[SPDK_ACCEL_OPC_COPY].num_modules = 2;
+	g_modules_opc[SPDK_ACCEL_OPC_COPY].modules[0] = &mods[0];
+	g_modules_opc[SPDK_ACCEL_OPC_COPY].modules[1] = &mods[1];
+	g_accel_ch->dispatch[SPDK_ACCEL_OPC_COPY] = &dispatch;
+	memset(stats, 0, sizeof(*stats));
+
+	STAILQ_INIT(&g_accel_ch->task_pool);
+	SLIST_INIT(&g_accel_ch->task_aux_data_pool);
+	for (i = 0; i < SPDK_COUNTOF(tasks); ++i) {
+		STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &tasks[i], link);
+		SLIST_INSERT_HEAD(&g_accel_ch->task_aux_data_pool, &task_aux[i], link);
+	}
+
+	/* Neither module's throughput is known yet, so the preferred one is picked */
+	rc = spdk_accel_submit_copy(g_ch, buf, buf, sizeof(buf), ut_spread_cb, &status);
+	CU_ASSERT_EQUAL(rc, 0);
+	CU_ASSERT_EQUAL(g_spread_num_tasks[0], 1);
+	CU_ASSERT_EQUAL(dispatch.modules[0].outstanding, 1);
+	spdk_delay_us(100);
+	status = -1;
+	ut_spread_complete(0);
+	CU_ASSERT_EQUAL(status, 0);
+	CU_ASSERT_EQUAL(dispatch.modules[0].outstanding, 0);
+	CU_ASSERT_EQUAL(dispatch.modules[0].task_ticks, 100);
+	CU_ASSERT_EQUAL(stats->modules[0].executed, 1);
+
+	/* mod1 hasn't been measured yet, so it's the cheapest one now */
+	rc = spdk_accel_submit_copy(g_ch, buf, buf, sizeof(buf), ut_spread_cb, &status);
+	CU_ASSERT_EQUAL(rc, 0);
+	CU_ASSERT_EQUAL(g_spread_num_tasks[1], 1);
+	spdk_delay_us(400);
+	ut_spread_complete(1);
+	CU_ASSERT_EQUAL(dispatch.modules[1].task_ticks, 400);
+	CU_ASSERT_EQUAL(stats->modules[1].executed, 1);
+
+	/*
+	 * mod0 is 4x faster, so it should get the first four tasks (the fourth one is a tie,
+	 * which goes to the preferred module) and mod1 the fifth one.
+	 */
+	for (i = 0; i < 5; ++i) {
+		rc = spdk_accel_submit_copy(g_ch, buf, buf, sizeof(buf), ut_spread_cb, &status);
+		CU_ASSERT_EQUAL(rc, 0);
+	}
+	CU_ASSERT_EQUAL(g_spread_num_tasks[0], 4);
+	CU_ASSERT_EQUAL(g_spread_num_tasks[1], 1);
+	CU_ASSERT_EQUAL(dispatch.modules[0].outstanding, 4);
+	CU_ASSERT_EQUAL(dispatch.modules[1].outstanding, 1);
+
+	/* mod0 running out of resources makes the task spill over to mod1 */
+	g_spread_submit_status[0] = -ENOMEM;
+	rc = spdk_accel_submit_copy(g_ch, buf, buf, sizeof(buf), ut_spread_cb, &status);
+	CU_ASSERT_EQUAL(rc, 0);
+	CU_ASSERT_EQUAL(g_spread_num_tasks[1], 2);
+	CU_ASSERT_EQUAL(dispatch.modules[0].outstanding, 4);
+	CU_ASSERT_EQUAL(dispatch.modules[1].outstanding, 2);
+	CU_ASSERT_EQUAL(stats->modules[1].spilled, 1);
+
+	/* If both modules are out of resources, the submission fails */
+	g_spread_submit_status[1] = -ENOMEM;
+	rc = spdk_accel_submit_copy(g_ch, buf, buf, sizeof(buf), ut_spread_cb, &status);
+	CU_ASSERT_EQUAL(rc, -ENOMEM);
+	CU_ASSERT_EQUAL(dispatch.modules[0].outstanding, 4);
+	CU_ASSERT_EQUAL(dispatch.modules[1].outstanding, 2);
+	CU_ASSERT_EQUAL(stats->failed, 1);
+	g_spread_submit_status[0] = 0;
+	g_spread_submit_status[1] = 0;
+
+	while (g_spread_num_tasks[0] > 0) {
+		ut_spread_complete(0);
+	}
+	while (g_spread_num_tasks[1] > 0) {
+		ut_spread_complete(1);
+	}
+	CU_ASSERT_EQUAL(dispatch.modules[0].outstanding, 0);
+	CU_ASSERT_EQUAL(dispatch.modules[1].outstanding, 0);
+	CU_ASSERT_EQUAL(stats->executed, 8);
+	CU_ASSERT_EQUAL(stats->modules[0].executed, 5);
+	CU_ASSERT_EQUAL(stats->modules[1].executed, 3);
+
+	g_accel_ch->dispatch[SPDK_ACCEL_OPC_COPY] = NULL;
+	g_modules_opc[SPDK_ACCEL_OPC_COPY] = saved_module;
+}
+
 struct ut_sequence {
 	bool complete;
 	int status;
@@ -3209,6 +3479,69 @@ test_sequence_crypto(void)
 	spdk_put_io_channel(ioch);
 	poll_threads();
 }
+
+static void
+test_sequence_crypto_key_cache(void)
+{
+	struct spdk_accel_crypto_key *key[3];
+	struct spdk_accel_crypto_key_create_param key_params[3] = {
+		{
+			.cipher = "AES_XTS",
+			.hex_key = "00112233445566778899aabbccddeeff",
+			.hex_key2 = "ffeeddccbbaa99887766554433221100",
+			.key_name = "ut_key0",
+		},
+		{
+			.cipher = "AES_XTS",
+			.hex_key = "00112233445566778899aabbccddeeff",
+			.hex_key2 = "ffeeddccbbaa99887766554433221100",
+			.key_name = "ut_key1",
+		},
+		{
+			.cipher = "AES_XTS",
+			.hex_key = "112233445566778899aabbccddeeff00",
+			.hex_key2 = "ffeeddccbbaa99887766554433221100",
+			.key_name = "ut_key2",
+		},
+	};
+	struct accel_sw_key_cache_stats stats;
+	struct sw_accel_crypto_key_data *key_data;
+	int i, rc;
+
+	for (i = 0; i < 3; i++) {
+		rc = spdk_accel_crypto_key_create(&key_params[i]);
+		CU_ASSERT_EQUAL(rc, 0);
+		key[i] = spdk_accel_crypto_key_get(key_params[i].key_name);
+		SPDK_CU_ASSERT_FATAL(key[i] != NULL);
+		SPDK_CU_ASSERT_FATAL(key[i]->priv != NULL);
+	}
+
+	/* The first two keys use the same key material, so they share the key schedules */
+	CU_ASSERT_EQUAL(key[0]->priv, key[1]->priv);
+	CU_ASSERT_NOT_EQUAL(key[0]->priv, key[2]->priv);
+	key_data = key[1]->priv;
+	CU_ASSERT_EQUAL(key_data->refcnt, 2);
+
+	accel_sw_get_key_cache_stats(&stats);
+	CU_ASSERT_EQUAL(stats.num_keys, 3);
+	CU_ASSERT(stats.arena_size >= 2 * sizeof(struct sw_accel_crypto_key_data));
+
+	/* The shared schedules are kept as long as any of the keys is using them */
+	rc = spdk_accel_crypto_key_destroy(key[0]);
+	CU_ASSERT_EQUAL(rc, 0);
+	accel_sw_get_key_cache_stats(&stats);
+	CU_ASSERT_EQUAL(stats.num_keys, 2);
+	CU_ASSERT_EQUAL(RB_FIND(sw_accel_key_tree, &g_sw_key_cache.tree, key_data), key_data);
+	CU_ASSERT_EQUAL(key_data->refcnt, 1);
+
+	rc = spdk_accel_crypto_key_destroy(key[1]);
+	CU_ASSERT_EQUAL(rc, 0);
+	rc = spdk_accel_crypto_key_destroy(key[2]);
+	CU_ASSERT_EQUAL(rc, 0);
+	accel_sw_get_key_cache_stats(&stats);
+	CU_ASSERT_EQUAL(stats.num_keys, 0);
+	CU_ASSERT(RB_EMPTY(&g_sw_key_cache.tree));
+}
 #endif /* SPDK_CONFIG_ISAL_CRYPTO */
 
 static int
@@ -3933,7 +4266,8 @@ test_sequence_crc32(void)
 	g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count = 0;
 
 	/* Now check copy+crc - This should not remove the copy. Otherwise the data does not
-	 * end up where the user expected it to be. */
+	 * end up where the user expected it to be.  Both operations are executed by the same
+	 * module, so they should be fused into a single copy_crc32c operation. */
 	seq = NULL;
 	completed = 0;
 	crc = 0;
@@ -3962,12 +4296,12 @@ test_sequence_crc32(void)
 	CU_ASSERT_EQUAL(completed, 2);
 	CU_ASSERT(ut_seq.complete);
 	CU_ASSERT_EQUAL(ut_seq.status, 0);
-	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count, 1);
-	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_COPY].count, 1);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count, 0);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_COPY].count, 0);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_COPY_CRC32C].count, 1);
 	CU_ASSERT_EQUAL(memcmp(buf, tmp[0], sizeof(buf)), 0);
 	CU_ASSERT_EQUAL(crc, spdk_crc32c_update(buf, sizeof(buf), ~0u));
-	g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count = 0;
-	g_seq_operations[SPDK_ACCEL_OPC_COPY].count = 0;
+	g_seq_operations[SPDK_ACCEL_OPC_COPY_CRC32C].count = 0;
 
 	/* Check crc+copy - Again, the copy cannot be removed. */
 	seq = NULL;
@@ -4118,6 +4452,185 @@ test_sequence_crc32(void)
 	poll_threads();
 }
 
+static bool g_fused_crc32c_seen;
+
+static bool
+ut_supports_fused_crc32c(enum spdk_accel_opcode opcode)
+{
+	return opcode == SPDK_ACCEL_OPC_DECOMPRESS;
+}
+
+static int
+ut_submit_decompress_fused_crc32c(struct spdk_io_channel *ch, struct spdk_accel_task *task)
+{
+	struct spdk_accel_task *fused = task->fused_crc32c;
+
+	spdk_iovmove(task->s.iovs, task->s.iovcnt, task->d.iovs, task->d.iovcnt);
+	if (fused != NULL) {
+		g_fused_crc32c_seen = true;
+		*fused->crc_dst = spdk_crc32c_iov_update(task->d.iovs, task->d.iovcnt, ~fused->seed);
+	}
+
+	spdk_accel_task_complete(task, 0);
+
+	return 0;
+}
+
+static void
+test_sequence_crc32_fused(void)
+{
+	struct spdk_accel_sequence *seq = NULL;
+	struct spdk_io_channel *ioch;
+	struct ut_sequence ut_seq;
+	struct accel_module modules[SPDK_ACCEL_OPC_LAST];
+	char buf[4096], tmp[2][4096];
+	struct iovec src_iovs[3], dst_iovs[3];
+	uint32_t crc, crc2;
+	int i, rc, completed;
+
+	ioch = spdk_accel_get_io_channel();
+	SPDK_CU_ASSERT_FATAL(ioch != NULL);
+
+	/* Override the submit_tasks function */
+	g_module_if.submit_tasks = ut_sequence_submit_tasks;
+	g_module_if.supports_fused_crc32c = ut_supports_fused_crc32c;
+	for (i = 0; i < SPDK_ACCEL_OPC_LAST; ++i) {
+		g_seq_operations[i].submit = sw_accel_submit_tasks;
+		modules[i] = g_modules_opc[i];
+		g_modules_opc[i] = g_module;
+	}
+	g_seq_operations[SPDK_ACCEL_OPC_DECOMPRESS].submit = ut_submit_decompress_fused_crc32c;
+
+	/* Check decompress+crc - the crc should be calculated by the decompress operation */
+	seq = NULL;
+	completed = 0;
+	crc = 0;
+	g_fused_crc32c_seen = false;
+	memset(&tmp[0], 0x5a, sizeof(tmp[0]));
+	memset(&tmp[1], 0, sizeof(tmp[1]));
+
+	dst_iovs[0].iov_base = tmp[1];
+	dst_iovs[0].iov_len = sizeof(tmp[1]);
+	src_iovs[0].iov_base = tmp[0];
+	src_iovs[0].iov_len = sizeof(tmp[0]);
+	rc = spdk_accel_append_decompress(&seq, ioch, &dst_iovs[0], 1, NULL, NULL,
+					  &src_iovs[0], 1, NULL, NULL,
+					  ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	src_iovs[1].iov_base = tmp[1];
+	src_iovs[1].iov_len = sizeof(tmp[1]);
+	rc = spdk_accel_append_crc32c(&seq, ioch, &crc, &src_iovs[1], 1, NULL, NULL, 0,
+				      ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	ut_seq.complete = false;
+	spdk_accel_sequence_finish(seq, ut_sequence_complete_cb, &ut_seq);
+
+	poll_threads();
+	CU_ASSERT_EQUAL(completed, 2);
+	CU_ASSERT(ut_seq.complete);
+	CU_ASSERT_EQUAL(ut_seq.status, 0);
+	CU_ASSERT(g_fused_crc32c_seen);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_DECOMPRESS].count, 1);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count, 0);
+	CU_ASSERT_EQUAL(memcmp(tmp[0], tmp[1], sizeof(tmp[0])), 0);
+	CU_ASSERT_EQUAL(crc, spdk_crc32c_update(tmp[0], sizeof(tmp[0]), ~0u));
+	g_seq_operations[SPDK_ACCEL_OPC_DECOMPRESS].count = 0;
+
+	/* Check decompress+crc+crc - only the first crc can be fused, the other one needs to be
+	 * executed separately */
+	seq = NULL;
+	completed = 0;
+	crc = crc2 = 0;
+	g_fused_crc32c_seen = false;
+	memset(&tmp[0], 0xa5, sizeof(tmp[0]));
+	memset(&tmp[1], 0, sizeof(tmp[1]));
+
+	dst_iovs[0].iov_base = tmp[1];
+	dst_iovs[0].iov_len = sizeof(tmp[1]);
+	src_iovs[0].iov_base = tmp[0];
+	src_iovs[0].iov_len = sizeof(tmp[0]);
+	rc = spdk_accel_append_decompress(&seq, ioch, &dst_iovs[0], 1, NULL, NULL,
+					  &src_iovs[0], 1, NULL, NULL,
+					  ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	src_iovs[1].iov_base = tmp[1];
+	src_iovs[1].iov_len = sizeof(tmp[1]);
+	rc = spdk_accel_append_crc32c(&seq, ioch, &crc, &src_iovs[1], 1, NULL, NULL, 0,
+				      ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	src_iovs[2].iov_base = tmp[1];
+	src_iovs[2].iov_len = sizeof(tmp[1]);
+	rc = spdk_accel_append_crc32c(&seq, ioch, &crc2, &src_iovs[2], 1, NULL, NULL, 0,
+				      ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	ut_seq.complete = false;
+	spdk_accel_sequence_finish(seq, ut_sequence_complete_cb, &ut_seq);
+
+	poll_threads();
+	CU_ASSERT_EQUAL(completed, 3);
+	CU_ASSERT(ut_seq.complete);
+	CU_ASSERT_EQUAL(ut_seq.status, 0);
+	CU_ASSERT(g_fused_crc32c_seen);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_DECOMPRESS].count, 1);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count, 1);
+	CU_ASSERT_EQUAL(crc, spdk_crc32c_update(tmp[0], sizeof(tmp[0]), ~0u));
+	CU_ASSERT_EQUAL(crc, crc2);
+	g_seq_operations[SPDK_ACCEL_OPC_DECOMPRESS].count = 0;
+	g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count = 0;
+
+	/* Check that the crc isn't fused if it's calculated over a different buffer */
+	seq = NULL;
+	completed = 0;
+	crc = 0;
+	g_fused_crc32c_seen = false;
+	memset(&tmp[0], 0xfe, sizeof(tmp[0]));
+	memset(&tmp[1], 0, sizeof(tmp[1]));
+	memset(buf, 0xa5, sizeof(buf));
+
+	dst_iovs[0].iov_base = tmp[1];
+	dst_iovs[0].iov_len = sizeof(tmp[1]);
+	src_iovs[0].iov_base = tmp[0];
+	src_iovs[0].iov_len = sizeof(tmp[0]);
+	rc = spdk_accel_append_decompress(&seq, ioch, &dst_iovs[0], 1, NULL, NULL,
+					  &src_iovs[0], 1, NULL, NULL,
+					  ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	src_iovs[1].iov_base = buf;
+	src_iovs[1].iov_len = sizeof(buf);
+	rc = spdk_accel_append_crc32c(&seq, ioch, &crc, &src_iovs[1], 1, NULL, NULL, 0,
+				      ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	ut_seq.complete = false;
+	spdk_accel_sequence_finish(seq, ut_sequence_complete_cb, &ut_seq);
+
+	poll_threads();
+	CU_ASSERT_EQUAL(completed, 2);
+	CU_ASSERT(ut_seq.complete);
+	CU_ASSERT_EQUAL(ut_seq.status, 0);
+	CU_ASSERT(!g_fused_crc32c_seen);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_DECOMPRESS].count, 1);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count, 1);
+	CU_ASSERT_EQUAL(crc, spdk_crc32c_update(buf, sizeof(buf), ~0u));
+	g_seq_operations[SPDK_ACCEL_OPC_DECOMPRESS].count = 0;
+	g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count = 0;
+
+	g_module_if.supports_fused_crc32c = NULL;
+	for (i = 0; i < SPDK_ACCEL_OPC_LAST; ++i) {
+		g_modules_opc[i] = modules[i];
+	}
+
+	ut_clear_operations();
+	spdk_put_io_channel(ioch);
+	poll_threads();
+}
+
 static void
 test_sequence_dix_generate_verify(void)
 {
@@ -4418,10 +4931,12 @@ main(int argc, char **argv)
 	CU_ADD_TEST(seq_suite, test_sequence_module_memory_domain);
 #ifdef SPDK_CONFIG_ISAL_CRYPTO /* accel_sw requires isa-l-crypto for crypto operations */
 	CU_ADD_TEST(seq_suite, test_sequence_crypto);
+	CU_ADD_TEST(seq_suite, test_sequence_crypto_key_cache);
 #endif
 	CU_ADD_TEST(seq_suite, test_sequence_driver);
 	CU_ADD_TEST(seq_suite, test_sequence_same_iovs);
 	CU_ADD_TEST(seq_suite, test_sequence_crc32);
+	CU_ADD_TEST(seq_suite, test_sequence_crc32_fused);
 	CU_ADD_TEST(seq_suite, test_sequence_dix_generate_verify);
 	CU_ADD_TEST(seq_suite, test_sequence_dix);
 
@@ -4431,6 +4946,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_spdk_accel_submit_copy);
 	CU_ADD_TEST(suite, test_spdk_accel_submit_dualcast);
 	CU_ADD_TEST(suite, test_spdk_accel_submit_compare);
+	CU_ADD_TEST(suite, test_spdk_accel_submit_check_zero);
 	CU_ADD_TEST(suite, test_spdk_accel_submit_fill);
 	CU_ADD_TEST(suite, test_spdk_accel_submit_crc32c);
 	CU_ADD_TEST(suite, test_spdk_accel_submit_crc32cv);
@@ -4438,6 +4954,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_spdk_accel_submit_xor);
 	CU_ADD_TEST(suite, test_spdk_accel_module_find_by_name);
 	CU_ADD_TEST(suite, test_spdk_accel_module_register);
+	CU_ADD_TEST(suite, test_spdk_accel_spread_modules);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 	CU_cleanup_registry();
@@ -0,0 +1,172 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2026 Samsung Electronics Co., Ltd.
+ *   All rights reserved.
+ */
+
+#include "spdk_internal/cunit.h"
+#include "spdk_internal/mock.h"
+#include "spdk_internal/thread.h"
+#include "spdk/accel_module.h"
+#include "common/lib/ut_multithread.c"
+#include "accel/accel_sw.c"
+#include "accel/accel_sw_async.c"
+#include "unit/lib/json_mock.c"
+
+DEFINE_STUB_V(spdk_accel_module_list_add, (struct spdk_accel_module_if *accel_module));
+DEFINE_STUB_V(spdk_accel_module_finish, (void));
+DEFINE_STUB_V(spdk_unaffinitize_thread, (void));
+
+struct spdk_accel_module_if *
+spdk_accel_get_module(const char *name)
+{
+	return strcmp(name, "software") == 0 ? &g_sw_module : NULL;
+}
+
+static int g_completed;
+static int g_status;
+
+void
+spdk_accel_task_complete(struct spdk_accel_task *task, int status)
+{
+	g_completed++;
+	g_status = status;
+}
+
+static void
+wait_for_completions(int count)
+{
+	int i;
+
+	/* The tasks are executed asynchronously by the workers, so give them some time */
+	for (i = 0; i < 1000 && g_completed < count; ++i) {
+		poll_threads();
+		usleep(1000);
+	}
+}
+
+static void
+test_sw_async_disabled(void)
+{
+	int rc;
+
+	CU_ASSERT(!accel_sw_async_supports_opcode(SPDK_ACCEL_OPC_CRC32C));
+	CU_ASSERT_EQUAL(accel_sw_async_module_init(), -ENODEV);
+
+	rc = accel_sw_async_enable(0);
+	CU_ASSERT_EQUAL(rc, -EINVAL);
+	rc = accel_sw_async_enable(ACCEL_SW_ASYNC_MAX_WORKERS + 1);
+	CU_ASSERT_EQUAL(rc, -EINVAL);
+	CU_ASSERT(!g_sw_async.enabled);
+}
+
+static void
+test_sw_async_execute(void)
+{
+	struct accel_sw_async_task tasks[4] = {};
+	struct spdk_io_channel *ch;
+	struct accel_sw_async_channel *async_ch;
+	struct iovec iov = {};
+	char buf[4096];
+	uint32_t crc[4];
+	int i, rc;
+
+	rc = accel_sw_async_enable(2);
+	CU_ASSERT_EQUAL(rc, 0);
+	CU_ASSERT(accel_sw_async_supports_opcode(SPDK_ACCEL_OPC_CRC32C));
+	CU_ASSERT(accel_sw_async_supports_opcode(SPDK_ACCEL_OPC_COMPRESS));
+	CU_ASSERT(!accel_sw_async_supports_opcode(SPDK_ACCEL_OPC_ENCRYPT));
+	CU_ASSERT(!accel_sw_async_supports_opcode(SPDK_ACCEL_OPC_COPY));
+
+	rc = accel_sw_async_module_init();
+	CU_ASSERT_EQUAL(rc, 0);
+
+	set_thread(0);
+	ch = accel_sw_async_get_io_channel();
+	SPDK_CU_ASSERT_FATAL(ch != NULL);
+	async_ch = spdk_io_channel_get_ctx(ch);
+
+	/* The completion poller doesn't run until tasks are submitted */
+	poll_threads();
+	CU_ASSERT_STRING_EQUAL(spdk_poller_get_state_str(async_ch->poller), "paused");
+
+	memset(buf, 0xa5, sizeof(buf));
+	iov.iov_base = buf;
+	iov.iov_len = sizeof(buf);
+
+	/* Submit a single task */
+	g_completed = 0;
+	g_status = -1;
+	tasks[0].task.op_code = SPDK_ACCEL_OPC_CRC32C;
+	tasks[0].task.s.iovs = &iov;
+	tasks[0].task.s.iovcnt = 1;
+	tasks[0].task.crc_dst = &crc[0];
+	tasks[0].task.seed = 0;
+
+	rc = accel_sw_async_submit_tasks(ch, &tasks[0].task);
+	CU_ASSERT_EQUAL(rc, 0);
+	wait_for_completions(1);
+	CU_ASSERT_EQUAL(g_completed, 1);
+	CU_ASSERT_EQUAL(g_status, 0);
+	CU_ASSERT_EQUAL(crc[0], spdk_crc32c_update(buf, sizeof(buf), ~0u));
+	CU_ASSERT_EQUAL(async_ch->num_outstanding, 0);
+	poll_threads();
+	CU_ASSERT_STRING_EQUAL(spdk_poller_get_state_str(async_ch->poller), "paused");
+
+	/* Submit a list of tasks at once */
+	g_completed = 0;
+	for (i = 0; i < (int)SPDK_COUNTOF(tasks); ++i) {
+		tasks[i].task.op_code = SPDK_ACCEL_OPC_CRC32C;
+		tasks[i].task.s.iovs = &iov;
+		tasks[i].task.s.iovcnt = 1;
+		tasks[i].task.crc_dst = &crc[i];
+		tasks[i].task.seed = i;
+		crc[i] = 0;
+		if (i > 0) {
+			STAILQ_NEXT(&tasks[i - 1].task, link) = &tasks[i].task;
+		}
+	}
+	STAILQ_NEXT(&tasks[SPDK_COUNTOF(tasks) - 1].task, link) = NULL;
+
+	rc = accel_sw_async_submit_tasks(ch, &tasks[0].task);
+	CU_ASSERT_EQUAL(rc, 0);
+	wait_for_completions(SPDK_COUNTOF(tasks));
+	CU_ASSERT_EQUAL(g_completed, (int)SPDK_COUNTOF(tasks));
+	for (i = 0; i < (int)SPDK_COUNTOF(tasks); ++i) {
+		CU_ASSERT_EQUAL(crc[i], spdk_crc32c_update(buf, sizeof(buf), ~(uint32_t)i));
+	}
+	poll_threads();
+	CU_ASSERT_STRING_EQUAL(spdk_poller_get_state_str(async_ch->poller), "paused");
+
+	spdk_put_io_channel(ch);
+	poll_threads();
+
+	accel_sw_async_module_fini(NULL);
+	poll_threads();
+	CU_ASSERT(g_sw_async.workers == NULL);
+	CU_ASSERT(g_sw_async.ring == NULL);
+	g_sw_async.enabled = false;
+}
+
+int
+main(int argc, char **argv)
+{
+	CU_pSuite suite = NULL;
+	unsigned int num_failures;
+
+	CU_initialize_registry();
+
+	suite = CU_add_suite("accel_sw_async", NULL, NULL);
+
+	CU_ADD_TEST(suite, test_sw_async_disabled);
+	CU_ADD_TEST(suite, test_sw_async_execute);
+
+	allocate_threads(1);
+	set_thread(0);
+
+	num_failures = spdk_ut_run_tests(argc, argv, NULL);
+	CU_cleanup_registry();
+
+	free_threads();
+
+	return num_failures;
+}
@@ -6693,6 +6693,241 @@ bdev_copy_split_test(void)
 	ut_fini_bdev();
 }
 
+static bool g_copy_between_done;
+static int g_copy_between_status;
+
+static void
+copy_between_done(void *cb_arg, int status)
+{
+	g_copy_between_done = true;
+	g_copy_between_status = status;
+}
+
+static uint64_t g_copy_between_progress_blocks;
+static bool g_copy_between_progress_stop;
+
+static bool
+copy_between_progress(void *cb_arg, uint64_t num_blocks)
+{
+	g_copy_between_progress_blocks += num_blocks;
+
+	return !g_copy_between_progress_stop;
+}
+
+static void
+bdev_copy_between_test(void)
+{
+	struct spdk_bdev *bdev;
+	struct spdk_bdev_desc *desc = NULL;
+	struct spdk_io_channel *ioch;
+	struct ut_expected_io *expected_io;
+	struct spdk_bdev_copy_opts opts;
+	struct spdk_iobuf_opts iobuf_opts;
+	uint64_t src_offset, num_blocks, chunk_blocks, max_chunk_blocks;
+	uint32_t i;
+	int rc;
+
+	ut_init_bdev(NULL);
+	bdev = allocate_bdev("bdev");
+
+	rc = spdk_bdev_open_ext("bdev", true, bdev_ut_event_cb, NULL, &desc);
+	CU_ASSERT_EQUAL(rc, 0);
+	SPDK_CU_ASSERT_FATAL(desc != NULL);
+	ioch = spdk_bdev_get_io_channel(desc);
+	SPDK_CU_ASSERT_FATAL(ioch != NULL);
+
+	fn_table.submit_request = stub_submit_request;
+	g_io_exp_status = SPDK_BDEV_IO_STATUS_SUCCESS;
+
+	spdk_bdev_copy_opts_init(&opts, sizeof(opts));
+	opts.queue_depth = 2;
+	opts.chunk_size = 4096;
+	chunk_blocks = opts.chunk_size / bdev->blocklen;
+
+	/* Overlapping ranges on the same bdev are rejected */
+	rc = spdk_bdev_copy_between(desc, ioch, 0, desc, ioch, 4, 8, &opts, copy_between_done, NULL);
+	CU_ASSERT_EQUAL(rc, -EINVAL);
+
+	/* Chunk size must be a multiple of the block size */
+	opts.chunk_size = 1000;
+	rc = spdk_bdev_copy_between(desc, ioch, 0, desc, ioch, 64, 8, &opts, copy_between_done, NULL);
+	CU_ASSERT_EQUAL(rc, -EINVAL);
+	opts.chunk_size = 4096;
+
+	/* Same bdev supporting copy: each chunk is offloaded, at most 2 at a time and the
+	 * progress callback is called for each of them */
+	opts.progress_cb = copy_between_progress;
+	g_copy_between_progress_blocks = 0;
+	g_copy_between_progress_stop = false;
+	num_blocks = chunk_blocks * 3;
+	src_offset = bdev->blockcnt - num_blocks;
+	for (i = 0; i < 3; i++) {
+		expected_io = ut_alloc_expected_copy_io(SPDK_BDEV_IO_TYPE_COPY, i * chunk_blocks,
+							src_offset + i * chunk_blocks, chunk_blocks);
+		TAILQ_INSERT_TAIL(&g_bdev_ut_channel->expected_io, expected_io, link);
+	}
+
+	g_copy_between_done = false;
+	rc = spdk_bdev_copy_between(desc, ioch, src_offset, desc, ioch, 0, num_blocks, &opts,
+				    copy_between_done, NULL);
+	CU_ASSERT_EQUAL(rc, 0);
+	poll_threads();
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 2);
+	stub_complete_io(1);
+	poll_threads();
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 2);
+	CU_ASSERT(g_copy_between_done == false);
+	stub_complete_io(2);
+	poll_threads();
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 0);
+	CU_ASSERT(g_copy_between_done == true);
+	CU_ASSERT(g_copy_between_status == 0);
+	CU_ASSERT(g_copy_between_progress_blocks == num_blocks);
+	CU_ASSERT(TAILQ_EMPTY(&g_bdev_ut_channel->expected_io));
+
+	/* Progress callback stopping the copy: the chunk in flight is completed, but no new
+	 * chunks are submitted and the copy fails with -ECANCELED */
+	for (i = 0; i < 2; i++) {
+		expected_io = ut_alloc_expected_copy_io(SPDK_BDEV_IO_TYPE_COPY, i * chunk_blocks,
+							src_offset + i * chunk_blocks, chunk_blocks);
+		TAILQ_INSERT_TAIL(&g_bdev_ut_channel->expected_io, expected_io, link);
+	}
+
+	g_copy_between_done = false;
+	g_copy_between_progress_blocks = 0;
+	g_copy_between_progress_stop = true;
+	rc = spdk_bdev_copy_between(desc, ioch, src_offset, desc, ioch, 0, num_blocks, &opts,
+				    copy_between_done, NULL);
+	CU_ASSERT_EQUAL(rc, 0);
+	poll_threads();
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 2);
+	stub_complete_io(1);
+	poll_threads();
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 1);
+	CU_ASSERT(g_copy_between_done == false);
+	stub_complete_io(1);
+	poll_threads();
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 0);
+	CU_ASSERT(g_copy_between_done == true);
+	CU_ASSERT(g_copy_between_status == -ECANCELED);
+	CU_ASSERT(g_copy_between_progress_blocks == chunk_blocks * 2);
+	CU_ASSERT(TAILQ_EMPTY(&g_bdev_ut_channel->expected_io));
+
+	/* Stopping once all of the chunks have been submitted doesn't fail the copy */
+	num_blocks = chunk_blocks;
+	expected_io = ut_alloc_expected_copy_io(SPDK_BDEV_IO_TYPE_COPY, 0, src_offset,
+						chunk_blocks);
+	TAILQ_INSERT_TAIL(&g_bdev_ut_channel->expected_io, expected_io, link);
+
+	g_copy_between_done = false;
+	g_copy_between_progress_blocks = 0;
+	rc = spdk_bdev_copy_between(desc, ioch, src_offset, desc, ioch, 0, num_blocks, &opts,
+				    copy_between_done, NULL);
+	CU_ASSERT_EQUAL(rc, 0);
+	poll_threads();
+	stub_complete_io(1);
+	poll_threads();
+	CU_ASSERT(g_copy_between_done == true);
+	CU_ASSERT(g_copy_between_status == 0);
+	CU_ASSERT(g_copy_between_progress_blocks == chunk_blocks);
+	CU_ASSERT(TAILQ_EMPTY(&g_bdev_ut_channel->expected_io));
+	opts.progress_cb = NULL;
+
+	/* Neither copy nor zcopy supported: each chunk is read and then written from the
+	 * same buffer */
+	ut_enable_io_type(SPDK_BDEV_IO_TYPE_COPY, false);
+	ut_enable_io_type(SPDK_BDEV_IO_TYPE_ZCOPY, false);
+
+	num_blocks = chunk_blocks * 2;
+	src_offset = bdev->blockcnt - num_blocks;
+	for (i = 0; i < 2; i++) {
+		expected_io = ut_alloc_expected_io(SPDK_BDEV_IO_TYPE_READ, src_offset + i * chunk_blocks,
+						   chunk_blocks, 0);
+		TAILQ_INSERT_TAIL(&g_bdev_ut_channel->expected_io, expected_io, link);
+	}
+	for (i = 0; i < 2; i++) {
+		expected_io = ut_alloc_expected_io(SPDK_BDEV_IO_TYPE_WRITE, i * chunk_blocks,
+						   chunk_blocks, 0);
+		TAILQ_INSERT_TAIL(&g_bdev_ut_channel->expected_io, expected_io, link);
+	}
+
+	g_copy_between_done = false;
+	rc = spdk_bdev_copy_between(desc, ioch, src_offset, desc, ioch, 0, num_blocks, &opts,
+				    copy_between_done, NULL);
+	CU_ASSERT_EQUAL(rc, 0);
+	poll_threads();
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 2);
+	stub_complete_io(2);
+	poll_threads();
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 2);
+	CU_ASSERT(g_copy_between_done == false);
+	stub_complete_io(2);
+	poll_threads();
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 0);
+	CU_ASSERT(g_copy_between_done == true);
+	CU_ASSERT(g_copy_between_status == 0);
+	CU_ASSERT(TAILQ_EMPTY(&g_bdev_ut_channel->expected_io));
+
+	/* Chunks read into bdev layer buffers are limited to the size of an iobuf large buffer */
+	spdk_iobuf_get_opts(&iobuf_opts, sizeof(iobuf_opts));
+	max_chunk_blocks = iobuf_opts.large_bufsize / bdev->blocklen;
+	num_blocks = max_chunk_blocks + 8;
+	src_offset = bdev->blockcnt - num_blocks;
+	opts.chunk_size = num_blocks * bdev->blocklen;
+
+	expected_io = ut_alloc_expected_io(SPDK_BDEV_IO_TYPE_READ, src_offset, max_chunk_blocks, 0);
+	TAILQ_INSERT_TAIL(&g_bdev_ut_channel->expected_io, expected_io, link);
+	expected_io = ut_alloc_expected_io(SPDK_BDEV_IO_TYPE_READ, src_offset + max_chunk_blocks,
+					   8, 0);
+	TAILQ_INSERT_TAIL(&g_bdev_ut_channel->expected_io, expected_io, link);
+	expected_io = ut_alloc_expected_io(SPDK_BDEV_IO_TYPE_WRITE, 0, max_chunk_blocks, 0);
+	TAILQ_INSERT_TAIL(&g_bdev_ut_channel->expected_io, expected_io, link);
+	expected_io = ut_alloc_expected_io(SPDK_BDEV_IO_TYPE_WRITE, max_chunk_blocks, 8, 0);
+	TAILQ_INSERT_TAIL(&g_bdev_ut_channel->expected_io, expected_io, link);
+
+	g_copy_between_done = false;
+	rc = spdk_bdev_copy_between(desc, ioch, src_offset, desc, ioch, 0, num_blocks, &opts,
+				    copy_between_done, NULL);
+	CU_ASSERT_EQUAL(rc, 0);
+	poll_threads();
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 2);
+	stub_complete_io(2);
+	poll_threads();
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 2);
+	stub_complete_io(2);
+	poll_threads();
+	CU_ASSERT(g_copy_between_done == true);
+	CU_ASSERT(g_copy_between_status == 0);
+	CU_ASSERT(TAILQ_EMPTY(&g_bdev_ut_channel->expected_io));
+	opts.chunk_size = 4096;
+
+	/* A failed read fails the whole copy without writing anything */
+	num_blocks = chunk_blocks;
+	expected_io = ut_alloc_expected_io(SPDK_BDEV_IO_TYPE_READ, src_offset, chunk_blocks, 0);
+	TAILQ_INSERT_TAIL(&g_bdev_ut_channel->expected_io, expected_io, link);
+
+	g_copy_between_done = false;
+	rc = spdk_bdev_copy_between(desc, ioch, src_offset, desc, ioch, 0, num_blocks, &opts,
+				    copy_between_done, NULL);
+	CU_ASSERT_EQUAL(rc, 0);
+	poll_threads();
+	g_io_exp_status = SPDK_BDEV_IO_STATUS_FAILED;
+	stub_complete_io(1);
+	poll_threads();
+	g_io_exp_status = SPDK_BDEV_IO_STATUS_SUCCESS;
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 0);
+	CU_ASSERT(g_copy_between_done == true);
+	CU_ASSERT(g_copy_between_status == -EIO);
+
+	ut_enable_io_type(SPDK_BDEV_IO_TYPE_COPY, true);
+	ut_enable_io_type(SPDK_BDEV_IO_TYPE_ZCOPY, true);
+
+	spdk_put_io_channel(ioch);
+	spdk_bdev_close(desc);
+	free_bdev(bdev);
+	ut_fini_bdev();
+}
+
 static void
 examine_claim_v1(struct spdk_bdev *bdev)
 {
@@ -7623,6 +7858,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, bdev_seek_test);
 	CU_ADD_TEST(suite, bdev_copy);
 	CU_ADD_TEST(suite, bdev_copy_split_test);
+	CU_ADD_TEST(suite, bdev_copy_between_test);
 	CU_ADD_TEST(suite, examine_locks);
 	CU_ADD_TEST(suite, claim_v2_rwo);
 	CU_ADD_TEST(suite, claim_v2_rom);
@@ -176,12 +176,17 @@ spdk_bdev_io_complete(struct spdk_bdev_io *bdev_io, enum spdk_bdev_io_status sta
 	g_completion_called = true;
 }
 
+static enum spdk_accel_comp_algo g_accel_comp_algo;
+static uint32_t g_accel_comp_level;
+
 int
 spdk_accel_submit_compress_ext(struct spdk_io_channel *ch, void *dst, uint64_t nbytes,
 			       struct iovec *src_iovs, size_t src_iovcnt,
 			       enum spdk_accel_comp_algo algo, uint32_t level,
 			       uint32_t *output_size, spdk_accel_completion_cb cb_fn, void *cb_arg)
 {
+	g_accel_comp_algo = algo;
+	g_accel_comp_level = level;
 
 	return 0;
 }
@@ -192,6 +197,7 @@ spdk_accel_submit_decompress_ext(struct spdk_io_channel *ch, struct iovec *dst_i
 				 enum spdk_accel_comp_algo algo, uint32_t *output_size,
 				 spdk_accel_completion_cb cb_fn, void *cb_arg)
 {
+	g_accel_comp_algo = algo;
 
 	return 0;
 }
@@ -347,6 +353,121 @@ test_supported_io(void)
 
 }
 
+int
+spdk_accel_get_compress_level_range(enum spdk_accel_comp_algo comp_algo,
+				    uint32_t *min_level, uint32_t *max_level)
+{
+	switch (comp_algo) {
+	case SPDK_ACCEL_COMP_ALGO_DEFLATE:
+		*min_level = 0;
+		*max_level = 3;
+		return 0;
+	case SPDK_ACCEL_COMP_ALGO_LZ4:
+		/* lz4 level is the acceleration factor, the lowest one compresses the most */
+		*min_level = 1;
+		*max_level = 65537;
+		return 0;
+	default:
+		return -EINVAL;
+	}
+}
+
+static void
+test_adaptive_init(void)
+{
+	struct vbdev_comp_adaptive *adaptive = &g_comp_bdev.adaptive;
+
+	g_comp_bdev.params.flags = SPDK_REDUCE_VOL_FLAG_ADAPTIVE;
+
+	/* deflate volumes switch to lz4 with a high acceleration factor when busy */
+	g_comp_bdev.comp_algo = SPDK_ACCEL_COMP_ALGO_DEFLATE;
+	g_comp_bdev.comp_level = 1;
+	_comp_adaptive_init(&g_comp_bdev);
+	CU_ASSERT(adaptive->switch_algo);
+	CU_ASSERT(adaptive->strong_algo == SPDK_ACCEL_COMP_ALGO_DEFLATE);
+	CU_ASSERT(adaptive->strong_level == 1);
+	CU_ASSERT(adaptive->fast_algo == SPDK_ACCEL_COMP_ALGO_LZ4);
+	CU_ASSERT(adaptive->fast_level == COMP_ADAPTIVE_LZ4_FAST_LEVEL);
+	CU_ASSERT(adaptive->fast_level > 1);
+
+	/* lz4 volumes keep their level as the fast setting and switch to the strongest deflate */
+	g_comp_bdev.comp_algo = SPDK_ACCEL_COMP_ALGO_LZ4;
+	g_comp_bdev.comp_level = 4;
+	_comp_adaptive_init(&g_comp_bdev);
+	CU_ASSERT(adaptive->switch_algo);
+	CU_ASSERT(adaptive->fast_algo == SPDK_ACCEL_COMP_ALGO_LZ4);
+	CU_ASSERT(adaptive->fast_level == 4);
+	CU_ASSERT(adaptive->strong_algo == SPDK_ACCEL_COMP_ALGO_DEFLATE);
+	CU_ASSERT(adaptive->strong_level == 3);
+
+	/* Non-adaptive volumes don't switch */
+	g_comp_bdev.params.flags = 0;
+	_comp_adaptive_init(&g_comp_bdev);
+	CU_ASSERT(!adaptive->switch_algo);
+
+	g_comp_bdev.comp_algo = 0;
+	g_comp_bdev.comp_level = 0;
+}
+
+static void
+test_adaptive_algo(void)
+{
+	struct vbdev_comp_adaptive *adaptive = &g_comp_bdev.adaptive;
+	struct spdk_reduce_vol_cb_args cb_args = {};
+	struct iovec src_iov = {}, dst_iov = {};
+
+	g_comp_bdev.comp_algo = SPDK_ACCEL_COMP_ALGO_DEFLATE;
+	g_comp_bdev.comp_level = 1;
+	adaptive->fast_algo = SPDK_ACCEL_COMP_ALGO_LZ4;
+	adaptive->fast_level = 2;
+	adaptive->strong_algo = SPDK_ACCEL_COMP_ALGO_DEFLATE;
+	adaptive->strong_level = 3;
+	adaptive->use_fast = false;
+
+	/* Switch to the fast algorithm only when busy and back only when mostly idle */
+	_comp_adaptive_update_mode(adaptive, 0, 0);
+	CU_ASSERT(!adaptive->use_fast);
+	_comp_adaptive_update_mode(adaptive, 70, 30);
+	CU_ASSERT(!adaptive->use_fast);
+	_comp_adaptive_update_mode(adaptive, 90, 10);
+	CU_ASSERT(adaptive->use_fast);
+	_comp_adaptive_update_mode(adaptive, 60, 40);
+	CU_ASSERT(adaptive->use_fast);
+	_comp_adaptive_update_mode(adaptive, 30, 70);
+	CU_ASSERT(!adaptive->use_fast);
+
+	/* Without algorithm switching, the volume's algorithm is used */
+	adaptive->switch_algo = false;
+	adaptive->use_fast = true;
+	cb_args.comp_algo = SPDK_ACCEL_COMP_ALGO_DEFLATE;
+	_comp_reduce_compress(&g_comp_bdev.backing_dev, &src_iov, 1, &dst_iov, 1, &cb_args);
+	CU_ASSERT(g_accel_comp_algo == SPDK_ACCEL_COMP_ALGO_DEFLATE);
+	CU_ASSERT(g_accel_comp_level == 1);
+	CU_ASSERT(cb_args.comp_algo == SPDK_ACCEL_COMP_ALGO_DEFLATE);
+
+	/* The algorithm used is reported back to reduce */
+	adaptive->switch_algo = true;
+	adaptive->period_ticks = UINT64_MAX;
+	adaptive->last_tsc = spdk_get_ticks();
+	_comp_reduce_compress(&g_comp_bdev.backing_dev, &src_iov, 1, &dst_iov, 1, &cb_args);
+	CU_ASSERT(g_accel_comp_algo == SPDK_ACCEL_COMP_ALGO_LZ4);
+	CU_ASSERT(g_accel_comp_level == 2);
+	CU_ASSERT(cb_args.comp_algo == SPDK_ACCEL_COMP_ALGO_LZ4);
+
+	adaptive->use_fast = false;
+	_comp_reduce_compress(&g_comp_bdev.backing_dev, &src_iov, 1, &dst_iov, 1, &cb_args);
+	CU_ASSERT(g_accel_comp_algo == SPDK_ACCEL_COMP_ALGO_DEFLATE);
+	CU_ASSERT(g_accel_comp_level == 3);
+	CU_ASSERT(cb_args.comp_algo == SPDK_ACCEL_COMP_ALGO_DEFLATE);
+
+	/* Chunks are decompressed with the algorithm recorded by reduce */
+	cb_args.comp_algo = SPDK_ACCEL_COMP_ALGO_LZ4;
+	_comp_reduce_decompress(&g_comp_bdev.backing_dev, &src_iov, 1, &dst_iov, 1, &cb_args);
+	CU_ASSERT(g_accel_comp_algo == SPDK_ACCEL_COMP_ALGO_LZ4);
+
+	memset(adaptive, 0, sizeof(*adaptive));
+}
+
 int
 main(int argc, char **argv)
 {
@@ -362,6 +483,8 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_passthru);
 	CU_ADD_TEST(suite, test_supported_io);
 	CU_ADD_TEST(suite, test_reset);
+	CU_ADD_TEST(suite, test_adaptive_init);
+	CU_ADD_TEST(suite, test_adaptive_algo);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 	CU_cleanup_registry();
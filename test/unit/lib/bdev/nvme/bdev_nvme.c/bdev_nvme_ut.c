@@ -49,6 +49,21 @@ DEFINE_STUB_V(accel_channel_destroy, (void *io_device, void *ctx_buf));
 DEFINE_STUB(spdk_nvme_ctrlr_get_discovery_log_page, int,
 	    (struct spdk_nvme_ctrlr *ctrlr, spdk_nvme_discovery_cb cb_fn, void *cb_arg), 0);
 
+DEFINE_STUB(spdk_notify_type_register, struct spdk_notify_type *, (const char *type), NULL);
+
+static uint64_t g_ut_notify_count;
+static char g_ut_notify_type[SPDK_NOTIFY_MAX_NAME_SIZE];
+static char g_ut_notify_ctx[SPDK_NOTIFY_MAX_CTX_SIZE];
+
+uint64_t
+spdk_notify_send(const char *type, const char *ctx)
+{
+	snprintf(g_ut_notify_type, sizeof(g_ut_notify_type), "%s", type);
+	snprintf(g_ut_notify_ctx, sizeof(g_ut_notify_ctx), "%s", ctx);
+
+	return ++g_ut_notify_count;
+}
+
 DEFINE_RETURN_MOCK(spdk_nvme_ctrlr_get_memory_domains, int);
 
 DEFINE_STUB_V(spdk_jsonrpc_send_error_response, (struct spdk_jsonrpc_request *request,
@@ -6194,6 +6209,311 @@ test_find_io_path_min_qd(void)
 	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path1);
 }
 
+static void
+ut_tally_io_path_latency(struct nvme_io_path *io_path, uint64_t ticks, uint32_t count)
+{
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		spdk_histogram_data_tally(io_path->latency, ticks);
+		io_path->latency_ios++;
+	}
+}
+
+static void
+ut_tally_slow_io_path1(struct nvme_io_path *io_path1, struct nvme_io_path *io_path2)
+{
+	/* Each channel sees only half of the I/Os needed to judge a path. */
+	ut_tally_io_path_latency(io_path1, 10000, SLOW_IO_PATH_MIN_IOS / 2);
+	ut_tally_io_path_latency(io_path2, 1000, SLOW_IO_PATH_MIN_IOS / 2);
+}
+
+static void
+test_slow_io_path(void)
+{
+	struct nvme_path_id path1 = {}, path2 = {};
+	struct spdk_nvme_ctrlr *ctrlr1, *ctrlr2;
+	struct spdk_nvme_ctrlr_opts opts = {.hostnqn = UT_HOSTNQN};
+	struct nvme_bdev_ctrlr *nbdev_ctrlr;
+	struct nvme_ctrlr *nvme_ctrlr1, *nvme_ctrlr2;
+	struct nvme_ns *nvme_ns1, *nvme_ns2;
+	const int STRING_SIZE = 32;
+	const char *attached_names[STRING_SIZE];
+	struct nvme_bdev *bdev;
+	struct spdk_io_channel *ch1, *ch2;
+	struct nvme_bdev_channel *nbdev_ch1, *nbdev_ch2;
+	struct nvme_io_path *io_path11, *io_path12, *io_path21, *io_path22;
+	struct spdk_uuid uuid1 = { .u.raw = { 0x1 } };
+	uint32_t i;
+	int rc;
+
+	memset(attached_names, 0, sizeof(char *) * STRING_SIZE);
+	ut_init_trid(&path1.trid);
+	ut_init_trid2(&path2.trid);
+	g_ut_attach_ctrlr_status = 0;
+	g_ut_attach_bdev_count = 1;
+	g_opts.slow_io_path_factor = 3;
+	g_ut_notify_count = 0;
+
+	set_thread(0);
+
+	ctrlr1 = ut_attach_ctrlr(&path1.trid, 1, true, true);
+	SPDK_CU_ASSERT_FATAL(ctrlr1 != NULL);
+
+	ctrlr1->ns[0].uuid = &uuid1;
+
+	rc = spdk_bdev_nvme_create(&path1.trid, "nvme0", attached_names, STRING_SIZE,
+				   attach_ctrlr_done, NULL, &opts, NULL, true);
+	CU_ASSERT(rc == 0);
+
+	spdk_delay_us(1000);
+	poll_threads();
+
+	spdk_delay_us(g_opts.nvme_adminq_poll_period_us);
+	poll_threads();
+
+	nbdev_ctrlr = nvme_bdev_ctrlr_get_by_name("nvme0");
+	SPDK_CU_ASSERT_FATAL(nbdev_ctrlr != NULL);
+
+	bdev = nvme_bdev_ctrlr_get_bdev(nbdev_ctrlr, 1);
+	SPDK_CU_ASSERT_FATAL(bdev != NULL);
+
+	/* A single io_path can't be compared with anything, so it is not checked. */
+	ch1 = spdk_get_io_channel(bdev);
+	SPDK_CU_ASSERT_FATAL(ch1 != NULL);
+	nbdev_ch1 = spdk_io_channel_get_ctx(ch1);
+
+	CU_ASSERT(nbdev_ch1->slow_io_path_poller == NULL);
+
+	/* Adding the second io_path starts checking. */
+	ctrlr2 = ut_attach_ctrlr(&path2.trid, 1, true, true);
+	SPDK_CU_ASSERT_FATAL(ctrlr2 != NULL);
+
+	ctrlr2->ns[0].uuid = &uuid1;
+
+	rc = spdk_bdev_nvme_create(&path2.trid, "nvme0", attached_names, STRING_SIZE,
+				   attach_ctrlr_done, NULL, &opts, NULL, true);
+	CU_ASSERT(rc == 0);
+
+	spdk_delay_us(1000);
+	poll_threads();
+
+	spdk_delay_us(g_opts.nvme_adminq_poll_period_us);
+	poll_threads();
+
+	CU_ASSERT(nbdev_ch1->slow_io_path_poller != NULL);
+
+	set_thread(1);
+
+	ch2 = spdk_get_io_channel(bdev);
+	SPDK_CU_ASSERT_FATAL(ch2 != NULL);
+	nbdev_ch2 = spdk_io_channel_get_ctx(ch2);
+
+	CU_ASSERT(nbdev_ch2->slow_io_path_poller != NULL);
+
+	nvme_ctrlr1 = nvme_bdev_ctrlr_get_ctrlr(nbdev_ctrlr, &path1.trid, opts.hostnqn);
+	SPDK_CU_ASSERT_FATAL(nvme_ctrlr1 != NULL);
+
+	nvme_ctrlr2 = nvme_bdev_ctrlr_get_ctrlr(nbdev_ctrlr, &path2.trid, opts.hostnqn);
+	SPDK_CU_ASSERT_FATAL(nvme_ctrlr2 != NULL);
+
+	nvme_ns1 = _nvme_bdev_get_ns(bdev, nvme_ctrlr1);
+	SPDK_CU_ASSERT_FATAL(nvme_ns1 != NULL);
+
+	nvme_ns2 = _nvme_bdev_get_ns(bdev, nvme_ctrlr2);
+	SPDK_CU_ASSERT_FATAL(nvme_ns2 != NULL);
+
+	io_path11 = _bdev_nvme_get_io_path(nbdev_ch1, nvme_ns1);
+	io_path12 = _bdev_nvme_get_io_path(nbdev_ch1, nvme_ns2);
+	io_path21 = _bdev_nvme_get_io_path(nbdev_ch2, nvme_ns1);
+	io_path22 = _bdev_nvme_get_io_path(nbdev_ch2, nvme_ns2);
+	SPDK_CU_ASSERT_FATAL(io_path11 != NULL && io_path12 != NULL);
+	SPDK_CU_ASSERT_FATAL(io_path21 != NULL && io_path22 != NULL);
+
+	CU_ASSERT(bdev_nvme_find_io_path(nbdev_ch1) == io_path11);
+	CU_ASSERT(bdev_nvme_find_io_path(nbdev_ch2) == io_path21);
+
+	/* The latencies of both channels are merged per path, and the slow path is
+	 * judged and notified only once.
+	 */
+	ut_tally_slow_io_path1(io_path11, io_path12);
+	ut_tally_slow_io_path1(io_path21, io_path22);
+
+	spdk_delay_us(g_opts.slow_io_path_check_period_ms * 1000);
+	poll_threads();
+
+	CU_ASSERT(!nvme_ns1->degraded);
+	CU_ASSERT(g_ut_notify_count == 0);
+
+	ut_tally_slow_io_path1(io_path11, io_path12);
+	ut_tally_slow_io_path1(io_path21, io_path22);
+
+	spdk_delay_us(g_opts.slow_io_path_check_period_ms * 1000);
+	poll_threads();
+
+	CU_ASSERT(nvme_ns1->degraded);
+	CU_ASSERT(!nvme_ns2->degraded);
+	CU_ASSERT(g_ut_notify_count == 1);
+	CU_ASSERT(strcmp(g_ut_notify_type, "bdev_nvme_io_path_degraded") == 0);
+	CU_ASSERT(strncmp(g_ut_notify_ctx, "nvme0n1 nvme0 ", strlen("nvme0n1 nvme0 ")) == 0);
+	CU_ASSERT(strstr(g_ut_notify_ctx, "traddr:192.168.100.8 trsvcid:4420") != NULL);
+
+	/* Both channels avoid the degraded path. */
+	CU_ASSERT(bdev_nvme_find_io_path(nbdev_ch1) == io_path12);
+	CU_ASSERT(bdev_nvme_find_io_path(nbdev_ch2) == io_path22);
+
+	/* The degraded path is still used if no other path is available. */
+	nvme_ns2->ana_state = SPDK_NVME_ANA_INACCESSIBLE_STATE;
+	nbdev_ch1->current_io_path = NULL;
+	CU_ASSERT(bdev_nvme_find_io_path(nbdev_ch1) == io_path11);
+
+	nvme_ns2->ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+	nbdev_ch1->current_io_path = NULL;
+
+	/* No more notifications while the path stays slow. */
+	for (i = 0; i < 2; i++) {
+		ut_tally_slow_io_path1(io_path11, io_path12);
+		ut_tally_slow_io_path1(io_path21, io_path22);
+
+		spdk_delay_us(g_opts.slow_io_path_check_period_ms * 1000);
+		poll_threads();
+	}
+
+	CU_ASSERT(nvme_ns1->degraded);
+	CU_ASSERT(g_ut_notify_count == 1);
+
+	/* The degraded path gets no I/O and is tried again after a while. */
+	for (i = 0; i < SLOW_IO_PATH_PROBE_PERIODS + 1; i++) {
+		ut_tally_io_path_latency(io_path12, 1000, SLOW_IO_PATH_MIN_IOS);
+
+		spdk_delay_us(g_opts.slow_io_path_check_period_ms * 1000);
+		poll_threads();
+	}
+
+	CU_ASSERT(!nvme_ns1->degraded);
+	CU_ASSERT(g_ut_notify_count == 2);
+	CU_ASSERT(strcmp(g_ut_notify_type, "bdev_nvme_io_path_restored") == 0);
+	CU_ASSERT(bdev_nvme_find_io_path(nbdev_ch1) == io_path11);
+
+	/* Degrade the path again and delete the other one. The last path is restored and
+	 * checking stops.
+	 */
+	for (i = 0; i < 2; i++) {
+		ut_tally_slow_io_path1(io_path11, io_path12);
+		ut_tally_slow_io_path1(io_path21, io_path22);
+
+		spdk_delay_us(g_opts.slow_io_path_check_period_ms * 1000);
+		poll_threads();
+	}
+
+	CU_ASSERT(nvme_ns1->degraded);
+	CU_ASSERT(g_ut_notify_count == 3);
+
+	rc = bdev_nvme_delete("nvme0", &path2, NULL, NULL);
+	CU_ASSERT(rc == 0);
+
+	poll_threads();
+	spdk_delay_us(1000);
+	poll_threads();
+
+	CU_ASSERT(!nvme_ns1->degraded);
+	CU_ASSERT(g_ut_notify_count == 4);
+	CU_ASSERT(strcmp(g_ut_notify_type, "bdev_nvme_io_path_restored") == 0);
+	CU_ASSERT(nbdev_ch1->slow_io_path_poller == NULL);
+	CU_ASSERT(nbdev_ch2->slow_io_path_poller == NULL);
+
+	spdk_put_io_channel(ch2);
+
+	set_thread(0);
+
+	spdk_put_io_channel(ch1);
+
+	poll_threads();
+
+	rc = bdev_nvme_delete("nvme0", &g_any_path, NULL, NULL);
+	CU_ASSERT(rc == 0);
+
+	poll_threads();
+	spdk_delay_us(1000);
+	poll_threads();
+
+	CU_ASSERT(nvme_bdev_ctrlr_get_by_name("nvme0") == NULL);
+
+	g_opts.slow_io_path_factor = 0;
+}
+
+static void
+test_ctrlr_attach_concurrency(void)
+{
+	struct spdk_nvme_transport_id trid1 = {}, trid2 = {};
+	struct spdk_nvme_ctrlr *ctrlr1, *ctrlr2;
+	struct spdk_nvme_ctrlr_opts opts = {.hostnqn = UT_HOSTNQN};
+	const int STRING_SIZE = 32;
+	const char *attached_names[STRING_SIZE];
+	struct nvme_ctrlr *nvme_ctrlr1, *nvme_ctrlr2;
+	int rc;
+
+	memset(attached_names, 0, sizeof(char *) * STRING_SIZE);
+	ut_init_trid(&trid1);
+	ut_init_trid2(&trid2);
+
+	set_thread(0);
+
+	g_opts.ctrlr_attach_concurrency = 1;
+
+	ctrlr1 = ut_attach_ctrlr(&trid1, 0, false, false);
+	SPDK_CU_ASSERT_FATAL(ctrlr1 != NULL);
+	ctrlr2 = ut_attach_ctrlr(&trid2, 0, false, false);
+	SPDK_CU_ASSERT_FATAL(ctrlr2 != NULL);
+
+	g_ut_attach_ctrlr_status = 0;
+	g_ut_attach_bdev_count = 0;
+
+	rc = spdk_bdev_nvme_create(&trid1, "nvme0", attached_names, STRING_SIZE,
+				   attach_ctrlr_done, NULL, &opts, NULL, false);
+	CU_ASSERT(rc == 0);
+
+	rc = spdk_bdev_nvme_create(&trid2, "nvme1", attached_names, STRING_SIZE,
+				   attach_ctrlr_done, NULL, &opts, NULL, false);
+	CU_ASSERT(rc == 0);
+
+	/* The second attach is queued until the first one completes. */
+	CU_ASSERT(g_num_probe_ctxs_in_progress == 1);
+	CU_ASSERT(!TAILQ_EMPTY(&g_pending_probe_ctxs));
+
+	spdk_delay_us(1000);
+	poll_threads();
+
+	nvme_ctrlr1 = nvme_ctrlr_get_by_name("nvme0");
+	SPDK_CU_ASSERT_FATAL(nvme_ctrlr1 != NULL);
+	CU_ASSERT(nvme_ctrlr1->ctrlr == ctrlr1);
+	CU_ASSERT(nvme_ctrlr_get_by_name("nvme1") == NULL);
+	CU_ASSERT(g_num_probe_ctxs_in_progress == 1);
+	CU_ASSERT(TAILQ_EMPTY(&g_pending_probe_ctxs));
+
+	spdk_delay_us(1000);
+	poll_threads();
+
+	nvme_ctrlr2 = nvme_ctrlr_get_by_name("nvme1");
+	SPDK_CU_ASSERT_FATAL(nvme_ctrlr2 != NULL);
+	CU_ASSERT(nvme_ctrlr2->ctrlr == ctrlr2);
+	CU_ASSERT(g_num_probe_ctxs_in_progress == 0);
+
+	rc = bdev_nvme_delete("nvme0", &g_any_path, NULL, NULL);
+	CU_ASSERT(rc == 0);
+	rc = bdev_nvme_delete("nvme1", &g_any_path, NULL, NULL);
+	CU_ASSERT(rc == 0);
+
+	poll_threads();
+	spdk_delay_us(1000);
+	poll_threads();
+
+	CU_ASSERT(nvme_ctrlr_get_by_name("nvme0") == NULL);
+	CU_ASSERT(nvme_ctrlr_get_by_name("nvme1") == NULL);
+
+	g_opts.ctrlr_attach_concurrency = 0;
+}
+
 static void
 test_disable_auto_failback(void)
 {
@@ -7771,6 +8091,8 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_set_preferred_path);
 	CU_ADD_TEST(suite, test_find_next_io_path);
 	CU_ADD_TEST(suite, test_find_io_path_min_qd);
+	CU_ADD_TEST(suite, test_slow_io_path);
+	CU_ADD_TEST(suite, test_ctrlr_attach_concurrency);
 	CU_ADD_TEST(suite, test_disable_auto_failback);
 	CU_ADD_TEST(suite, test_set_multipath_policy);
 	CU_ADD_TEST(suite, test_uuid_generation);
@@ -211,13 +211,35 @@ __io_type_supported(void *ctx, enum spdk_bdev_io_type type)
 	return true;
 }
 
+static struct spdk_bdev_io *g_base_io;
+
+static void
+base_submit_request(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_io)
+{
+	CU_ASSERT(g_base_io == NULL);
+	g_base_io = bdev_io;
+}
+
+static void
+part_submit_request(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_io)
+{
+	int rc;
+
+	rc = spdk_bdev_part_submit_request(spdk_io_channel_get_ctx(ch), bdev_io);
+	if (rc != 0) {
+		spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_FAILED);
+	}
+}
+
 static struct spdk_bdev_fn_table base_fn_table = {
 	.destruct		= __destruct,
+	.submit_request		= base_submit_request,
 	.get_io_channel = part_ut_get_io_channel,
 	.io_type_supported	= __io_type_supported,
 };
 static struct spdk_bdev_fn_table part_fn_table = {
 	.destruct		= __destruct,
+	.submit_request		= part_submit_request,
 	.io_type_supported	= __io_type_supported,
 };
 
@@ -402,6 +424,92 @@ part_get_io_channel_test(void)
 	ut_fini_bdev();
 }
 
+static bool g_read_done;
+static void *g_read_buf;
+
+static void
+part_read_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	CU_ASSERT(success);
+	g_read_done = true;
+	/* The data must still be available after the base I/O has been freed */
+	CU_ASSERT(bdev_io->u.bdev.iovs[0].iov_base == g_read_buf);
+	CU_ASSERT(bdev_io->internal.buf.ptr == g_read_buf);
+	spdk_bdev_free_io(bdev_io);
+}
+
+static void
+part_read_null_buf_test(void)
+{
+	struct spdk_bdev_part_base	*base = NULL;
+	struct spdk_bdev_desc		*desc = NULL;
+	struct spdk_io_channel		*io_ch;
+	struct spdk_bdev_part		*part;
+	struct spdk_bdev		bdev_base = {};
+	SPDK_BDEV_PART_TAILQ		tailq = TAILQ_HEAD_INITIALIZER(tailq);
+	int rc;
+
+	ut_init_bdev();
+	bdev_base.name = "base";
+	bdev_base.blocklen = 512;
+	bdev_base.blockcnt = 1024;
+	bdev_base.fn_table = &base_fn_table;
+	bdev_base.module = &bdev_ut_if;
+	rc = spdk_bdev_register(&bdev_base);
+	CU_ASSERT(rc == 0);
+
+	rc = spdk_bdev_part_base_construct_ext("base", NULL, &vbdev_ut_if,
+					       &part_fn_table, &tailq, NULL,
+					       NULL, sizeof(struct spdk_bdev_part_channel),
+					       NULL, NULL, &base);
+	CU_ASSERT(rc == 0);
+	SPDK_CU_ASSERT_FATAL(base != NULL);
+
+	part = calloc(1, sizeof(*part));
+	SPDK_CU_ASSERT_FATAL(part != NULL);
+	rc = spdk_bdev_part_construct(part, base, "test", 100, 100, "test");
+	SPDK_CU_ASSERT_FATAL(rc == 0);
+
+	rc = spdk_bdev_open_ext("test", true, bdev_ut_event_cb, NULL, &desc);
+	CU_ASSERT(rc == 0);
+	SPDK_CU_ASSERT_FATAL(desc != NULL);
+	io_ch = spdk_bdev_get_io_channel(desc);
+	SPDK_CU_ASSERT_FATAL(io_ch != NULL);
+
+	/* A read without a buffer gets one for the part I/O before it is forwarded, so that it
+	 * isn't released along with the base I/O */
+	g_base_io = NULL;
+	g_read_done = false;
+	rc = spdk_bdev_read_blocks(desc, io_ch, NULL, 0, 8, part_read_done, NULL);
+	CU_ASSERT(rc == 0);
+	poll_threads();
+	SPDK_CU_ASSERT_FATAL(g_base_io != NULL);
+	CU_ASSERT(g_base_io->type == SPDK_BDEV_IO_TYPE_READ);
+	CU_ASSERT(g_base_io->u.bdev.offset_blocks == 100);
+	CU_ASSERT(g_base_io->u.bdev.iovcnt == 1);
+	g_read_buf = g_base_io->u.bdev.iovs[0].iov_base;
+	CU_ASSERT(g_read_buf != NULL);
+	CU_ASSERT(g_base_io->internal.buf.ptr == NULL);
+
+	spdk_bdev_io_complete(g_base_io, SPDK_BDEV_IO_STATUS_SUCCESS);
+	g_base_io = NULL;
+	poll_threads();
+	CU_ASSERT(g_read_done == true);
+
+	spdk_put_io_channel(io_ch);
+	spdk_bdev_close(desc);
+	spdk_bdev_unregister(&part->internal.bdev, NULL, NULL);
+	poll_threads();
+
+	rc = spdk_bdev_part_free(part);
+	CU_ASSERT(rc == 1);
+	poll_threads();
+	CU_ASSERT(TAILQ_EMPTY(&tailq));
+
+	spdk_bdev_unregister(&bdev_base, NULL, NULL);
+	ut_fini_bdev();
+}
+
 static void
 part_construct_ext(void)
 {
@@ -458,6 +566,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, part_free_test);
 	CU_ADD_TEST(suite, part_get_io_channel_test);
 	CU_ADD_TEST(suite, part_construct_ext);
+	CU_ADD_TEST(suite, part_read_null_buf_test);
 
 	allocate_cores(1);
 	allocate_threads(1);
@@ -22,6 +22,9 @@ struct io_output *g_io_output = NULL;
 uint32_t g_max_io_size;
 uint32_t g_io_output_index;
 uint32_t g_io_comp_status;
+bool g_get_buf_success = true;
+uint64_t g_get_buf_len;
+struct spdk_io_channel *g_get_buf_ch;
 uint8_t g_rpc_err;
 uint8_t g_json_decode_obj_construct;
 static TAILQ_HEAD(, spdk_bdev) g_bdev_list = TAILQ_HEAD_INITIALIZER(g_bdev_list);
@@ -36,6 +39,7 @@ struct io_output {
 	spdk_bdev_io_completion_cb  cb;
 	void                        *cb_arg;
 	enum spdk_bdev_io_type      iotype;
+	struct iovec                *iovs;
 };
 
 DEFINE_STUB_V(spdk_bdev_module_list_add, (struct spdk_bdev_module *bdev_module));
@@ -395,6 +399,7 @@ spdk_bdev_readv_blocks_with_md(struct spdk_bdev_desc *desc, struct spdk_io_chann
 	SPDK_CU_ASSERT_FATAL(g_io_output_index < g_max_io_size);
 	set_io_output(output, desc, ch, offset_blocks, num_blocks, cb, cb_arg,
 		      SPDK_BDEV_IO_TYPE_READ);
+	output->iovs = iov;
 	g_io_output_index++;
 
 	child_io = calloc(1, sizeof(struct spdk_bdev_io));
@@ -404,6 +409,19 @@ spdk_bdev_readv_blocks_with_md(struct spdk_bdev_desc *desc, struct spdk_io_chann
 	return 0;
 }
 
+void
+spdk_bdev_io_get_buf(struct spdk_bdev_io *bdev_io, spdk_bdev_io_get_buf_cb cb, uint64_t len)
+{
+	g_get_buf_len = len;
+	if (g_get_buf_success) {
+		bdev_io->u.bdev.iovs[0].iov_base = calloc(1, len);
+		SPDK_CU_ASSERT_FATAL(bdev_io->u.bdev.iovs[0].iov_base != NULL);
+		bdev_io->u.bdev.iovs[0].iov_len = len;
+	}
+
+	cb(g_get_buf_ch, bdev_io, g_get_buf_success);
+}
+
 int
 spdk_bdev_readv_blocks(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
 		       struct iovec *iov, int iovcnt,
@@ -1274,6 +1292,72 @@ test_zone_read(void)
 	test_cleanup();
 }
 
+static void
+test_zone_read_get_buf(void)
+{
+	struct spdk_io_channel *ch;
+	struct bdev_zone_block *bdev;
+	struct spdk_bdev_io *bdev_io;
+	char *name = "Nvme0n1";
+	uint32_t num_zones = 20;
+
+	init_test_globals(20 * 1024ul);
+	CU_ASSERT(zone_block_init() == 0);
+
+	/* Create zone dev */
+	bdev = create_and_get_vbdev("zone_dev1", name, num_zones, 1, true);
+
+	ch = calloc(1, sizeof(struct spdk_io_channel) + sizeof(struct zone_block_io_channel));
+	SPDK_CU_ASSERT_FATAL(ch != NULL);
+	g_get_buf_ch = ch;
+
+	bdev_io = calloc(1, sizeof(struct spdk_bdev_io) + sizeof(struct zone_block_io));
+	SPDK_CU_ASSERT_FATAL(bdev_io != NULL);
+	bdev_io_initialize(bdev_io, &bdev->bdev, 0, 2, SPDK_BDEV_IO_TYPE_READ);
+	free(bdev_io->iov.iov_base);
+	bdev_io->iov.iov_base = NULL;
+
+	/* Reads without a buffer get one before being sent to the base bdev */
+	memset(g_io_output, 0, (g_max_io_size * sizeof(struct io_output)));
+	g_io_output_index = 0;
+	g_io_comp_status = false;
+	zone_block_submit_request(ch, bdev_io);
+	CU_ASSERT(g_io_comp_status == true);
+	CU_ASSERT(g_get_buf_len == 2 * BLOCK_SIZE);
+	CU_ASSERT(g_io_output_index == 1);
+	CU_ASSERT(g_io_output[0].iotype == SPDK_BDEV_IO_TYPE_READ);
+	CU_ASSERT(g_io_output[0].offset_blocks == 0);
+	CU_ASSERT(g_io_output[0].num_blocks == 2);
+	CU_ASSERT(g_io_output[0].iovs == bdev_io->u.bdev.iovs);
+	CU_ASSERT(bdev_io->u.bdev.iovs[0].iov_base != NULL);
+	CU_ASSERT(bdev_io->u.bdev.iovs[0].iov_len == 2 * BLOCK_SIZE);
+
+	/* Failing to get a buffer fails the read without reaching the base bdev */
+	free(bdev_io->iov.iov_base);
+	bdev_io->iov.iov_base = NULL;
+	g_io_output_index = 0;
+	g_io_comp_status = true;
+	g_get_buf_success = false;
+	zone_block_submit_request(ch, bdev_io);
+	CU_ASSERT(g_io_comp_status == false);
+	CU_ASSERT(g_io_output_index == 0);
+	g_get_buf_success = true;
+
+	/* Reads with a buffer don't need another one */
+	bdev_io_cleanup(bdev_io);
+	g_get_buf_len = 0;
+	send_read_zone(bdev, ch, 0, 1, 0, true);
+	CU_ASSERT(g_get_buf_len == 0);
+
+	/* Delete zone dev */
+	send_delete_vbdev("zone_dev1", true);
+
+	while (spdk_thread_poll(g_thread, 0, 0) > 0) {}
+	g_get_buf_ch = NULL;
+	free(ch);
+	test_cleanup();
+}
+
 static void
 test_close_zone(void)
 {
@@ -1483,6 +1567,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_open_zone);
 	CU_ADD_TEST(suite, test_zone_write);
 	CU_ADD_TEST(suite, test_zone_read);
+	CU_ADD_TEST(suite, test_zone_read_get_buf);
 	CU_ADD_TEST(suite, test_close_zone);
 	CU_ADD_TEST(suite, test_finish_zone);
 	CU_ADD_TEST(suite, test_append_zone);
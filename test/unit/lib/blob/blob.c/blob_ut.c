@@ -65,6 +65,66 @@ DEFINE_STUB(spdk_memory_domain_memzero, int, (struct spdk_memory_domain *src_dom
 		void *src_domain_ctx, struct iovec *iov, uint32_t iovcnt, void (*cpl_cb)(void *, int),
 		void *cpl_cb_arg), 0);
 
+/* Accel channels are only handed out when a test registers the fake accel io_device */
+static bool g_accel_registered = false;
+static int g_accel_io_device;
+static uint32_t g_accel_check_zero_count = 0;
+
+struct spdk_io_channel *
+spdk_accel_get_io_channel(void)
+{
+	return g_accel_registered ? spdk_get_io_channel(&g_accel_io_device) : NULL;
+}
+
+static int
+ut_accel_channel_create(void *io_device, void *ctx_buf)
+{
+	return 0;
+}
+
+static void
+ut_accel_channel_destroy(void *io_device, void *ctx_buf)
+{
+}
+
+struct ut_accel_check_zero_ctx {
+	spdk_accel_completion_cb	cb_fn;
+	void				*cb_arg;
+};
+
+static void
+ut_accel_check_zero_done(void *_ctx)
+{
+	struct ut_accel_check_zero_ctx *ctx = _ctx;
+
+	ctx->cb_fn(ctx->cb_arg, 0);
+	free(ctx);
+}
+
+int
+spdk_accel_submit_check_zero(struct spdk_io_channel *ch, struct iovec *iovs, uint32_t iovcnt,
+			     bool *is_zero, spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct ut_accel_check_zero_ctx *ctx;
+	uint32_t i;
+
+	ctx = calloc(1, sizeof(*ctx));
+	SPDK_CU_ASSERT_FATAL(ctx != NULL);
+	ctx->cb_fn = cb_fn;
+	ctx->cb_arg = cb_arg;
+
+	*is_zero = true;
+	for (i = 0; i < iovcnt; i++) {
+		*is_zero = *is_zero && spdk_mem_all_zero(iovs[i].iov_base, iovs[i].iov_len);
+	}
+	g_accel_check_zero_count++;
+
+	/* Complete asynchronously, like a real accel module would */
+	spdk_thread_send_msg(spdk_get_thread(), ut_accel_check_zero_done, ctx);
+
+	return 0;
+}
+
 static bool
 is_esnap_clone(struct spdk_blob *_blob, const void *id, size_t id_len)
 {
@@ -4576,7 +4636,7 @@ blob_thin_prov_write_count_io(void)
 	CU_ASSERT(free_clusters == spdk_bs_free_cluster_count(bs));
 	CU_ASSERT(blob->active.num_clusters == SPDK_EXTENTS_PER_EP * 8);
 
-	memset(payload_write, 0, sizeof(payload_write));
+	memset(payload_write, 0xE5, sizeof(payload_write));
 	for (i = 0; i < 8; i++) {
 		write_bytes = g_dev_write_bytes;
 		read_bytes = g_dev_read_bytes;
@@ -4662,6 +4722,149 @@ blob_thin_prov_write_count_io(void)
 	g_bs = NULL;
 }
 
+static void
+blob_thin_prov_write_zero_skip(void)
+{
+	struct spdk_blob_store *bs = g_bs;
+	struct spdk_blob *blob;
+	struct spdk_io_channel *ch;
+	struct spdk_blob_opts opts;
+	struct iovec iov;
+	spdk_blob_id snapshotid;
+	uint64_t free_clusters;
+	uint64_t io_unit_size;
+	uint64_t io_units_per_cluster;
+	uint8_t payload_write[4096];
+	uint8_t payload_read[4096];
+
+	free_clusters = spdk_bs_free_cluster_count(bs);
+	io_unit_size = spdk_bs_get_io_unit_size(bs);
+	io_units_per_cluster = spdk_bs_get_cluster_size(bs) / io_unit_size;
+	SPDK_CU_ASSERT_FATAL(io_unit_size <= sizeof(payload_write));
+
+	ch = spdk_bs_alloc_io_channel(bs);
+	SPDK_CU_ASSERT_FATAL(ch != NULL);
+
+	ut_spdk_blob_opts_init(&opts);
+	opts.thin_provision = true;
+	opts.num_clusters = 4;
+
+	blob = ut_blob_create_and_open(bs, &opts);
+	CU_ASSERT(spdk_blob_get_num_allocated_clusters(blob) == 0);
+
+	/* Writing zeroes to unallocated clusters of a thin blob must not allocate them */
+	memset(payload_write, 0, sizeof(payload_write));
+	g_bserrno = -1;
+	spdk_blob_io_write(blob, ch, payload_write, 0, 1, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+
+	iov.iov_base = payload_write;
+	iov.iov_len = io_unit_size;
+	g_bserrno = -1;
+	spdk_blob_io_writev(blob, ch, &iov, 1, io_units_per_cluster, 1, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+
+	g_bserrno = -1;
+	spdk_blob_io_write_zeroes(blob, ch, 2 * io_units_per_cluster, io_units_per_cluster,
+				  blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(spdk_blob_get_num_allocated_clusters(blob) == 0);
+	CU_ASSERT(free_clusters == spdk_bs_free_cluster_count(bs));
+
+	/* Any non-zero byte still results in the cluster being allocated */
+	payload_write[io_unit_size - 1] = 0xE5;
+	g_bserrno = -1;
+	spdk_blob_io_write(blob, ch, payload_write, 0, 1, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(spdk_blob_get_num_allocated_clusters(blob) == 1);
+
+	memset(payload_read, 0, sizeof(payload_read));
+	spdk_blob_io_read(blob, ch, payload_read, 0, 1, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(memcmp(payload_write, payload_read, io_unit_size) == 0);
+
+	/* Use a channel on another thread (thread 0 already has one for metadata ops), which
+	 * offloads the zero detection to accel */
+	spdk_bs_free_io_channel(ch);
+	poll_threads();
+	spdk_io_device_register(&g_accel_io_device, ut_accel_channel_create,
+				ut_accel_channel_destroy, 0, "ut_accel");
+	g_accel_registered = true;
+	set_thread(1);
+	ch = spdk_bs_alloc_io_channel(bs);
+	SPDK_CU_ASSERT_FATAL(ch != NULL);
+	g_accel_check_zero_count = 0;
+
+	memset(payload_write, 0, sizeof(payload_write));
+	g_bserrno = -1;
+	spdk_blob_io_write(blob, ch, payload_write, io_units_per_cluster, 1,
+			   blob_op_complete, NULL);
+	CU_ASSERT(g_bserrno == -1);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(g_accel_check_zero_count == 1);
+	CU_ASSERT(spdk_blob_get_num_allocated_clusters(blob) == 1);
+
+	payload_write[0] = 0xE5;
+	g_bserrno = -1;
+	spdk_blob_io_write(blob, ch, payload_write, io_units_per_cluster, 1,
+			   blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(g_accel_check_zero_count == 2);
+	CU_ASSERT(spdk_blob_get_num_allocated_clusters(blob) == 2);
+
+	/* After taking a snapshot, zeroes written to the clone still need to allocate the clusters
+	 * which hold data in the snapshot, but not the ones that are unallocated there. */
+	set_thread(0);
+	spdk_bs_create_snapshot(bs, spdk_blob_get_id(blob), NULL, blob_op_with_id_complete, NULL);
+	poll_threads();
+	set_thread(1);
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(g_blobid != SPDK_BLOBID_INVALID);
+	snapshotid = g_blobid;
+	CU_ASSERT(spdk_blob_get_num_allocated_clusters(blob) == 0);
+
+	memset(payload_write, 0, sizeof(payload_write));
+	g_bserrno = -1;
+	spdk_blob_io_write(blob, ch, payload_write, 0, 1, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(spdk_blob_get_num_allocated_clusters(blob) == 1);
+
+	g_bserrno = -1;
+	spdk_blob_io_write(blob, ch, payload_write, 3 * io_units_per_cluster, 1,
+			   blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(spdk_blob_get_num_allocated_clusters(blob) == 1);
+
+	memset(payload_read, 0xFF, sizeof(payload_read));
+	spdk_blob_io_read(blob, ch, payload_read, 0, 1, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(spdk_mem_all_zero(payload_read, io_unit_size));
+	CU_ASSERT(g_accel_check_zero_count == 3);
+
+	spdk_bs_free_io_channel(ch);
+	poll_threads();
+	set_thread(0);
+	g_accel_registered = false;
+	spdk_io_device_unregister(&g_accel_io_device, NULL);
+	poll_threads();
+
+	ut_blob_close_and_delete(bs, blob);
+	spdk_bs_delete_blob(bs, snapshotid, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(free_clusters == spdk_bs_free_cluster_count(bs));
+}
+
 static void
 blob_thin_prov_unmap_cluster(void)
 {
@@ -10110,6 +10313,7 @@ main(int argc, char **argv)
 		CU_ADD_TEST(suite_bs, blob_insert_cluster_msg_test);
 		CU_ADD_TEST(suite_bs, blob_thin_prov_rw);
 		CU_ADD_TEST(suite, blob_thin_prov_write_count_io);
+		CU_ADD_TEST(suite_bs, blob_thin_prov_write_zero_skip);
 		CU_ADD_TEST(suite, blob_thin_prov_unmap_cluster);
 		CU_ADD_TEST(suite_bs, blob_thin_prov_rle);
 		CU_ADD_TEST(suite_bs, blob_thin_prov_rw_iov);
@@ -214,6 +214,8 @@ create_bs_dev(void)
 	CU_ASSERT(blob_bdev->desc->bdev == g_bdev);
 	CU_ASSERT(blob_bdev->desc->claim_type == SPDK_BDEV_CLAIM_NONE);
 	CU_ASSERT(bdev.claim_type == SPDK_BDEV_CLAIM_NONE);
+	/* Copy is exposed even if the bdev doesn't support it natively */
+	CU_ASSERT(bs_dev->copy != NULL);
 
 	bs_dev->destroy(bs_dev);
 	CU_ASSERT(bdev.open_cnt == 0);
@@ -491,6 +491,29 @@ static uint32_t g_active_ns_list_length = 0;
 static struct spdk_nvme_ctrlr_data *g_cdata = NULL;
 static bool g_fail_next_identify = false;
 
+/* If set, identify namespace commands are not completed until ut_complete_identify_ns() */
+static bool g_defer_identify_ns = false;
+static struct {
+	spdk_nvme_cmd_cb	cb_fn;
+	void			*cb_arg;
+} g_deferred_identify_ns[NVME_MAX_IDENTIFY_NS_OUTSTANDING + 1];
+static uint32_t g_num_deferred_identify_ns;
+static uint32_t g_num_identify_ns;
+
+static void
+ut_complete_identify_ns(void)
+{
+	spdk_nvme_cmd_cb cb_fn = g_deferred_identify_ns[0].cb_fn;
+	void *cb_arg = g_deferred_identify_ns[0].cb_arg;
+
+	SPDK_CU_ASSERT_FATAL(g_num_deferred_identify_ns > 0);
+	g_num_deferred_identify_ns--;
+	memmove(&g_deferred_identify_ns[0], &g_deferred_identify_ns[1],
+		g_num_deferred_identify_ns * sizeof(g_deferred_identify_ns[0]));
+
+	fake_cpl_sc(cb_fn, cb_arg);
+}
+
 int
 nvme_ctrlr_cmd_identify(struct spdk_nvme_ctrlr *ctrlr, uint8_t cns, uint16_t cntid, uint32_t nsid,
 			uint8_t csi, void *payload, size_t payload_size,
@@ -537,6 +560,13 @@ nvme_ctrlr_cmd_identify(struct spdk_nvme_ctrlr *ctrlr, uint8_t cns, uint16_t cnt
 		}
 	} else if (cns == SPDK_NVME_IDENTIFY_NS_IOCS) {
 		return 0;
+	} else if (cns == SPDK_NVME_IDENTIFY_NS && g_defer_identify_ns) {
+		SPDK_CU_ASSERT_FATAL(g_num_deferred_identify_ns < SPDK_COUNTOF(g_deferred_identify_ns));
+		g_deferred_identify_ns[g_num_deferred_identify_ns].cb_fn = cb_fn;
+		g_deferred_identify_ns[g_num_deferred_identify_ns].cb_arg = cb_arg;
+		g_num_deferred_identify_ns++;
+		g_num_identify_ns++;
+		return 0;
 	}
 
 	fake_cpl_sc(cb_fn, cb_arg);
@@ -2734,6 +2764,67 @@ test_nvme_ctrlr_active_ns_list_v0(void)
 	nvme_ctrlr_destruct(&ctrlr);
 }
 
+static void
+test_nvme_ctrlr_identify_namespaces_pipelined(void)
+{
+	uint32_t i;
+	DECLARE_AND_CONSTRUCT_CTRLR();
+
+	SPDK_CU_ASSERT_FATAL(nvme_ctrlr_construct(&ctrlr) == 0);
+
+	ctrlr.vs.bits.mjr = 1;
+	ctrlr.vs.bits.mnr = 0;
+	ctrlr.vs.bits.ter = 0;
+	ctrlr.cdata.nn = 3 * NVME_MAX_IDENTIFY_NS_OUTSTANDING + 1;
+
+	ctrlr.state = NVME_CTRLR_STATE_IDENTIFY_ACTIVE_NS;
+	SPDK_CU_ASSERT_FATAL(nvme_ctrlr_process_init(&ctrlr) == 0);
+	SPDK_CU_ASSERT_FATAL(ctrlr.state == NVME_CTRLR_STATE_IDENTIFY_NS);
+
+	g_defer_identify_ns = true;
+	g_num_identify_ns = 0;
+
+	/* Identify commands for the first namespaces are submitted at once */
+	CU_ASSERT(nvme_ctrlr_identify_namespaces(&ctrlr) == 0);
+	CU_ASSERT(ctrlr.state == NVME_CTRLR_STATE_WAIT_FOR_IDENTIFY_NS);
+	CU_ASSERT(ctrlr.identify_ns_outstanding == NVME_MAX_IDENTIFY_NS_OUTSTANDING);
+	CU_ASSERT(g_num_deferred_identify_ns == NVME_MAX_IDENTIFY_NS_OUTSTANDING);
+
+	/* Each completion submits the identify command for the next namespace */
+	for (i = 0; i < ctrlr.cdata.nn - NVME_MAX_IDENTIFY_NS_OUTSTANDING; i++) {
+		ut_complete_identify_ns();
+		CU_ASSERT(ctrlr.state == NVME_CTRLR_STATE_WAIT_FOR_IDENTIFY_NS);
+		CU_ASSERT(ctrlr.identify_ns_outstanding == NVME_MAX_IDENTIFY_NS_OUTSTANDING);
+	}
+	CU_ASSERT(g_num_identify_ns == ctrlr.cdata.nn);
+
+	/* The state moves on once the last outstanding command completed */
+	for (i = 0; i < NVME_MAX_IDENTIFY_NS_OUTSTANDING - 1; i++) {
+		ut_complete_identify_ns();
+		CU_ASSERT(ctrlr.state == NVME_CTRLR_STATE_WAIT_FOR_IDENTIFY_NS);
+	}
+	ut_complete_identify_ns();
+	CU_ASSERT(ctrlr.state == NVME_CTRLR_STATE_IDENTIFY_ID_DESCS);
+	CU_ASSERT(ctrlr.identify_ns_outstanding == 0);
+
+	/* A failed identify command fails the controller once */
+	ctrlr.state = NVME_CTRLR_STATE_IDENTIFY_NS;
+	CU_ASSERT(nvme_ctrlr_identify_namespaces(&ctrlr) == 0);
+	set_status_code = SPDK_NVME_SC_INVALID_FIELD;
+	ut_complete_identify_ns();
+	set_status_code = SPDK_NVME_SC_SUCCESS;
+	CU_ASSERT(ctrlr.state == NVME_CTRLR_STATE_ERROR);
+	while (g_num_deferred_identify_ns > 0) {
+		ut_complete_identify_ns();
+		CU_ASSERT(ctrlr.state == NVME_CTRLR_STATE_ERROR);
+	}
+	CU_ASSERT(ctrlr.identify_ns_outstanding == 0);
+
+	g_defer_identify_ns = false;
+
+	nvme_ctrlr_destruct(&ctrlr);
+}
+
 static void
 test_nvme_ctrlr_active_ns_list_v2(void)
 {
@@ -3475,6 +3566,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_nvme_ctrlr_set_state);
 	CU_ADD_TEST(suite, test_nvme_ctrlr_active_ns_list_v0);
 	CU_ADD_TEST(suite, test_nvme_ctrlr_active_ns_list_v2);
+	CU_ADD_TEST(suite, test_nvme_ctrlr_identify_namespaces_pipelined);
 	CU_ADD_TEST(suite, test_nvme_ctrlr_ns_mgmt);
 	CU_ADD_TEST(suite, test_nvme_ctrlr_reset);
 	CU_ADD_TEST(suite, test_nvme_ctrlr_aer_callback);
@@ -1278,6 +1278,45 @@ test_nvme_tcp_icresp_handle(void)
 	CU_ASSERT(tqpair.flags.host_ddgst_enable == pdu.hdr.ic_resp.dgst.bits.ddgst_enable);
 }
 
+static void
+test_nvme_tcp_pdu_update_data_digest(void)
+{
+	struct nvme_tcp_pdu pdu = {};
+	uint8_t buf1[600], buf2[600];
+	uint32_t crc32c, offset, i;
+	uint32_t reads[] = { 1, 99, 500, 427 };
+
+	for (i = 0; i < sizeof(buf1); i++) {
+		buf1[i] = i;
+		buf2[i] = ~i;
+	}
+
+	/* Data length is not dword aligned and the last read also returns the digest */
+	pdu.data_iov[0].iov_base = buf1;
+	pdu.data_iov[0].iov_len = 600;
+	pdu.data_iov[1].iov_base = buf2;
+	pdu.data_iov[1].iov_len = 423;
+	pdu.data_iovcnt = 2;
+	pdu.data_len = 1023;
+	pdu.ddgst_inline = true;
+	pdu.data_digest_crc32 = SPDK_CRC32C_XOR;
+
+	offset = 0;
+	for (i = 0; i < SPDK_COUNTOF(reads); i++) {
+		nvme_tcp_pdu_update_data_digest(&pdu, offset, reads[i]);
+		offset += reads[i];
+	}
+	CU_ASSERT(offset == pdu.data_len + SPDK_NVME_TCP_DIGEST_LEN);
+
+	crc32c = nvme_tcp_pdu_pad_data_digest(&pdu, pdu.data_digest_crc32);
+	CU_ASSERT(crc32c == nvme_tcp_pdu_calc_data_digest(&pdu));
+
+	/* Reads that only cover the digest don't touch the running CRC */
+	crc32c = pdu.data_digest_crc32;
+	nvme_tcp_pdu_update_data_digest(&pdu, pdu.data_len, SPDK_NVME_TCP_DIGEST_LEN);
+	CU_ASSERT(pdu.data_digest_crc32 == crc32c);
+}
+
 static void
 test_nvme_tcp_pdu_payload_handle(void)
 {
@@ -1947,6 +1986,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_nvme_tcp_c2h_payload_handle);
 	CU_ADD_TEST(suite, test_nvme_tcp_icresp_handle);
 	CU_ADD_TEST(suite, test_nvme_tcp_pdu_payload_handle);
+	CU_ADD_TEST(suite, test_nvme_tcp_pdu_update_data_digest);
 	CU_ADD_TEST(suite, test_nvme_tcp_capsule_resp_hdr_handle);
 	CU_ADD_TEST(suite, test_nvme_tcp_ctrlr_connect_qpair);
 	CU_ADD_TEST(suite, test_nvme_tcp_ctrlr_disconnect_qpair);
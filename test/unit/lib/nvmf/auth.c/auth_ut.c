@@ -117,8 +117,10 @@ test_auth_send_recv_error(void)
 {
 	union nvmf_c2h_msg rsp = {};
 	struct spdk_nvmf_subsystem subsys = {};
+	struct spdk_nvmf_tgt tgt = {};
+	struct spdk_nvmf_poll_group group = { .tgt = &tgt };
 	struct spdk_nvmf_ctrlr ctrlr = { .subsys = &subsys };
-	struct spdk_nvmf_qpair qpair = { .ctrlr = &ctrlr };
+	struct spdk_nvmf_qpair qpair = { .ctrlr = &ctrlr, .group = &group };
 	struct spdk_nvmf_request req = { .qpair = &qpair, .rsp = &rsp };
 	struct spdk_nvme_cpl *cpl = &rsp.nvme_cpl;
 	struct spdk_nvmf_fabric_auth_send_cmd send_cmd = {};
@@ -619,8 +621,10 @@ test_auth_failure1(void)
 {
 	union nvmf_c2h_msg rsp = {};
 	struct spdk_nvmf_subsystem subsys = {};
+	struct spdk_nvmf_tgt tgt = {};
+	struct spdk_nvmf_poll_group group = { .tgt = &tgt };
 	struct spdk_nvmf_ctrlr ctrlr = { .subsys = &subsys };
-	struct spdk_nvmf_qpair qpair = { .ctrlr = &ctrlr };
+	struct spdk_nvmf_qpair qpair = { .ctrlr = &ctrlr, .group = &group };
 	struct spdk_nvmf_request req = { .qpair = &qpair, .rsp = &rsp };
 	struct spdk_nvmf_fabric_auth_recv_cmd cmd = {
 		.fctype = SPDK_NVMF_FABRIC_COMMAND_AUTHENTICATION_RECV
@@ -699,8 +703,10 @@ test_auth_challenge(void)
 {
 	union nvmf_c2h_msg rsp = {};
 	struct spdk_nvmf_subsystem subsys = { .mutex = PTHREAD_MUTEX_INITIALIZER };
+	struct spdk_nvmf_tgt tgt = {};
+	struct spdk_nvmf_poll_group group = { .tgt = &tgt };
 	struct spdk_nvmf_ctrlr ctrlr = { .subsys = &subsys };
-	struct spdk_nvmf_qpair qpair = { .ctrlr = &ctrlr };
+	struct spdk_nvmf_qpair qpair = { .ctrlr = &ctrlr, .group = &group };
 	struct spdk_nvmf_request req = { .qpair = &qpair, .rsp = &rsp };
 	struct spdk_nvmf_fabric_auth_recv_cmd cmd = {
 		.fctype = SPDK_NVMF_FABRIC_COMMAND_AUTHENTICATION_RECV
@@ -854,8 +860,10 @@ test_auth_reply(void)
 {
 	union nvmf_c2h_msg rsp = {};
 	struct spdk_nvmf_subsystem subsys = {};
+	struct spdk_nvmf_tgt tgt = {};
+	struct spdk_nvmf_poll_group group = { .tgt = &tgt };
 	struct spdk_nvmf_ctrlr ctrlr = { .subsys = &subsys };
-	struct spdk_nvmf_qpair qpair = { .ctrlr = &ctrlr };
+	struct spdk_nvmf_qpair qpair = { .ctrlr = &ctrlr, .group = &group };
 	struct spdk_nvmf_request req = { .qpair = &qpair, .rsp = &rsp };
 	struct spdk_nvmf_fabric_auth_send_cmd cmd = {};
 	struct spdk_nvmf_qpair_auth *auth;
@@ -1075,8 +1083,10 @@ test_auth_success1(void)
 {
 	union nvmf_c2h_msg rsp = {};
 	struct spdk_nvmf_subsystem subsys = {};
+	struct spdk_nvmf_tgt tgt = {};
+	struct spdk_nvmf_poll_group group = { .tgt = &tgt };
 	struct spdk_nvmf_ctrlr ctrlr = { .subsys = &subsys };
-	struct spdk_nvmf_qpair qpair = { .ctrlr = &ctrlr };
+	struct spdk_nvmf_qpair qpair = { .ctrlr = &ctrlr, .group = &group };
 	struct spdk_nvmf_request req = { .qpair = &qpair, .rsp = &rsp };
 	struct spdk_nvmf_fabric_auth_recv_cmd cmd = {
 		.fctype = SPDK_NVMF_FABRIC_COMMAND_AUTHENTICATION_RECV
@@ -1172,6 +1182,145 @@ test_auth_success1(void)
 	nvmf_qpair_auth_destroy(&qpair);
 }
 
+static void
+test_auth_workers(void)
+{
+	union nvmf_c2h_msg rsp[2] = {};
+	struct spdk_nvmf_subsystem subsys = { .mutex = PTHREAD_MUTEX_INITIALIZER };
+	struct spdk_nvmf_tgt tgt = {};
+	struct spdk_nvmf_poll_group group = { .tgt = &tgt };
+	struct spdk_nvmf_ctrlr ctrlr = { .subsys = &subsys };
+	struct spdk_nvmf_qpair qpair[2] = {
+		{ .ctrlr = &ctrlr, .group = &group },
+		{ .ctrlr = &ctrlr, .group = &group },
+	};
+	struct spdk_nvmf_request req[2] = {
+		{ .qpair = &qpair[0], .rsp = &rsp[0] },
+		{ .qpair = &qpair[1], .rsp = &rsp[1] },
+	};
+	struct spdk_nvmf_fabric_auth_recv_cmd cmd[2] = {
+		{ .fctype = SPDK_NVMF_FABRIC_COMMAND_AUTHENTICATION_RECV },
+		{ .fctype = SPDK_NVMF_FABRIC_COMMAND_AUTHENTICATION_RECV },
+	};
+	struct nvmf_auth_workers *workers;
+	struct spdk_nvmf_qpair_auth *auth;
+	struct spdk_nvmf_dhchap_challenge *msg;
+	struct nvmf_auth_job *job;
+	uint8_t msgbuf[2][4096];
+	int i, rc;
+
+	/* Don't start any threads, the jobs are executed by the test */
+	workers = calloc(1, sizeof(*workers));
+	SPDK_CU_ASSERT_FATAL(workers != NULL);
+	STAILQ_INIT(&workers->jobs);
+	pthread_mutex_init(&workers->mutex, NULL);
+	pthread_cond_init(&workers->cond, NULL);
+	workers->queue_depth = 1;
+	tgt.auth_workers = workers;
+
+	MOCK_SET(spdk_nvme_dhchap_get_digest_length, 48);
+	MOCK_SET(spdk_nvme_dhchap_generate_dhkey, (struct spdk_nvme_dhchap_dhkey *)0xdeadbeef);
+	g_dhv = 0xfe;
+	g_dhvlen = 256;
+	for (i = 0; i < 2; ++i) {
+		rc = nvmf_qpair_auth_init(&qpair[i]);
+		SPDK_CU_ASSERT_FATAL(rc == 0);
+		qpair[i].state = SPDK_NVMF_QPAIR_AUTHENTICATING;
+		auth = qpair[i].auth;
+		auth->state = NVMF_QPAIR_AUTH_CHALLENGE;
+		auth->digest = SPDK_NVMF_DHCHAP_HASH_SHA384;
+		auth->dhgroup = SPDK_NVMF_DHCHAP_DHGROUP_2048;
+		ut_prep_recv_cmd(&req[i], &cmd[i], msgbuf[i], sizeof(msgbuf[i]));
+	}
+
+	/* The first challenge is queued to the workers */
+	g_req_completed = false;
+	nvmf_auth_recv_exec(&req[0]);
+	poll_threads();
+	CU_ASSERT(!g_req_completed);
+	CU_ASSERT(qpair[0].auth->job_inflight);
+	CU_ASSERT_EQUAL(workers->num_jobs, 1);
+	CU_ASSERT_EQUAL(STAILQ_FIRST(&workers->jobs), &qpair[0].auth->job);
+
+	/* Another command can't be processed on that qpair until the job is done */
+	nvmf_auth_request_exec(&req[0]);
+	CU_ASSERT(g_req_completed);
+	CU_ASSERT_EQUAL(rsp[0].nvme_cpl.status.sc, SPDK_NVME_SC_COMMAND_SEQUENCE_ERROR);
+	CU_ASSERT_EQUAL(qpair[0].auth->state, NVMF_QPAIR_AUTH_CHALLENGE);
+	ut_clear_resp(&req[0]);
+
+	/* The queue is full, so the second one is deferred */
+	g_req_completed = false;
+	nvmf_auth_recv_exec(&req[1]);
+	CU_ASSERT(!g_req_completed);
+	CU_ASSERT(qpair[1].auth->job_inflight);
+	CU_ASSERT(qpair[1].auth->job.retry_poller != NULL);
+	CU_ASSERT_EQUAL(group.stat.auth_deferred, 1);
+	CU_ASSERT_EQUAL(workers->num_jobs, 1);
+
+	/* Execute the first job, its challenge is completed on the qpair's thread */
+	job = STAILQ_FIRST(&workers->jobs);
+	STAILQ_REMOVE_HEAD(&workers->jobs, link);
+	nvmf_auth_job_execute(workers, job);
+	CU_ASSERT(!g_req_completed);
+	CU_ASSERT_EQUAL(workers->num_jobs, 0);
+	poll_threads();
+	CU_ASSERT(g_req_completed);
+	CU_ASSERT(!qpair[0].auth->job_inflight);
+	CU_ASSERT_EQUAL(qpair[0].auth->state, NVMF_QPAIR_AUTH_REPLY);
+	CU_ASSERT_EQUAL(qpair[0].auth->dhkey, (struct spdk_nvme_dhchap_dhkey *)0xdeadbeef);
+	msg = (void *)msgbuf[0];
+	CU_ASSERT_EQUAL(msg->auth_id, SPDK_NVMF_AUTH_ID_DHCHAP_CHALLENGE);
+	CU_ASSERT_EQUAL(msg->dhvlen, 256);
+	CU_ASSERT_EQUAL(group.stat.auth_challenges, 1);
+
+	/* The second job is queued once the retry poller runs */
+	g_req_completed = false;
+	spdk_delay_us(NVMF_AUTH_QUEUE_RETRY_US);
+	poll_threads();
+	CU_ASSERT(!g_req_completed);
+	CU_ASSERT(qpair[1].auth->job.retry_poller == NULL);
+	CU_ASSERT_EQUAL(workers->num_jobs, 1);
+	CU_ASSERT_EQUAL(STAILQ_FIRST(&workers->jobs), &qpair[1].auth->job);
+
+	/* The transaction times out while the job is executed */
+	qpair[1].auth->state = NVMF_QPAIR_AUTH_ERROR;
+	job = STAILQ_FIRST(&workers->jobs);
+	STAILQ_REMOVE_HEAD(&workers->jobs, link);
+	nvmf_auth_job_execute(workers, job);
+	poll_threads();
+	CU_ASSERT(g_req_completed);
+	CU_ASSERT(!qpair[1].auth->job_inflight);
+	CU_ASSERT_EQUAL(rsp[1].nvme_cpl.status.sc, SPDK_NVME_SC_COMMAND_SEQUENCE_ERROR);
+	CU_ASSERT_EQUAL(qpair[1].auth->state, NVMF_QPAIR_AUTH_ERROR);
+	CU_ASSERT_EQUAL(group.stat.auth_challenges, 1);
+
+	nvmf_auth_workers_destroy(&tgt);
+	CU_ASSERT(tgt.auth_workers == NULL);
+
+	/* Compute a challenge on an actual authentication thread */
+	rc = nvmf_auth_workers_create(&tgt, 1, 0);
+	SPDK_CU_ASSERT_FATAL(rc == 0);
+	CU_ASSERT_EQUAL(tgt.auth_workers->queue_depth, NVMF_AUTH_DEFAULT_QUEUE_DEPTH);
+	g_req_completed = false;
+	qpair[0].auth->state = NVMF_QPAIR_AUTH_CHALLENGE;
+	ut_prep_recv_cmd(&req[0], &cmd[0], msgbuf[0], sizeof(msgbuf[0]));
+	nvmf_auth_recv_exec(&req[0]);
+	for (i = 0; i < 1000 && !g_req_completed; ++i) {
+		usleep(1000);
+		poll_threads();
+	}
+	CU_ASSERT(g_req_completed);
+	CU_ASSERT_EQUAL(qpair[0].auth->state, NVMF_QPAIR_AUTH_REPLY);
+	CU_ASSERT_EQUAL(group.stat.auth_challenges, 2);
+	nvmf_auth_workers_destroy(&tgt);
+
+	for (i = 0; i < 2; ++i) {
+		nvmf_qpair_auth_destroy(&qpair[i]);
+	}
+	MOCK_SET(spdk_nvme_dhchap_generate_dhkey, NULL);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -1187,6 +1336,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_auth_challenge);
 	CU_ADD_TEST(suite, test_auth_reply);
 	CU_ADD_TEST(suite, test_auth_success1);
+	CU_ADD_TEST(suite, test_auth_workers);
 
 	allocate_threads(1);
 	set_thread(0);
@@ -227,6 +227,8 @@ DEFINE_STUB(spdk_nvmf_subsystem_get_nqn, const char *,
 
 DEFINE_STUB(spdk_bdev_io_type_supported, bool,
 	    (struct spdk_bdev *bdev, enum spdk_bdev_io_type io_type), false);
+DEFINE_STUB(nvmf_qos_admit, bool,
+	    (struct spdk_nvmf_request *req, struct spdk_nvmf_subsystem_pg_ns_info *ns_info), true);
 
 void
 nvmf_qpair_set_state(struct spdk_nvmf_qpair *qpair, enum spdk_nvmf_qpair_state state)
@@ -306,6 +308,9 @@ nvmf_bdev_zcopy_enabled(struct spdk_bdev *bdev)
 	return true;
 }
 
+DEFINE_STUB(nvmf_bdev_ctrlr_read_buf_fits, bool, (struct spdk_bdev *bdev,
+		struct spdk_nvmf_request *req), true);
+
 int
 nvmf_bdev_ctrlr_zcopy_start(struct spdk_bdev *bdev,
 			    struct spdk_bdev_desc *desc,
@@ -2723,8 +2728,26 @@ test_nvmf_ctrlr_use_zcopy(void)
 	CU_ASSERT(nvmf_ctrlr_use_zcopy(&req) == false);
 	cmd.nvme_cmd.nsid = 1;
 
+	/* Passthrough subsystem */
+	subsystem.passthrough = true;
+	CU_ASSERT(nvmf_ctrlr_use_zcopy(&req) == false);
+	subsystem.passthrough = false;
+
 	/* ZCOPY Not supported */
 	CU_ASSERT(nvmf_ctrlr_use_zcopy(&req) == false);
+
+	/* READs use bdev buffers even if ZCOPY is not supported */
+	cmd.nvme_cmd.opc = SPDK_NVME_OPC_READ;
+	CU_ASSERT(nvmf_ctrlr_use_zcopy(&req));
+	CU_ASSERT(req.zcopy_phase == NVMF_ZCOPY_PHASE_INIT);
+	req.zcopy_phase = NVMF_ZCOPY_PHASE_NONE;
+
+	/* ...unless the bdev layer can't get a single buffer for them */
+	MOCK_SET(nvmf_bdev_ctrlr_read_buf_fits, false);
+	CU_ASSERT(nvmf_ctrlr_use_zcopy(&req) == false);
+	CU_ASSERT(req.zcopy_phase == NVMF_ZCOPY_PHASE_NONE);
+	MOCK_CLEAR(nvmf_bdev_ctrlr_read_buf_fits);
+	cmd.nvme_cmd.opc = SPDK_NVME_OPC_WRITE;
 	ns.zcopy = true;
 
 	/* ZCOPY disabled on transport level */
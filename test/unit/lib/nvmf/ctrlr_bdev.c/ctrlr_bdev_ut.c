@@ -72,6 +72,26 @@ spdk_bdev_is_md_interleaved(const struct spdk_bdev *bdev)
 	return (bdev->md_len != 0) && bdev->md_interleave;
 }
 
+#define UT_IOBUF_LARGE_BUFSIZE	(128 * 1024 + 4096)
+
+void
+spdk_iobuf_get_opts(struct spdk_iobuf_opts *opts, size_t opts_size)
+{
+	opts->large_bufsize = UT_IOBUF_LARGE_BUFSIZE;
+}
+
+bool
+spdk_bdev_is_md_separate(const struct spdk_bdev *bdev)
+{
+	return (bdev->md_len != 0) && !bdev->md_interleave;
+}
+
+size_t
+spdk_bdev_get_buf_align(const struct spdk_bdev *bdev)
+{
+	return 1 << bdev->required_alignment;
+}
+
 /* We have to use the typedef in the function declaration to appease astyle. */
 typedef enum spdk_dif_type spdk_dif_type_t;
 
@@ -312,6 +332,38 @@ test_get_rw_params(void)
 	CU_ASSERT(count == 0x9875 + 1); /* NOTE: this field is 0's based, hence the +1 */
 }
 
+static void
+test_read_buf_fits(void)
+{
+	struct spdk_bdev bdev = { .blocklen = 512 };
+	struct spdk_nvmf_request req = {};
+	union nvmf_h2c_msg h2c = {};
+	uint32_t max_blocks = UT_IOBUF_LARGE_BUFSIZE / bdev.blocklen;
+
+	req.cmd = &h2c;
+
+	/* NLB is 0's based */
+	to_le32(&req.cmd->nvme_cmd.cdw12, max_blocks - 1);
+	CU_ASSERT(nvmf_bdev_ctrlr_read_buf_fits(&bdev, &req));
+	to_le32(&req.cmd->nvme_cmd.cdw12, max_blocks);
+	CU_ASSERT(!nvmf_bdev_ctrlr_read_buf_fits(&bdev, &req));
+
+	/* The alignment and separate metadata need space too */
+	to_le32(&req.cmd->nvme_cmd.cdw12, max_blocks - 1);
+	bdev.required_alignment = 12;
+	CU_ASSERT(!nvmf_bdev_ctrlr_read_buf_fits(&bdev, &req));
+	bdev.required_alignment = 0;
+	bdev.md_len = 8;
+	bdev.md_interleave = true;
+	bdev.blocklen = 520;
+	to_le32(&req.cmd->nvme_cmd.cdw12, UT_IOBUF_LARGE_BUFSIZE / 520 - 1);
+	CU_ASSERT(nvmf_bdev_ctrlr_read_buf_fits(&bdev, &req));
+	bdev.md_interleave = false;
+	bdev.blocklen = 512;
+	to_le32(&req.cmd->nvme_cmd.cdw12, max_blocks - 1);
+	CU_ASSERT(!nvmf_bdev_ctrlr_read_buf_fits(&bdev, &req));
+}
+
 static void
 test_get_rw_ext_params(void)
 {
@@ -580,6 +632,7 @@ test_nvmf_bdev_ctrlr_zcopy_start(void)
 {
 	int rc;
 	struct spdk_bdev bdev = {};
+	struct spdk_bdev_io bdev_io = {};
 	struct spdk_bdev_desc *desc = NULL;
 	struct spdk_io_channel ch = {};
 
@@ -659,6 +712,45 @@ test_nvmf_bdev_ctrlr_zcopy_start(void)
 	CU_ASSERT_EQUAL(rc, SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE);
 	CU_ASSERT_EQUAL(write_rsp.nvme_cpl.status.sct, SPDK_NVME_SCT_GENERIC);
 	CU_ASSERT_EQUAL(write_rsp.nvme_cpl.status.sc, SPDK_NVME_SC_DATA_SGL_LENGTH_INVALID);
+
+	/* 4. READ without ZCOPY support reads into a bdev provided buffer */
+	write_cmd.opc = SPDK_NVME_OPC_READ;
+	write_cmd.cdw10 = 1;	/* SLBA: CDW10 and CDW11 */
+	write_cmd.cdw12 = 1;	/* NLB: CDW12 bits 15:00, 0's based */
+	write_req.length = (write_cmd.cdw12 + 1) * bdev.blocklen;
+	write_req.iovcnt = NVMF_REQ_MAX_BUFFERS;
+	write_rsp.nvme_cpl.status.sc = SPDK_NVME_SC_SUCCESS;
+
+	rc = nvmf_bdev_ctrlr_zcopy_start(&bdev, desc, &ch, &write_req);
+
+	CU_ASSERT_EQUAL(rc, SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS);
+	CU_ASSERT_EQUAL(write_rsp.nvme_cpl.status.sc, SPDK_NVME_SC_SUCCESS);
+	CU_ASSERT_EQUAL(write_req.iovcnt, 1);
+	CU_ASSERT(write_req.iov[0].iov_base == NULL);
+	CU_ASSERT_EQUAL(write_req.iov[0].iov_len, write_req.length);
+
+	/* Releasing the READ bdev_io frees it directly instead of going through ZCOPY end,
+	 * which completes asynchronously */
+	bdev_io.type = SPDK_BDEV_IO_TYPE_READ;
+	write_req.zcopy_bdev_io = &bdev_io;
+	nvmf_bdev_ctrlr_zcopy_end(&write_req, false);
+	CU_ASSERT(write_req.zcopy_bdev_io == NULL);
+
+	bdev_io.type = SPDK_BDEV_IO_TYPE_ZCOPY;
+	write_req.zcopy_bdev_io = &bdev_io;
+	nvmf_bdev_ctrlr_zcopy_end(&write_req, false);
+	CU_ASSERT(write_req.zcopy_bdev_io == &bdev_io);
+	write_req.zcopy_bdev_io = NULL;
+
+	/* 5. READ with ZCOPY support uses the ZCOPY iovecs */
+	MOCK_SET(spdk_bdev_io_type_supported, true);
+	write_req.iovcnt = NVMF_REQ_MAX_BUFFERS;
+
+	rc = nvmf_bdev_ctrlr_zcopy_start(&bdev, desc, &ch, &write_req);
+
+	CU_ASSERT_EQUAL(rc, SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS);
+	CU_ASSERT_EQUAL(write_req.iovcnt, NVMF_REQ_MAX_BUFFERS);
+	MOCK_SET(spdk_bdev_io_type_supported, false);
 }
 
 static void
@@ -983,6 +1075,7 @@ main(int argc, char **argv)
 
 	CU_ADD_TEST(suite, test_get_rw_params);
 	CU_ADD_TEST(suite, test_get_rw_ext_params);
+	CU_ADD_TEST(suite, test_read_buf_fits);
 	CU_ADD_TEST(suite, test_lba_in_range);
 	CU_ADD_TEST(suite, test_get_dif_ctx);
 	CU_ADD_TEST(suite, test_nvmf_bdev_ctrlr_identify_ns);
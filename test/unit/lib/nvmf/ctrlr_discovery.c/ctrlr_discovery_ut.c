@@ -88,6 +88,7 @@ DEFINE_STUB(nvmf_auth_is_supported, bool, (void), false);
 DEFINE_STUB(spdk_bdev_get_nvme_ctratt, union spdk_bdev_nvme_ctratt,
 	    (struct spdk_bdev *bdev), {});
 DEFINE_STUB(nvmf_tgt_update_mdns_prr, int, (struct spdk_nvmf_tgt *tgt), 0);
+DEFINE_STUB_V(nvmf_ns_qos_clear, (struct spdk_nvmf_ns *ns));
 
 const char *
 spdk_bdev_get_name(const struct spdk_bdev *bdev)
@@ -214,7 +215,7 @@ nvmf_ctrlr_destruct(struct spdk_nvmf_ctrlr *ctrlr)
 
 int
 nvmf_poll_group_update_subsystem(struct spdk_nvmf_poll_group *group,
-				 struct spdk_nvmf_subsystem *subsystem)
+				 struct spdk_nvmf_subsystem *subsystem, uint32_t nsid)
 {
 	return 0;
 }
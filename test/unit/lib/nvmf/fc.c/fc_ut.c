@@ -170,6 +170,10 @@ DEFINE_STUB_V(nvmf_fc_dump_all_queues, (struct spdk_nvmf_fc_hwqp *ls_queue,
 					struct spdk_nvmf_fc_hwqp *io_queues,
 					uint32_t num_io_queues,
 					struct spdk_nvmf_fc_queue_dump_info *dump_info));
+DEFINE_STUB_V(nvmf_ns_qos_clear, (struct spdk_nvmf_ns *ns));
+DEFINE_STUB(nvmf_ns_qos_update_buckets, int,
+	    (struct spdk_nvmf_subsystem_pg_ns_info *ns_info, struct spdk_nvmf_ns *ns), 0);
+DEFINE_STUB_V(nvmf_reservation_bdev_store_write_config_json, (struct spdk_json_write_ctx *w));
 
 uint32_t
 nvmf_fc_process_queue(struct spdk_nvmf_fc_hwqp *hwqp)
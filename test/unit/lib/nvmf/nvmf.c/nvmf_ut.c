@@ -116,7 +116,19 @@ DEFINE_STUB(nvmf_nqn_is_discovery, bool, (const char *nqn), true);
 DEFINE_STUB(spdk_key_get_name, const char *, (struct spdk_key *k), NULL);
 DEFINE_STUB(nvmf_qpair_auth_init, int, (struct spdk_nvmf_qpair *q), 0);
 DEFINE_STUB_V(nvmf_qpair_auth_destroy, (struct spdk_nvmf_qpair *q));
+DEFINE_STUB(nvmf_auth_workers_create, int,
+	    (struct spdk_nvmf_tgt *tgt, uint32_t num_threads, uint32_t queue_depth), 0);
+DEFINE_STUB_V(nvmf_auth_workers_destroy, (struct spdk_nvmf_tgt *tgt));
 DEFINE_STUB_V(nvmf_tgt_stop_mdns_prr, (struct spdk_nvmf_tgt *tgt));
+DEFINE_STUB(nvmf_transport_poll_group_detach, int,
+	    (struct spdk_nvmf_transport_poll_group *group, struct spdk_nvmf_qpair *qpair), 0);
+DEFINE_STUB(nvmf_transport_poll_group_can_detach, bool,
+	    (struct spdk_nvmf_transport_poll_group *group, struct spdk_nvmf_qpair *qpair), true);
+DEFINE_STUB(nvmf_transport_poll_group_attach, int,
+	    (struct spdk_nvmf_transport_poll_group *group, struct spdk_nvmf_qpair *qpair), 0);
+DEFINE_STUB(nvmf_ns_qos_update_buckets, int,
+	    (struct spdk_nvmf_subsystem_pg_ns_info *ns_info, struct spdk_nvmf_ns *ns), 0);
+DEFINE_STUB_V(nvmf_reservation_bdev_store_write_config_json, (struct spdk_json_write_ctx *w));
 
 struct spdk_io_channel {
 	struct spdk_thread		*thread;
@@ -223,6 +235,325 @@ test_nvmf_tgt_create_poll_group(void)
 	MOCK_CLEAR(spdk_bdev_get_io_channel);
 }
 
+static void
+test_nvmf_tgt_least_loaded_poll_group(void)
+{
+	struct spdk_nvmf_tgt tgt = {};
+	struct spdk_nvmf_transport transport = {};
+	struct spdk_nvmf_transport_poll_group tgroups[3] = {};
+	struct spdk_nvmf_poll_group groups[3] = {};
+	int i;
+
+	TAILQ_INIT(&tgt.poll_groups);
+	transport.tgt = &tgt;
+	for (i = 0; i < 3; i++) {
+		TAILQ_INIT(&groups[i].tgroups);
+		tgroups[i].transport = &transport;
+		TAILQ_INSERT_TAIL(&groups[i].tgroups, &tgroups[i], link);
+		TAILQ_INSERT_TAIL(&tgt.poll_groups, &groups[i], link);
+	}
+
+	/* Disabled by default, transports fall back to their own placement */
+	CU_ASSERT(nvmf_transport_get_least_loaded_poll_group(&transport) == NULL);
+
+	tgt.load_aware_placement = true;
+
+	/* The least busy poll group wins */
+	groups[0].load.busy_pct = 80;
+	groups[1].load.busy_pct = 20;
+	groups[2].load.busy_pct = 50;
+	CU_ASSERT(nvmf_transport_get_least_loaded_poll_group(&transport) == &tgroups[1]);
+	CU_ASSERT(tgt.next_poll_group == &groups[2]);
+
+	/* Busy percentages within the tolerance are equal, the qpair count decides */
+	groups[0].load.busy_pct = 22;
+	groups[2].load.busy_pct = 21;
+	groups[0].stat.current_io_qpairs = 2;
+	groups[1].stat.current_io_qpairs = 3;
+	groups[2].current_unassociated_qpairs = 1;
+	CU_ASSERT(nvmf_tgt_get_least_loaded_poll_group(&tgt) == &groups[2]);
+
+	/* Then the IOPS */
+	groups[0].stat.current_io_qpairs = 1;
+	groups[0].load.iops = 1000;
+	groups[2].load.iops = 500;
+	CU_ASSERT(nvmf_tgt_get_least_loaded_poll_group(&tgt) == &groups[2]);
+
+	/* Equally loaded poll groups take turns */
+	memset(&groups[0].load, 0, sizeof(groups[0].load));
+	memset(&groups[0].stat, 0, sizeof(groups[0].stat));
+	memset(&groups[1].load, 0, sizeof(groups[1].load));
+	memset(&groups[1].stat, 0, sizeof(groups[1].stat));
+	memset(&groups[2].load, 0, sizeof(groups[2].load));
+	groups[2].current_unassociated_qpairs = 0;
+	tgt.next_poll_group = NULL;
+	CU_ASSERT(nvmf_tgt_get_least_loaded_poll_group(&tgt) == &groups[0]);
+	CU_ASSERT(nvmf_tgt_get_least_loaded_poll_group(&tgt) == &groups[1]);
+	CU_ASSERT(nvmf_tgt_get_least_loaded_poll_group(&tgt) == &groups[2]);
+	CU_ASSERT(nvmf_tgt_get_least_loaded_poll_group(&tgt) == &groups[0]);
+}
+
+static uint64_t
+ut_poll_group_qpair_iops(struct spdk_nvmf_poll_group *group)
+{
+	struct spdk_nvmf_qpair *qpair;
+	uint64_t iops = 0;
+
+	TAILQ_FOREACH(qpair, &group->qpairs, link) {
+		iops += qpair->load.iops;
+	}
+
+	return iops;
+}
+
+static void
+test_nvmf_poll_group_rebalance(void)
+{
+	struct spdk_thread *thread;
+	struct spdk_nvmf_tgt tgt = {};
+	struct spdk_nvmf_transport transport = {};
+	struct spdk_nvmf_transport_poll_group tgroup1 = {}, tgroup2 = {};
+	struct spdk_nvmf_poll_group group1 = {}, group2 = {};
+	struct spdk_nvmf_ctrlr ctrlr = {};
+	struct spdk_nvmf_qpair qpairs[4] = {};
+	struct spdk_nvmf_request req = {};
+	uint64_t qpair_iops[4] = { 0, 200, 1000, 600 };
+	int i;
+
+	thread = spdk_thread_create(NULL, NULL);
+	SPDK_CU_ASSERT_FATAL(thread != NULL);
+	spdk_set_thread(thread);
+
+	TAILQ_INIT(&tgt.poll_groups);
+	pthread_mutex_init(&tgt.mutex, NULL);
+	tgt.state = NVMF_TGT_RUNNING;
+	tgt.qpair_migration_threshold = 50;
+	transport.tgt = &tgt;
+
+	group1.tgt = &tgt;
+	group1.thread = thread;
+	TAILQ_INIT(&group1.tgroups);
+	TAILQ_INIT(&group1.qpairs);
+	tgroup1.transport = &transport;
+	TAILQ_INSERT_TAIL(&group1.tgroups, &tgroup1, link);
+	TAILQ_INSERT_TAIL(&tgt.poll_groups, &group1, link);
+
+	group2.tgt = &tgt;
+	group2.thread = thread;
+	TAILQ_INIT(&group2.tgroups);
+	TAILQ_INIT(&group2.qpairs);
+	tgroup2.transport = &transport;
+	TAILQ_INSERT_TAIL(&group2.tgroups, &tgroup2, link);
+	TAILQ_INSERT_TAIL(&tgt.poll_groups, &group2, link);
+
+	for (i = 0; i < 4; i++) {
+		qpairs[i].qid = i + 1;
+		qpairs[i].state = SPDK_NVMF_QPAIR_ENABLED;
+		qpairs[i].transport = &transport;
+		qpairs[i].ctrlr = &ctrlr;
+		qpairs[i].group = &group1;
+		TAILQ_INIT(&qpairs[i].outstanding);
+		TAILQ_INSERT_TAIL(&group1.qpairs, &qpairs[i], link);
+	}
+	group1.stat.current_io_qpairs = 4;
+
+	/* The imbalance has to persist before anything is moved */
+	group1.load.busy_pct = 90;
+	group2.load.busy_pct = 30;
+	for (i = 0; i < NVMF_QPAIR_MIGRATION_PERIODS - 1; i++) {
+		nvmf_poll_group_rebalance(&group1);
+	}
+	CU_ASSERT(group1.load.imbalance_periods == NVMF_QPAIR_MIGRATION_PERIODS - 1);
+	CU_ASSERT(group1.stat.current_io_qpairs == 4);
+
+	/* A smaller imbalance than the threshold resets the count */
+	group2.load.busy_pct = 50;
+	nvmf_poll_group_rebalance(&group1);
+	CU_ASSERT(group1.load.imbalance_periods == 0);
+
+	/* Moving qpairs without I/O wouldn't change anything */
+	group2.load.busy_pct = 30;
+	for (i = 0; i < NVMF_QPAIR_MIGRATION_PERIODS; i++) {
+		nvmf_poll_group_rebalance(&group1);
+	}
+	CU_ASSERT(group1.stat.current_io_qpairs == 4);
+	CU_ASSERT(group1.load.imbalance_periods == 0);
+
+	/* The qpair whose load evens out both poll groups the most is picked. It's busy, so it
+	 * stops taking new commands until its outstanding ones complete.
+	 */
+	for (i = 0; i < 4; i++) {
+		qpairs[i].load.iops = qpair_iops[i];
+	}
+	group1.load.iops = ut_poll_group_qpair_iops(&group1);
+	TAILQ_INSERT_TAIL(&qpairs[2].outstanding, &req, link);
+	for (i = 0; i < NVMF_QPAIR_MIGRATION_PERIODS; i++) {
+		nvmf_poll_group_rebalance(&group1);
+	}
+	CU_ASSERT(group1.load.imbalance_periods == 0);
+	CU_ASSERT(group1.load.draining_qpair == &qpairs[2]);
+	CU_ASSERT(group1.load.migrate_to == &group2);
+	CU_ASSERT(qpairs[2].draining);
+	CU_ASSERT(qpairs[2].group == &group1);
+
+	/* No other qpair is moved while draining */
+	for (i = 0; i < NVMF_QPAIR_MIGRATION_PERIODS; i++) {
+		nvmf_poll_group_rebalance(&group1);
+	}
+	spdk_thread_poll(thread, 0, 0);
+	CU_ASSERT(group1.stat.current_io_qpairs == 4);
+	CU_ASSERT(qpairs[2].draining);
+
+	/* Once drained, the qpair is moved and the hot poll group's load drops */
+	TAILQ_REMOVE(&qpairs[2].outstanding, &req, link);
+	spdk_thread_poll(thread, 0, 0);
+	CU_ASSERT(group1.load.draining_qpair == NULL);
+	CU_ASSERT(group1.load.drain_poller == NULL);
+	CU_ASSERT(!qpairs[2].draining);
+	CU_ASSERT(qpairs[2].migrating);
+	CU_ASSERT(qpairs[2].group == &group2);
+	CU_ASSERT(group1.stat.current_io_qpairs == 3);
+
+	spdk_thread_poll(thread, 0, 0);
+	CU_ASSERT(!qpairs[2].migrating);
+	CU_ASSERT(TAILQ_FIRST(&group2.qpairs) == &qpairs[2]);
+	CU_ASSERT(group2.stat.current_io_qpairs == 1);
+	CU_ASSERT(ut_poll_group_qpair_iops(&group1) == 800);
+	CU_ASSERT(ut_poll_group_qpair_iops(&group2) == 1000);
+
+	/* Qpairs which don't drain in time resume taking commands on the same poll group */
+	group1.load.iops = ut_poll_group_qpair_iops(&group1);
+	group2.load.iops = 0;
+	MOCK_SET(nvmf_transport_poll_group_detach, -EBUSY);
+	for (i = 0; i < NVMF_QPAIR_MIGRATION_PERIODS; i++) {
+		nvmf_poll_group_rebalance(&group1);
+	}
+	CU_ASSERT(group1.load.draining_qpair != NULL);
+	spdk_thread_poll(thread, 0, 0);
+	CU_ASSERT(group1.load.draining_qpair != NULL);
+	spdk_delay_us(NVMF_QPAIR_DRAIN_TIMEOUT_US);
+	spdk_thread_poll(thread, 0, 0);
+	CU_ASSERT(group1.load.draining_qpair == NULL);
+	CU_ASSERT(group1.load.drain_poller == NULL);
+	for (i = 0; i < 4; i++) {
+		CU_ASSERT(!qpairs[i].draining);
+	}
+	CU_ASSERT(group1.stat.current_io_qpairs == 3);
+	MOCK_SET(nvmf_transport_poll_group_detach, 0);
+
+	/* Qpairs which the transport can't detach are never drained */
+	MOCK_SET(nvmf_transport_poll_group_can_detach, false);
+	TAILQ_INSERT_TAIL(&qpairs[3].outstanding, &req, link);
+	for (i = 0; i < NVMF_QPAIR_MIGRATION_PERIODS; i++) {
+		nvmf_poll_group_rebalance(&group1);
+	}
+	CU_ASSERT(group1.load.draining_qpair == NULL);
+	CU_ASSERT(group1.load.drain_poller == NULL);
+	for (i = 0; i < 4; i++) {
+		CU_ASSERT(!qpairs[i].draining);
+	}
+	CU_ASSERT(nvmf_poll_group_migrate_qpair(&qpairs[3], &group2) == -ENOTSUP);
+	CU_ASSERT(group1.stat.current_io_qpairs == 3);
+	TAILQ_REMOVE(&qpairs[3].outstanding, &req, link);
+	MOCK_CLEAR(nvmf_transport_poll_group_can_detach);
+
+	/* The last I/O qpair of a poll group isn't moved */
+	group1.stat.current_io_qpairs = 1;
+	for (i = 0; i < NVMF_QPAIR_MIGRATION_PERIODS; i++) {
+		nvmf_poll_group_rebalance(&group1);
+	}
+	CU_ASSERT(group1.stat.current_io_qpairs == 1);
+	CU_ASSERT(group1.load.imbalance_periods == 0);
+
+	pthread_mutex_destroy(&tgt.mutex);
+	spdk_thread_exit(thread);
+	while (!spdk_thread_is_exited(thread)) {
+		spdk_thread_poll(thread, 0, 0);
+	}
+	spdk_thread_destroy(thread);
+}
+
+static void
+ut_pause_done(void *cb_arg, int status)
+{
+	int *rc = cb_arg;
+
+	*rc = status;
+}
+
+static void
+test_nvmf_poll_group_pause_resume_ns(void)
+{
+	struct spdk_nvmf_poll_group group = {};
+	struct spdk_nvmf_subsystem_poll_group sgroup = {};
+	struct spdk_nvmf_subsystem_pg_ns_info ns_info[2] = {};
+	struct spdk_nvmf_ns *ns[2] = {};
+	struct spdk_nvmf_subsystem subsystem = {};
+	int rc;
+
+	subsystem.id = 0;
+	subsystem.max_nsid = 2;
+	subsystem.ns = ns;
+	TAILQ_INIT(&subsystem.ctrlrs);
+
+	group.num_sgroups = 1;
+	group.sgroups = &sgroup;
+	sgroup.num_ns = 2;
+	sgroup.ns_info = ns_info;
+	sgroup.state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
+	TAILQ_INIT(&sgroup.queued);
+	ns_info[0].state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
+	ns_info[1].state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
+
+	/* Only the paused namespace is waited for, I/O to the other one doesn't matter */
+	ns_info[0].io_outstanding = 1;
+	ns_info[1].io_outstanding = 3;
+	rc = -1;
+	nvmf_poll_group_pause_subsystem(&group, &subsystem, 1, ut_pause_done, &rc);
+	CU_ASSERT(rc == -1);
+	CU_ASSERT(sgroup.state == SPDK_NVMF_SUBSYSTEM_PAUSING);
+	CU_ASSERT(sgroup.num_ns_pausing == 1);
+	CU_ASSERT(ns_info[0].state == SPDK_NVMF_SUBSYSTEM_PAUSING);
+	CU_ASSERT(ns_info[1].state == SPDK_NVMF_SUBSYSTEM_ACTIVE);
+	CU_ASSERT(sgroup.cb_fn == ut_pause_done);
+	sgroup.cb_fn = NULL;
+	sgroup.cb_arg = NULL;
+
+	/* A namespace without outstanding I/O is paused right away */
+	sgroup.state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
+	ns_info[0].state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
+	ns_info[0].io_outstanding = 0;
+	nvmf_poll_group_pause_subsystem(&group, &subsystem, 1, ut_pause_done, &rc);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(sgroup.state == SPDK_NVMF_SUBSYSTEM_PAUSED);
+	CU_ASSERT(sgroup.num_ns_pausing == 0);
+	CU_ASSERT(ns_info[0].state == SPDK_NVMF_SUBSYSTEM_PAUSED);
+
+	/* A scoped resume only refreshes the paused namespace */
+	ns_info[1].num_blocks = 8;
+	subsystem.paused_nsid = 1;
+	rc = -1;
+	nvmf_poll_group_resume_subsystem(&group, &subsystem, ut_pause_done, &rc);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(sgroup.state == SPDK_NVMF_SUBSYSTEM_ACTIVE);
+	CU_ASSERT(ns_info[0].state == SPDK_NVMF_SUBSYSTEM_ACTIVE);
+	CU_ASSERT(ns_info[1].num_blocks == 8);
+	CU_ASSERT(ns_info[1].io_outstanding == 3);
+
+	/* An unscoped one refreshes all of them */
+	ns_info[1].io_outstanding = 0;
+	nvmf_poll_group_pause_subsystem(&group, &subsystem, SPDK_NVME_GLOBAL_NS_TAG, ut_pause_done, &rc);
+	CU_ASSERT(sgroup.state == SPDK_NVMF_SUBSYSTEM_PAUSED);
+	CU_ASSERT(ns_info[1].state == SPDK_NVMF_SUBSYSTEM_PAUSED);
+	subsystem.paused_nsid = 0;
+	rc = -1;
+	nvmf_poll_group_resume_subsystem(&group, &subsystem, ut_pause_done, &rc);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(ns_info[1].num_blocks == 0);
+	CU_ASSERT(ns_info[0].state == SPDK_NVMF_SUBSYSTEM_ACTIVE);
+	CU_ASSERT(ns_info[1].state == SPDK_NVMF_SUBSYSTEM_ACTIVE);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -234,6 +565,9 @@ main(int argc, char **argv)
 	suite = CU_add_suite("nvmf", NULL, NULL);
 
 	CU_ADD_TEST(suite, test_nvmf_tgt_create_poll_group);
+	CU_ADD_TEST(suite, test_nvmf_tgt_least_loaded_poll_group);
+	CU_ADD_TEST(suite, test_nvmf_poll_group_rebalance);
+	CU_ADD_TEST(suite, test_nvmf_poll_group_pause_resume_ns);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 	CU_cleanup_registry();
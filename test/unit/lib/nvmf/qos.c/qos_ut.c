@@ -0,0 +1,334 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2026 Samsung Electronics Co., Ltd.
+ *   All rights reserved.
+ */
+#include "spdk/stdinc.h"
+
+#include "spdk_internal/cunit.h"
+#include "spdk_internal/mock.h"
+
+#include "common/lib/ut_multithread.c"
+#include "nvmf/qos.c"
+
+#define UT_HOSTNQN0 "nqn.2024-01.io.spdk:host0"
+#define UT_HOSTNQN1 "nqn.2024-01.io.spdk:host1"
+
+DEFINE_STUB(nvmf_nqn_is_valid, bool, (const char *nqn), true);
+
+static int g_num_executed;
+static int g_num_completed;
+
+int
+nvmf_ctrlr_process_io_cmd(struct spdk_nvmf_request *req)
+{
+	g_num_executed++;
+
+	return SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS;
+}
+
+int
+spdk_nvmf_request_complete(struct spdk_nvmf_request *req)
+{
+	g_num_completed++;
+
+	return 0;
+}
+
+struct ut_qos_req {
+	struct spdk_nvmf_request	req;
+	union nvmf_h2c_msg		cmd;
+	union nvmf_c2h_msg		rsp;
+};
+
+static void
+ut_qos_req_init(struct ut_qos_req *r, struct spdk_nvmf_qpair *qpair, uint8_t opc,
+		uint32_t length)
+{
+	memset(r, 0, sizeof(*r));
+	r->req.qpair = qpair;
+	r->req.cmd = &r->cmd;
+	r->req.rsp = &r->rsp;
+	r->req.length = length;
+	r->cmd.nvme_cmd.opc = opc;
+	r->cmd.nvme_cmd.nsid = 1;
+}
+
+static void
+ut_subsystem_init(struct spdk_nvmf_subsystem *subsystem, struct spdk_nvmf_ns *ns,
+		  struct spdk_nvmf_ns **ns_array)
+{
+	memset(subsystem, 0, sizeof(*subsystem));
+	memset(ns, 0, sizeof(*ns));
+	TAILQ_INIT(&ns->qos);
+	ns->nsid = 1;
+	ns->subsystem = subsystem;
+	ns_array[0] = ns;
+	subsystem->ns = ns_array;
+	subsystem->max_nsid = 1;
+	subsystem->state = SPDK_NVMF_SUBSYSTEM_PAUSED;
+}
+
+static void
+test_nvmf_ns_set_qos_limits(void)
+{
+	struct spdk_nvmf_subsystem subsystem;
+	struct spdk_nvmf_ns ns, *ns_array[1];
+	struct spdk_nvmf_ns_qos *qos;
+	int rc;
+
+	ut_subsystem_init(&subsystem, &ns, ns_array);
+
+	/* Invalid namespace IDs */
+	rc = spdk_nvmf_ns_set_qos_limits(&subsystem, 0, UT_HOSTNQN0, 1000, 0);
+	CU_ASSERT(rc == -EINVAL);
+	rc = spdk_nvmf_ns_set_qos_limits(&subsystem, 2, UT_HOSTNQN0, 1000, 0);
+	CU_ASSERT(rc == -EINVAL);
+
+	/* Limits large enough to overflow the refill computations */
+	rc = spdk_nvmf_ns_set_qos_limits(&subsystem, 1, UT_HOSTNQN0, UINT64_MAX, 0);
+	CU_ASSERT(rc == -EINVAL);
+	rc = spdk_nvmf_ns_set_qos_limits(&subsystem, 1, UT_HOSTNQN0, 0, UINT64_MAX / (1024 * 1024));
+	CU_ASSERT(rc == -EINVAL);
+	CU_ASSERT(TAILQ_EMPTY(&ns.qos));
+
+	/* Removing limits that were never set is not an error */
+	rc = spdk_nvmf_ns_set_qos_limits(&subsystem, 1, UT_HOSTNQN0, 0, 0);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(TAILQ_EMPTY(&ns.qos));
+
+	rc = spdk_nvmf_ns_set_qos_limits(&subsystem, 1, UT_HOSTNQN0, 10000, 100);
+	CU_ASSERT(rc == 0);
+	qos = TAILQ_FIRST(&ns.qos);
+	SPDK_CU_ASSERT_FATAL(qos != NULL);
+	CU_ASSERT(strcmp(qos->hostnqn, UT_HOSTNQN0) == 0);
+	CU_ASSERT(qos->limits[NVMF_QOS_RW_IOPS_RATE_LIMIT] == 10000);
+	CU_ASSERT(qos->limits[NVMF_QOS_RW_BPS_RATE_LIMIT] == 100 * 1024 * 1024);
+	/* The pool starts out with a timeslice worth of tokens */
+	CU_ASSERT(qos->pool[NVMF_QOS_RW_IOPS_RATE_LIMIT] == 10);
+	CU_ASSERT(qos->pool[NVMF_QOS_RW_BPS_RATE_LIMIT] == 100 * 1024 * 1024 / 1000);
+	CU_ASSERT(qos->refcnt == 1);
+
+	/* Updating the limits of the same host keeps the object */
+	rc = spdk_nvmf_ns_set_qos_limits(&subsystem, 1, UT_HOSTNQN0, 0, 50);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(TAILQ_FIRST(&ns.qos) == qos);
+	CU_ASSERT(TAILQ_NEXT(qos, link) == NULL);
+	CU_ASSERT(qos->limits[NVMF_QOS_RW_IOPS_RATE_LIMIT] == 0);
+	CU_ASSERT(qos->limits[NVMF_QOS_RW_BPS_RATE_LIMIT] == 50 * 1024 * 1024);
+	CU_ASSERT(qos->pool[NVMF_QOS_RW_IOPS_RATE_LIMIT] == 0);
+
+	rc = spdk_nvmf_ns_set_qos_limits(&subsystem, 1, UT_HOSTNQN1, 1000, 0);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(TAILQ_NEXT(qos, link) != NULL);
+
+	rc = spdk_nvmf_ns_set_qos_limits(&subsystem, 1, UT_HOSTNQN0, 0, 0);
+	CU_ASSERT(rc == 0);
+	qos = TAILQ_FIRST(&ns.qos);
+	SPDK_CU_ASSERT_FATAL(qos != NULL);
+	CU_ASSERT(strcmp(qos->hostnqn, UT_HOSTNQN1) == 0);
+
+	nvmf_ns_qos_clear(&ns);
+	CU_ASSERT(TAILQ_EMPTY(&ns.qos));
+}
+
+static void
+test_nvmf_ns_qos_update_buckets(void)
+{
+	struct spdk_nvmf_subsystem subsystem;
+	struct spdk_nvmf_ns ns, *ns_array[1];
+	struct spdk_nvmf_subsystem_pg_ns_info ns_info[2] = {};
+	struct spdk_nvmf_ns_qos *qos0, *qos1;
+	int rc;
+
+	ut_subsystem_init(&subsystem, &ns, ns_array);
+
+	rc = spdk_nvmf_ns_set_qos_limits(&subsystem, 1, UT_HOSTNQN0, 1000, 0);
+	CU_ASSERT(rc == 0);
+	rc = spdk_nvmf_ns_set_qos_limits(&subsystem, 1, UT_HOSTNQN1, 1000, 0);
+	CU_ASSERT(rc == 0);
+	qos0 = TAILQ_FIRST(&ns.qos);
+	qos1 = TAILQ_NEXT(qos0, link);
+
+	/* Each poll group gets a bucket for each host */
+	rc = nvmf_ns_qos_update_buckets(&ns_info[0], &ns);
+	CU_ASSERT(rc == 0);
+	rc = nvmf_ns_qos_update_buckets(&ns_info[1], &ns);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(nvmf_qos_find_bucket(&ns_info[0], UT_HOSTNQN0)->qos == qos0);
+	CU_ASSERT(nvmf_qos_find_bucket(&ns_info[0], UT_HOSTNQN1)->qos == qos1);
+	CU_ASSERT(nvmf_qos_find_bucket(&ns_info[1], UT_HOSTNQN0)->qos == qos0);
+	CU_ASSERT(qos0->num_buckets == 2);
+	CU_ASSERT(qos0->refcnt == 3);
+
+	/* Updating again doesn't create any new buckets */
+	rc = nvmf_ns_qos_update_buckets(&ns_info[0], &ns);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(qos0->num_buckets == 2);
+	CU_ASSERT(qos1->num_buckets == 2);
+
+	/* The limits stay alive until the last poll group lets go of them */
+	rc = spdk_nvmf_ns_set_qos_limits(&subsystem, 1, UT_HOSTNQN0, 0, 0);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(qos0->refcnt == 2);
+	rc = nvmf_ns_qos_update_buckets(&ns_info[0], &ns);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(nvmf_qos_find_bucket(&ns_info[0], UT_HOSTNQN0) == NULL);
+	CU_ASSERT(nvmf_qos_find_bucket(&ns_info[0], UT_HOSTNQN1) != NULL);
+	CU_ASSERT(qos0->num_buckets == 1);
+	CU_ASSERT(qos0->refcnt == 1);
+	rc = nvmf_ns_qos_update_buckets(&ns_info[1], &ns);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(nvmf_qos_find_bucket(&ns_info[1], UT_HOSTNQN0) == NULL);
+
+	/* Namespace removal */
+	nvmf_ns_qos_clear(&ns);
+	CU_ASSERT(qos1->refcnt == 2);
+	nvmf_ns_qos_update_buckets(&ns_info[0], NULL);
+	nvmf_ns_qos_update_buckets(&ns_info[1], NULL);
+	CU_ASSERT(ns_info[0].qos_buckets == NULL);
+	CU_ASSERT(ns_info[1].qos_buckets == NULL);
+}
+
+static void
+test_nvmf_qos_admit(void)
+{
+	struct spdk_nvmf_subsystem subsystem;
+	struct spdk_nvmf_ns ns, *ns_array[1];
+	struct spdk_nvmf_subsystem_pg_ns_info ns_info[2] = {};
+	struct spdk_nvmf_ctrlr ctrlr0 = {}, ctrlr1 = {};
+	struct spdk_nvmf_qpair qpair0 = {}, qpair1 = {};
+	struct ut_qos_req r[6];
+	struct nvmf_qos_bucket *bucket0, *bucket1;
+	int rc;
+
+	ut_subsystem_init(&subsystem, &ns, ns_array);
+	snprintf(ctrlr0.hostnqn, sizeof(ctrlr0.hostnqn), "%s", UT_HOSTNQN0);
+	snprintf(ctrlr1.hostnqn, sizeof(ctrlr1.hostnqn), "%s", UT_HOSTNQN1);
+	qpair0.ctrlr = &ctrlr0;
+	qpair0.state = SPDK_NVMF_QPAIR_ENABLED;
+	qpair1.ctrlr = &ctrlr1;
+	qpair1.state = SPDK_NVMF_QPAIR_ENABLED;
+	g_num_executed = 0;
+	g_num_completed = 0;
+
+	/* 1 I/O per timeslice, shared by two poll groups */
+	rc = spdk_nvmf_ns_set_qos_limits(&subsystem, 1, UT_HOSTNQN0, 1000, 0);
+	CU_ASSERT(rc == 0);
+	rc = nvmf_ns_qos_update_buckets(&ns_info[0], &ns);
+	CU_ASSERT(rc == 0);
+	rc = nvmf_ns_qos_update_buckets(&ns_info[1], &ns);
+	CU_ASSERT(rc == 0);
+	bucket0 = ns_info[0].qos_buckets;
+	bucket1 = ns_info[1].qos_buckets;
+
+	/* Hosts without limits and commands other than reads and writes pass through */
+	ut_qos_req_init(&r[0], &qpair1, SPDK_NVME_OPC_READ, 4096);
+	CU_ASSERT(nvmf_qos_admit(&r[0].req, &ns_info[0]));
+	ut_qos_req_init(&r[0], &qpair0, SPDK_NVME_OPC_FLUSH, 0);
+	CU_ASSERT(nvmf_qos_admit(&r[0].req, &ns_info[0]));
+
+	/* The first I/O uses the initial tokens, the others have to wait */
+	ut_qos_req_init(&r[0], &qpair0, SPDK_NVME_OPC_READ, 4096);
+	CU_ASSERT(nvmf_qos_admit(&r[0].req, &ns_info[0]));
+	ut_qos_req_init(&r[1], &qpair0, SPDK_NVME_OPC_WRITE, 4096);
+	CU_ASSERT(!nvmf_qos_admit(&r[1].req, &ns_info[0]));
+	ut_qos_req_init(&r[2], &qpair0, SPDK_NVME_OPC_READ, 4096);
+	CU_ASSERT(!nvmf_qos_admit(&r[2].req, &ns_info[1]));
+	CU_ASSERT(bucket0->poller != NULL);
+	CU_ASSERT(bucket1->poller != NULL);
+
+	/* Requests queue up behind the waiting ones */
+	ut_qos_req_init(&r[3], &qpair0, SPDK_NVME_OPC_READ, 4096);
+	CU_ASSERT(!nvmf_qos_admit(&r[3].req, &ns_info[0]));
+
+	poll_threads();
+	CU_ASSERT(g_num_executed == 0);
+
+	/* A timeslice worth of tokens is spread between the poll groups */
+	spdk_delay_us(NVMF_QOS_TIMESLICE_US);
+	poll_threads();
+	CU_ASSERT(g_num_executed == 1);
+	spdk_delay_us(NVMF_QOS_TIMESLICE_US);
+	poll_threads();
+	CU_ASSERT(g_num_executed == 2);
+	spdk_delay_us(NVMF_QOS_TIMESLICE_US);
+	poll_threads();
+	CU_ASSERT(g_num_executed == 3);
+	CU_ASSERT(STAILQ_EMPTY(&bucket0->queued));
+	CU_ASSERT(STAILQ_EMPTY(&bucket1->queued));
+	CU_ASSERT(bucket0->poller == NULL);
+	CU_ASSERT(bucket1->poller == NULL);
+	CU_ASSERT(g_num_completed == 0);
+
+	/* Requests of a queue pair that went away meanwhile are aborted */
+	ut_qos_req_init(&r[4], &qpair0, SPDK_NVME_OPC_READ, 4096);
+	CU_ASSERT(!nvmf_qos_admit(&r[4].req, &ns_info[0]));
+	qpair0.state = SPDK_NVMF_QPAIR_DEACTIVATING;
+	spdk_delay_us(NVMF_QOS_TIMESLICE_US);
+	poll_threads();
+	CU_ASSERT(g_num_executed == 3);
+	CU_ASSERT(g_num_completed == 1);
+	CU_ASSERT(r[4].rsp.nvme_cpl.status.sct == SPDK_NVME_SCT_GENERIC);
+	CU_ASSERT(r[4].rsp.nvme_cpl.status.sc == SPDK_NVME_SC_ABORTED_SQ_DELETION);
+	qpair0.state = SPDK_NVMF_QPAIR_ENABLED;
+
+	/* Tokens accumulated while idle are capped */
+	spdk_delay_us(1000 * NVMF_QOS_TIMESLICE_US);
+	rc = 0;
+	while (rc < 10) {
+		ut_qos_req_init(&r[5], &qpair0, SPDK_NVME_OPC_READ, 4096);
+		if (!nvmf_qos_admit(&r[5].req, &ns_info[0])) {
+			break;
+		}
+		rc++;
+	}
+	CU_ASSERT(rc == NVMF_QOS_MAX_BURST_US / NVMF_QOS_TIMESLICE_US);
+	spdk_delay_us(NVMF_QOS_TIMESLICE_US);
+	poll_threads();
+	CU_ASSERT(STAILQ_EMPTY(&bucket0->queued));
+
+	/* Bandwidth limits let a large I/O through and hold the next ones back until the debt
+	 * is paid off.
+	 */
+	rc = spdk_nvmf_ns_set_qos_limits(&subsystem, 1, UT_HOSTNQN0, 0, 1);
+	CU_ASSERT(rc == 0);
+	g_num_executed = 0;
+	ut_qos_req_init(&r[0], &qpair0, SPDK_NVME_OPC_WRITE, 128 * 1024);
+	CU_ASSERT(nvmf_qos_admit(&r[0].req, &ns_info[0]));
+	ut_qos_req_init(&r[1], &qpair0, SPDK_NVME_OPC_WRITE, 4096);
+	CU_ASSERT(!nvmf_qos_admit(&r[1].req, &ns_info[0]));
+	/* 1 MiB/s is ~1048 bytes per timeslice, so it takes ~125 timeslices */
+	for (rc = 0; rc < 200 && g_num_executed == 0; rc++) {
+		spdk_delay_us(NVMF_QOS_TIMESLICE_US);
+		poll_threads();
+	}
+	CU_ASSERT(g_num_executed == 1);
+	CU_ASSERT(rc >= 120 && rc <= 130);
+
+	nvmf_ns_qos_clear(&ns);
+	nvmf_ns_qos_update_buckets(&ns_info[0], NULL);
+	nvmf_ns_qos_update_buckets(&ns_info[1], NULL);
+}
+
+int
+main(int argc, char **argv)
+{
+	CU_pSuite suite = NULL;
+	unsigned int num_failures;
+
+	CU_initialize_registry();
+	suite = CU_add_suite("nvmf_qos", NULL, NULL);
+	CU_ADD_TEST(suite, test_nvmf_ns_set_qos_limits);
+	CU_ADD_TEST(suite, test_nvmf_ns_qos_update_buckets);
+	CU_ADD_TEST(suite, test_nvmf_qos_admit);
+
+	allocate_threads(1);
+	set_thread(0);
+
+	num_failures = spdk_ut_run_tests(argc, argv, NULL);
+	CU_cleanup_registry();
+
+	free_threads();
+
+	return num_failures;
+}
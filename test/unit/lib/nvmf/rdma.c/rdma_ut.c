@@ -52,6 +52,8 @@ DEFINE_STUB(ibv_dereg_mr, int, (struct ibv_mr *mr), 0);
 DEFINE_STUB(ibv_resize_cq, int, (struct ibv_cq *cq, int cqe), 0);
 DEFINE_STUB(spdk_mempool_lookup, struct spdk_mempool *, (const char *name), NULL);
 DEFINE_STUB(spdk_rdma_cm_id_get_numa_id, int32_t, (struct rdma_cm_id *cm_id), 0);
+DEFINE_STUB(nvmf_transport_get_least_loaded_poll_group, struct spdk_nvmf_transport_poll_group *,
+	    (struct spdk_nvmf_transport *transport), NULL);
 
 /* ibv_reg_mr can be a macro, need to undefine it */
 #ifdef ibv_reg_mr
@@ -552,12 +554,15 @@ test_spdk_nvmf_rdma_request_process(void)
 	CU_ASSERT(progress == true);
 	CU_ASSERT(rdma_req->state == RDMA_REQUEST_STATE_EXECUTING);
 	CU_ASSERT(rdma_req->req.xfer == SPDK_NVME_DATA_CONTROLLER_TO_HOST);
-	/* EXECUTED -> TRANSFERRING_C2H */
+	/* EXECUTED -> TRANSFERRING_C2H, the response is sent inline */
+	rqpair.inline_rsp = true;
 	rdma_req->state = RDMA_REQUEST_STATE_EXECUTED;
 	progress = nvmf_rdma_request_process(&rtransport, rdma_req);
 	CU_ASSERT(progress == true);
 	CU_ASSERT(rdma_req->state == RDMA_REQUEST_STATE_TRANSFERRING_CONTROLLER_TO_HOST);
 	CU_ASSERT(rdma_req->recv == NULL);
+	CU_ASSERT(rdma_req->rsp.wr.send_flags == (IBV_SEND_SIGNALED | IBV_SEND_INLINE));
+	rqpair.inline_rsp = false;
 	/* COMPLETED -> FREE */
 	rdma_req->state = RDMA_REQUEST_STATE_COMPLETED;
 	progress = nvmf_rdma_request_process(&rtransport, rdma_req);
@@ -590,6 +595,7 @@ test_spdk_nvmf_rdma_request_process(void)
 	CU_ASSERT(progress == true);
 	CU_ASSERT(rdma_req->state == RDMA_REQUEST_STATE_COMPLETING);
 	CU_ASSERT(rdma_req->recv == NULL);
+	CU_ASSERT(rdma_req->rsp.wr.send_flags == IBV_SEND_SIGNALED);
 	/* COMPLETED -> FREE */
 	rdma_req->state = RDMA_REQUEST_STATE_COMPLETED;
 	progress = nvmf_rdma_request_process(&rtransport, rdma_req);
@@ -0,0 +1,374 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2026 Samsung Electronics Co., Ltd.
+ *   All rights reserved.
+ */
+#include "spdk/stdinc.h"
+
+#include "spdk_internal/cunit.h"
+#include "spdk_internal/mock.h"
+
+#include "common/lib/ut_multithread.c"
+#include "nvmf/reservation_bdev.c"
+
+#define UT_BLOCK_SIZE	512
+#define UT_NUM_BLOCKS	16
+
+DEFINE_STUB(spdk_bdev_module_claim_bdev, int,
+	    (struct spdk_bdev *bdev, struct spdk_bdev_desc *desc,
+	     struct spdk_bdev_module *module), 0);
+DEFINE_STUB_V(spdk_bdev_module_release_bdev, (struct spdk_bdev *bdev));
+DEFINE_STUB(spdk_bdev_is_md_interleaved, bool, (const struct spdk_bdev *bdev), false);
+DEFINE_STUB(spdk_bdev_get_buf_align, size_t, (const struct spdk_bdev *bdev), 0);
+DEFINE_STUB(spdk_bdev_queue_io_wait, int, (struct spdk_bdev *bdev, struct spdk_io_channel *ch,
+		struct spdk_bdev_io_wait_entry *entry), 0);
+DEFINE_STUB_V(spdk_bdev_free_io, (struct spdk_bdev_io *bdev_io));
+DEFINE_STUB(spdk_json_write_object_begin, int, (struct spdk_json_write_ctx *w), 0);
+DEFINE_STUB(spdk_json_write_named_object_begin, int, (struct spdk_json_write_ctx *w,
+		const char *name), 0);
+DEFINE_STUB(spdk_json_write_named_string, int, (struct spdk_json_write_ctx *w,
+		const char *name, const char *val), 0);
+DEFINE_STUB(spdk_json_write_object_end, int, (struct spdk_json_write_ctx *w), 0);
+
+static struct spdk_bdev g_bdev = {
+	.name = "rsv",
+	.blocklen = UT_BLOCK_SIZE,
+	.blockcnt = UT_NUM_BLOCKS,
+};
+static struct spdk_bdev_desc *g_desc = (struct spdk_bdev_desc *)0xdeadbeef;
+static spdk_bdev_event_cb_t g_event_cb;
+static void *g_event_ctx;
+static uint8_t g_disk[UT_NUM_BLOCKS * UT_BLOCK_SIZE];
+
+struct ut_bdev_io {
+	spdk_bdev_io_completion_cb	cb;
+	void				*cb_arg;
+	TAILQ_ENTRY(ut_bdev_io)		link;
+};
+
+static TAILQ_HEAD(, ut_bdev_io) g_bdev_ios = TAILQ_HEAD_INITIALIZER(g_bdev_ios);
+static int g_num_writes;
+static const struct spdk_nvmf_ns_reservation_ops *g_ops;
+
+int
+spdk_bdev_open_ext(const char *bdev_name, bool write, spdk_bdev_event_cb_t event_cb,
+		   void *event_ctx, struct spdk_bdev_desc **desc)
+{
+	if (strcmp(bdev_name, g_bdev.name) != 0) {
+		return -ENODEV;
+	}
+
+	g_event_cb = event_cb;
+	g_event_ctx = event_ctx;
+	*desc = g_desc;
+
+	return 0;
+}
+
+void
+spdk_bdev_close(struct spdk_bdev_desc *desc)
+{
+	g_event_cb = NULL;
+}
+
+struct spdk_bdev *
+spdk_bdev_desc_get_bdev(struct spdk_bdev_desc *desc)
+{
+	return &g_bdev;
+}
+
+uint32_t
+spdk_bdev_get_block_size(const struct spdk_bdev *bdev)
+{
+	return bdev->blocklen;
+}
+
+uint64_t
+spdk_bdev_get_num_blocks(const struct spdk_bdev *bdev)
+{
+	return bdev->blockcnt;
+}
+
+const struct spdk_uuid *
+spdk_bdev_get_uuid(const struct spdk_bdev *bdev)
+{
+	return &bdev->uuid;
+}
+
+struct spdk_io_channel *
+spdk_bdev_get_io_channel(struct spdk_bdev_desc *desc)
+{
+	return spdk_get_io_channel(&g_bdev);
+}
+
+static int
+ut_bdev_io_submit(spdk_bdev_io_completion_cb cb, void *cb_arg)
+{
+	struct ut_bdev_io *io;
+
+	io = calloc(1, sizeof(*io));
+	SPDK_CU_ASSERT_FATAL(io != NULL);
+	io->cb = cb;
+	io->cb_arg = cb_arg;
+	TAILQ_INSERT_TAIL(&g_bdev_ios, io, link);
+
+	return 0;
+}
+
+static int
+ut_complete_bdev_ios(bool success)
+{
+	TAILQ_HEAD(, ut_bdev_io) ios = TAILQ_HEAD_INITIALIZER(ios);
+	struct ut_bdev_io *io;
+	int count = 0;
+
+	TAILQ_SWAP(&ios, &g_bdev_ios, ut_bdev_io, link);
+	while ((io = TAILQ_FIRST(&ios)) != NULL) {
+		TAILQ_REMOVE(&ios, io, link);
+		io->cb((struct spdk_bdev_io *)0x1, success, io->cb_arg);
+		free(io);
+		count++;
+	}
+
+	return count;
+}
+
+int
+spdk_bdev_read_blocks(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch, void *buf,
+		      uint64_t offset_blocks, uint64_t num_blocks,
+		      spdk_bdev_io_completion_cb cb, void *cb_arg)
+{
+	SPDK_CU_ASSERT_FATAL(offset_blocks + num_blocks <= UT_NUM_BLOCKS);
+	memcpy(buf, &g_disk[offset_blocks * UT_BLOCK_SIZE], num_blocks * UT_BLOCK_SIZE);
+
+	return ut_bdev_io_submit(cb, cb_arg);
+}
+
+int
+spdk_bdev_write_blocks(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch, void *buf,
+		       uint64_t offset_blocks, uint64_t num_blocks,
+		       spdk_bdev_io_completion_cb cb, void *cb_arg)
+{
+	SPDK_CU_ASSERT_FATAL(offset_blocks + num_blocks <= UT_NUM_BLOCKS);
+	memcpy(&g_disk[offset_blocks * UT_BLOCK_SIZE], buf, num_blocks * UT_BLOCK_SIZE);
+	g_num_writes++;
+
+	return ut_bdev_io_submit(cb, cb_arg);
+}
+
+void
+spdk_nvmf_set_custom_ns_reservation_ops(const struct spdk_nvmf_ns_reservation_ops *ops)
+{
+	g_ops = ops;
+}
+
+static int
+ut_create_ch(void *io_device, void *ctx_buf)
+{
+	return 0;
+}
+
+static void
+ut_destroy_ch(void *io_device, void *ctx_buf)
+{
+}
+
+static void
+ut_status_done(void *cb_arg, int status)
+{
+	int *rc = cb_arg;
+
+	*rc = status;
+}
+
+static void
+ut_store_init(void)
+{
+	int rc, status = 1;
+
+	g_ops = NULL;
+	rc = nvmf_reservation_bdev_store_init(g_bdev.name, ut_status_done, &status);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(status == 1);
+	CU_ASSERT(ut_complete_bdev_ios(true) == 1);
+	CU_ASSERT(status == 0);
+	CU_ASSERT(g_ops == &g_rsv_bdev_ops);
+	SPDK_CU_ASSERT_FATAL(g_rsv_store != NULL);
+	/* 2 blocks per record, 2 copies per slot */
+	CU_ASSERT(g_rsv_store->num_slots == UT_NUM_BLOCKS / 4);
+}
+
+static void
+ut_store_remove(void)
+{
+	SPDK_CU_ASSERT_FATAL(g_event_cb != NULL);
+	g_event_cb(SPDK_BDEV_EVENT_REMOVE, &g_bdev, g_event_ctx);
+	poll_threads();
+	CU_ASSERT(g_rsv_store == NULL);
+}
+
+static void
+ut_info_init(struct spdk_nvmf_reservation_info *info, const char *bdev_uuid, uint64_t crkey)
+{
+	memset(info, 0, sizeof(*info));
+	info->ptpl_activated = 1;
+	info->crkey = crkey;
+	info->rtype = SPDK_NVME_RESERVE_WRITE_EXCLUSIVE;
+	info->num_regs = 1;
+	info->registrants[0].rkey = crkey;
+	snprintf(info->bdev_uuid, sizeof(info->bdev_uuid), "%s", bdev_uuid);
+	snprintf(info->holder_uuid, sizeof(info->holder_uuid), "%s", bdev_uuid);
+	snprintf(info->registrants[0].host_uuid, sizeof(info->registrants[0].host_uuid), "%s",
+		 bdev_uuid);
+}
+
+static void
+test_reservation_bdev_store(void)
+{
+	struct spdk_nvmf_ns ns = { .bdev = &g_bdev };
+	struct spdk_nvmf_reservation_info info, loaded;
+	char bdev_uuid[SPDK_UUID_STRING_LEN];
+	int rc, status[3];
+
+	memset(g_disk, 0, sizeof(g_disk));
+	spdk_uuid_generate(&g_bdev.uuid);
+	spdk_uuid_fmt_lower(bdev_uuid, sizeof(bdev_uuid), &g_bdev.uuid);
+
+	ut_store_init();
+	CU_ASSERT(g_ops->is_ptpl_capable(&ns));
+
+	/* Nothing is stored yet */
+	memset(&loaded, 0, sizeof(loaded));
+	rc = g_ops->load(&ns, &loaded);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(loaded.ptpl_activated == 0);
+
+	/* The first update is written immediately */
+	ut_info_init(&info, bdev_uuid, 0xa1);
+	status[0] = status[1] = status[2] = 1;
+	rc = g_ops->update_async(&ns, &info, ut_status_done, &status[0]);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_num_writes == 1);
+
+	/* The updates received in the meantime are written together */
+	ut_info_init(&info, bdev_uuid, 0xa2);
+	rc = g_ops->update_async(&ns, &info, ut_status_done, &status[1]);
+	CU_ASSERT(rc == 0);
+	ut_info_init(&info, bdev_uuid, 0xa3);
+	rc = g_ops->update_async(&ns, &info, ut_status_done, &status[2]);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_num_writes == 1);
+
+	CU_ASSERT(ut_complete_bdev_ios(true) == 1);
+	CU_ASSERT(status[0] == 0);
+	CU_ASSERT(status[1] == 1);
+	CU_ASSERT(status[2] == 1);
+	CU_ASSERT(g_num_writes == 2);
+
+	CU_ASSERT(ut_complete_bdev_ios(true) == 1);
+	CU_ASSERT(status[1] == 0);
+	CU_ASSERT(status[2] == 0);
+	CU_ASSERT(g_num_writes == 2);
+
+	/* Reload the latest state from the bdev */
+	ut_store_remove();
+	ut_store_init();
+	rc = g_ops->load(&ns, &loaded);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(memcmp(&loaded, &info, sizeof(info)) == 0);
+
+	/* A torn write leaves the previous state in place */
+	ut_info_init(&info, bdev_uuid, 0xa4);
+	rc = g_ops->update_async(&ns, &info, ut_status_done, &status[0]);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(ut_complete_bdev_ios(false) == 1);
+	CU_ASSERT(status[0] == -EIO);
+	g_disk[(2 * g_rsv_store->slots[0].index + 1) * 2 * UT_BLOCK_SIZE + 100] ^= 0xff;
+
+	ut_store_remove();
+	ut_store_init();
+	rc = g_ops->load(&ns, &loaded);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(loaded.crkey == 0xa3);
+
+	/* Updates fail once the bdev is gone */
+	ut_store_remove();
+	CU_ASSERT(!g_ops->is_ptpl_capable(&ns));
+	rc = g_ops->update_async(&ns, &info, ut_status_done, &status[0]);
+	CU_ASSERT(rc == -ENODEV);
+}
+
+static void
+test_reservation_bdev_store_slots(void)
+{
+	struct spdk_nvmf_ns ns = { .bdev = &g_bdev };
+	struct spdk_nvmf_reservation_info info;
+	char bdev_uuid[SPDK_UUID_STRING_LEN];
+	struct spdk_uuid uuid;
+	uint32_t i;
+	int rc, status;
+
+	memset(g_disk, 0, sizeof(g_disk));
+	ut_store_init();
+
+	/* Fill all the slots */
+	for (i = 0; i < g_rsv_store->num_slots; i++) {
+		spdk_uuid_generate(&uuid);
+		spdk_uuid_fmt_lower(bdev_uuid, sizeof(bdev_uuid), &uuid);
+		ut_info_init(&info, bdev_uuid, i + 1);
+		status = 1;
+		rc = g_ops->update_async(&ns, &info, ut_status_done, &status);
+		CU_ASSERT(rc == 0);
+		CU_ASSERT(ut_complete_bdev_ios(true) == 1);
+		CU_ASSERT(status == 0);
+	}
+
+	spdk_uuid_generate(&uuid);
+	spdk_uuid_fmt_lower(bdev_uuid, sizeof(bdev_uuid), &uuid);
+	ut_info_init(&info, bdev_uuid, 0xff);
+	status = 1;
+	rc = g_ops->update_async(&ns, &info, ut_status_done, &status);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(status == -ENOSPC);
+
+	/* A slot with PTPL deactivated can be reused by another namespace */
+	info = g_rsv_store->slots[1].info;
+	info.ptpl_activated = 0;
+	rc = g_ops->update_async(&ns, &info, ut_status_done, &status);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(ut_complete_bdev_ios(true) == 1);
+	CU_ASSERT(status == 0);
+
+	ut_info_init(&info, bdev_uuid, 0xff);
+	status = 1;
+	rc = g_ops->update_async(&ns, &info, ut_status_done, &status);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(ut_complete_bdev_ios(true) == 1);
+	CU_ASSERT(status == 0);
+	CU_ASSERT(strcmp(g_rsv_store->slots[1].info.bdev_uuid, bdev_uuid) == 0);
+
+	ut_store_remove();
+}
+
+int
+main(int argc, char **argv)
+{
+	CU_pSuite suite = NULL;
+	unsigned int num_failures;
+
+	CU_initialize_registry();
+	suite = CU_add_suite("nvmf_reservation_bdev", NULL, NULL);
+	CU_ADD_TEST(suite, test_reservation_bdev_store);
+	CU_ADD_TEST(suite, test_reservation_bdev_store_slots);
+
+	allocate_threads(1);
+	set_thread(0);
+	spdk_io_device_register(&g_bdev, ut_create_ch, ut_destroy_ch, 0, "ut_bdev");
+
+	num_failures = spdk_ut_run_tests(argc, argv, NULL);
+	CU_cleanup_registry();
+
+	spdk_io_device_unregister(&g_bdev, NULL);
+	free_threads();
+
+	return num_failures;
+}
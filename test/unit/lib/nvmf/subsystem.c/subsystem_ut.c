@@ -77,6 +77,7 @@ DEFINE_STUB(nvmf_tgt_update_mdns_prr, int, (struct spdk_nvmf_tgt *tgt), 0);
 DEFINE_STUB(spdk_bdev_get_module_name, const char *, (const struct spdk_bdev *bdev), "nvme");
 DEFINE_STUB(spdk_bdev_get_module_ctx, void *, (struct spdk_bdev_desc *desc), NULL);
 DEFINE_STUB(spdk_nvme_ns_get_id, uint32_t, (struct spdk_nvme_ns *ns), 0);
+DEFINE_STUB_V(nvmf_ns_qos_clear, (struct spdk_nvmf_ns *ns));
 
 static struct spdk_nvmf_transport g_transport = {};
 
@@ -98,7 +99,7 @@ spdk_nvmf_tgt_get_transport(struct spdk_nvmf_tgt *tgt, const char *transport_nam
 
 int
 nvmf_poll_group_update_subsystem(struct spdk_nvmf_poll_group *group,
-				 struct spdk_nvmf_subsystem *subsystem)
+				 struct spdk_nvmf_subsystem *subsystem, uint32_t nsid)
 {
 	return 0;
 }
@@ -751,6 +752,14 @@ nvmf_ctrlr_async_event_reservation_notification(struct spdk_nvmf_ctrlr *ctrlr)
 {
 }
 
+static void
+ut_reservation_update_done(void *cb_arg, int status)
+{
+	int *rc = cb_arg;
+
+	*rc = status;
+}
+
 static void
 ut_reservation_init(void)
 {
@@ -1097,7 +1106,8 @@ test_reservation_register_with_ptpl(void)
 	SPDK_CU_ASSERT_FATAL(update_sgroup == true);
 	SPDK_CU_ASSERT_FATAL(rsp->status.sc == SPDK_NVME_SC_SUCCESS);
 	SPDK_CU_ASSERT_FATAL(g_ns.ptpl_activated == true);
-	rc = nvmf_ns_update_reservation_info(&g_ns);
+	rc = -1;
+	nvmf_ns_update_reservation_info(&g_ns, ut_reservation_update_done, &rc);
 	SPDK_CU_ASSERT_FATAL(rc == 0);
 	reg = nvmf_ns_reservation_get_registrant(&g_ns, &g_ctrlr1_A.hostid);
 	SPDK_CU_ASSERT_FATAL(reg != NULL);
@@ -1116,7 +1126,8 @@ test_reservation_register_with_ptpl(void)
 	SPDK_CU_ASSERT_FATAL(update_sgroup == true);
 	SPDK_CU_ASSERT_FATAL(rsp->status.sc == SPDK_NVME_SC_SUCCESS);
 	SPDK_CU_ASSERT_FATAL(g_ns.ptpl_activated == false);
-	rc = nvmf_ns_update_reservation_info(&g_ns);
+	rc = -1;
+	nvmf_ns_update_reservation_info(&g_ns, ut_reservation_update_done, &rc);
 	SPDK_CU_ASSERT_FATAL(rc == 0);
 	rc = nvmf_ns_reservation_load(&g_ns, &info);
 	SPDK_CU_ASSERT_FATAL(rc < 0);
@@ -1222,7 +1233,8 @@ test_reservation_acquire_release_with_ptpl(void)
 	SPDK_CU_ASSERT_FATAL(update_sgroup == true);
 	SPDK_CU_ASSERT_FATAL(rsp->status.sc == SPDK_NVME_SC_SUCCESS);
 	SPDK_CU_ASSERT_FATAL(g_ns.ptpl_activated == true);
-	rc = nvmf_ns_update_reservation_info(&g_ns);
+	rc = -1;
+	nvmf_ns_update_reservation_info(&g_ns, ut_reservation_update_done, &rc);
 	SPDK_CU_ASSERT_FATAL(rc == 0);
 	reg = nvmf_ns_reservation_get_registrant(&g_ns, &g_ctrlr1_A.hostid);
 	SPDK_CU_ASSERT_FATAL(reg != NULL);
@@ -1240,7 +1252,8 @@ test_reservation_acquire_release_with_ptpl(void)
 	update_sgroup = nvmf_ns_reservation_acquire(&g_ns, &g_ctrlr1_A, req);
 	SPDK_CU_ASSERT_FATAL(update_sgroup == true);
 	SPDK_CU_ASSERT_FATAL(rsp->status.sc == SPDK_NVME_SC_SUCCESS);
-	rc = nvmf_ns_update_reservation_info(&g_ns);
+	rc = -1;
+	nvmf_ns_update_reservation_info(&g_ns, ut_reservation_update_done, &rc);
 	SPDK_CU_ASSERT_FATAL(rc == 0);
 	memset(&info, 0, sizeof(info));
 	rc = nvmf_ns_reservation_load(&g_ns, &info);
@@ -1258,7 +1271,8 @@ test_reservation_acquire_release_with_ptpl(void)
 	update_sgroup = nvmf_ns_reservation_release(&g_ns, &g_ctrlr1_A, req);
 	SPDK_CU_ASSERT_FATAL(update_sgroup == true);
 	SPDK_CU_ASSERT_FATAL(rsp->status.sc == SPDK_NVME_SC_SUCCESS);
-	rc = nvmf_ns_update_reservation_info(&g_ns);
+	rc = -1;
+	nvmf_ns_update_reservation_info(&g_ns, ut_reservation_update_done, &rc);
 	SPDK_CU_ASSERT_FATAL(rc == 0);
 	memset(&info, 0, sizeof(info));
 	rc = nvmf_ns_reservation_load(&g_ns, &info);
@@ -2171,7 +2185,8 @@ test_nvmf_reservation_custom_ops(void)
 	SPDK_CU_ASSERT_FATAL(update_sgroup == true);
 	SPDK_CU_ASSERT_FATAL(rsp->status.sc == SPDK_NVME_SC_SUCCESS);
 	SPDK_CU_ASSERT_FATAL(g_ns.ptpl_activated == true);
-	rc = nvmf_ns_update_reservation_info(&g_ns);
+	rc = -1;
+	nvmf_ns_update_reservation_info(&g_ns, ut_reservation_update_done, &rc);
 	SPDK_CU_ASSERT_FATAL(rc == 0);
 
 	/* Acquire a reservation */
@@ -2181,7 +2196,8 @@ test_nvmf_reservation_custom_ops(void)
 	update_sgroup = nvmf_ns_reservation_acquire(&g_ns, &g_ctrlr1_A, req);
 	SPDK_CU_ASSERT_FATAL(update_sgroup == true);
 	SPDK_CU_ASSERT_FATAL(rsp->status.sc == SPDK_NVME_SC_SUCCESS);
-	rc = nvmf_ns_update_reservation_info(&g_ns);
+	rc = -1;
+	nvmf_ns_update_reservation_info(&g_ns, ut_reservation_update_done, &rc);
 	SPDK_CU_ASSERT_FATAL(rc == 0);
 
 	/* Add the namespace using a different subsystem.
@@ -188,6 +188,11 @@ DEFINE_STUB(nvmf_bdev_zcopy_enabled,
 	    (struct spdk_bdev *bdev),
 	    false);
 
+DEFINE_STUB(nvmf_bdev_ctrlr_read_buf_fits,
+	    bool,
+	    (struct spdk_bdev *bdev, struct spdk_nvmf_request *req),
+	    true);
+
 DEFINE_STUB(nvmf_bdev_ctrlr_zcopy_start,
 	    int,
 	    (struct spdk_bdev *bdev, struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
@@ -273,6 +278,9 @@ spdk_accel_get_io_channel(void)
 	return spdk_get_io_channel(g_accel_p);
 }
 
+DEFINE_STUB(spdk_accel_get_opc_module_name, int,
+	    (enum spdk_accel_opcode opcode, const char **module_name), -ENOENT);
+
 DEFINE_STUB(spdk_accel_submit_crc32cv,
 	    int,
 	    (struct spdk_io_channel *ch, uint32_t *dst, struct iovec *iovs,
@@ -286,6 +294,11 @@ DEFINE_STUB(spdk_nvmf_bdev_ctrlr_nvme_passthru_admin,
 	     spdk_nvmf_nvme_passthru_cmd_cb cb_fn),
 	    0)
 
+DEFINE_STUB(nvmf_transport_get_least_loaded_poll_group, struct spdk_nvmf_transport_poll_group *,
+	    (struct spdk_nvmf_transport *transport), NULL);
+DEFINE_STUB(nvmf_qos_admit, bool,
+	    (struct spdk_nvmf_request *req, struct spdk_nvmf_subsystem_pg_ns_info *ns_info), true);
+
 struct spdk_key {
 	const char *name;
 	char data[4096];
@@ -550,6 +563,7 @@ test_nvmf_tcp_poll_group_create(void)
 	struct spdk_nvmf_transport *transport;
 	struct spdk_nvmf_transport_poll_group *group;
 	struct spdk_nvmf_tcp_poll_group *tgroup;
+	struct spdk_nvmf_tcp_transport *ttransport;
 	struct spdk_thread *thread;
 	struct spdk_nvmf_transport_opts opts;
 	struct spdk_sock_group grp = {};
@@ -577,10 +591,26 @@ test_nvmf_tcp_poll_group_create(void)
 	group = nvmf_tcp_poll_group_create(transport, NULL);
 	MOCK_CLEAR_P(spdk_sock_group_create);
 	SPDK_CU_ASSERT_FATAL(group);
+	tgroup = SPDK_CONTAINEROF(group, struct spdk_nvmf_tcp_poll_group, group);
 	if (opts.in_capsule_data_size < SPDK_NVME_TCP_IN_CAPSULE_DATA_MAX_SIZE) {
-		tgroup = SPDK_CONTAINEROF(group, struct spdk_nvmf_tcp_poll_group, group);
 		SPDK_CU_ASSERT_FATAL(tgroup->control_msg_list);
 	}
+	CU_ASSERT(tgroup->recv_bufs == NULL);
+	CU_ASSERT(nvmf_tcp_poll_group_can_detach(group, NULL));
+	group->transport = transport;
+	nvmf_tcp_poll_group_destroy(group);
+
+	/* Receive buffers are provided to the sock group when requested */
+	ttransport = SPDK_CONTAINEROF(transport, struct spdk_nvmf_tcp_transport, transport);
+	ttransport->tcp_opts.recv_buf_count = 4;
+	MOCK_SET(spdk_sock_group_create, &grp);
+	group = nvmf_tcp_poll_group_create(transport, NULL);
+	MOCK_CLEAR_P(spdk_sock_group_create);
+	SPDK_CU_ASSERT_FATAL(group);
+	tgroup = SPDK_CONTAINEROF(group, struct spdk_nvmf_tcp_poll_group, group);
+	CU_ASSERT(tgroup->recv_bufs != NULL);
+	/* Qpairs can't be moved to another poll group with data in the provided buffers */
+	CU_ASSERT(!nvmf_tcp_poll_group_can_detach(group, NULL));
 	group->transport = transport;
 	nvmf_tcp_poll_group_destroy(group);
 	nvmf_tcp_destroy(transport, NULL, NULL);
@@ -1522,6 +1552,106 @@ test_nvmf_tcp_tls_generate_tls_psk(void)
 					  NVME_TCP_CIPHER_AES_128_GCM_SHA256) < 0);
 }
 
+static void
+test_nvmf_tcp_pdu_recv_data(void)
+{
+	struct nvme_tcp_pdu pdu = {};
+	struct spdk_dif_ctx dif_ctx = {};
+	struct spdk_dif_ctx_init_ext_opts dif_opts;
+	struct spdk_dif_error err_blk = {};
+	uint8_t data[1040], expected[1040];
+	uint32_t crc32c, i;
+	int rc;
+
+	for (i = 0; i < sizeof(data); i++) {
+		data[i] = i * 7 + 3;
+	}
+
+	/* Digest accumulated over reads of any size matches the one calculated at once */
+	pdu.data_iov[0].iov_base = data;
+	pdu.data_iov[0].iov_len = 100;
+	pdu.data_iov[1].iov_base = data + 100;
+	pdu.data_iov[1].iov_len = 922;
+	pdu.data_iovcnt = 2;
+	pdu.data_len = 1022;
+	pdu.ddgst_inline = true;
+	pdu.data_digest_crc32 = SPDK_CRC32C_XOR;
+
+	CU_ASSERT(nvmf_tcp_pdu_recv_data(&pdu, 0, 1) == 0);
+	CU_ASSERT(nvmf_tcp_pdu_recv_data(&pdu, 1, 500) == 0);
+	/* The last read also returns the data digest itself */
+	CU_ASSERT(nvmf_tcp_pdu_recv_data(&pdu, 501, 521 + SPDK_NVME_TCP_DIGEST_LEN) == 0);
+	crc32c = nvme_tcp_pdu_pad_data_digest(&pdu, pdu.data_digest_crc32);
+	CU_ASSERT(crc32c == nvme_tcp_pdu_calc_data_digest(&pdu));
+
+	/* DIF is inserted and the digest skips the metadata */
+	dif_opts.size = SPDK_SIZEOF(&dif_opts, dif_pi_format);
+	dif_opts.dif_pi_format = SPDK_DIF_PI_FORMAT_16;
+	rc = spdk_dif_ctx_init(&dif_ctx, 520, 8, true, false, SPDK_DIF_TYPE1,
+			       SPDK_DIF_FLAGS_GUARD_CHECK | SPDK_DIF_FLAGS_REFTAG_CHECK,
+			       22, 0, 0, 0, 0, &dif_opts);
+	CU_ASSERT(rc == 0);
+
+	memset(data + 512, 0, 8);
+	memset(data + 1032, 0, 8);
+	memcpy(expected, data, sizeof(data));
+	pdu.data_iov[0].iov_base = expected;
+	pdu.data_iov[0].iov_len = sizeof(expected);
+	pdu.data_iovcnt = 1;
+	rc = spdk_dif_generate(pdu.data_iov, 1, 2, &dif_ctx);
+	CU_ASSERT(rc == 0);
+
+	pdu.data_iov[0].iov_base = data;
+	pdu.data_iov[0].iov_len = sizeof(data);
+	pdu.data_len = 1024;
+	pdu.dif_ctx = &dif_ctx;
+	pdu.data_digest_crc32 = SPDK_CRC32C_XOR;
+
+	CU_ASSERT(nvmf_tcp_pdu_recv_data(&pdu, 0, 300) == 0);
+	CU_ASSERT(nvmf_tcp_pdu_recv_data(&pdu, 300, 600) == 0);
+	CU_ASSERT(nvmf_tcp_pdu_recv_data(&pdu, 900, 124 + SPDK_NVME_TCP_DIGEST_LEN) == 0);
+	CU_ASSERT(memcmp(data, expected, sizeof(data)) == 0);
+	CU_ASSERT(spdk_dif_verify(pdu.data_iov, 1, 2, &dif_ctx, &err_blk) == 0);
+	crc32c = nvme_tcp_pdu_pad_data_digest(&pdu, pdu.data_digest_crc32);
+	CU_ASSERT(crc32c == nvme_tcp_pdu_calc_data_digest(&pdu));
+}
+
+static void
+test_nvmf_tcp_qpair_draining(void)
+{
+	struct spdk_nvmf_tcp_transport ttransport = {};
+	struct spdk_nvmf_tcp_qpair tqpair = {};
+	struct nvme_tcp_pdu pdu = {};
+
+	tqpair.qpair.transport = &ttransport.transport;
+	tqpair.state = NVMF_TCP_QPAIR_STATE_RUNNING;
+	tqpair.recv_state = NVME_TCP_PDU_RECV_STATE_AWAIT_PDU_READY;
+	SLIST_INIT(&tqpair.tcp_pdu_free_queue);
+	SLIST_INSERT_HEAD(&tqpair.tcp_pdu_free_queue, &pdu, slist);
+
+	/* A draining qpair doesn't read the next command */
+	tqpair.qpair.draining = true;
+	nvmf_tcp_sock_process(&tqpair);
+	CU_ASSERT(tqpair.recv_state == NVME_TCP_PDU_RECV_STATE_AWAIT_PDU_CH);
+	CU_ASSERT(tqpair.pdu_in_progress == &pdu);
+	CU_ASSERT(pdu.ch_valid_bytes == 0);
+
+	/* Unless a command in progress may still need data from the host */
+	tqpair.state_cntr[TCP_REQUEST_STATE_TRANSFERRING_HOST_TO_CONTROLLER] = 1;
+	nvmf_tcp_sock_process(&tqpair);
+	CU_ASSERT(pdu.ch_valid_bytes == 1);
+	tqpair.state_cntr[TCP_REQUEST_STATE_TRANSFERRING_HOST_TO_CONTROLLER] = 0;
+
+	/* A PDU which was started is always received in full */
+	nvmf_tcp_sock_process(&tqpair);
+	CU_ASSERT(pdu.ch_valid_bytes == 2);
+
+	pdu.ch_valid_bytes = 0;
+	tqpair.qpair.draining = false;
+	nvmf_tcp_sock_process(&tqpair);
+	CU_ASSERT(pdu.ch_valid_bytes == 1);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -1545,6 +1675,8 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_nvmf_tcp_check_xfer_type);
 	CU_ADD_TEST(suite, test_nvmf_tcp_invalid_sgl);
 	CU_ADD_TEST(suite, test_nvmf_tcp_pdu_ch_handle);
+	CU_ADD_TEST(suite, test_nvmf_tcp_pdu_recv_data);
+	CU_ADD_TEST(suite, test_nvmf_tcp_qpair_draining);
 	CU_ADD_TEST(suite, test_nvmf_tcp_tls_add_remove_credentials);
 	CU_ADD_TEST(suite, test_nvmf_tcp_tls_generate_psk_id);
 	CU_ADD_TEST(suite, test_nvmf_tcp_tls_generate_retained_psk);
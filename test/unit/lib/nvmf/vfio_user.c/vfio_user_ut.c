@@ -247,6 +247,320 @@ test_nvmf_vfio_user_create_destroy(void)
 	CU_ASSERT(done == 1);
 }
 
+static void
+ut_irq_coalescing_ctrlr_init(struct nvmf_vfio_user_ctrlr *vu_ctrlr, struct spdk_nvmf_ctrlr *ctrlr,
+			     struct nvmf_vfio_user_endpoint *endpoint)
+{
+	memset(vu_ctrlr, 0, sizeof(*vu_ctrlr));
+	memset(ctrlr, 0, sizeof(*ctrlr));
+
+	vu_ctrlr->ctrlr = ctrlr;
+	vu_ctrlr->endpoint = endpoint;
+	TAILQ_INIT(&vu_ctrlr->connected_sqs);
+}
+
+static void
+test_vfio_user_irq_coalescing(void)
+{
+	struct spdk_thread *thread;
+	struct spdk_nvmf_poll_group group = {};
+	struct nvmf_vfio_user_poll_group vu_group = {};
+	struct nvmf_vfio_user_endpoint endpoint = {};
+	struct nvmf_vfio_user_ctrlr vu_ctrlr;
+	struct spdk_nvmf_ctrlr ctrlr;
+	struct nvmf_vfio_user_sq sq = {}, sq2 = {};
+	struct nvmf_vfio_user_cq cq = {};
+	struct spdk_nvmf_request req = {};
+	int rc;
+
+	thread = spdk_thread_create(NULL, NULL);
+	SPDK_CU_ASSERT_FATAL(thread != NULL);
+	spdk_set_thread(thread);
+
+	ut_irq_coalescing_ctrlr_init(&vu_ctrlr, &ctrlr, &endpoint);
+
+	group.thread = thread;
+	vu_group.group.group = &group;
+	TAILQ_INIT(&vu_group.sqs);
+	vu_group.irq_poller = SPDK_POLLER_REGISTER(vfio_user_poll_group_irq_poller, &vu_group,
+			      NVMF_VFIO_USER_IRQ_COALESCING_PERIOD_US);
+	SPDK_CU_ASSERT_FATAL(vu_group.irq_poller != NULL);
+	spdk_poller_pause(vu_group.irq_poller);
+
+	sq.qid = 1;
+	sq.cqid = 1;
+	sq.ctrlr = &vu_ctrlr;
+	TAILQ_INIT(&sq.qpair.outstanding);
+	TAILQ_INSERT_TAIL(&vu_group.sqs, &sq, link);
+	vu_ctrlr.sqs[1] = &sq;
+
+	/* Interrupts are disabled so that the poller only drops the expired ones. */
+	cq.qid = 1;
+	cq.iv = 1;
+	cq.ien = false;
+	cq.group = &vu_group.group;
+	vu_ctrlr.cqs[1] = &cq;
+
+	/* Coalescing is off until both the threshold and the time are set. */
+	ctrlr.feat.interrupt_coalescing.bits.thr = 2;
+	CU_ASSERT(!cq_irq_coalescing_enabled(&vu_ctrlr, &cq));
+	ctrlr.feat.interrupt_coalescing.bits.time = 1;
+	CU_ASSERT(cq_irq_coalescing_enabled(&vu_ctrlr, &cq));
+
+	/* It can be disabled per interrupt vector. */
+	set_irq_coalescing_disabled(&vu_ctrlr, 1, true);
+	CU_ASSERT(!cq_irq_coalescing_enabled(&vu_ctrlr, &cq));
+	set_irq_coalescing_disabled(&vu_ctrlr, 1, false);
+	CU_ASSERT(cq_irq_coalescing_enabled(&vu_ctrlr, &cq));
+
+	/* The interrupt isn't delayed if there is nothing else to aggregate it with. */
+	CU_ASSERT(!cq_hold_irq(&vu_ctrlr, &cq, &sq));
+	CU_ASSERT(cq.irq_pending == 0);
+	CU_ASSERT(!vu_group.irq_poller_active);
+
+	/* The threshold is 0's based: the interrupt fires with the third completion. */
+	TAILQ_INSERT_TAIL(&sq.qpair.outstanding, &req, link);
+
+	CU_ASSERT(cq_hold_irq(&vu_ctrlr, &cq, &sq));
+	CU_ASSERT(cq.irq_pending == 1);
+	CU_ASSERT(cq.irq_pending_tsc == spdk_get_ticks());
+	CU_ASSERT(vu_group.irq_poller_active);
+
+	CU_ASSERT(cq_hold_irq(&vu_ctrlr, &cq, &sq));
+	CU_ASSERT(cq.irq_pending == 2);
+
+	CU_ASSERT(!cq_hold_irq(&vu_ctrlr, &cq, &sq));
+	CU_ASSERT(cq.irq_pending == 2);
+	CU_ASSERT(vu_group.stats.irqs_coalesced == 2);
+
+	/* The held back interrupts are kept until the aggregation time expires. */
+	rc = vfio_user_poll_group_irq_poller(&vu_group);
+	CU_ASSERT(rc == SPDK_POLLER_IDLE);
+	CU_ASSERT(cq.irq_pending == 2);
+	CU_ASSERT(vu_group.irq_poller_active);
+
+	spdk_delay_us(NVMF_VFIO_USER_IRQ_COALESCING_PERIOD_US - 1);
+	rc = vfio_user_poll_group_irq_poller(&vu_group);
+	CU_ASSERT(rc == SPDK_POLLER_IDLE);
+	CU_ASSERT(cq.irq_pending == 2);
+
+	spdk_delay_us(1);
+	rc = vfio_user_poll_group_irq_poller(&vu_group);
+	CU_ASSERT(rc == SPDK_POLLER_BUSY);
+	CU_ASSERT(cq.irq_pending == 0);
+	CU_ASSERT(!vu_group.irq_poller_active);
+
+	/* Nothing pending, the poller has nothing to do. */
+	rc = vfio_user_poll_group_irq_poller(&vu_group);
+	CU_ASSERT(rc == SPDK_POLLER_IDLE);
+
+	/* An interrupt held back for a CQ isn't lost once its last SQ is deleted. */
+	sq2.qid = 2;
+	sq2.cqid = 1;
+	sq2.ctrlr = &vu_ctrlr;
+	TAILQ_INIT(&sq2.qpair.outstanding);
+	TAILQ_INSERT_TAIL(&vu_group.sqs, &sq2, link);
+	vu_ctrlr.sqs[2] = &sq2;
+
+	CU_ASSERT(cq_hold_irq(&vu_ctrlr, &cq, &sq));
+	CU_ASSERT(cq.irq_pending == 1);
+
+	rc = nvmf_vfio_user_poll_group_remove(&vu_group.group, &sq.qpair);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(cq.irq_pending == 1);
+
+	rc = nvmf_vfio_user_poll_group_remove(&vu_group.group, &sq2.qpair);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(TAILQ_EMPTY(&vu_group.sqs));
+	CU_ASSERT(cq.irq_pending == 0);
+
+	rc = vfio_user_poll_group_irq_poller(&vu_group);
+	CU_ASSERT(rc == SPDK_POLLER_IDLE);
+	CU_ASSERT(!vu_group.irq_poller_active);
+
+	spdk_poller_unregister(&vu_group.irq_poller);
+
+	spdk_thread_exit(thread);
+	while (!spdk_thread_is_exited(thread)) {
+		spdk_thread_poll(thread, 0, 0);
+	}
+	spdk_thread_destroy(thread);
+}
+
+static void
+ut_irq_feature_cmd(struct nvmf_vfio_user_ctrlr *vu_ctrlr, uint8_t opc, uint8_t fid, bool sv,
+		   uint32_t cdw11, struct spdk_nvme_cpl *cpl)
+{
+	struct nvmf_vfio_user_cq *cq = vu_ctrlr->cqs[0];
+	struct spdk_nvme_cmd cmd = {};
+	int rc;
+
+	cmd.opc = opc;
+	cmd.cid = 0x10;
+	cmd.cdw10_bits.set_features.fid = fid;
+	cmd.cdw10_bits.set_features.sv = sv;
+	cmd.cdw11 = cdw11;
+
+	CU_ASSERT(is_irq_feature_cmd(&cmd));
+
+	rc = handle_irq_feature(vu_ctrlr, &cmd);
+	CU_ASSERT(rc == 0);
+
+	*cpl = ((struct spdk_nvme_cpl *)q_addr(&cq->mapping))[cq->tail - 1];
+	CU_ASSERT(cpl->cid == 0x10);
+}
+
+static void
+test_vfio_user_irq_coalescing_feature(void)
+{
+	struct spdk_thread *thread;
+	struct spdk_nvmf_poll_group group = {};
+	struct spdk_nvmf_transport_poll_group tgroup = {};
+	struct nvmf_vfio_user_endpoint endpoint = {};
+	struct nvmf_vfio_user_ctrlr vu_ctrlr;
+	struct spdk_nvmf_ctrlr ctrlr;
+	struct nvmf_vfio_user_sq sq = {};
+	struct nvmf_vfio_user_cq cq = {};
+	struct spdk_nvme_cpl cpls[16] = {};
+	union spdk_nvme_feat_interrupt_coalescing coalescing = {};
+	union spdk_nvme_feat_interrupt_vector_configuration iv_conf = {};
+	struct spdk_nvme_cmd cmd = {};
+	struct spdk_nvme_cpl cpl;
+	uint32_t head = 0;
+
+	thread = spdk_thread_create(NULL, NULL);
+	SPDK_CU_ASSERT_FATAL(thread != NULL);
+	spdk_set_thread(thread);
+
+	ut_irq_coalescing_ctrlr_init(&vu_ctrlr, &ctrlr, &endpoint);
+
+	group.thread = thread;
+	tgroup.group = &group;
+
+	sq.ctrlr = &vu_ctrlr;
+	vu_ctrlr.sqs[0] = &sq;
+
+	cq.group = &tgroup;
+	cq.size = SPDK_COUNTOF(cpls);
+	cq.mapping.iov.iov_base = cpls;
+	cq.dbl_headp = &head;
+	vu_ctrlr.cqs[0] = &cq;
+
+	/* Get Features - Interrupt Coalescing is left to the NVMf controller. */
+	cmd.opc = SPDK_NVME_OPC_GET_FEATURES;
+	cmd.cdw10_bits.get_features.fid = SPDK_NVME_FEAT_INTERRUPT_COALESCING;
+	CU_ASSERT(!is_irq_feature_cmd(&cmd));
+
+	/* Set Features - Interrupt Coalescing */
+	coalescing.bits.thr = 7;
+	coalescing.bits.time = 3;
+	ut_irq_feature_cmd(&vu_ctrlr, SPDK_NVME_OPC_SET_FEATURES,
+			   SPDK_NVME_FEAT_INTERRUPT_COALESCING, false, coalescing.raw, &cpl);
+	CU_ASSERT(cpl.status.sct == SPDK_NVME_SCT_GENERIC);
+	CU_ASSERT(cpl.status.sc == SPDK_NVME_SC_SUCCESS);
+	CU_ASSERT(ctrlr.feat.interrupt_coalescing.bits.thr == 7);
+	CU_ASSERT(ctrlr.feat.interrupt_coalescing.bits.time == 3);
+
+	/* The features can't be saved. */
+	coalescing.bits.thr = 1;
+	ut_irq_feature_cmd(&vu_ctrlr, SPDK_NVME_OPC_SET_FEATURES,
+			   SPDK_NVME_FEAT_INTERRUPT_COALESCING, true, coalescing.raw, &cpl);
+	CU_ASSERT(cpl.status.sct == SPDK_NVME_SCT_COMMAND_SPECIFIC);
+	CU_ASSERT(cpl.status.sc == SPDK_NVME_SC_FEATURE_ID_NOT_SAVEABLE);
+	CU_ASSERT(ctrlr.feat.interrupt_coalescing.bits.thr == 7);
+
+	/* Set Features - Interrupt Vector Configuration disables coalescing per vector. */
+	iv_conf.bits.iv = 3;
+	iv_conf.bits.cd = 1;
+	ut_irq_feature_cmd(&vu_ctrlr, SPDK_NVME_OPC_SET_FEATURES,
+			   SPDK_NVME_FEAT_INTERRUPT_VECTOR_CONFIGURATION, false, iv_conf.raw, &cpl);
+	CU_ASSERT(cpl.status.sc == SPDK_NVME_SC_SUCCESS);
+	CU_ASSERT(irq_coalescing_disabled(&vu_ctrlr, 3));
+	CU_ASSERT(!irq_coalescing_disabled(&vu_ctrlr, 2));
+
+	/* Get Features - Interrupt Vector Configuration */
+	iv_conf.raw = 0;
+	iv_conf.bits.iv = 3;
+	ut_irq_feature_cmd(&vu_ctrlr, SPDK_NVME_OPC_GET_FEATURES,
+			   SPDK_NVME_FEAT_INTERRUPT_VECTOR_CONFIGURATION, false, iv_conf.raw, &cpl);
+	CU_ASSERT(cpl.status.sc == SPDK_NVME_SC_SUCCESS);
+	iv_conf.raw = cpl.cdw0;
+	CU_ASSERT(iv_conf.bits.iv == 3);
+	CU_ASSERT(iv_conf.bits.cd == 1);
+
+	iv_conf.raw = 0;
+	iv_conf.bits.iv = 2;
+	ut_irq_feature_cmd(&vu_ctrlr, SPDK_NVME_OPC_GET_FEATURES,
+			   SPDK_NVME_FEAT_INTERRUPT_VECTOR_CONFIGURATION, false, iv_conf.raw, &cpl);
+	iv_conf.raw = cpl.cdw0;
+	CU_ASSERT(iv_conf.bits.iv == 2);
+	CU_ASSERT(iv_conf.bits.cd == 0);
+
+	/* Coalescing never applies to the Admin CQ. */
+	iv_conf.raw = 0;
+	ut_irq_feature_cmd(&vu_ctrlr, SPDK_NVME_OPC_GET_FEATURES,
+			   SPDK_NVME_FEAT_INTERRUPT_VECTOR_CONFIGURATION, false, iv_conf.raw, &cpl);
+	iv_conf.raw = cpl.cdw0;
+	CU_ASSERT(iv_conf.bits.cd == 1);
+
+	/* Vectors beyond the ones the controller supports are rejected. */
+	iv_conf.raw = 0;
+	iv_conf.bits.iv = NVME_IRQ_MSIX_NUM;
+	iv_conf.bits.cd = 1;
+	ut_irq_feature_cmd(&vu_ctrlr, SPDK_NVME_OPC_SET_FEATURES,
+			   SPDK_NVME_FEAT_INTERRUPT_VECTOR_CONFIGURATION, false, iv_conf.raw, &cpl);
+	CU_ASSERT(cpl.status.sct == SPDK_NVME_SCT_GENERIC);
+	CU_ASSERT(cpl.status.sc == SPDK_NVME_SC_INVALID_FIELD);
+
+	spdk_thread_exit(thread);
+	while (!spdk_thread_is_exited(thread)) {
+		spdk_thread_poll(thread, 0, 0);
+	}
+	spdk_thread_destroy(thread);
+}
+
+static void
+test_vfio_user_migr_irq_coalescing(void)
+{
+	struct nvmf_vfio_user_endpoint endpoint = {};
+	struct nvmf_vfio_user_ctrlr src, dst;
+	struct spdk_nvmf_ctrlr src_ctrlr, dst_ctrlr;
+	struct nvmf_vfio_user_sq sq = {};
+	struct nvmf_vfio_user_cq cq = {};
+	uint32_t doorbells[NVMF_VFIO_USER_DOORBELLS_SIZE / sizeof(uint32_t)] = {};
+	uint8_t cfg[NVME_REG_CFG_SIZE] = {};
+	int rc;
+
+	endpoint.migr_data = calloc(1, vfio_user_migr_data_len());
+	SPDK_CU_ASSERT_FATAL(endpoint.migr_data != NULL);
+	endpoint.pci_config_space = (vfu_pci_config_space_t *)cfg;
+
+	/* Only the Admin queue pair is connected, and it isn't mapped. */
+	ut_irq_coalescing_ctrlr_init(&src, &src_ctrlr, &endpoint);
+	src.bar0_doorbells = doorbells;
+	src.sqs[0] = &sq;
+	src.cqs[0] = &cq;
+	TAILQ_INSERT_TAIL(&src.connected_sqs, &sq, tailq);
+
+	set_irq_coalescing_disabled(&src, 1, true);
+	set_irq_coalescing_disabled(&src, NVME_IRQ_MSIX_NUM - 1, true);
+
+	vfio_user_migr_ctrlr_save_data(&src);
+
+	ut_irq_coalescing_ctrlr_init(&dst, &dst_ctrlr, &endpoint);
+	dst.bar0_doorbells = doorbells;
+
+	rc = vfio_user_migr_ctrlr_restore(&dst);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(irq_coalescing_disabled(&dst, 1));
+	CU_ASSERT(irq_coalescing_disabled(&dst, NVME_IRQ_MSIX_NUM - 1));
+	CU_ASSERT(!irq_coalescing_disabled(&dst, 2));
+	CU_ASSERT(memcmp(dst.irq_coalescing_disabled, src.irq_coalescing_disabled,
+			 sizeof(dst.irq_coalescing_disabled)) == 0);
+
+	free(endpoint.migr_data);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -260,6 +574,9 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_nvme_cmd_map_prps);
 	CU_ADD_TEST(suite, test_nvme_cmd_map_sgls);
 	CU_ADD_TEST(suite, test_nvmf_vfio_user_create_destroy);
+	CU_ADD_TEST(suite, test_vfio_user_irq_coalescing);
+	CU_ADD_TEST(suite, test_vfio_user_irq_coalescing_feature);
+	CU_ADD_TEST(suite, test_vfio_user_migr_irq_coalescing);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 	CU_cleanup_registry();
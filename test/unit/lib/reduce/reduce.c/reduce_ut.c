@@ -62,6 +62,9 @@ struct ut_reduce_bdev_io {
 };
 
 static bool g_defer_bdev_io = false;
+static uint32_t g_compress_count;
+static int g_compress_algo = -1;
+static uint8_t g_decompress_algo;
 static TAILQ_HEAD(, ut_reduce_bdev_io) g_pending_bdev_io =
 	TAILQ_HEAD_INITIALIZER(g_pending_bdev_io);
 static uint32_t g_pending_bdev_io_count = 0;
@@ -219,6 +222,13 @@ init_failure(void)
 	CU_ASSERT(g_reduce_errno == -EINVAL);
 	SPDK_CU_ASSERT_FATAL(g_vol == NULL);
 
+	/* Unknown volume flags.  This should fail. */
+	params.flags = SPDK_REDUCE_VOL_FLAG_ADAPTIVE << 1;
+	CU_ASSERT(_validate_vol_params(&params) == -EINVAL);
+	params.flags = SPDK_REDUCE_VOL_FLAG_ADAPTIVE;
+	CU_ASSERT(_validate_vol_params(&params) == 0);
+	params.flags = 0;
+
 	/* backing_dev now has valid size, but backing_dev still has null
 	 *  function pointers.  This should fail.
 	 */
@@ -501,6 +511,10 @@ backing_dev_compress(struct spdk_reduce_backing_dev *backing_dev,
 	rc = ut_compress(dst_iov[0].iov_base, &compressed_len,
 			 g_decomp_buf, total_length);
 
+	g_compress_count++;
+	if (g_compress_algo >= 0) {
+		args->comp_algo = g_compress_algo;
+	}
 	args->output_size = compressed_len;
 
 	args->cb_fn(args->cb_arg, rc);
@@ -524,6 +538,7 @@ backing_dev_decompress(struct spdk_reduce_backing_dev *backing_dev,
 
 	rc = ut_decompress(g_decomp_buf, &decompressed_len,
 			   src_iov[0].iov_base, src_iov[0].iov_len);
+	g_decompress_algo = args->comp_algo;
 
 	for (i = 0; i < dst_iovcnt; i++) {
 		memcpy(dst_iov[i].iov_base, buf, dst_iov[i].iov_len);
@@ -707,6 +722,15 @@ _load(uint32_t backing_blocklen)
 	spdk_reduce_vol_unload(g_vol, unload_cb, NULL);
 	CU_ASSERT(g_reduce_errno == 0);
 
+	/* A volume with flags this release doesn't know can't be loaded */
+	((struct spdk_reduce_vol_superblock *)g_backing_dev_buf)->params.flags =
+		SPDK_REDUCE_VOL_FLAG_ADAPTIVE << 1;
+	g_vol = NULL;
+	g_reduce_errno = -1;
+	spdk_reduce_vol_load(&backing_dev, load_cb, NULL);
+	CU_ASSERT(g_reduce_errno == -EINVAL);
+	CU_ASSERT(g_vol == NULL);
+
 	persistent_pm_buf_destroy();
 	backing_dev_destroy(&backing_dev);
 }
@@ -1813,6 +1837,155 @@ test_reduce_decompress_chunk(void)
 	free(buf);
 }
 
+/* Reduce doesn't interpret the algorithm, it only records it for the backing device */
+#define UT_VOL_COMP_ALGO	1
+#define UT_CHUNK_COMP_ALGO	2
+
+static void
+_adaptive_write_read_chunk(uint64_t chunk, bool compressible)
+{
+	uint64_t lbas_per_chunk = g_vol->params.chunk_size / g_vol->params.logical_block_size;
+	uint8_t buf[16 * 1024], read_buf[16 * 1024];
+	struct iovec iov;
+
+	SPDK_CU_ASSERT_FATAL(g_vol->params.chunk_size == sizeof(buf));
+	if (compressible) {
+		memset(buf, (int)chunk, sizeof(buf));
+	} else {
+		ut_build_data_buffer(buf, sizeof(buf), (uint8_t)chunk, 1);
+	}
+
+	iov.iov_base = buf;
+	iov.iov_len = sizeof(buf);
+	g_reduce_errno = -1;
+	spdk_reduce_vol_writev(g_vol, &iov, 1, chunk * lbas_per_chunk, lbas_per_chunk,
+			       write_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+
+	iov.iov_base = read_buf;
+	g_reduce_errno = -1;
+	spdk_reduce_vol_readv(g_vol, &iov, 1, chunk * lbas_per_chunk, lbas_per_chunk,
+			      read_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	CU_ASSERT(memcmp(buf, read_buf, sizeof(buf)) == 0);
+}
+
+static void
+test_adaptive_compression(void)
+{
+	struct spdk_reduce_vol_params params = {};
+	struct spdk_reduce_backing_dev backing_dev = {};
+	struct spdk_reduce_chunk_map *chunk;
+	uint8_t buf[16 * 1024];
+	struct iovec iov;
+	uint64_t i, num_chunks = 0;
+
+	params.chunk_size = 16 * 1024;
+	params.backing_io_unit_size = 4096;
+	params.logical_block_size = 512;
+	params.comp_algo = UT_VOL_COMP_ALGO;
+	params.flags = SPDK_REDUCE_VOL_FLAG_ADAPTIVE;
+	spdk_uuid_generate(&params.uuid);
+
+	backing_dev_init(&backing_dev, &params, 512);
+
+	g_vol = NULL;
+	g_reduce_errno = -1;
+	spdk_reduce_vol_init(&params, &backing_dev, TEST_MD_PATH, init_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	SPDK_CU_ASSERT_FATAL(g_vol != NULL);
+
+	/* The first incompressible chunks are still compressed */
+	g_compress_count = 0;
+	for (i = 0; i < REDUCE_ADAPTIVE_INCOMPRESSIBLE_CHUNKS; i++) {
+		_adaptive_write_read_chunk(num_chunks++, false);
+	}
+	CU_ASSERT(g_compress_count == REDUCE_ADAPTIVE_INCOMPRESSIBLE_CHUNKS);
+
+	/* Now the chunks are stored uncompressed without compressing them until the next sample */
+	g_compress_count = 0;
+	for (i = 0; i < REDUCE_ADAPTIVE_SAMPLE_INTERVAL - 1; i++) {
+		_adaptive_write_read_chunk(num_chunks++, true);
+		chunk = _reduce_vol_get_chunk_map(g_vol, g_vol->pm_logical_map[num_chunks - 1]);
+		CU_ASSERT(chunk->compressed_size == params.chunk_size);
+	}
+	CU_ASSERT(g_compress_count == 0);
+
+	/* The sample shows the data is compressible again, so the following chunks are compressed
+	 * too.  Check that the algorithm reported by the backing device is used for decompression.
+	 */
+	g_compress_algo = UT_CHUNK_COMP_ALGO;
+	for (i = 0; i < 2; i++) {
+		_adaptive_write_read_chunk(num_chunks++, true);
+		chunk = _reduce_vol_get_chunk_map(g_vol, g_vol->pm_logical_map[num_chunks - 1]);
+		CU_ASSERT(chunk->compressed_size < params.chunk_size);
+		CU_ASSERT(chunk->flags & REDUCE_CHUNK_FLAG_COMP_ALGO);
+		CU_ASSERT(chunk->comp_algo == UT_CHUNK_COMP_ALGO);
+		CU_ASSERT(g_decompress_algo == UT_CHUNK_COMP_ALGO);
+	}
+	CU_ASSERT(g_compress_count == 2);
+	g_compress_algo = -1;
+
+	/* Chunks without a recorded algorithm use the volume's one */
+	chunk->flags = 0;
+	iov.iov_base = buf;
+	iov.iov_len = sizeof(buf);
+	g_reduce_errno = -1;
+	spdk_reduce_vol_readv(g_vol, &iov, 1, (num_chunks - 1) * g_vol->logical_blocks_per_chunk,
+			      g_vol->logical_blocks_per_chunk, read_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	CU_ASSERT(g_decompress_algo == UT_VOL_COMP_ALGO);
+
+	g_reduce_errno = -1;
+	spdk_reduce_vol_unload(g_vol, unload_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+
+	persistent_pm_buf_destroy();
+	backing_dev_destroy(&backing_dev);
+}
+
+static void
+test_legacy_chunk_map(void)
+{
+	struct spdk_reduce_vol_params params = {};
+	struct spdk_reduce_backing_dev backing_dev = {};
+	struct spdk_reduce_chunk_map *chunk;
+
+	params.chunk_size = 16 * 1024;
+	params.backing_io_unit_size = 4096;
+	params.logical_block_size = 512;
+	params.comp_algo = UT_VOL_COMP_ALGO;
+	spdk_uuid_generate(&params.uuid);
+
+	backing_dev_init(&backing_dev, &params, 512);
+
+	g_vol = NULL;
+	g_reduce_errno = -1;
+	spdk_reduce_vol_init(&params, &backing_dev, TEST_MD_PATH, init_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	SPDK_CU_ASSERT_FATAL(g_vol != NULL);
+
+	/* Chunk maps start out filled with 0xFF, which is also what volumes created before the
+	 * chunk flags were introduced have in them.  On non-adaptive volumes they're left alone
+	 * and ignored, even if the backing device reports a different algorithm.
+	 */
+	g_compress_algo = UT_CHUNK_COMP_ALGO;
+	_adaptive_write_read_chunk(0, true);
+	g_compress_algo = -1;
+	chunk = _reduce_vol_get_chunk_map(g_vol, g_vol->pm_logical_map[0]);
+	CU_ASSERT(chunk->compressed_size < params.chunk_size);
+	CU_ASSERT(chunk->flags == 0xFF);
+	CU_ASSERT(chunk->comp_algo == 0xFF);
+	CU_ASSERT(g_decompress_algo == UT_VOL_COMP_ALGO);
+
+	g_reduce_errno = -1;
+	spdk_reduce_vol_unload(g_vol, unload_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+
+	persistent_pm_buf_destroy();
+	backing_dev_destroy(&backing_dev);
+}
+
 static void
 test_allocate_vol_requests(void)
 {
@@ -1868,6 +2041,8 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_prepare_compress_chunk);
 	CU_ADD_TEST(suite, test_reduce_decompress_chunk);
 	CU_ADD_TEST(suite, test_allocate_vol_requests);
+	CU_ADD_TEST(suite, test_adaptive_compression);
+	CU_ADD_TEST(suite, test_legacy_chunk_map);
 
 	g_unlink_path = g_path;
 	g_unlink_callback = unlink_cb;
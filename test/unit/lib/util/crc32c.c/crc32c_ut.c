@@ -112,6 +112,18 @@ test_crc32c(void)
 	crc = spdk_crc32c_update(buf, strlen(buf), crc);
 	crc ^= 0xFFFFFFFFu;
 	CU_ASSERT(crc == 0x6087809A);
+
+	/* Short buffers that start and end between the same two 8-byte boundaries. */
+	snprintf(buf, sizeof(buf), "%s", "x1234567");
+	crc = 0xFFFFFFFFu;
+	crc = spdk_crc32c_update(buf + 1, 1, crc);
+	crc ^= 0xFFFFFFFFu;
+	CU_ASSERT(crc == 0x90F599E3);
+
+	crc = 0xFFFFFFFFu;
+	crc = spdk_crc32c_update(buf + 1, 3, crc);
+	crc ^= 0xFFFFFFFFu;
+	CU_ASSERT(crc == 0x107B2FB2);
 }
 
 static void
@@ -164,6 +176,46 @@ test_crc32c_nvme(void)
 	CU_ASSERT(crc == 0x214941A8);
 }
 
+static void
+test_crc32c_batch(void)
+{
+	/* Mix of short/long and aligned/unaligned buffers, including lengths not divisible by 8 and
+	 * buffers longer than the size at which the interleaving stops */
+	const size_t lens[] = { 0, 1, 7, 8, 13, 512, 520, 1024, 1025, 4096, 3 };
+	const size_t offs[] = { 0, 0, 1, 0, 3, 0, 5, 0, 7, 8, 2 };
+	uint8_t buf[4096 + 16];
+	struct iovec iovs[SPDK_COUNTOF(lens)];
+	uint32_t crcs[SPDK_COUNTOF(lens)], expected[SPDK_COUNTOF(lens)];
+	uint32_t i, count;
+
+	for (i = 0; i < sizeof(buf); i++) {
+		buf[i] = (uint8_t)(i * 7 + 1);
+	}
+
+	/* Check all possible batch sizes, so that partial groups of buffers are tested too */
+	for (count = 0; count <= SPDK_COUNTOF(iovs); count++) {
+		for (i = 0; i < count; i++) {
+			iovs[i].iov_base = &buf[offs[i]];
+			iovs[i].iov_len = lens[i];
+			crcs[i] = 0xFFFFFFFFu - i;
+			expected[i] = spdk_crc32c_update(iovs[i].iov_base, iovs[i].iov_len, crcs[i]);
+		}
+
+		spdk_crc32c_update_batch(iovs, crcs, count);
+		for (i = 0; i < count; i++) {
+			CU_ASSERT_EQUAL(crcs[i], expected[i]);
+		}
+	}
+
+	/* Verify against a known value */
+	snprintf((char *)buf, sizeof(buf), "%s", "Hello world!");
+	iovs[0].iov_base = buf;
+	iovs[0].iov_len = strlen((char *)buf);
+	crcs[0] = 0xFFFFFFFFu;
+	spdk_crc32c_update_batch(iovs, crcs, 1);
+	CU_ASSERT_EQUAL(crcs[0] ^ 0xFFFFFFFFu, 0x7b98e751);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -176,6 +228,7 @@ main(int argc, char **argv)
 
 	CU_ADD_TEST(suite, test_crc32c);
 	CU_ADD_TEST(suite, test_crc32c_nvme);
+	CU_ADD_TEST(suite, test_crc32c_batch);
 
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
@@ -58,6 +58,41 @@ test_crc64_nvme(void)
 	CU_ASSERT(crc == 0x9A2DF64B8E9E517E);
 }
 
+static void
+test_crc64_nvme_batch(void)
+{
+	const size_t lens[] = { 4096, 0, 1, 512, 4095, 33 };
+	uint8_t buf[4096];
+	struct iovec iovs[SPDK_COUNTOF(lens)];
+	uint64_t crcs[SPDK_COUNTOF(lens)], expected[SPDK_COUNTOF(lens)];
+	uint32_t i, count;
+
+	for (i = 0; i < sizeof(buf); i++) {
+		buf[i] = (uint8_t)i;
+	}
+
+	for (count = 0; count <= SPDK_COUNTOF(iovs); count++) {
+		for (i = 0; i < count; i++) {
+			iovs[i].iov_base = &buf[sizeof(buf) - lens[i]];
+			iovs[i].iov_len = lens[i];
+			crcs[i] = i;
+			expected[i] = spdk_crc64_nvme(iovs[i].iov_base, iovs[i].iov_len, crcs[i]);
+		}
+
+		spdk_crc64_nvme_batch(iovs, crcs, count);
+		for (i = 0; i < count; i++) {
+			CU_ASSERT_EQUAL(crcs[i], expected[i]);
+		}
+	}
+
+	/* Input buffer = 0x00, 0x01, 0x02, ... (known value from test_crc64_nvme()) */
+	iovs[0].iov_base = buf;
+	iovs[0].iov_len = sizeof(buf);
+	crcs[0] = 0;
+	spdk_crc64_nvme_batch(iovs, crcs, 1);
+	CU_ASSERT(crcs[0] == 0x3E729F5F6750449C);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -70,6 +105,7 @@ main(int argc, char **argv)
 	suite = CU_add_suite("crc64", NULL, NULL);
 
 	CU_ADD_TEST(suite, test_crc64_nvme);
+	CU_ADD_TEST(suite, test_crc64_nvme_batch);
 
 	CU_basic_set_mode(CU_BRM_VERBOSE);
 
@@ -1575,6 +1575,70 @@ dif_sec_4096_md_128_inject_1_2_4_8_multi_iovs_split_reftag_test(void)
 	_dif_sec_4096_md_128_inject_1_2_4_8_multi_iovs_split_reftag_test(SPDK_DIF_PI_FORMAT_64);
 }
 
+/* Enough blocks for several batches of the contiguous fast path, whose result must be the same
+ * as the one of the general path used when a block is split between iovecs.
+ */
+static void
+_dif_sec_md_prchk_7_many_blocks_test(uint32_t block_size, uint32_t md_size,
+				     enum spdk_dif_pi_format dif_pi_format)
+{
+	struct spdk_dif_ctx ctx = {};
+	struct spdk_dif_ctx_init_ext_opts dif_opts;
+	struct iovec iov1, iov2, iovs[2];
+	uint32_t dif_flags, num_blocks = 70, split;
+	int rc;
+
+	dif_flags = SPDK_DIF_FLAGS_GUARD_CHECK | SPDK_DIF_FLAGS_APPTAG_CHECK |
+		    SPDK_DIF_FLAGS_REFTAG_CHECK;
+
+	_iov_alloc_buf(&iov1, block_size * num_blocks);
+	_iov_alloc_buf(&iov2, block_size * num_blocks);
+	split = block_size * 33 + 7;
+	_iov_set_buf(&iovs[0], iov2.iov_base, split);
+	_iov_set_buf(&iovs[1], (uint8_t *)iov2.iov_base + split, block_size * num_blocks - split);
+
+	rc = ut_data_pattern_generate(&iov1, 1, block_size, md_size, num_blocks);
+	CU_ASSERT(rc == 0);
+	rc = ut_data_pattern_generate(iovs, 2, block_size, md_size, num_blocks);
+	CU_ASSERT(rc == 0);
+
+	dif_opts.size = SPDK_SIZEOF(&dif_opts, dif_pi_format);
+	dif_opts.dif_pi_format = dif_pi_format;
+	rc = spdk_dif_ctx_init(&ctx, block_size, md_size, true, false, SPDK_DIF_TYPE1, dif_flags,
+			       22, 0xFFFF, 0x22, 0, GUARD_SEED, &dif_opts);
+	CU_ASSERT(rc == 0);
+
+	rc = spdk_dif_generate(&iov1, 1, num_blocks, &ctx);
+	CU_ASSERT(rc == 0);
+	rc = spdk_dif_generate(iovs, 2, num_blocks, &ctx);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(memcmp(iov1.iov_base, iov2.iov_base, block_size * num_blocks) == 0);
+
+	rc = spdk_dif_verify(&iov1, 1, num_blocks, &ctx, NULL);
+	CU_ASSERT(rc == 0);
+
+	dif_inject_error_and_verify(&iov1, 1, block_size, md_size, num_blocks,
+				    SPDK_DIF_GUARD_ERROR, dif_pi_format);
+	dif_inject_error_and_verify(&iov1, 1, block_size, md_size, num_blocks,
+				    SPDK_DIF_APPTAG_ERROR, dif_pi_format);
+	dif_inject_error_and_verify(&iov1, 1, block_size, md_size, num_blocks,
+				    SPDK_DIF_REFTAG_ERROR, dif_pi_format);
+	dif_inject_error_and_verify(&iov1, 1, block_size, md_size, num_blocks,
+				    SPDK_DIF_DATA_ERROR, dif_pi_format);
+
+	_iov_free_buf(&iov1);
+	_iov_free_buf(&iov2);
+}
+
+static void
+dif_sec_md_prchk_7_many_blocks_test(void)
+{
+	_dif_sec_md_prchk_7_many_blocks_test(512 + 8, 8, SPDK_DIF_PI_FORMAT_16);
+	_dif_sec_md_prchk_7_many_blocks_test(4096 + 128, 128, SPDK_DIF_PI_FORMAT_16);
+	_dif_sec_md_prchk_7_many_blocks_test(4096 + 128, 128, SPDK_DIF_PI_FORMAT_32);
+	_dif_sec_md_prchk_7_many_blocks_test(4096 + 128, 128, SPDK_DIF_PI_FORMAT_64);
+}
+
 static void
 dif_copy_gen_and_verify(struct iovec *iovs, int iovcnt,
 			struct iovec *bounce_iovs, int bounce_iovcnt,
@@ -2757,6 +2821,71 @@ dix_sec_4096_md_128_inject_1_2_4_8_multi_iovs_split_test(void)
 	_iov_free_buf(&md_iov);
 }
 
+static void
+_dix_sec_md_prchk_7_many_blocks_test(uint32_t block_size, uint32_t md_size,
+				     enum spdk_dif_pi_format dif_pi_format)
+{
+	struct spdk_dif_ctx ctx = {};
+	struct spdk_dif_ctx_init_ext_opts dif_opts;
+	struct iovec iov1, iov2, iovs[2], md_iov1, md_iov2;
+	uint32_t dif_flags, num_blocks = 70, split;
+	int rc;
+
+	dif_flags = SPDK_DIF_FLAGS_GUARD_CHECK | SPDK_DIF_FLAGS_APPTAG_CHECK |
+		    SPDK_DIF_FLAGS_REFTAG_CHECK;
+
+	_iov_alloc_buf(&iov1, block_size * num_blocks);
+	_iov_alloc_buf(&iov2, block_size * num_blocks);
+	_iov_alloc_buf(&md_iov1, md_size * num_blocks);
+	_iov_alloc_buf(&md_iov2, md_size * num_blocks);
+	split = block_size * 33 + 7;
+	_iov_set_buf(&iovs[0], iov2.iov_base, split);
+	_iov_set_buf(&iovs[1], (uint8_t *)iov2.iov_base + split, block_size * num_blocks - split);
+
+	rc = ut_data_pattern_generate(&iov1, 1, block_size, 0, num_blocks);
+	CU_ASSERT(rc == 0);
+	rc = ut_data_pattern_generate(iovs, 2, block_size, 0, num_blocks);
+	CU_ASSERT(rc == 0);
+
+	dif_opts.size = SPDK_SIZEOF(&dif_opts, dif_pi_format);
+	dif_opts.dif_pi_format = dif_pi_format;
+	rc = spdk_dif_ctx_init(&ctx, block_size, md_size, false, false, SPDK_DIF_TYPE1, dif_flags,
+			       22, 0xFFFF, 0x22, 0, GUARD_SEED, &dif_opts);
+	CU_ASSERT(rc == 0);
+
+	rc = spdk_dix_generate(&iov1, 1, &md_iov1, num_blocks, &ctx);
+	CU_ASSERT(rc == 0);
+	rc = spdk_dix_generate(iovs, 2, &md_iov2, num_blocks, &ctx);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(memcmp(md_iov1.iov_base, md_iov2.iov_base, md_size * num_blocks) == 0);
+
+	rc = spdk_dix_verify(&iov1, 1, &md_iov1, num_blocks, &ctx, NULL);
+	CU_ASSERT(rc == 0);
+
+	dix_inject_error_and_verify(&iov1, 1, &md_iov1, block_size, md_size, num_blocks,
+				    SPDK_DIF_GUARD_ERROR, dif_pi_format);
+	dix_inject_error_and_verify(&iov1, 1, &md_iov1, block_size, md_size, num_blocks,
+				    SPDK_DIF_APPTAG_ERROR, dif_pi_format);
+	dix_inject_error_and_verify(&iov1, 1, &md_iov1, block_size, md_size, num_blocks,
+				    SPDK_DIF_REFTAG_ERROR, dif_pi_format);
+	dix_inject_error_and_verify(&iov1, 1, &md_iov1, block_size, md_size, num_blocks,
+				    SPDK_DIF_DATA_ERROR, dif_pi_format);
+
+	_iov_free_buf(&iov1);
+	_iov_free_buf(&iov2);
+	_iov_free_buf(&md_iov1);
+	_iov_free_buf(&md_iov2);
+}
+
+static void
+dix_sec_md_prchk_7_many_blocks_test(void)
+{
+	_dix_sec_md_prchk_7_many_blocks_test(512, 8, SPDK_DIF_PI_FORMAT_16);
+	_dix_sec_md_prchk_7_many_blocks_test(4096, 128, SPDK_DIF_PI_FORMAT_16);
+	_dix_sec_md_prchk_7_many_blocks_test(4096, 128, SPDK_DIF_PI_FORMAT_32);
+	_dix_sec_md_prchk_7_many_blocks_test(4096, 128, SPDK_DIF_PI_FORMAT_64);
+}
+
 static int
 ut_readv(uint32_t read_base, uint32_t read_len, struct iovec *iovs, int iovcnt)
 {
@@ -4456,6 +4585,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, dif_sec_4096_md_128_inject_1_2_4_8_multi_iovs_split_apptag_test);
 	CU_ADD_TEST(suite, dif_sec_4096_md_128_inject_1_2_4_8_multi_iovs_split_reftag_pi_16_test);
 	CU_ADD_TEST(suite, dif_sec_4096_md_128_inject_1_2_4_8_multi_iovs_split_reftag_test);
+	CU_ADD_TEST(suite, dif_sec_md_prchk_7_many_blocks_test);
 	CU_ADD_TEST(suite, dif_copy_sec_512_md_8_prchk_0_single_iov);
 	CU_ADD_TEST(suite, dif_copy_sec_512_md_8_dif_disable_single_iov);
 	CU_ADD_TEST(suite, dif_copy_sec_4096_md_128_prchk_0_single_iov_test);
@@ -4486,6 +4616,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, dix_sec_4096_md_128_prchk_7_multi_iovs_complex_splits_test);
 	CU_ADD_TEST(suite, dix_sec_4096_md_128_inject_1_2_4_8_multi_iovs_test);
 	CU_ADD_TEST(suite, dix_sec_4096_md_128_inject_1_2_4_8_multi_iovs_split_test);
+	CU_ADD_TEST(suite, dix_sec_md_prchk_7_many_blocks_test);
 	CU_ADD_TEST(suite, set_md_interleave_iovs_test);
 	CU_ADD_TEST(suite, set_md_interleave_iovs_split_test);
 	CU_ADD_TEST(suite, dif_generate_stream_pi_16_test);
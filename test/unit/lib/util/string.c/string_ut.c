@@ -503,6 +503,33 @@ test_strcpy_replace(void)
 	CU_ASSERT(strcmp(result, expected7) == 0);
 }
 
+static void
+test_mem_all_zero(void)
+{
+	uint8_t buf[1024 + 7] = {};
+	size_t offset, size, i;
+
+	CU_ASSERT(spdk_mem_all_zero(buf, 0));
+
+	/* Cover all the combinations of misaligned start addresses and sizes that aren't a
+	 * multiple of the vector or word size, with a single non-zero byte at every position */
+	for (offset = 0; offset < 8; offset++) {
+		for (size = 1; size <= sizeof(buf) - offset; size += 61) {
+			CU_ASSERT(spdk_mem_all_zero(&buf[offset], size));
+			for (i = 0; i < size; i++) {
+				buf[offset + i] = 0x80;
+				CU_ASSERT(!spdk_mem_all_zero(&buf[offset], size));
+				buf[offset + i] = 0;
+			}
+		}
+	}
+
+	/* Bytes outside of the checked range must be ignored */
+	buf[0] = 1;
+	buf[sizeof(buf) - 1] = 1;
+	CU_ASSERT(spdk_mem_all_zero(&buf[1], sizeof(buf) - 2));
+}
+
 int
 main(int argc, char **argv)
 {
@@ -521,6 +548,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_strtoll);
 	CU_ADD_TEST(suite, test_strarray);
 	CU_ADD_TEST(suite, test_strcpy_replace);
+	CU_ADD_TEST(suite, test_mem_all_zero);
 
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
@@ -111,6 +111,8 @@ function unittest_nvmf() {
 	$valgrind $testdir/lib/nvmf/subsystem.c/subsystem_ut
 	$valgrind $testdir/lib/nvmf/tcp.c/tcp_ut
 	$valgrind $testdir/lib/nvmf/nvmf.c/nvmf_ut
+	$valgrind $testdir/lib/nvmf/qos.c/qos_ut
+	$valgrind $testdir/lib/nvmf/reservation_bdev.c/reservation_bdev_ut
 }
 
 function unittest_scsi() {
@@ -217,6 +219,7 @@ if [ $(uname -s) = Linux ]; then
 fi
 
 run_test "unittest_accel" $valgrind $testdir/lib/accel/accel.c/accel_ut
+run_test "unittest_accel_sw_async" $valgrind $testdir/lib/accel/sw_async.c/accel_sw_async_ut
 run_test "unittest_ioat" $valgrind $testdir/lib/ioat/ioat.c/ioat_ut
 if [[ $CONFIG_IDXD == y ]]; then
 	run_test "unittest_idxd_user" $valgrind $testdir/lib/idxd/idxd_user.c/idxd_user_ut